@@ -0,0 +1,154 @@
+//======================================================================================
+// Filename: AllocationTracking.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "AllocationTracking.h"
+
+#if BUILD_ENABLE_ALLOCATION_TRACKING
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+//======================================================================================
+
+namespace
+{
+	std::atomic<u64> _globalAllocationCount = { 0 };
+}
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+u64 GetGlobalAllocationCount()
+{
+	return _globalAllocationCount.load(std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------
+
+void* operator new(size_t size)
+{
+	_globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* memory = malloc(size != 0 ? size : 1);
+	if (nullptr == memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+//--------------------------------------------------------------------------------------
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+//--------------------------------------------------------------------------------------
+
+// Types over alignof(std::max_align_t), e.g. the alignas(64) BvhNode
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	_globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* memory = _aligned_malloc(size != 0 ? size : 1, static_cast<size_t>(alignment));
+	if (nullptr == memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+//--------------------------------------------------------------------------------------
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+//--------------------------------------------------------------------------------------
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+//--------------------------------------------------------------------------------------
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+//--------------------------------------------------------------------------------------
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+//--------------------------------------------------------------------------------------
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+//--------------------------------------------------------------------------------------
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	_aligned_free(memory);
+}
+
+//--------------------------------------------------------------------------------------
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	_aligned_free(memory);
+}
+
+//--------------------------------------------------------------------------------------
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+	_aligned_free(memory);
+}
+
+//--------------------------------------------------------------------------------------
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept
+{
+	_aligned_free(memory);
+}
+
+//======================================================================================
+// Class FrameAllocationCheck
+//======================================================================================
+
+void FrameAllocationCheck::BeginFrame()
+{
+	mFrameStart = GetGlobalAllocationCount();
+}
+
+//--------------------------------------------------------------------------------------
+
+u64 FrameAllocationCheck::EndFrame()
+{
+	const u64 allocations = GetGlobalAllocationCount() - mFrameStart;
+	++mFrameCount;
+	if (mFrameCount > mWarmupFrames)
+	{
+		mSteadyAllocationCount += allocations;
+		ASSERT(allocations == 0, "[FrameAllocationCheck] Frame %llu made %llu heap allocations!", mFrameCount, allocations);
+	}
+	return allocations;
+}
+
+#endif //BUILD_ENABLE_ALLOCATION_TRACKING
+
+//======================================================================================
@@ -0,0 +1,54 @@
+#ifndef ENGINE_ALLOCATION_TRACKING_H__
+#define ENGINE_ALLOCATION_TRACKING_H__
+//======================================================================================
+// Filename: AllocationTracking.h
+// Description: Counts global operator new calls when BUILD_ENABLE_ALLOCATION_TRACKING
+//				is on, which it is by default in Debug. AllocationTracking.cpp then
+//				replaces operator new for the whole program.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+
+//======================================================================================
+// Function Declarations
+//======================================================================================
+
+#if BUILD_ENABLE_ALLOCATION_TRACKING
+// Number of global operator new calls made by the program so far, aligned or not
+u64 GetGlobalAllocationCount();
+#endif //BUILD_ENABLE_ALLOCATION_TRACKING
+
+//======================================================================================
+// Class FrameAllocationCheck
+//======================================================================================
+
+#if BUILD_ENABLE_ALLOCATION_TRACKING
+// Wraps each frame of a steady state loop. The warm-up frames may allocate while
+// persistent containers grow to their working size, after that any heap allocation
+// in a frame fails an ASSERT.
+class FrameAllocationCheck
+{
+public:
+	explicit FrameAllocationCheck( u64 warmupFrames ) : mWarmupFrames( warmupFrames ) {}
+
+	void BeginFrame();
+	// Returns the heap allocations made since BeginFrame
+	u64 EndFrame();
+
+	u64 GetFrameCount() const												{ return mFrameCount; }
+	// Heap allocations made by the frames after the warm-up
+	u64 GetSteadyAllocationCount() const									{ return mSteadyAllocationCount; }
+
+private:
+	u64 mWarmupFrames = 0;
+	u64 mFrameCount = 0;
+	u64 mFrameStart = 0;
+	u64 mSteadyAllocationCount = 0;
+};
+#endif //BUILD_ENABLE_ALLOCATION_TRACKING
+
+//======================================================================================
+#endif // !ENGINE_ALLOCATION_TRACKING_H__
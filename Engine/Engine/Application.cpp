@@ -8,24 +8,32 @@
 // Includes
 //======================================================================================
 #include "Application.h"
+#include "AllocationTracking.h"
+#include "BindlessTable.h"
 #include "Common.h"
+#include "DescriptorAllocator.h"
+#include "EngineMath.h"
+#include "GpuRingBuffer.h"
+#include "GpuTimeline.h"
+#include "JobSystem.h"
 #include "Renderer.h"
 #include "Window.h"
 //======================================================================================
 
-constexpr double kPi				= 3.14159265358979323846;
-constexpr double kCircleRad			= kPi * 2;
-constexpr double kCircleThird		= kCircleRad / 3.0;
-constexpr double kCircleThird1		= 0;
-constexpr double kCircleThird2		= kCircleThird;
-constexpr double kCircleThird3		= kCircleThird * 2;
+constexpr f32 kCircleThird			= Math::kTwoPi / 3.0f;
+constexpr f32 kCircleThird1			= 0.0f;
+constexpr f32 kCircleThird2			= kCircleThird;
+constexpr f32 kCircleThird3			= kCircleThird * 2.0f;
+
+#if BUILD_ENABLE_ALLOCATION_TRACKING
+constexpr u64 kAllocationWarmupFrames	= 16;
+#endif
 
 namespace
 {
 	VkCommandPool		_commandPool	= VK_NULL_HANDLE;
 	VkCommandBuffer		_commandBuffer	= VK_NULL_HANDLE;
-
-	VkSemaphore			_renderCompleteSempahore = VK_NULL_HANDLE;
+	u64					_commandBufferTimelineValue = 0;
 
 	struct Color
 	{
@@ -36,7 +44,11 @@ namespace
 	};
 
 	Color _color = {};
-	double _colorRotator = 0.0f;
+	f32 _colorRotator = 0.0f;
+
+#if BUILD_ENABLE_ALLOCATION_TRACKING
+	FrameAllocationCheck _allocationCheck(kAllocationWarmupFrames);
+#endif
 }
 
 
@@ -55,6 +67,7 @@ Application::~Application()
 
 void Application::Initialize(const std::string& appName, u32 windowWidth, u32 windowHeight)
 {
+	mJobSystem = new JobSystem();
 
 	mRenderer = new Renderer();
 	mRenderer->InitializeWindow( appName, windowWidth, windowHeight );
@@ -73,32 +86,38 @@ void Application::Initialize(const std::string& appName, u32 windowWidth, u32 wi
 	cmdBufferAllocateInfo.level					= VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 	cmdBufferAllocateInfo.commandBufferCount	= 1;
 	vkAllocateCommandBuffers(mRenderer->GetVulkanDevice(), &cmdBufferAllocateInfo, &_commandBuffer);
-
-	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
-	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-	vkCreateSemaphore(mRenderer->GetVulkanDevice(), &semaphoreCreateInfo, nullptr, &_renderCompleteSempahore);
-
 }
 
 //--------------------------------------------------------------------------------------
 
 void Application::Terminate()
 {
-	vkQueueWaitIdle(mRenderer->GetVulkanQueue());
-	vkDestroySemaphore(mRenderer->GetVulkanDevice(), _renderCompleteSempahore, nullptr);
+	{
+		std::lock_guard<std::mutex> lock(mRenderer->GetVulkanQueueMutex());
+		vkQueueWaitIdle(mRenderer->GetVulkanQueue());
+	}
 	vkDestroyCommandPool(mRenderer->GetVulkanDevice(), _commandPool, nullptr);
 	SAVE_DELETE(mRenderer);
+	SAVE_DELETE(mJobSystem);
 }
 
 //--------------------------------------------------------------------------------------
 
 bool Application::Run()
 {
+#if BUILD_ENABLE_ALLOCATION_TRACKING
+	_allocationCheck.BeginFrame();
+#endif
+
 	mIsRunning = mRenderer->Run();
 	if (mIsRunning)
 	{
 		//Begin render
 		mWindow->BeginRender();
+
+		//Command buffer is reused, wait for the frame that last recorded it
+		GpuTimeline* timeline = mRenderer->GetGraphicsTimeline();
+		timeline->Wait(_commandBufferTimelineValue);
 		
 		//Record command buffer
 		VkCommandBufferBeginInfo bufferBeginInfo = {};
@@ -120,10 +139,15 @@ bool Application::Run()
 
 		//Cycle colors
 		{
-			_colorRotator += 0.001;
-			_color.r = static_cast<float>( std::sin( _colorRotator + kCircleThird1 ) * 0.5 + 0.5 );
-			_color.g = static_cast<float>( std::sin( _colorRotator + kCircleThird2 ) * 0.5 + 0.5 );
-			_color.b = static_cast<float>( std::sin( _colorRotator + kCircleThird3 ) * 0.5 + 0.5 );
+			//Wrap so the angle keeps its precision however long we run
+			_colorRotator += 0.001f;
+			if (_colorRotator > Math::kTwoPi)
+			{
+				_colorRotator -= Math::kTwoPi;
+			}
+			_color.r = Math::Sin( _colorRotator + kCircleThird1 ) * 0.5f + 0.5f;
+			_color.g = Math::Sin( _colorRotator + kCircleThird2 ) * 0.5f + 0.5f;
+			_color.b = Math::Sin( _colorRotator + kCircleThird3 ) * 0.5f + 0.5f;
 		}
 
 		//@TODO: Check unlying color type and init proper
@@ -150,6 +174,8 @@ bool Application::Run()
 		vkEndCommandBuffer(_commandBuffer);
 
 		//Submit command buffer
+		VkSemaphore renderCompleteSemaphore = mWindow->GetVulkanRenderCompleteSemaphore();
+
 		VkSubmitInfo submitInfo = {};
 		submitInfo.sType				= VK_STRUCTURE_TYPE_SUBMIT_INFO;
 		submitInfo.waitSemaphoreCount	= 0;
@@ -158,15 +184,27 @@ bool Application::Run()
 		submitInfo.commandBufferCount	= 1;
 		submitInfo.pCommandBuffers		= &_commandBuffer;
 		submitInfo.signalSemaphoreCount	= 1;
-		submitInfo.pSignalSemaphores	= &_renderCompleteSempahore;
+		submitInfo.pSignalSemaphores	= &renderCompleteSemaphore;
 
-		vkQueueSubmit(mRenderer->GetVulkanQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+		GpuRingBuffer* frameConstants = mRenderer->GetFrameConstants();
+		frameConstants->Flush();
+		_commandBufferTimelineValue = timeline->Submit(submitInfo);
+		frameConstants->EndFrame(_commandBufferTimelineValue);
+		mRenderer->GetDescriptorAllocator()->EndFrame(_commandBufferTimelineValue);
+		mRenderer->GetBindlessTable()->EndFrame(_commandBufferTimelineValue);
 
 		//End Runder
-		mWindow->EndRender({_renderCompleteSempahore});
+		mWindow->EndRender({renderCompleteSemaphore});
+	}
 
+#if BUILD_ENABLE_ALLOCATION_TRACKING
+	//The steady state loop must not touch the heap, use the frame allocator instead
+	if (mIsRunning)
+	{
+		_allocationCheck.EndFrame();
 	}
-	vkQueueWaitIdle(mRenderer->GetVulkanQueue());
+#endif
+
 	return mIsRunning;
 }
 
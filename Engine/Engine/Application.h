@@ -12,6 +12,7 @@
 #include "Common.h"
 #include <string>
 
+class JobSystem;
 class Renderer;
 class Window;
 //======================================================================================
@@ -28,12 +29,13 @@ public:
 	void Initialize( const std::string& appName, u32 windowWidth, u32 windowHeight );
 	bool Run();
 	void Terminate();
-	
+
 private:
 	NONCOPYABLE(Application)
 
 private:
 	bool mIsRunning = true;
+	JobSystem* mJobSystem = nullptr;
 	Renderer* mRenderer;
 
 	Window* mWindow;
@@ -9,8 +9,33 @@
 // Defines
 //======================================================================================
 
+// Each can be set from the command line instead, e.g. the Tests builds turn
+// BUILD_ENABLE_MATH_SIMD off to measure the scalar paths
+
+#ifndef BUILD_ENABLE_VULKAN_DEBUG
 #define BUILD_ENABLE_VULKAN_DEBUG 1
+#endif
+#ifndef BUILD_ENABLE_VULKAN_RUNTIME_DEBUG
 #define BUILD_ENABLE_VULKAN_RUNTIME_DEBUG 1
+#endif
+#ifndef BUILD_ENABLE_PRESENT_THREAD
+#define BUILD_ENABLE_PRESENT_THREAD 1
+#endif
+// On wherever ASSERT is, so a Debug run fails on the first steady state frame that
+// touches the heap
+#ifndef BUILD_ENABLE_ALLOCATION_TRACKING
+#if defined(_DEBUG)
+#define BUILD_ENABLE_ALLOCATION_TRACKING 1
+#else
+#define BUILD_ENABLE_ALLOCATION_TRACKING 0
+#endif
+#endif
+#ifndef BUILD_ENABLE_MATH_SIMD
+#define BUILD_ENABLE_MATH_SIMD 1
+#endif
+#ifndef BUILD_ENABLE_MATH_ALIGNED_MATRIX
+#define BUILD_ENABLE_MATH_ALIGNED_MATRIX 0
+#endif
 
 
 #endif // !INCLUDE_BUILD_OPTIONS_H__
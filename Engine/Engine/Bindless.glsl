@@ -0,0 +1,16 @@
+//======================================================================================
+// Filename: Bindless.glsl
+// Description: Shader side of BindlessTable. Include with the set index the pipeline
+//				layout gives the table, e.g.
+//					#define BINDLESS_SET 1
+//					#include "Bindless.glsl"
+//				Indices that can differ within a draw must be wrapped in nonuniformEXT.
+//======================================================================================
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = BINDLESS_SET, binding = 0) uniform texture2D bindlessImages[];
+
+layout(std430, set = BINDLESS_SET, binding = 1) readonly buffer BindlessBuffer
+{
+	uint data[];
+} bindlessBuffers[];
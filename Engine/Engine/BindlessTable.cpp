@@ -0,0 +1,247 @@
+//======================================================================================
+// Filename: BindlessTable.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "BindlessTable.h"
+
+#include "GpuTimeline.h"
+#include "GraphicsCommon.h"
+#include "Renderer.h"
+#include "VulkanExtensions.h"
+//======================================================================================
+
+BindlessTable::BindlessTable(Renderer* renderer, u32 frameCount, u32 imageCapacity, u32 bufferCapacity)
+	: mRenderer( renderer )
+	, mFrames( frameCount )
+{
+	ASSERT(frameCount > 0, "[BindlessTable] Needs at least one frame!");
+	mFrameIndex = frameCount - 1;
+
+	if (!mRenderer->IsDescriptorIndexingSupported())
+	{
+		LOG("[BindlessTable] VK_EXT_descriptor_indexing is not supported, bindless is disabled");
+		return;
+	}
+
+	//Stay under both the per stage and the per set limits
+	const VkPhysicalDeviceDescriptorIndexingPropertiesEXT& limits = mRenderer->GetVulkanDescriptorIndexingProperties();
+	u32 maxImages = limits.maxPerStageDescriptorUpdateAfterBindSampledImages;
+	maxImages = (limits.maxDescriptorSetUpdateAfterBindSampledImages < maxImages) ? limits.maxDescriptorSetUpdateAfterBindSampledImages : maxImages;
+	u32 maxBuffers = limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers;
+	maxBuffers = (limits.maxDescriptorSetUpdateAfterBindStorageBuffers < maxBuffers) ? limits.maxDescriptorSetUpdateAfterBindStorageBuffers : maxBuffers;
+	mImages.capacity = (imageCapacity < maxImages) ? imageCapacity : maxImages;
+	mBuffers.capacity = (bufferCapacity < maxBuffers) ? bufferCapacity : maxBuffers;
+	ASSERT(mImages.capacity > 0 && mBuffers.capacity > 0, "[BindlessTable] Capacities must not be zero!");
+
+	VkDevice device = mRenderer->GetVulkanDevice();
+
+	VkDescriptorSetLayoutBinding bindings[2] = {};
+	bindings[0].binding			= kBindlessImageBinding;
+	bindings[0].descriptorType	= VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	bindings[0].descriptorCount	= mImages.capacity;
+	bindings[0].stageFlags		= VK_SHADER_STAGE_ALL;
+	bindings[1].binding			= kBindlessBufferBinding;
+	bindings[1].descriptorType	= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	bindings[1].descriptorCount	= mBuffers.capacity;
+	bindings[1].stageFlags		= VK_SHADER_STAGE_ALL;
+
+	//Unwritten slots are never read, and free slots can be written while the set is
+	//in use by frames still in flight
+	const VkDescriptorBindingFlagsEXT bindingFlag = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT
+		| VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+	const VkDescriptorBindingFlagsEXT bindingFlags[2] = { bindingFlag, bindingFlag };
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo = {};
+	bindingFlagsCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+	bindingFlagsCreateInfo.bindingCount		= 2;
+	bindingFlagsCreateInfo.pBindingFlags	= bindingFlags;
+
+	VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+	layoutCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutCreateInfo.pNext			= &bindingFlagsCreateInfo;
+	layoutCreateInfo.flags			= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+	layoutCreateInfo.bindingCount	= 2;
+	layoutCreateInfo.pBindings		= bindings;
+	vkErrorCheck( vkCreateDescriptorSetLayout(device, &layoutCreateInfo, nullptr, &mDescriptorSetLayout) );
+
+	VkDescriptorPoolSize poolSizes[2] = {};
+	poolSizes[0].type				= VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	poolSizes[0].descriptorCount	= mImages.capacity;
+	poolSizes[1].type				= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	poolSizes[1].descriptorCount	= mBuffers.capacity;
+
+	VkDescriptorPoolCreateInfo poolCreateInfo = {};
+	poolCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolCreateInfo.flags			= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+	poolCreateInfo.maxSets			= 1;
+	poolCreateInfo.poolSizeCount	= 2;
+	poolCreateInfo.pPoolSizes		= poolSizes;
+	vkErrorCheck( vkCreateDescriptorPool(device, &poolCreateInfo, nullptr, &mDescriptorPool) );
+
+	VkDescriptorSetAllocateInfo setAllocateInfo = {};
+	setAllocateInfo.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	setAllocateInfo.descriptorPool		= mDescriptorPool;
+	setAllocateInfo.descriptorSetCount	= 1;
+	setAllocateInfo.pSetLayouts			= &mDescriptorSetLayout;
+	vkErrorCheck( vkAllocateDescriptorSets(device, &setAllocateInfo, &mDescriptorSet) );
+}
+
+//--------------------------------------------------------------------------------------
+
+BindlessTable::~BindlessTable()
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	GpuTimeline* timeline = mRenderer->GetGraphicsTimeline();
+	timeline->Wait(timeline->GetSubmittedValue());
+
+	VkDevice device = mRenderer->GetVulkanDevice();
+	vkDestroyDescriptorPool(device, mDescriptorPool, nullptr);
+	vkDestroyDescriptorSetLayout(device, mDescriptorSetLayout, nullptr);
+}
+
+//--------------------------------------------------------------------------------------
+
+void BindlessTable::BeginFrame()
+{
+	mFrameIndex = (mFrameIndex + 1) % mFrames.size();
+	FrameReleases& frame = mFrames[mFrameIndex];
+	mRenderer->GetGraphicsTimeline()->Wait(frame.value);
+
+	FreeSlots(mImages, frame.images);
+	FreeSlots(mBuffers, frame.buffers);
+}
+
+//--------------------------------------------------------------------------------------
+
+void BindlessTable::EndFrame(u64 value)
+{
+	mFrames[mFrameIndex].value = value;
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 BindlessTable::AllocateImage(VkImageView imageView, VkImageLayout imageLayout)
+{
+	if (!IsEnabled())
+	{
+		return kBindlessInvalid;
+	}
+
+	const u32 slot = AllocateSlot(mImages);
+	if (slot == kBindlessInvalid)
+	{
+		return slot;
+	}
+
+	VkDescriptorImageInfo imageInfo = {};
+	imageInfo.imageView		= imageView;
+	imageInfo.imageLayout	= imageLayout;
+
+	VkWriteDescriptorSet write = {};
+	write.sType				= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet			= mDescriptorSet;
+	write.dstBinding		= kBindlessImageBinding;
+	write.dstArrayElement	= slot;
+	write.descriptorCount	= 1;
+	write.descriptorType	= VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	write.pImageInfo		= &imageInfo;
+	vkUpdateDescriptorSets(mRenderer->GetVulkanDevice(), 1, &write, 0, nullptr);
+	return slot;
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 BindlessTable::AllocateBuffer(const VkDescriptorBufferInfo& bufferInfo)
+{
+	if (!IsEnabled())
+	{
+		return kBindlessInvalid;
+	}
+
+	const u32 slot = AllocateSlot(mBuffers);
+	if (slot == kBindlessInvalid)
+	{
+		return slot;
+	}
+
+	VkWriteDescriptorSet write = {};
+	write.sType				= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet			= mDescriptorSet;
+	write.dstBinding		= kBindlessBufferBinding;
+	write.dstArrayElement	= slot;
+	write.descriptorCount	= 1;
+	write.descriptorType	= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	write.pBufferInfo		= &bufferInfo;
+	vkUpdateDescriptorSets(mRenderer->GetVulkanDevice(), 1, &write, 0, nullptr);
+	return slot;
+}
+
+//--------------------------------------------------------------------------------------
+
+void BindlessTable::ReleaseImage(u32 slot)
+{
+	if (slot == kBindlessInvalid)
+	{
+		return;
+	}
+
+	ASSERT(slot < mImages.nextUnused, "[BindlessTable] Releasing image slot %u that was never allocated!", slot);
+	mFrames[mFrameIndex].images.push_back(slot);
+}
+
+//--------------------------------------------------------------------------------------
+
+void BindlessTable::ReleaseBuffer(u32 slot)
+{
+	if (slot == kBindlessInvalid)
+	{
+		return;
+	}
+
+	ASSERT(slot < mBuffers.nextUnused, "[BindlessTable] Releasing buffer slot %u that was never allocated!", slot);
+	mFrames[mFrameIndex].buffers.push_back(slot);
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 BindlessTable::AllocateSlot(SlotList& slots)
+{
+	u32 slot = kBindlessInvalid;
+	if (!slots.freeSlots.empty())
+	{
+		slot = slots.freeSlots.back();
+		slots.freeSlots.pop_back();
+	}
+	else if (slots.nextUnused < slots.capacity)
+	{
+		slot = slots.nextUnused++;
+	}
+	else
+	{
+		ASSERT(false, "[BindlessTable] Out of slots, %u in use!", slots.used);
+		return kBindlessInvalid;
+	}
+
+	++slots.used;
+	return slot;
+}
+
+//--------------------------------------------------------------------------------------
+
+void BindlessTable::FreeSlots(SlotList& slots, std::vector<u32>& released)
+{
+	//The descriptors are left as they are, partially bound slots are never read
+	slots.freeSlots.insert(slots.freeSlots.end(), released.begin(), released.end());
+	slots.used -= static_cast<u32>(released.size());
+	released.clear();
+}
+
+//======================================================================================
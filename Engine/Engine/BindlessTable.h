@@ -0,0 +1,103 @@
+#ifndef ENGINE_GRAPHICS_BINDLESS_TABLE_H__
+#define ENGINE_GRAPHICS_BINDLESS_TABLE_H__
+//======================================================================================
+// Filename: BindlessTable.h
+// Description: One descriptor set holding large update after bind arrays of sampled
+//				images and storage buffers (VK_EXT_descriptor_indexing). Resources get
+//				a slot that shaders index with a material id (Bindless.glsl), so draws
+//				bind the set once instead of a set per material. Released slots go back
+//				on the free list once the frames that could use them have retired.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Platform.h"
+
+#include <vector>
+
+class Renderer;
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr u32 kBindlessInvalid				= U32_MAX;
+constexpr u32 kBindlessImageBinding			= 0;	// Matches Bindless.glsl
+constexpr u32 kBindlessBufferBinding		= 1;
+
+//======================================================================================
+// Class BindlessTable
+//======================================================================================
+
+// Without descriptor indexing the table stays disabled, allocations return
+// kBindlessInvalid and callers keep binding a set per draw.
+class BindlessTable
+{
+public:
+	// Capacities are clamped to the device's update after bind limits.
+	BindlessTable( Renderer* renderer, u32 frameCount, u32 imageCapacity, u32 bufferCapacity );
+	~BindlessTable();
+
+	bool IsEnabled() const													{ return mDescriptorSet != VK_NULL_HANDLE; }
+
+	// Moves to the next frame, waiting on the graphics timeline if needed, and frees the
+	// slots released the last time this frame was recorded.
+	void BeginFrame();
+	// value is the graphics timeline value of the last submit recorded this frame.
+	void EndFrame( u64 value );
+
+	// Writes the resource into a free slot and returns its index. The resource must
+	// live until the slot is released and retired.
+	u32 AllocateImage( VkImageView imageView, VkImageLayout imageLayout );
+	u32 AllocateBuffer( const VkDescriptorBufferInfo& bufferInfo );
+	// Draws recorded this frame may still read the slot, it is reused once they retire.
+	// Releasing kBindlessInvalid does nothing, like deleting a null pointer.
+	void ReleaseImage( u32 slot );
+	void ReleaseBuffer( u32 slot );
+
+	VkDescriptorSetLayout	GetVulkanDescriptorSetLayout() const			{ return mDescriptorSetLayout; }
+	VkDescriptorSet			GetVulkanDescriptorSet() const					{ return mDescriptorSet; }
+	u32						GetImageCapacity() const						{ return mImages.capacity; }
+	u32						GetBufferCapacity() const						{ return mBuffers.capacity; }
+	u32						GetImageCount() const							{ return mImages.used; }
+	u32						GetBufferCount() const							{ return mBuffers.used; }
+
+private:
+	NONCOPYABLE(BindlessTable);
+
+	struct SlotList
+	{
+		u32					capacity = 0;
+		u32					used = 0;
+		u32					nextUnused = 0;		// Slots past this were never handed out
+		std::vector<u32>	freeSlots;
+	};
+
+	struct FrameReleases
+	{
+		std::vector<u32>	images;
+		std::vector<u32>	buffers;
+		u64					value = 0;
+	};
+
+	static u32 AllocateSlot( SlotList& slots );
+	static void FreeSlots( SlotList& slots, std::vector<u32>& released );
+
+private:
+	Renderer*					mRenderer = nullptr;
+
+	VkDescriptorSetLayout		mDescriptorSetLayout = VK_NULL_HANDLE;
+	VkDescriptorPool			mDescriptorPool = VK_NULL_HANDLE;
+	VkDescriptorSet				mDescriptorSet = VK_NULL_HANDLE;
+
+	SlotList					mImages;
+	SlotList					mBuffers;
+
+	std::vector<FrameReleases>	mFrames;
+	u32							mFrameIndex = 0;
+};
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_BINDLESS_TABLE_H__
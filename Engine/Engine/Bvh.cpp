@@ -0,0 +1,761 @@
+//======================================================================================
+// Filename: Bvh.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Bvh.h"
+
+#include "EngineMath.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+//======================================================================================
+
+namespace
+{
+
+//======================================================================================
+// Bounds Helpers
+//======================================================================================
+
+inline BvhBounds EmptyBounds()
+{
+	BvhBounds bounds;
+	bounds.min = Math::Vector3(F32_MAX, F32_MAX, F32_MAX);
+	bounds.max = Math::Vector3(-F32_MAX, -F32_MAX, -F32_MAX);
+	return bounds;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline void Grow(BvhBounds& bounds, const BvhBounds& other)
+{
+	bounds.min = Math::Vector3(Math::Min(bounds.min.x, other.min.x), Math::Min(bounds.min.y, other.min.y), Math::Min(bounds.min.z, other.min.z));
+	bounds.max = Math::Vector3(Math::Max(bounds.max.x, other.max.x), Math::Max(bounds.max.y, other.max.y), Math::Max(bounds.max.z, other.max.z));
+}
+
+//--------------------------------------------------------------------------------------
+
+inline void Grow(BvhBounds& bounds, const Math::Vector3& point)
+{
+	bounds.min = Math::Vector3(Math::Min(bounds.min.x, point.x), Math::Min(bounds.min.y, point.y), Math::Min(bounds.min.z, point.z));
+	bounds.max = Math::Vector3(Math::Max(bounds.max.x, point.x), Math::Max(bounds.max.y, point.y), Math::Max(bounds.max.z, point.z));
+}
+
+//--------------------------------------------------------------------------------------
+
+// Half the surface area, the SAH only compares ratios
+inline f32 HalfArea(const BvhBounds& bounds)
+{
+	const Math::Vector3 size = bounds.max - bounds.min;
+	if (size.x < 0.0f)
+	{
+		return 0.0f;
+	}
+	return (size.x * size.y) + (size.y * size.z) + (size.z * size.x);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 GetAxis(const Math::Vector3& v, u32 axis)
+{
+	return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+//--------------------------------------------------------------------------------------
+
+// 1 / value, except that 0 and denormals give a huge finite value of the same sign
+// instead of inf. A ray starting on a slab plane then gets 0 * x = 0 rather than
+// 0 * inf = NaN, and behaves like a ray with a tiny component in that direction.
+inline f32 SafeInverse(f32 value)
+{
+	if (Math::Abs(value) < F32_MIN)
+	{
+		return std::signbit(value) ? -F32_MAX : F32_MAX;
+	}
+	return 1.0f / value;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline void SetSlot(BvhNode& node, u32 slot, const BvhBounds& bounds, u32 child, u32 primitiveCount)
+{
+	node.minX[slot] = bounds.min.x;
+	node.minY[slot] = bounds.min.y;
+	node.minZ[slot] = bounds.min.z;
+	node.maxX[slot] = bounds.max.x;
+	node.maxY[slot] = bounds.max.y;
+	node.maxZ[slot] = bounds.max.z;
+	node.child[slot] = child;
+	node.primitiveCount[slot] = primitiveCount;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline BvhBounds GetNodeBounds(const BvhNode& node)
+{
+	BvhBounds bounds = EmptyBounds();
+	for (u32 slot = 0; slot < kBvhWidth; ++slot)
+	{
+		if (node.child[slot] != kBvhInvalid)
+		{
+			BvhBounds slotBounds;
+			slotBounds.min = Math::Vector3(node.minX[slot], node.minY[slot], node.minZ[slot]);
+			slotBounds.max = Math::Vector3(node.maxX[slot], node.maxY[slot], node.maxZ[slot]);
+			Grow(bounds, slotBounds);
+		}
+	}
+	return bounds;
+}
+
+//======================================================================================
+// Traversal Helpers
+//======================================================================================
+
+// Sets bit i of visibleMask when slot i touches the frustum and of insideMask when it
+// is entirely inside, so its subtree needs no more plane tests
+inline void TestFrustum(const BvhNode& node, const Math::Frustum& frustum, u32& visibleMask, u32& insideMask)
+{
+#if MATH_SIMD_SSE4
+	const __m128 minX = _mm_load_ps(node.minX);
+	const __m128 minY = _mm_load_ps(node.minY);
+	const __m128 minZ = _mm_load_ps(node.minZ);
+	const __m128 maxX = _mm_load_ps(node.maxX);
+	const __m128 maxY = _mm_load_ps(node.maxY);
+	const __m128 maxZ = _mm_load_ps(node.maxZ);
+	const __m128 zero = _mm_setzero_ps();
+
+	__m128 visible = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(node.child)), _mm_set1_epi32(-1)));
+	visible = _mm_xor_ps(visible, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+	__m128 inside = visible;
+	for (const Math::Vector4& plane : frustum.planes)
+	{
+		const __m128 nx = _mm_set1_ps(plane.x);
+		const __m128 ny = _mm_set1_ps(plane.y);
+		const __m128 nz = _mm_set1_ps(plane.z);
+		const __m128 d = _mm_set1_ps(plane.w);
+
+		//Corner furthest along the normal decides visible, the nearest decides inside
+		const bool px = plane.x > 0.0f;
+		const bool py = plane.y > 0.0f;
+		const bool pz = plane.z > 0.0f;
+		__m128 farDistance = Math::SIMD::MulAdd(nz, pz ? maxZ : minZ, d);
+		farDistance = Math::SIMD::MulAdd(ny, py ? maxY : minY, farDistance);
+		farDistance = Math::SIMD::MulAdd(nx, px ? maxX : minX, farDistance);
+		__m128 nearDistance = Math::SIMD::MulAdd(nz, pz ? minZ : maxZ, d);
+		nearDistance = Math::SIMD::MulAdd(ny, py ? minY : maxY, nearDistance);
+		nearDistance = Math::SIMD::MulAdd(nx, px ? minX : maxX, nearDistance);
+
+		visible = _mm_and_ps(visible, _mm_cmpge_ps(farDistance, zero));
+		inside = _mm_and_ps(inside, _mm_cmpge_ps(nearDistance, zero));
+	}
+	visibleMask = static_cast<u32>(_mm_movemask_ps(visible));
+	insideMask = static_cast<u32>(_mm_movemask_ps(inside)) & visibleMask;
+#else
+	visibleMask = 0;
+	insideMask = 0;
+	for (u32 slot = 0; slot < kBvhWidth; ++slot)
+	{
+		if (node.child[slot] == kBvhInvalid)
+		{
+			continue;
+		}
+
+		const Math::Vector3 min(node.minX[slot], node.minY[slot], node.minZ[slot]);
+		const Math::Vector3 max(node.maxX[slot], node.maxY[slot], node.maxZ[slot]);
+		if (frustum.TestAABB(min, max))
+		{
+			visibleMask |= 1u << slot;
+
+			//Every corner inside means the nearest corner to each plane is inside
+			bool isInside = true;
+			for (const Math::Vector4& plane : frustum.planes)
+			{
+				const Math::Vector3 corner
+				(
+					(plane.x > 0.0f) ? min.x : max.x,
+					(plane.y > 0.0f) ? min.y : max.y,
+					(plane.z > 0.0f) ? min.z : max.z
+				);
+				isInside &= Math::Dot(plane.ToVector3(), corner) + plane.w >= 0.0f;
+			}
+			insideMask |= (isInside ? 1u : 0u) << slot;
+		}
+	}
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+struct RayData
+{
+	Math::Vector3	origin;
+	Math::Vector3	invDirection;
+};
+
+//--------------------------------------------------------------------------------------
+
+// Slab test of the ray against all 4 slots. Returns a bit per slot hit before tMax and
+// writes the entry distances to tEnter.
+inline u32 TestRay(const BvhNode& node, const RayData& ray, f32 tMax, f32* tEnter)
+{
+#if MATH_SIMD_SSE4
+	const __m128 ox = _mm_set1_ps(ray.origin.x);
+	const __m128 oy = _mm_set1_ps(ray.origin.y);
+	const __m128 oz = _mm_set1_ps(ray.origin.z);
+	const __m128 ix = _mm_set1_ps(ray.invDirection.x);
+	const __m128 iy = _mm_set1_ps(ray.invDirection.y);
+	const __m128 iz = _mm_set1_ps(ray.invDirection.z);
+
+	const __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minX), ox), ix);
+	const __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxX), ox), ix);
+	const __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minY), oy), iy);
+	const __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxY), oy), iy);
+	const __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minZ), oz), iz);
+	const __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxZ), oz), iz);
+
+	__m128 enter = _mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y));
+	enter = _mm_max_ps(enter, _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+	__m128 exit = _mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y));
+	exit = _mm_min_ps(exit, _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_set1_ps(tMax)));
+
+	const __m128 invalid = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(node.child)), _mm_set1_epi32(-1)));
+	_mm_storeu_ps(tEnter, enter);
+	return static_cast<u32>(_mm_movemask_ps(_mm_andnot_ps(invalid, _mm_cmple_ps(enter, exit))));
+#else
+	u32 mask = 0;
+	for (u32 slot = 0; slot < kBvhWidth; ++slot)
+	{
+		const f32 t0x = (node.minX[slot] - ray.origin.x) * ray.invDirection.x;
+		const f32 t1x = (node.maxX[slot] - ray.origin.x) * ray.invDirection.x;
+		const f32 t0y = (node.minY[slot] - ray.origin.y) * ray.invDirection.y;
+		const f32 t1y = (node.maxY[slot] - ray.origin.y) * ray.invDirection.y;
+		const f32 t0z = (node.minZ[slot] - ray.origin.z) * ray.invDirection.z;
+		const f32 t1z = (node.maxZ[slot] - ray.origin.z) * ray.invDirection.z;
+
+		const f32 enter = Math::Max(Math::Max(Math::Min(t0x, t1x), Math::Min(t0y, t1y)), Math::Max(Math::Min(t0z, t1z), 0.0f));
+		const f32 exit = Math::Min(Math::Min(Math::Max(t0x, t1x), Math::Max(t0y, t1y)), Math::Min(Math::Max(t0z, t1z), tMax));
+		tEnter[slot] = enter;
+		if (node.child[slot] != kBvhInvalid && enter <= exit)
+		{
+			mask |= 1u << slot;
+		}
+	}
+	return mask;
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline bool TestRay(const BvhBounds& bounds, const RayData& ray, f32 tMax, f32& tEnter)
+{
+	const f32 t0x = (bounds.min.x - ray.origin.x) * ray.invDirection.x;
+	const f32 t1x = (bounds.max.x - ray.origin.x) * ray.invDirection.x;
+	const f32 t0y = (bounds.min.y - ray.origin.y) * ray.invDirection.y;
+	const f32 t1y = (bounds.max.y - ray.origin.y) * ray.invDirection.y;
+	const f32 t0z = (bounds.min.z - ray.origin.z) * ray.invDirection.z;
+	const f32 t1z = (bounds.max.z - ray.origin.z) * ray.invDirection.z;
+
+	tEnter = Math::Max(Math::Max(Math::Min(t0x, t1x), Math::Min(t0y, t1y)), Math::Max(Math::Min(t0z, t1z), 0.0f));
+	const f32 exit = Math::Min(Math::Min(Math::Max(t0x, t1x), Math::Max(t0y, t1y)), Math::Min(Math::Max(t0z, t1z), tMax));
+	return tEnter <= exit;
+}
+
+} // namespace
+
+//======================================================================================
+// Class Bvh
+//======================================================================================
+
+Bvh::Bvh()
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+Bvh::~Bvh()
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+void Bvh::Build(Span<const BvhBounds> bounds)
+{
+	ASSERT(bounds.size < (1u << 31), "[Bvh] Too many primitives!");
+	Clear();
+	if (bounds.size == 0)
+	{
+		return;
+	}
+
+	const u32 count = static_cast<u32>(bounds.size);
+	std::vector<Math::Vector3> centroids(count);
+	mPrimitiveIndices.resize(count);
+	mPrimitiveOrder.resize(count);
+	mPrimitiveLeaf.resize(count);
+	for (u32 i = 0; i < count; ++i)
+	{
+		centroids[i] = (bounds.data[i].min + bounds.data[i].max) * 0.5f;
+		mPrimitiveIndices[i] = i;
+	}
+
+	//A 4 wide tree has roughly a third as many nodes as primitives
+	mNodes.reserve((count / 2) + 1);
+	mNodeParents.reserve((count / 2) + 1);
+	BuildNode(MakeRange(0, count, bounds), kBvhInvalid, 0, bounds, centroids);
+
+	mLeafBounds.resize(count);
+	for (u32 i = 0; i < count; ++i)
+	{
+		mPrimitiveOrder[mPrimitiveIndices[i]] = i;
+		mLeafBounds[i] = bounds.data[mPrimitiveIndices[i]];
+	}
+	mRefitMarks.assign(mNodes.size(), 0);
+}
+
+//--------------------------------------------------------------------------------------
+
+void Bvh::Clear()
+{
+	mNodes.clear();
+	mNodeParents.clear();
+	mPrimitiveIndices.clear();
+	mPrimitiveOrder.clear();
+	mPrimitiveLeaf.clear();
+	mLeafBounds.clear();
+	mRefitNodes.clear();
+	mRefitMarks.clear();
+}
+
+//--------------------------------------------------------------------------------------
+
+void Bvh::Refit(Span<const BvhBounds> bounds)
+{
+	ASSERT(bounds.size == mPrimitiveIndices.size(), "[Bvh] Refit with a different primitive count, rebuild instead!");
+
+	for (size_t i = 0; i < mLeafBounds.size(); ++i)
+	{
+		mLeafBounds[i] = bounds.data[mPrimitiveIndices[i]];
+	}
+
+	//Children always come after their parent
+	for (size_t i = mNodes.size(); i > 0; --i)
+	{
+		RefitNode(static_cast<u32>(i - 1));
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void Bvh::Refit(Span<const BvhBounds> bounds, Span<const u32> changedPrimitives)
+{
+	ASSERT(bounds.size == mPrimitiveIndices.size(), "[Bvh] Refit with a different primitive count, rebuild instead!");
+
+	mRefitNodes.clear();
+	for (size_t i = 0; i < changedPrimitives.size; ++i)
+	{
+		const u32 primitive = changedPrimitives.data[i];
+		mLeafBounds[mPrimitiveOrder[primitive]] = bounds.data[primitive];
+
+		//Stop at the first marked node, everything above it is already queued
+		for (u32 node = mPrimitiveLeaf[primitive]; node != kBvhInvalid && mRefitMarks[node] == 0; node = mNodeParents[node])
+		{
+			mRefitMarks[node] = 1;
+			mRefitNodes.push_back(node);
+		}
+	}
+
+	std::sort(mRefitNodes.begin(), mRefitNodes.end(), [](u32 a, u32 b) { return a > b; });
+	for (u32 node : mRefitNodes)
+	{
+		RefitNode(node);
+		mRefitMarks[node] = 0;
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+size_t Bvh::QueryFrustum(const Math::Frustum& frustum, Span<u32> visible) const
+{
+	ASSERT(visible.size >= mPrimitiveIndices.size(), "[Bvh] Visible span is smaller than the primitive count!");
+	if (mNodes.empty())
+	{
+		return 0;
+	}
+
+	//The top bit of a stack entry marks subtrees already known to be fully inside
+	const u32 kInsideBit = 1u << 31;
+	u32 stack[kBvhMaxStackSize];
+	u32 stackSize = 0;
+	stack[stackSize++] = 0;
+
+	size_t visibleCount = 0;
+	while (stackSize > 0)
+	{
+		const u32 entry = stack[--stackSize];
+		const BvhNode& node = mNodes[entry & ~kInsideBit];
+
+		u32 visibleMask;
+		u32 insideMask;
+		if (entry & kInsideBit)
+		{
+			visibleMask = 0;
+			for (u32 slot = 0; slot < kBvhWidth; ++slot)
+			{
+				visibleMask |= (node.child[slot] != kBvhInvalid ? 1u : 0u) << slot;
+			}
+			insideMask = visibleMask;
+		}
+		else
+		{
+			TestFrustum(node, frustum, visibleMask, insideMask);
+		}
+
+		for (u32 slot = 0; slot < kBvhWidth; ++slot)
+		{
+			if ((visibleMask & (1u << slot)) == 0)
+			{
+				continue;
+			}
+
+			const bool isInside = (insideMask & (1u << slot)) != 0;
+			const u32 child = node.child[slot];
+			const u32 primitiveCount = node.primitiveCount[slot];
+			if (primitiveCount == 0)
+			{
+				ASSERT(stackSize < kBvhMaxStackSize, "[Bvh] Traversal stack overflow!");
+				stack[stackSize++] = child | (isInside ? kInsideBit : 0);
+				continue;
+			}
+
+			for (u32 i = child; i < child + primitiveCount; ++i)
+			{
+				const BvhBounds& bounds = mLeafBounds[i];
+				if (isInside || frustum.TestAABB(bounds.min, bounds.max))
+				{
+					visible.data[visibleCount++] = mPrimitiveIndices[i];
+				}
+			}
+		}
+	}
+	return visibleCount;
+}
+
+//--------------------------------------------------------------------------------------
+
+void Bvh::RayCast(Span<const BvhRay> rays, Span<BvhHit> hits) const
+{
+	ASSERT(hits.size >= rays.size, "[Bvh] Hit span is smaller than the ray count!");
+	for (size_t i = 0; i < rays.size; ++i)
+	{
+		hits.data[i] = RayCastOne(rays.data[i]);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void Bvh::RayCast(JobSystem& jobSystem, Span<const BvhRay> rays, Span<BvhHit> hits) const
+{
+	ASSERT(hits.size >= rays.size, "[Bvh] Hit span is smaller than the ray count!");
+	jobSystem.ParallelFor(rays.size, kBvhRayGrainSize, [this, rays, hits](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			hits.data[i] = RayCastOne(rays.data[i]);
+		}
+	});
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 Bvh::BuildNode(const BuildRange& range, u32 parent, u32 depth, Span<const BvhBounds> bounds, const std::vector<Math::Vector3>& centroids)
+{
+	const u32 nodeIndex = static_cast<u32>(mNodes.size());
+	mNodes.emplace_back();
+	mNodeParents.push_back(parent);
+
+	//Keep splitting the child with the largest area until there are 4 or all of them
+	//are small enough to be leaves
+	BuildRange children[kBvhWidth];
+	u32 childCount = 1;
+	children[0] = range;
+	while (childCount < kBvhWidth)
+	{
+		u32 best = kBvhInvalid;
+		f32 bestArea = -1.0f;
+		for (u32 c = 0; c < childCount; ++c)
+		{
+			const f32 area = HalfArea(children[c].bounds);
+			if (children[c].end - children[c].begin > kBvhMaxLeafSize && area > bestArea)
+			{
+				best = c;
+				bestArea = area;
+			}
+		}
+		if (best == kBvhInvalid)
+		{
+			break;
+		}
+
+		BuildRange left;
+		BuildRange right;
+		SplitRange(children[best], bounds, centroids, left, right);
+		children[best] = left;
+		children[childCount++] = right;
+	}
+
+	//Children are built after the slots are known, mNodes may grow while recursing
+	for (u32 slot = 0; slot < kBvhWidth; ++slot)
+	{
+		if (slot >= childCount)
+		{
+			SetSlot(mNodes[nodeIndex], slot, EmptyBounds(), kBvhInvalid, 0);
+			continue;
+		}
+
+		const BuildRange& child = children[slot];
+		const u32 primitiveCount = child.end - child.begin;
+		if (primitiveCount <= kBvhMaxLeafSize || depth + 1 >= kBvhMaxDepth)
+		{
+			for (u32 i = child.begin; i < child.end; ++i)
+			{
+				mPrimitiveLeaf[mPrimitiveIndices[i]] = nodeIndex;
+			}
+			SetSlot(mNodes[nodeIndex], slot, child.bounds, child.begin, primitiveCount);
+		}
+		else
+		{
+			const u32 childNode = BuildNode(child, nodeIndex, depth + 1, bounds, centroids);
+			SetSlot(mNodes[nodeIndex], slot, child.bounds, childNode, 0);
+		}
+	}
+	return nodeIndex;
+}
+
+//--------------------------------------------------------------------------------------
+
+void Bvh::SplitRange(const BuildRange& range, Span<const BvhBounds> bounds, const std::vector<Math::Vector3>& centroids, BuildRange& left, BuildRange& right)
+{
+	struct Bin
+	{
+		BvhBounds	bounds;
+		u32			count;
+	};
+
+	BvhBounds centroidBounds = EmptyBounds();
+	for (u32 i = range.begin; i < range.end; ++i)
+	{
+		Grow(centroidBounds, centroids[mPrimitiveIndices[i]]);
+	}
+
+	//Binned SAH, Wald "On fast Construction of SAH-based Bounding Volume Hierarchies"
+	u32 bestAxis = kBvhInvalid;
+	u32 bestBin = 0;
+	f32 bestCost = F32_MAX;
+	for (u32 axis = 0; axis < 3; ++axis)
+	{
+		const f32 axisMin = GetAxis(centroidBounds.min, axis);
+		const f32 extent = GetAxis(centroidBounds.max, axis) - axisMin;
+		if (extent <= 0.0f)
+		{
+			continue;
+		}
+
+		Bin bins[kBvhSahBins];
+		for (Bin& bin : bins)
+		{
+			bin.bounds = EmptyBounds();
+			bin.count = 0;
+		}
+
+		const f32 scale = kBvhSahBins * 0.9999f / extent;
+		for (u32 i = range.begin; i < range.end; ++i)
+		{
+			const u32 primitive = mPrimitiveIndices[i];
+			Bin& bin = bins[static_cast<u32>((GetAxis(centroids[primitive], axis) - axisMin) * scale)];
+			Grow(bin.bounds, bounds.data[primitive]);
+			++bin.count;
+		}
+
+		//Sweep from the right for the right side areas, then from the left for the cost
+		f32 rightCost[kBvhSahBins];
+		BvhBounds rightBounds = EmptyBounds();
+		u32 rightCount = 0;
+		for (u32 b = kBvhSahBins - 1; b > 0; --b)
+		{
+			Grow(rightBounds, bins[b].bounds);
+			rightCount += bins[b].count;
+			rightCost[b] = HalfArea(rightBounds) * rightCount;
+		}
+
+		BvhBounds leftBounds = EmptyBounds();
+		u32 leftCount = 0;
+		for (u32 b = 0; b < kBvhSahBins - 1; ++b)
+		{
+			Grow(leftBounds, bins[b].bounds);
+			leftCount += bins[b].count;
+			const f32 cost = (HalfArea(leftBounds) * leftCount) + rightCost[b + 1];
+			if (leftCount > 0 && leftCount < range.end - range.begin && cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = b;
+			}
+		}
+	}
+
+	u32 middle = range.begin + ((range.end - range.begin) / 2);
+	u32* first = mPrimitiveIndices.data() + range.begin;
+	u32* last = mPrimitiveIndices.data() + range.end;
+	if (bestAxis != kBvhInvalid)
+	{
+		const f32 axisMin = GetAxis(centroidBounds.min, bestAxis);
+		const f32 scale = kBvhSahBins * 0.9999f / (GetAxis(centroidBounds.max, bestAxis) - axisMin);
+		u32* split = std::partition(first, last, [&](u32 primitive)
+		{
+			return static_cast<u32>((GetAxis(centroids[primitive], bestAxis) - axisMin) * scale) <= bestBin;
+		});
+		middle = static_cast<u32>(split - mPrimitiveIndices.data());
+	}
+	//else every centroid is the same point, any even split is as good as another
+
+	left = MakeRange(range.begin, middle, bounds);
+	right = MakeRange(middle, range.end, bounds);
+}
+
+//--------------------------------------------------------------------------------------
+
+Bvh::BuildRange Bvh::MakeRange(u32 begin, u32 end, Span<const BvhBounds> bounds) const
+{
+	BuildRange range;
+	range.begin = begin;
+	range.end = end;
+	range.bounds = EmptyBounds();
+	for (u32 i = begin; i < end; ++i)
+	{
+		Grow(range.bounds, bounds.data[mPrimitiveIndices[i]]);
+	}
+	return range;
+}
+
+//--------------------------------------------------------------------------------------
+
+void Bvh::RefitNode(u32 nodeIndex)
+{
+	BvhNode& node = mNodes[nodeIndex];
+	for (u32 slot = 0; slot < kBvhWidth; ++slot)
+	{
+		const u32 child = node.child[slot];
+		if (child == kBvhInvalid)
+		{
+			continue;
+		}
+
+		const u32 primitiveCount = node.primitiveCount[slot];
+		BvhBounds bounds = EmptyBounds();
+		if (primitiveCount > 0)
+		{
+			for (u32 i = child; i < child + primitiveCount; ++i)
+			{
+				Grow(bounds, mLeafBounds[i]);
+			}
+		}
+		else
+		{
+			bounds = GetNodeBounds(mNodes[child]);
+		}
+		SetSlot(node, slot, bounds, child, primitiveCount);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+BvhHit Bvh::RayCastOne(const BvhRay& ray) const
+{
+	BvhHit hit;
+	hit.t = ray.tMax;
+	if (mNodes.empty())
+	{
+		return hit;
+	}
+
+	RayData rayData;
+	rayData.origin = ray.origin;
+	rayData.invDirection = Math::Vector3(SafeInverse(ray.direction.x), SafeInverse(ray.direction.y), SafeInverse(ray.direction.z));
+
+	struct StackEntry
+	{
+		u32 node;
+		f32 tEnter;
+	};
+	StackEntry stack[kBvhMaxStackSize];
+	u32 stackSize = 0;
+	stack[stackSize++] = { 0, 0.0f };
+
+	while (stackSize > 0)
+	{
+		const StackEntry entry = stack[--stackSize];
+		if (entry.tEnter > hit.t)
+		{
+			continue;
+		}
+
+		const BvhNode& node = mNodes[entry.node];
+		f32 tEnter[kBvhWidth];
+		const u32 hitMask = TestRay(node, rayData, hit.t, tEnter);
+
+		//Leaves are resolved straight away to shrink hit.t, inner nodes are pushed far
+		//to near so the nearest is popped first
+		u32 order[kBvhWidth];
+		u32 orderCount = 0;
+		for (u32 slot = 0; slot < kBvhWidth; ++slot)
+		{
+			if ((hitMask & (1u << slot)) == 0)
+			{
+				continue;
+			}
+
+			const u32 child = node.child[slot];
+			const u32 primitiveCount = node.primitiveCount[slot];
+			if (primitiveCount == 0)
+			{
+				u32 i = orderCount++;
+				for (; i > 0 && tEnter[order[i - 1]] < tEnter[slot]; --i)
+				{
+					order[i] = order[i - 1];
+				}
+				order[i] = slot;
+				continue;
+			}
+
+			for (u32 i = child; i < child + primitiveCount; ++i)
+			{
+				f32 t;
+				if (TestRay(mLeafBounds[i], rayData, hit.t, t) && t < hit.t)
+				{
+					hit.t = t;
+					hit.primitive = mPrimitiveIndices[i];
+				}
+			}
+		}
+
+		for (u32 i = 0; i < orderCount; ++i)
+		{
+			ASSERT(stackSize < kBvhMaxStackSize, "[Bvh] Traversal stack overflow!");
+			stack[stackSize++] = { node.child[order[i]], tEnter[order[i]] };
+		}
+	}
+
+	if (hit.primitive == kBvhInvalid)
+	{
+		hit.t = F32_MAX;
+	}
+	return hit;
+}
+
+//======================================================================================
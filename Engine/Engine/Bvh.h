@@ -0,0 +1,146 @@
+#ifndef ENGINE_BVH_H__
+#define ENGINE_BVH_H__
+//======================================================================================
+// Filename: Bvh.h
+// Description: Bounding volume hierarchy over static or slowly moving objects. Built
+//				top down with binned SAH into 4 wide nodes stored in one flat array,
+//				parents before children, so traversal tests 4 boxes per SIMD step.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Span.h"
+#include "Vector3.h"
+
+#include <cfloat>
+#include <vector>
+
+class JobSystem;
+
+namespace Math
+{
+struct Frustum;
+}
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr u32 kBvhInvalid					= U32_MAX;
+constexpr u32 kBvhWidth						= 4;
+constexpr u32 kBvhMaxLeafSize				= 4;
+constexpr u32 kBvhSahBins					= 16;
+constexpr u32 kBvhMaxStackSize				= 256;
+// Every traversal step pops one node and pushes at most kBvhWidth, ranges that would
+// go deeper than this become oversized leaves so the fixed stacks can't overflow
+constexpr u32 kBvhMaxDepth					= (kBvhMaxStackSize - 1) / (kBvhWidth - 1);
+constexpr size_t kBvhRayGrainSize			= 256;
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+struct BvhBounds
+{
+	Math::Vector3	min;
+	Math::Vector3	max;
+};
+
+//--------------------------------------------------------------------------------------
+
+struct BvhRay
+{
+	Math::Vector3	origin;
+	Math::Vector3	direction;
+	f32				tMax = F32_MAX;
+};
+
+//--------------------------------------------------------------------------------------
+
+// Nearest primitive whose bounds the ray enters, t is the entry distance along the
+// ray direction. primitive is kBvhInvalid on a miss.
+struct BvhHit
+{
+	u32				primitive = kBvhInvalid;
+	f32				t = F32_MAX;
+};
+
+//--------------------------------------------------------------------------------------
+
+// Child bounds are stored per axis so one load covers all 4 children. A child is
+// either another node or a leaf of primitiveCount primitives starting at first.
+struct alignas(64) BvhNode
+{
+	f32		minX[kBvhWidth];
+	f32		minY[kBvhWidth];
+	f32		minZ[kBvhWidth];
+	f32		maxX[kBvhWidth];
+	f32		maxY[kBvhWidth];
+	f32		maxZ[kBvhWidth];
+	u32		child[kBvhWidth];			// Node index, first leaf primitive or kBvhInvalid
+	u32		primitiveCount[kBvhWidth];	// 0 for interior children
+};
+
+//======================================================================================
+// Class Bvh
+//======================================================================================
+
+class Bvh
+{
+public:
+	Bvh();
+	~Bvh();
+
+	void Build( Span<const BvhBounds> bounds );
+	void Clear();
+
+	// Recomputes every node from the new bounds, keeping the topology. Quality drops as
+	// objects move away from where they were built, rebuild when queries get slow.
+	void Refit( Span<const BvhBounds> bounds );
+	// Only walks the nodes above the changed primitives.
+	void Refit( Span<const BvhBounds> bounds, Span<const u32> changedPrimitives );
+
+	// Writes the indices of every primitive whose bounds touch the frustum, in no
+	// particular order. visible.size must be at least GetPrimitiveCount().
+	size_t QueryFrustum( const Math::Frustum& frustum, Span<u32> visible ) const;
+
+	// hits.size must be at least rays.size
+	void RayCast( Span<const BvhRay> rays, Span<BvhHit> hits ) const;
+	void RayCast( JobSystem& jobSystem, Span<const BvhRay> rays, Span<BvhHit> hits ) const;
+
+	u32 GetPrimitiveCount() const											{ return static_cast<u32>(mPrimitiveIndices.size()); }
+	u32 GetNodeCount() const												{ return static_cast<u32>(mNodes.size()); }
+
+private:
+	NONCOPYABLE(Bvh);
+
+	struct BuildRange
+	{
+		u32			begin;
+		u32			end;
+		BvhBounds	bounds;
+	};
+
+	u32 BuildNode( const BuildRange& range, u32 parent, u32 depth, Span<const BvhBounds> bounds, const std::vector<Math::Vector3>& centroids );
+	void SplitRange( const BuildRange& range, Span<const BvhBounds> bounds, const std::vector<Math::Vector3>& centroids, BuildRange& left, BuildRange& right );
+	BuildRange MakeRange( u32 begin, u32 end, Span<const BvhBounds> bounds ) const;
+
+	void RefitNode( u32 nodeIndex );
+	BvhHit RayCastOne( const BvhRay& ray ) const;
+
+private:
+	std::vector<BvhNode>	mNodes;
+	std::vector<u32>		mNodeParents;
+	std::vector<u32>		mPrimitiveIndices;	// Leaf order to primitive index
+	std::vector<u32>		mPrimitiveOrder;	// Primitive index to leaf order
+	std::vector<u32>		mPrimitiveLeaf;		// Primitive index to the node holding it
+	std::vector<BvhBounds>	mLeafBounds;		// Primitive bounds in leaf order
+
+	std::vector<u32>		mRefitNodes;
+	std::vector<u8>			mRefitMarks;
+};
+
+//======================================================================================
+#endif // !ENGINE_BVH_H__
@@ -54,11 +54,9 @@ typedef double				f64;
 	{\
 		{\
 			char buffer[1024];\
-			sprintf_s(buffer, 1024, (#format), __VA_ARGS__);\
-			std::string message;\
-			message += (buffer);\
-			message += "\n";\
-			OutputDebugStringA(message.c_str());\
+			sprintf_s(buffer, 1024 - 1, (#format), ##__VA_ARGS__);\
+			strcat_s(buffer, 1024, "\n");\
+			OutputDebugStringA(buffer);\
 		}\
 	}
 #else
@@ -72,7 +70,7 @@ typedef double				f64;
 	{\
 		if (!(condition))\
 		{\
-			LOG(format, __VA_ARGS__)\
+			LOG(format, ##__VA_ARGS__)\
 			DebugBreak();\
 		}\
 	}
@@ -80,7 +78,7 @@ typedef double				f64;
 	{\
 		if (!(condition))\
 		{\
-			LOG(format, __VA_ARGS__)\
+			LOG(format, ##__VA_ARGS__)\
 			DebugBreak();\
 		}\
 	}
@@ -0,0 +1,308 @@
+//======================================================================================
+// Filename: Culling.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Culling.h"
+
+#include "EngineMath.h"
+#include "JobSystem.h"
+
+#include <cstring>
+//======================================================================================
+
+namespace
+{
+
+//======================================================================================
+// Register Types
+//======================================================================================
+#if MATH_SIMD_AVX2
+
+typedef __m256 Lanes;
+constexpr size_t kLaneCount = 8;
+
+inline Lanes AllSet()								{ return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+inline Lanes Splat(f32 s)							{ return _mm256_set1_ps(s); }
+inline Lanes Load(const f32* p)						{ return _mm256_loadu_ps(p); }
+inline Lanes Negate(Lanes a)						{ return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+inline Lanes MulAdd(Lanes a, Lanes b, Lanes c)		{ return _mm256_fmadd_ps(a, b, c); }
+inline Lanes GreaterEqual(Lanes a, Lanes b)			{ return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+inline Lanes And(Lanes a, Lanes b)					{ return _mm256_and_ps(a, b); }
+inline u32 MoveMask(Lanes a)						{ return static_cast<u32>(_mm256_movemask_ps(a)); }
+
+#elif MATH_SIMD_SSE4
+
+typedef __m128 Lanes;
+constexpr size_t kLaneCount = 4;
+
+inline Lanes AllSet()								{ return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+inline Lanes Splat(f32 s)							{ return _mm_set1_ps(s); }
+inline Lanes Load(const f32* p)						{ return _mm_loadu_ps(p); }
+inline Lanes Negate(Lanes a)						{ return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+inline Lanes MulAdd(Lanes a, Lanes b, Lanes c)		{ return Math::SIMD::MulAdd(a, b, c); }
+inline Lanes GreaterEqual(Lanes a, Lanes b)			{ return _mm_cmpge_ps(a, b); }
+inline Lanes And(Lanes a, Lanes b)					{ return _mm_and_ps(a, b); }
+inline u32 MoveMask(Lanes a)						{ return static_cast<u32>(_mm_movemask_ps(a)); }
+
+#endif //MATH_SIMD_AVX2
+
+//--------------------------------------------------------------------------------------
+
+#if MATH_SIMD_SSE4
+// Frustum planes with each component splatted across a register
+struct FrustumLanes
+{
+	Lanes nx[Math::Frustum::kPlaneCount];
+	Lanes ny[Math::Frustum::kPlaneCount];
+	Lanes nz[Math::Frustum::kPlaneCount];
+	Lanes d[Math::Frustum::kPlaneCount];
+
+	explicit FrustumLanes(const Math::Frustum& frustum)
+	{
+		for (int p = 0; p < Math::Frustum::kPlaneCount; ++p)
+		{
+			nx[p] = Splat(frustum.planes[p].x);
+			ny[p] = Splat(frustum.planes[p].y);
+			nz[p] = Splat(frustum.planes[p].z);
+			d[p] = Splat(frustum.planes[p].w);
+		}
+	}
+
+	Lanes Distance(int p, Lanes x, Lanes y, Lanes z) const
+	{
+		return MulAdd(nx[p], x, MulAdd(ny[p], y, MulAdd(nz[p], z, d[p])));
+	}
+};
+#endif //MATH_SIMD_SSE4
+
+//======================================================================================
+// Testers
+//======================================================================================
+
+// Test8 returns a bit per volume in [i, i + 8), set when the volume is visible
+
+struct SphereTester
+{
+	const Math::Frustum& frustum;
+	const SphereSoA& spheres;
+#if MATH_SIMD_SSE4
+	FrustumLanes lanes;
+#endif //MATH_SIMD_SSE4
+
+	SphereTester(const Math::Frustum& frustum, const SphereSoA& spheres)
+		: frustum( frustum )
+		, spheres( spheres )
+#if MATH_SIMD_SSE4
+		, lanes( frustum )
+#endif //MATH_SIMD_SSE4
+	{
+	}
+
+	size_t GetCount() const
+	{
+		return spheres.count;
+	}
+
+	bool Test(size_t i) const
+	{
+		return frustum.TestSphere(Math::Vector3(spheres.x[i], spheres.y[i], spheres.z[i]), spheres.radius[i]);
+	}
+
+#if MATH_SIMD_SSE4
+	u32 Test8(size_t i) const
+	{
+		u32 mask = 0;
+		for (size_t lane = 0; lane < 8; lane += kLaneCount)
+		{
+			const Lanes x = Load(spheres.x + i + lane);
+			const Lanes y = Load(spheres.y + i + lane);
+			const Lanes z = Load(spheres.z + i + lane);
+			const Lanes negRadius = Negate(Load(spheres.radius + i + lane));
+
+			Lanes inside = AllSet();
+			for (int p = 0; p < Math::Frustum::kPlaneCount; ++p)
+			{
+				inside = And(inside, GreaterEqual(lanes.Distance(p, x, y, z), negRadius));
+			}
+			mask |= MoveMask(inside) << lane;
+		}
+		return mask;
+	}
+#endif //MATH_SIMD_SSE4
+};
+
+//--------------------------------------------------------------------------------------
+
+struct AABBTester
+{
+	const Math::Frustum& frustum;
+	const AABBSoA& boxes;
+#if MATH_SIMD_SSE4
+	FrustumLanes lanes;
+#endif //MATH_SIMD_SSE4
+
+	AABBTester(const Math::Frustum& frustum, const AABBSoA& boxes)
+		: frustum( frustum )
+		, boxes( boxes )
+#if MATH_SIMD_SSE4
+		, lanes( frustum )
+#endif //MATH_SIMD_SSE4
+	{
+	}
+
+	size_t GetCount() const
+	{
+		return boxes.count;
+	}
+
+	bool Test(size_t i) const
+	{
+		return frustum.TestAABB(Math::Vector3(boxes.minX[i], boxes.minY[i], boxes.minZ[i]),
+								Math::Vector3(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]));
+	}
+
+#if MATH_SIMD_SSE4
+	u32 Test8(size_t i) const
+	{
+		u32 mask = 0;
+		for (size_t lane = 0; lane < 8; lane += kLaneCount)
+		{
+			const Lanes minX = Load(boxes.minX + i + lane);
+			const Lanes minY = Load(boxes.minY + i + lane);
+			const Lanes minZ = Load(boxes.minZ + i + lane);
+			const Lanes maxX = Load(boxes.maxX + i + lane);
+			const Lanes maxY = Load(boxes.maxY + i + lane);
+			const Lanes maxZ = Load(boxes.maxZ + i + lane);
+			const Lanes zero = Splat(0.0f);
+
+			//The plane is the same for every lane, so picking the corner furthest along
+			//its normal is a per plane branch rather than a per lane blend
+			Lanes inside = AllSet();
+			for (int p = 0; p < Math::Frustum::kPlaneCount; ++p)
+			{
+				const Math::Vector4& plane = frustum.planes[p];
+				const Lanes x = (plane.x > 0.0f) ? maxX : minX;
+				const Lanes y = (plane.y > 0.0f) ? maxY : minY;
+				const Lanes z = (plane.z > 0.0f) ? maxZ : minZ;
+				inside = And(inside, GreaterEqual(lanes.Distance(p, x, y, z), zero));
+			}
+			mask |= MoveMask(inside) << lane;
+		}
+		return mask;
+	}
+#endif //MATH_SIMD_SSE4
+};
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+// Culls [begin, end) writing the visible indices to out, returns how many were written
+template <typename Tester>
+size_t CullRange(const Tester& tester, size_t begin, size_t end, u32* out)
+{
+	size_t visibleCount = 0;
+	size_t i = begin;
+#if MATH_SIMD_SSE4
+	for (; i + 8 <= end; i += 8)
+	{
+		//Branch free compaction, every index is written and only the visible ones are
+		//kept. The write position never passes i, so this stays inside out.
+		const u32 mask = tester.Test8(i);
+		for (u32 lane = 0; lane < 8; ++lane)
+		{
+			out[visibleCount] = static_cast<u32>(i + lane);
+			visibleCount += (mask >> lane) & 1;
+		}
+	}
+#endif //MATH_SIMD_SSE4
+
+	for (; i < end; ++i)
+	{
+		if (tester.Test(i))
+		{
+			out[visibleCount++] = static_cast<u32>(i);
+		}
+	}
+	return visibleCount;
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename Tester>
+size_t Cull(const Tester& tester, Span<u32> visible)
+{
+	ASSERT(visible.size >= tester.GetCount(), "[Culling] Visible span is smaller than the volume count!");
+	return CullRange(tester, 0, tester.GetCount(), visible.data);
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename Tester>
+size_t Cull(JobSystem& jobSystem, const Tester& tester, Span<u32> visible)
+{
+	const size_t count = tester.GetCount();
+	ASSERT(visible.size >= count, "[Culling] Visible span is smaller than the volume count!");
+
+	//Multiple of 8 so every range but the last stays on the SIMD path
+	size_t rangeSize = (count + kCullingMaxRanges - 1) / kCullingMaxRanges;
+	rangeSize = (rangeSize < kCullingGrainSize) ? kCullingGrainSize : (rangeSize + 7) & ~static_cast<size_t>(7);
+	const size_t rangeCount = (count + rangeSize - 1) / rangeSize;
+
+	//Each range compacts into its own slice of visible, the slices are then joined
+	size_t rangeVisibleCounts[kCullingMaxRanges];
+	jobSystem.ParallelFor(count, rangeSize, [&](size_t begin, size_t end)
+	{
+		rangeVisibleCounts[begin / rangeSize] = CullRange(tester, begin, end, visible.data + begin);
+	});
+
+	size_t visibleCount = 0;
+	for (size_t range = 0; range < rangeCount; ++range)
+	{
+		const u32* rangeVisible = visible.data + (range * rangeSize);
+		if (rangeVisible != visible.data + visibleCount)
+		{
+			memmove(visible.data + visibleCount, rangeVisible, rangeVisibleCounts[range] * sizeof(u32));
+		}
+		visibleCount += rangeVisibleCounts[range];
+	}
+	return visibleCount;
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+size_t CullSpheres(const Math::Frustum& frustum, const SphereSoA& spheres, Span<u32> visible)
+{
+	return Cull(SphereTester(frustum, spheres), visible);
+}
+
+//--------------------------------------------------------------------------------------
+
+size_t CullAABBs(const Math::Frustum& frustum, const AABBSoA& boxes, Span<u32> visible)
+{
+	return Cull(AABBTester(frustum, boxes), visible);
+}
+
+//--------------------------------------------------------------------------------------
+
+size_t CullSpheres(JobSystem& jobSystem, const Math::Frustum& frustum, const SphereSoA& spheres, Span<u32> visible)
+{
+	return Cull(jobSystem, SphereTester(frustum, spheres), visible);
+}
+
+//--------------------------------------------------------------------------------------
+
+size_t CullAABBs(JobSystem& jobSystem, const Math::Frustum& frustum, const AABBSoA& boxes, Span<u32> visible)
+{
+	return Cull(jobSystem, AABBTester(frustum, boxes), visible);
+}
+
+//======================================================================================
@@ -0,0 +1,69 @@
+#ifndef ENGINE_CULLING_H__
+#define ENGINE_CULLING_H__
+//======================================================================================
+// Filename: Culling.h
+// Description: Frustum culling of bounding volume arrays. Volumes are tested 8 at a
+//				time and the indices of the visible ones are written out compacted, in
+//				ascending order.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Frustum.h"
+#include "Span.h"
+
+class JobSystem;
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr size_t kCullingGrainSize			= 4096;
+constexpr size_t kCullingMaxRanges			= 256;
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+// Structure of arrays bounding spheres. All arrays hold count elements.
+struct SphereSoA
+{
+	const f32*	x = nullptr;
+	const f32*	y = nullptr;
+	const f32*	z = nullptr;
+	const f32*	radius = nullptr;
+	size_t		count = 0;
+};
+
+//--------------------------------------------------------------------------------------
+
+// Structure of arrays axis aligned boxes. All arrays hold count elements.
+struct AABBSoA
+{
+	const f32*	minX = nullptr;
+	const f32*	minY = nullptr;
+	const f32*	minZ = nullptr;
+	const f32*	maxX = nullptr;
+	const f32*	maxY = nullptr;
+	const f32*	maxZ = nullptr;
+	size_t		count = 0;
+};
+
+//======================================================================================
+// Function Declarations
+//======================================================================================
+
+// Returns the number of visible indices written. visible.size must be at least the
+// volume count, the whole span may be written to.
+size_t CullSpheres( const Math::Frustum& frustum, const SphereSoA& spheres, Span<u32> visible );
+size_t CullAABBs( const Math::Frustum& frustum, const AABBSoA& boxes, Span<u32> visible );
+
+// Same results as above with ranges of kCullingGrainSize or more volumes spread across
+// the job system.
+size_t CullSpheres( JobSystem& jobSystem, const Math::Frustum& frustum, const SphereSoA& spheres, Span<u32> visible );
+size_t CullAABBs( JobSystem& jobSystem, const Math::Frustum& frustum, const AABBSoA& boxes, Span<u32> visible );
+
+//======================================================================================
+#endif // !ENGINE_CULLING_H__
@@ -0,0 +1,204 @@
+//======================================================================================
+// Filename: DeletionQueue.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "DeletionQueue.h"
+
+#include "GpuTimeline.h"
+#include "GraphicsCommon.h"
+//======================================================================================
+
+namespace
+{
+	const u32 kMaxTimelinesPerCollect = 8;
+}
+
+//--------------------------------------------------------------------------------------
+
+DeletionQueue::DeletionQueue(VkDevice device)
+	: mDevice( device )
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+DeletionQueue::~DeletionQueue()
+{
+	Flush();
+}
+
+//--------------------------------------------------------------------------------------
+
+void DeletionQueue::Enqueue(DeferredObjectType type, u64 handle, GpuTimeline* timeline, u64 value)
+{
+	if (handle == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mPending.push_back({ type, handle, timeline, value });
+}
+
+//--------------------------------------------------------------------------------------
+
+void DeletionQueue::EnqueueAfterSubmitted(DeferredObjectType type, u64 handle, GpuTimeline* timeline)
+{
+	Enqueue(type, handle, timeline, timeline->GetSubmittedValue());
+}
+
+//--------------------------------------------------------------------------------------
+
+void DeletionQueue::Collect()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mPending.empty())
+		{
+			return;
+		}
+		mCollecting.swap(mPending);
+	}
+
+	//Query each timeline once per collect rather than once per object
+	GpuTimeline* timelines[kMaxTimelinesPerCollect] = {};
+	u64 completedValues[kMaxTimelinesPerCollect] = {};
+	u32 timelineCount = 0;
+
+	auto getCompletedValue = [&](GpuTimeline* timeline) -> u64
+	{
+		for (u32 i = 0; i < timelineCount; ++i)
+		{
+			if (timelines[i] == timeline)
+			{
+				return completedValues[i];
+			}
+		}
+
+		const u64 completed = timeline->GetCompletedValue();
+		if (timelineCount < kMaxTimelinesPerCollect)
+		{
+			timelines[timelineCount] = timeline;
+			completedValues[timelineCount] = completed;
+			++timelineCount;
+		}
+		return completed;
+	};
+
+	size_t kept = 0;
+	for (size_t i = 0; i < mCollecting.size(); ++i)
+	{
+		const PendingObject& object = mCollecting[i];
+		if (object.value <= getCompletedValue(object.timeline))
+		{
+			Destroy(object);
+		}
+		else
+		{
+			mCollecting[kept++] = object;
+		}
+	}
+	mCollecting.resize(kept);
+
+	//Anything enqueued while collecting goes after the survivors
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCollecting.insert(mCollecting.end(), mPending.begin(), mPending.end());
+	mPending.clear();
+	mPending.swap(mCollecting);
+}
+
+//--------------------------------------------------------------------------------------
+
+void DeletionQueue::Flush()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (const auto& object : mPending)
+	{
+		object.timeline->Wait(object.value);
+		Destroy(object);
+	}
+	mPending.clear();
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 DeletionQueue::GetPendingCount()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return static_cast<u32>(mPending.size());
+}
+
+//--------------------------------------------------------------------------------------
+
+void DeletionQueue::Destroy(const PendingObject& object)
+{
+	switch (object.type)
+	{
+	case DeferredObjectType::Buffer:
+		vkDestroyBuffer(mDevice, U64ToHandle<VkBuffer>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::BufferView:
+		vkDestroyBufferView(mDevice, U64ToHandle<VkBufferView>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::Image:
+		vkDestroyImage(mDevice, U64ToHandle<VkImage>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::ImageView:
+		vkDestroyImageView(mDevice, U64ToHandle<VkImageView>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::DeviceMemory:
+		vkFreeMemory(mDevice, U64ToHandle<VkDeviceMemory>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::Sampler:
+		vkDestroySampler(mDevice, U64ToHandle<VkSampler>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::Framebuffer:
+		vkDestroyFramebuffer(mDevice, U64ToHandle<VkFramebuffer>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::RenderPass:
+		vkDestroyRenderPass(mDevice, U64ToHandle<VkRenderPass>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::Pipeline:
+		vkDestroyPipeline(mDevice, U64ToHandle<VkPipeline>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::PipelineLayout:
+		vkDestroyPipelineLayout(mDevice, U64ToHandle<VkPipelineLayout>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::DescriptorSetLayout:
+		vkDestroyDescriptorSetLayout(mDevice, U64ToHandle<VkDescriptorSetLayout>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::DescriptorPool:
+		vkDestroyDescriptorPool(mDevice, U64ToHandle<VkDescriptorPool>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::ShaderModule:
+		vkDestroyShaderModule(mDevice, U64ToHandle<VkShaderModule>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::CommandPool:
+		vkDestroyCommandPool(mDevice, U64ToHandle<VkCommandPool>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::QueryPool:
+		vkDestroyQueryPool(mDevice, U64ToHandle<VkQueryPool>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::Fence:
+		vkDestroyFence(mDevice, U64ToHandle<VkFence>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::Semaphore:
+		vkDestroySemaphore(mDevice, U64ToHandle<VkSemaphore>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::Event:
+		vkDestroyEvent(mDevice, U64ToHandle<VkEvent>(object.handle), nullptr);
+		break;
+	case DeferredObjectType::Swapchain:
+		vkDestroySwapchainKHR(mDevice, U64ToHandle<VkSwapchainKHR>(object.handle), nullptr);
+		break;
+	default:
+		ASSERT(false, "[DeletionQueue] Unhandled object type!");
+		break;
+	}
+}
+
+//======================================================================================
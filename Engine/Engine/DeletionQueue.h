@@ -0,0 +1,93 @@
+#ifndef ENGINE_GRAPHICS_DELETION_QUEUE_H__
+#define ENGINE_GRAPHICS_DELETION_QUEUE_H__
+//======================================================================================
+// Filename: DeletionQueue.h
+// Description: Defers destruction of Vulkan objects until the GpuTimeline value that
+//				last used them has retired, so runtime resource churn never has to
+//				drain the GPU.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Platform.h"
+
+#include <mutex>
+#include <vector>
+
+class GpuTimeline;
+//======================================================================================
+// Enums
+//======================================================================================
+
+enum class DeferredObjectType : u32
+{
+	Buffer,
+	BufferView,
+	Image,
+	ImageView,
+	DeviceMemory,
+	Sampler,
+	Framebuffer,
+	RenderPass,
+	Pipeline,
+	PipelineLayout,
+	DescriptorSetLayout,
+	DescriptorPool,
+	ShaderModule,
+	CommandPool,
+	QueryPool,
+	Fence,
+	Semaphore,
+	Event,
+	Swapchain
+};
+
+//======================================================================================
+// Class DeletionQueue
+//======================================================================================
+
+class DeletionQueue
+{
+public:
+	DeletionQueue( VkDevice device );
+	~DeletionQueue();
+
+	// Destroys the object once timeline has reached value. Handles are passed as u64 since
+	// non-dispatchable handles are plain integers on 32-bit builds and cannot be overloaded,
+	// convert them with HandleToU64.
+	void Enqueue( DeferredObjectType type, u64 handle, GpuTimeline* timeline, u64 value );
+	// Destroys the object once everything submitted to timeline so far has retired.
+	void EnqueueAfterSubmitted( DeferredObjectType type, u64 handle, GpuTimeline* timeline );
+
+	// Releases every object whose timeline value has retired. Call once per frame.
+	void Collect();
+	// Waits on every pending timeline value and releases everything. Shutdown only.
+	void Flush();
+
+	u32 GetPendingCount();
+
+private:
+	NONCOPYABLE(DeletionQueue);
+
+	struct PendingObject
+	{
+		DeferredObjectType	type;
+		u64					handle;
+		GpuTimeline*		timeline;
+		u64					value;
+	};
+
+	void Destroy( const PendingObject& object );
+
+private:
+	VkDevice					mDevice = VK_NULL_HANDLE;
+
+	std::mutex					mMutex;
+	std::vector<PendingObject>	mPending;
+	std::vector<PendingObject>	mCollecting;
+};
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_DELETION_QUEUE_H__
@@ -0,0 +1,433 @@
+//======================================================================================
+// Filename: DescriptorAllocator.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "DescriptorAllocator.h"
+
+#include "GpuTimeline.h"
+#include "GraphicsCommon.h"
+#include "Renderer.h"
+
+//======================================================================================
+
+namespace
+{
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+// FNV-1a, fed one field at a time so struct padding never reaches the hash
+inline void HashCombine(u64& hash, u64 value)
+{
+	for (u32 i = 0; i < 8; ++i)
+	{
+		hash ^= (value >> (i * 8)) & 0xff;
+		hash *= 1099511628211ull;
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr u64 kHashSeed = 14695981039346656037ull;
+
+//--------------------------------------------------------------------------------------
+
+u64 HashBindings(Span<const VkDescriptorSetLayoutBinding> bindings)
+{
+	u64 hash = kHashSeed;
+	for (const VkDescriptorSetLayoutBinding& binding : bindings)
+	{
+		HashCombine(hash, binding.binding);
+		HashCombine(hash, binding.descriptorType);
+		HashCombine(hash, binding.descriptorCount);
+		HashCombine(hash, binding.stageFlags);
+	}
+	return hash;
+}
+
+//--------------------------------------------------------------------------------------
+
+bool IsSameBinding(const VkDescriptorSetLayoutBinding& lhs, const VkDescriptorSetLayoutBinding& rhs)
+{
+	return lhs.binding == rhs.binding && lhs.descriptorType == rhs.descriptorType
+		&& lhs.descriptorCount == rhs.descriptorCount && lhs.stageFlags == rhs.stageFlags;
+}
+
+//--------------------------------------------------------------------------------------
+
+bool IsBufferDescriptor(VkDescriptorType type)
+{
+	return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+		|| type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+}
+
+//--------------------------------------------------------------------------------------
+
+u64 HashWrites(VkDescriptorSetLayout layout, Span<const DescriptorWrite> writes)
+{
+	u64 hash = kHashSeed;
+	HashCombine(hash, HandleToU64(layout));
+	for (const DescriptorWrite& write : writes)
+	{
+		HashCombine(hash, write.binding);
+		HashCombine(hash, write.type);
+		if (IsBufferDescriptor(write.type))
+		{
+			HashCombine(hash, HandleToU64(write.bufferInfo.buffer));
+			HashCombine(hash, write.bufferInfo.offset);
+			HashCombine(hash, write.bufferInfo.range);
+		}
+		else
+		{
+			HashCombine(hash, HandleToU64(write.imageInfo.sampler));
+			HashCombine(hash, HandleToU64(write.imageInfo.imageView));
+			HashCombine(hash, write.imageInfo.imageLayout);
+		}
+	}
+	return hash;
+}
+
+//--------------------------------------------------------------------------------------
+
+bool IsSameWrite(const DescriptorWrite& lhs, const DescriptorWrite& rhs)
+{
+	if (lhs.binding != rhs.binding || lhs.type != rhs.type)
+	{
+		return false;
+	}
+	if (IsBufferDescriptor(lhs.type))
+	{
+		return lhs.bufferInfo.buffer == rhs.bufferInfo.buffer && lhs.bufferInfo.offset == rhs.bufferInfo.offset
+			&& lhs.bufferInfo.range == rhs.bufferInfo.range;
+	}
+	return lhs.imageInfo.sampler == rhs.imageInfo.sampler && lhs.imageInfo.imageView == rhs.imageInfo.imageView
+		&& lhs.imageInfo.imageLayout == rhs.imageInfo.imageLayout;
+}
+
+} // namespace
+
+//======================================================================================
+// Class DescriptorAllocator
+//======================================================================================
+
+DescriptorAllocator::DescriptorAllocator(Renderer* renderer, u32 frameCount)
+	: mRenderer( renderer )
+	, mDevice( renderer->GetVulkanDevice() )
+	, mFrames( frameCount )
+{
+	ASSERT(frameCount > 0, "[DescriptorAllocator] Needs at least one frame!");
+
+	//Start on the last frame so the first BeginFrame lands on frame 0
+	mFrameIndex = frameCount - 1;
+}
+
+//--------------------------------------------------------------------------------------
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+	GpuTimeline* timeline = mRenderer->GetGraphicsTimeline();
+	for (FramePools& frame : mFrames)
+	{
+		timeline->Wait(frame.value);
+		for (auto& entry : frame.lists)
+		{
+			for (VkDescriptorPool pool : entry.second.pools)
+			{
+				vkDestroyDescriptorPool(mDevice, pool, nullptr);
+			}
+		}
+	}
+
+	//Immutable sets can be used by any frame still in flight
+	timeline->Wait(timeline->GetSubmittedValue());
+	for (auto& entry : mImmutablePools)
+	{
+		for (VkDescriptorPool pool : entry.second.pools)
+		{
+			vkDestroyDescriptorPool(mDevice, pool, nullptr);
+		}
+	}
+
+	for (auto& entry : mLayouts)
+	{
+		for (LayoutInfo& info : entry.second)
+		{
+			vkDestroyDescriptorSetLayout(mDevice, info.layout, nullptr);
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+VkDescriptorSetLayout DescriptorAllocator::GetLayout(Span<const VkDescriptorSetLayoutBinding> bindings)
+{
+	const u64 hash = HashBindings(bindings);
+	std::vector<LayoutInfo>& candidates = mLayouts[hash];
+	for (const LayoutInfo& info : candidates)
+	{
+		if (info.bindings.size() != bindings.size)
+		{
+			continue;
+		}
+
+		bool isSame = true;
+		for (size_t i = 0; i < bindings.size && isSame; ++i)
+		{
+			isSame = IsSameBinding(info.bindings[i], bindings.data[i]);
+		}
+		if (isSame)
+		{
+			return info.layout;
+		}
+	}
+
+	VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+	layoutCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutCreateInfo.bindingCount	= static_cast<uint32_t>(bindings.size);
+	layoutCreateInfo.pBindings		= bindings.data;
+
+	LayoutInfo info;
+	vkErrorCheck( vkCreateDescriptorSetLayout(mDevice, &layoutCreateInfo, nullptr, &info.layout) );
+
+	//Pool sizes for one set, merged by type
+	std::vector<VkDescriptorPoolSize>& poolSizes = mPoolSizes[info.layout];
+	for (const VkDescriptorSetLayoutBinding& binding : bindings)
+	{
+		ASSERT(nullptr == binding.pImmutableSamplers, "[DescriptorAllocator] Immutable samplers are not supported!");
+		info.bindings.push_back(binding);
+
+		bool isMerged = false;
+		for (VkDescriptorPoolSize& poolSize : poolSizes)
+		{
+			if (poolSize.type == binding.descriptorType)
+			{
+				poolSize.descriptorCount += binding.descriptorCount;
+				isMerged = true;
+				break;
+			}
+		}
+		if (!isMerged && binding.descriptorCount > 0)
+		{
+			poolSizes.push_back({ binding.descriptorType, binding.descriptorCount });
+		}
+	}
+
+	candidates.push_back(info);
+	return info.layout;
+}
+
+//--------------------------------------------------------------------------------------
+
+void DescriptorAllocator::BeginFrame()
+{
+	mFrameStats.poolCount = mPoolCount;
+	mLastFrameStats = mFrameStats;
+	mFrameStats = DescriptorAllocatorStats();
+
+	mFrameIndex = (mFrameIndex + 1) % mFrames.size();
+	FramePools& frame = mFrames[mFrameIndex];
+	mRenderer->GetGraphicsTimeline()->Wait(frame.value);
+
+	//Every set from these pools goes at once, the pools themselves are kept
+	for (auto& entry : frame.lists)
+	{
+		PoolList& list = entry.second;
+		for (u32 i = 0; i <= list.current && i < list.pools.size(); ++i)
+		{
+			vkErrorCheck( vkResetDescriptorPool(mDevice, list.pools[i], 0) );
+		}
+		list.current = 0;
+		list.used = 0;
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void DescriptorAllocator::EndFrame(u64 value)
+{
+	mFrames[mFrameIndex].value = value;
+}
+
+//--------------------------------------------------------------------------------------
+
+VkDescriptorSet DescriptorAllocator::AllocateFrameSet(VkDescriptorSetLayout layout)
+{
+	VkDescriptorSet set = VK_NULL_HANDLE;
+	AllocateFrameSets(layout, Span<VkDescriptorSet>(&set, 1));
+	return set;
+}
+
+//--------------------------------------------------------------------------------------
+
+VkDescriptorSet DescriptorAllocator::AllocateFrameSet(VkDescriptorSetLayout layout, Span<const DescriptorWrite> writes)
+{
+	const VkDescriptorSet set = AllocateFrameSet(layout);
+	Write(set, writes);
+	return set;
+}
+
+//--------------------------------------------------------------------------------------
+
+void DescriptorAllocator::AllocateFrameSets(VkDescriptorSetLayout layout, Span<VkDescriptorSet> sets)
+{
+	Allocate(mFrames[mFrameIndex].lists[layout], layout, sets);
+}
+
+//--------------------------------------------------------------------------------------
+
+VkDescriptorSet DescriptorAllocator::GetImmutableSet(VkDescriptorSetLayout layout, Span<const DescriptorWrite> writes)
+{
+	++mFrameStats.cacheLookups;
+	++mTotalStats.cacheLookups;
+
+	const u64 hash = HashWrites(layout, writes);
+	std::vector<ImmutableSet>& candidates = mImmutableSets[hash];
+	for (const ImmutableSet& candidate : candidates)
+	{
+		if (candidate.layout != layout || candidate.writes.size() != writes.size)
+		{
+			continue;
+		}
+
+		bool isSame = true;
+		for (size_t i = 0; i < writes.size && isSame; ++i)
+		{
+			isSame = IsSameWrite(candidate.writes[i], writes.data[i]);
+		}
+		if (isSame)
+		{
+			++mFrameStats.cacheHits;
+			++mTotalStats.cacheHits;
+			return candidate.set;
+		}
+	}
+
+	ImmutableSet immutableSet;
+	immutableSet.layout = layout;
+	immutableSet.writes.assign(writes.begin(), writes.end());
+	Allocate(mImmutablePools[layout], layout, Span<VkDescriptorSet>(&immutableSet.set, 1));
+	Write(immutableSet.set, writes);
+	candidates.push_back(std::move(immutableSet));
+	return candidates.back().set;
+}
+
+//--------------------------------------------------------------------------------------
+
+void DescriptorAllocator::Allocate(PoolList& list, VkDescriptorSetLayout layout, Span<VkDescriptorSet> sets)
+{
+	ASSERT(mPoolSizes.find(layout) != mPoolSizes.end(), "[DescriptorAllocator] Layout was not created by GetLayout!");
+
+	size_t allocated = 0;
+	while (allocated < sets.size)
+	{
+		//Move on to the next pool, creating a larger one when the list runs out
+		if (list.pools.empty() || list.used == list.capacities[list.current])
+		{
+			if (!list.pools.empty())
+			{
+				++list.current;
+				list.used = 0;
+			}
+			if (list.current == list.pools.size())
+			{
+				const u32 lastCapacity = list.capacities.empty() ? kDescriptorPoolMinSets / 2 : list.capacities.back();
+				const u32 capacity = (lastCapacity * 2 < kDescriptorPoolMaxSets) ? lastCapacity * 2 : kDescriptorPoolMaxSets;
+				list.pools.push_back(CreatePool(layout, capacity));
+				list.capacities.push_back(capacity);
+			}
+		}
+
+		const u32 available = list.capacities[list.current] - list.used;
+		const u32 count = (sets.size - allocated < available) ? static_cast<u32>(sets.size - allocated) : available;
+
+		//The pool only ever holds sets of this layout, so it can't fragment
+		mSetLayouts.assign(count, layout);
+
+		VkDescriptorSetAllocateInfo allocateInfo = {};
+		allocateInfo.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocateInfo.descriptorPool		= list.pools[list.current];
+		allocateInfo.descriptorSetCount	= count;
+		allocateInfo.pSetLayouts		= mSetLayouts.data();
+		vkErrorCheck( vkAllocateDescriptorSets(mDevice, &allocateInfo, sets.data + allocated) );
+		CountAllocation(count);
+
+		list.used += count;
+		allocated += count;
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+VkDescriptorPool DescriptorAllocator::CreatePool(VkDescriptorSetLayout layout, u32 setCount)
+{
+	std::vector<VkDescriptorPoolSize> poolSizes = mPoolSizes[layout];
+	for (VkDescriptorPoolSize& poolSize : poolSizes)
+	{
+		poolSize.descriptorCount *= setCount;
+	}
+	if (poolSizes.empty())
+	{
+		//Sets of a layout without descriptors still need a pool, and poolSizeCount
+		//can't be 0, so ask for one descriptor that is never written
+		poolSizes.push_back({ VK_DESCRIPTOR_TYPE_SAMPLER, 1 });
+	}
+
+	VkDescriptorPoolCreateInfo poolCreateInfo = {};
+	poolCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolCreateInfo.maxSets			= setCount;
+	poolCreateInfo.poolSizeCount	= static_cast<uint32_t>(poolSizes.size());
+	poolCreateInfo.pPoolSizes		= poolSizes.data();
+
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+	vkErrorCheck( vkCreateDescriptorPool(mDevice, &poolCreateInfo, nullptr, &pool) );
+	++mPoolCount;
+	mTotalStats.poolCount = mPoolCount;
+	return pool;
+}
+
+//--------------------------------------------------------------------------------------
+
+void DescriptorAllocator::Write(VkDescriptorSet set, Span<const DescriptorWrite> writes)
+{
+	mWrites.clear();
+	for (const DescriptorWrite& write : writes)
+	{
+		VkWriteDescriptorSet descriptorWrite = {};
+		descriptorWrite.sType			= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet			= set;
+		descriptorWrite.dstBinding		= write.binding;
+		descriptorWrite.descriptorCount	= 1;
+		descriptorWrite.descriptorType	= write.type;
+		if (IsBufferDescriptor(write.type))
+		{
+			descriptorWrite.pBufferInfo	= &write.bufferInfo;
+		}
+		else
+		{
+			descriptorWrite.pImageInfo	= &write.imageInfo;
+		}
+		mWrites.push_back(descriptorWrite);
+	}
+
+	if (!mWrites.empty())
+	{
+		vkUpdateDescriptorSets(mDevice, static_cast<uint32_t>(mWrites.size()), mWrites.data(), 0, nullptr);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void DescriptorAllocator::CountAllocation(u32 setCount)
+{
+	++mFrameStats.allocateCalls;
+	++mTotalStats.allocateCalls;
+	mFrameStats.allocatedSets += setCount;
+	mTotalStats.allocatedSets += setCount;
+}
+
+//======================================================================================
@@ -0,0 +1,154 @@
+#ifndef ENGINE_GRAPHICS_DESCRIPTOR_ALLOCATOR_H__
+#define ENGINE_GRAPHICS_DESCRIPTOR_ALLOCATOR_H__
+//======================================================================================
+// Filename: DescriptorAllocator.h
+// Description: Hands out descriptor sets from pools dedicated to one layout each.
+//				Frame sets come from a pool list per frame in flight that is reset
+//				wholesale once the GPU is done with it, so nothing is freed one set at a
+//				time. Immutable sets are written once and shared by everyone asking for
+//				the same layout and contents.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Platform.h"
+#include "Span.h"
+
+#include <unordered_map>
+#include <vector>
+
+class Renderer;
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr u32 kDescriptorPoolMinSets		= 16;
+constexpr u32 kDescriptorPoolMaxSets		= 1024;
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+// One binding of a set, bufferInfo or imageInfo is used depending on type
+struct DescriptorWrite
+{
+	u32						binding = 0;
+	VkDescriptorType		type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	VkDescriptorBufferInfo	bufferInfo = {};
+	VkDescriptorImageInfo	imageInfo = {};
+};
+
+//--------------------------------------------------------------------------------------
+
+struct DescriptorAllocatorStats
+{
+	u32		allocateCalls = 0;			// vkAllocateDescriptorSets calls
+	u32		allocatedSets = 0;
+	u32		cacheLookups = 0;			// GetImmutableSet calls
+	u32		cacheHits = 0;
+	u32		poolCount = 0;				// Every pool the allocator owns
+
+	f32 GetCacheHitRate() const												{ return (cacheLookups > 0) ? static_cast<f32>(cacheHits) / cacheLookups : 0.0f; }
+};
+
+//======================================================================================
+// Class DescriptorAllocator
+//======================================================================================
+
+// Not thread safe
+class DescriptorAllocator
+{
+public:
+	DescriptorAllocator( Renderer* renderer, u32 frameCount );
+	~DescriptorAllocator();
+
+	// Layouts are cached by their bindings and owned by the allocator. Immutable
+	// samplers are not supported.
+	VkDescriptorSetLayout GetLayout( Span<const VkDescriptorSetLayoutBinding> bindings );
+
+	// Moves to the next frame's pools and resets them, waiting on the graphics
+	// timeline if the GPU may still be using their sets.
+	void BeginFrame();
+	// value is the graphics timeline value of the last submit using this frame's sets.
+	void EndFrame( u64 value );
+
+	// Valid until the same frame comes around again. layout must come from GetLayout.
+	VkDescriptorSet AllocateFrameSet( VkDescriptorSetLayout layout );
+	VkDescriptorSet AllocateFrameSet( VkDescriptorSetLayout layout, Span<const DescriptorWrite> writes );
+	// Fills sets with one vkAllocateDescriptorSets call per pool touched.
+	void AllocateFrameSets( VkDescriptorSetLayout layout, Span<VkDescriptorSet> sets );
+
+	// Returns the set written with writes, allocating it on first use. Lives as long as
+	// the allocator, so the resources written must too.
+	VkDescriptorSet GetImmutableSet( VkDescriptorSetLayout layout, Span<const DescriptorWrite> writes );
+
+	// Counts for the previous frame, BeginFrame rolls them over
+	const DescriptorAllocatorStats&	GetFrameStats() const					{ return mLastFrameStats; }
+	// Counts since the allocator was created
+	const DescriptorAllocatorStats&	GetTotalStats() const					{ return mTotalStats; }
+
+private:
+	NONCOPYABLE(DescriptorAllocator);
+
+	struct LayoutInfo
+	{
+		std::vector<VkDescriptorSetLayoutBinding>	bindings;
+		VkDescriptorSetLayout						layout;
+	};
+
+	// Pools for one layout, each twice the size of the last up to kDescriptorPoolMaxSets
+	struct PoolList
+	{
+		std::vector<VkDescriptorPool>	pools;
+		std::vector<u32>				capacities;
+		u32								current = 0;
+		u32								used = 0;	// Sets taken from pools[current]
+	};
+
+	struct FramePools
+	{
+		std::unordered_map<VkDescriptorSetLayout, PoolList>	lists;
+		u64													value = 0;
+	};
+
+	struct ImmutableSet
+	{
+		VkDescriptorSetLayout			layout;
+		std::vector<DescriptorWrite>	writes;
+		VkDescriptorSet					set;
+	};
+
+	void Allocate( PoolList& list, VkDescriptorSetLayout layout, Span<VkDescriptorSet> sets );
+	VkDescriptorPool CreatePool( VkDescriptorSetLayout layout, u32 setCount );
+	void Write( VkDescriptorSet set, Span<const DescriptorWrite> writes );
+	void CountAllocation( u32 setCount );
+
+private:
+	Renderer*		mRenderer = nullptr;
+	VkDevice		mDevice = VK_NULL_HANDLE;
+
+	std::unordered_map<u64, std::vector<LayoutInfo>>		mLayouts;		// By binding hash
+	// Descriptors of each type in one set of the layout
+	std::unordered_map<VkDescriptorSetLayout, std::vector<VkDescriptorPoolSize>>	mPoolSizes;
+
+	std::vector<FramePools>		mFrames;
+	u32							mFrameIndex = 0;
+
+	std::unordered_map<VkDescriptorSetLayout, PoolList>		mImmutablePools;
+	std::unordered_map<u64, std::vector<ImmutableSet>>		mImmutableSets;	// By content hash
+
+	// Reused by Allocate and Write
+	std::vector<VkDescriptorSetLayout>	mSetLayouts;
+	std::vector<VkWriteDescriptorSet>	mWrites;
+
+	u32							mPoolCount = 0;
+	DescriptorAllocatorStats	mFrameStats;
+	DescriptorAllocatorStats	mLastFrameStats;
+	DescriptorAllocatorStats	mTotalStats;
+};
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_DESCRIPTOR_ALLOCATOR_H__
@@ -0,0 +1,244 @@
+//======================================================================================
+// Filename: DrawBatcher.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "DrawBatcher.h"
+
+#include "GpuRingBuffer.h"
+#include "JobSystem.h"
+
+#include <cstring>
+//======================================================================================
+
+//======================================================================================
+// Class DrawBatcher
+//======================================================================================
+
+DrawBatcher::DrawBatcher(u32 instanceStride, u32 instanceBinding, u32 materialSet, FrameAllocator* frameAllocator)
+	: mInstanceStride( instanceStride )
+	, mInstanceBinding( instanceBinding )
+	, mMaterialSet( materialSet )
+	, mSorter( frameAllocator )
+{
+	ASSERT(instanceStride > 0, "[DrawBatcher] Instance stride must not be zero!");
+	ASSERT(instanceBinding != 0, "[DrawBatcher] Binding 0 is taken by the mesh vertices!");
+}
+
+//--------------------------------------------------------------------------------------
+
+DrawBatcher::~DrawBatcher()
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 DrawBatcher::AddPipeline(VkPipeline pipeline, VkPipelineLayout layout)
+{
+	ASSERT(mPipelines.size() < (1u << kDrawKeyPipelineBits), "[DrawBatcher] Out of pipeline ids!");
+	mPipelines.push_back({ pipeline, layout });
+	return static_cast<u32>(mPipelines.size() - 1);
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 DrawBatcher::AddMaterial(VkDescriptorSet descriptorSet)
+{
+	ASSERT(mMaterials.size() < (1u << kDrawKeyMaterialBits), "[DrawBatcher] Out of material ids!");
+	mMaterials.push_back(descriptorSet);
+	return static_cast<u32>(mMaterials.size() - 1);
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 DrawBatcher::AddMesh(const DrawMesh& mesh)
+{
+	ASSERT(mMeshes.size() < (1u << kDrawKeyMeshBits), "[DrawBatcher] Out of mesh ids!");
+	mMeshes.push_back(mesh);
+	return static_cast<u32>(mMeshes.size() - 1);
+}
+
+//--------------------------------------------------------------------------------------
+
+void DrawBatcher::Begin()
+{
+	mKeys.clear();
+	mItems.clear();
+	mInstanceData.clear();
+}
+
+//--------------------------------------------------------------------------------------
+
+void DrawBatcher::Submit(u64 key, const void* instanceData)
+{
+	ASSERT(GetDrawKeyField(key, kDrawKeyPipelineShift, kDrawKeyPipelineBits) < mPipelines.size(), "[DrawBatcher] Unknown pipeline in draw key!");
+	ASSERT(GetDrawKeyField(key, kDrawKeyMaterialShift, kDrawKeyMaterialBits) < mMaterials.size(), "[DrawBatcher] Unknown material in draw key!");
+	ASSERT(GetDrawKeyField(key, kDrawKeyMeshShift, kDrawKeyMeshBits) < mMeshes.size(), "[DrawBatcher] Unknown mesh in draw key!");
+
+	mItems.push_back(static_cast<u32>(mKeys.size()));
+	mKeys.push_back(key);
+
+	const size_t offset = mInstanceData.size();
+	mInstanceData.resize(offset + mInstanceStride);
+	memcpy(mInstanceData.data() + offset, instanceData, mInstanceStride);
+}
+
+//--------------------------------------------------------------------------------------
+
+bool DrawBatcher::Build(GpuRingBuffer& ring)
+{
+	return BuildDraws(nullptr, ring);
+}
+
+//--------------------------------------------------------------------------------------
+
+bool DrawBatcher::Build(JobSystem& jobSystem, GpuRingBuffer& ring)
+{
+	return BuildDraws(&jobSystem, ring);
+}
+
+//--------------------------------------------------------------------------------------
+
+bool DrawBatcher::BuildDraws(JobSystem* jobSystem, GpuRingBuffer& ring)
+{
+	mDrawCommands.clear();
+	mStats = DrawBatcherStats();
+	mStats.submittedCount = static_cast<u32>(mKeys.size());
+	if (mKeys.empty())
+	{
+		return true;
+	}
+
+	if (nullptr != jobSystem)
+	{
+		mSorter.Sort(*jobSystem, mKeys, mItems);
+	}
+	else
+	{
+		mSorter.Sort(mKeys, mItems);
+	}
+
+	//Runs of the same pipeline, material and mesh become one draw. Depth only orders
+	//the instances inside the run.
+	const u32 count = static_cast<u32>(mKeys.size());
+	u32 lastPipeline = U32_MAX;
+	u32 lastMaterial = U32_MAX;
+	u32 lastMesh = U32_MAX;
+	for (u32 first = 0; first < count;)
+	{
+		const u64 batchKey = GetDrawBatchKey(mKeys[first]);
+		u32 end = first + 1;
+		while (end < count && GetDrawBatchKey(mKeys[end]) == batchKey)
+		{
+			++end;
+		}
+
+		DrawCommand command;
+		command.pipeline = GetDrawKeyField(mKeys[first], kDrawKeyPipelineShift, kDrawKeyPipelineBits);
+		command.material = GetDrawKeyField(mKeys[first], kDrawKeyMaterialShift, kDrawKeyMaterialBits);
+		command.mesh = GetDrawKeyField(mKeys[first], kDrawKeyMeshShift, kDrawKeyMeshBits);
+		command.firstInstance = first;
+		command.instanceCount = end - first;
+		mDrawCommands.push_back(command);
+
+		//Same rules as Record, a new pipeline layout invalidates the material set
+		if (command.pipeline != lastPipeline)
+		{
+			++mStats.pipelineBindCount;
+			lastMaterial = U32_MAX;
+		}
+		if (command.material != lastMaterial)
+		{
+			++mStats.materialBindCount;
+		}
+		if (command.mesh != lastMesh)
+		{
+			++mStats.meshBindCount;
+		}
+		lastPipeline = command.pipeline;
+		lastMaterial = command.material;
+		lastMesh = command.mesh;
+		first = end;
+	}
+	mStats.drawCount = static_cast<u32>(mDrawCommands.size());
+	mStats.instanceBytes = static_cast<u64>(count) * mInstanceStride;
+
+	const GpuRingAllocation allocation = ring.Allocate(mStats.instanceBytes, 16);
+	if (nullptr == allocation.data)
+	{
+		mDrawCommands.clear();
+		mStats.drawCount = 0;
+		return false;
+	}
+	mInstanceBuffer = allocation.buffer;
+	mInstanceOffset = allocation.offset;
+
+	//Gather the instance data in sorted order so each draw reads a contiguous range
+	u8* target = static_cast<u8*>(allocation.data);
+	const u8* source = mInstanceData.data();
+	const u32* items = mItems.data();
+	const size_t stride = mInstanceStride;
+	auto gather = [target, source, items, stride](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			memcpy(target + i * stride, source + items[i] * stride, stride);
+		}
+	};
+	if (nullptr != jobSystem)
+	{
+		jobSystem->ParallelFor(count, kDrawBatcherGrainSize, gather);
+	}
+	else
+	{
+		gather(0, count);
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------
+
+void DrawBatcher::Record(VkCommandBuffer commandBuffer) const
+{
+	if (mDrawCommands.empty())
+	{
+		return;
+	}
+
+	//Instance data is one range, firstInstance picks each draw's part of it
+	vkCmdBindVertexBuffers(commandBuffer, mInstanceBinding, 1, &mInstanceBuffer, &mInstanceOffset);
+
+	u32 lastPipeline = U32_MAX;
+	u32 lastMaterial = U32_MAX;
+	u32 lastMesh = U32_MAX;
+	for (const DrawCommand& command : mDrawCommands)
+	{
+		const DrawPipeline& pipeline = mPipelines[command.pipeline];
+		if (command.pipeline != lastPipeline)
+		{
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipeline);
+			lastPipeline = command.pipeline;
+			lastMaterial = U32_MAX;
+		}
+		if (command.material != lastMaterial)
+		{
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout, mMaterialSet, 1, &mMaterials[command.material], 0, nullptr);
+			lastMaterial = command.material;
+		}
+
+		const DrawMesh& mesh = mMeshes[command.mesh];
+		if (command.mesh != lastMesh)
+		{
+			vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mesh.vertexBuffer, &mesh.vertexOffset);
+			vkCmdBindIndexBuffer(commandBuffer, mesh.indexBuffer, mesh.indexOffset, mesh.indexType);
+			lastMesh = command.mesh;
+		}
+
+		vkCmdDrawIndexed(commandBuffer, mesh.indexCount, command.instanceCount, 0, 0, command.firstInstance);
+	}
+}
+
+//======================================================================================
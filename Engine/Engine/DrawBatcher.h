@@ -0,0 +1,140 @@
+#ifndef ENGINE_GRAPHICS_DRAW_BATCHER_H__
+#define ENGINE_GRAPHICS_DRAW_BATCHER_H__
+//======================================================================================
+// Filename: DrawBatcher.h
+// Description: Collects a frame's draws as 64-bit sort keys, radix sorts them and
+//				merges runs of the same pipeline, material and mesh into one instanced
+//				draw. Per instance data is gathered into a GpuRingBuffer in sorted order
+//				and bound as an instance rate vertex buffer.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "DrawKey.h"
+#include "Platform.h"
+#include "RadixSort.h"
+
+#include <vector>
+
+class FrameAllocator;
+class GpuRingBuffer;
+class JobSystem;
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr size_t kDrawBatcherGrainSize		= 1024;
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+struct DrawMesh
+{
+	VkBuffer		vertexBuffer = VK_NULL_HANDLE;
+	VkDeviceSize	vertexOffset = 0;
+	VkBuffer		indexBuffer = VK_NULL_HANDLE;
+	VkDeviceSize	indexOffset = 0;
+	VkIndexType		indexType = VK_INDEX_TYPE_UINT16;
+	u32				indexCount = 0;
+};
+
+//--------------------------------------------------------------------------------------
+
+// One instanced draw, the ids index the batcher's registered pipelines, materials and meshes
+struct DrawCommand
+{
+	u32		pipeline;
+	u32		material;
+	u32		mesh;
+	u32		firstInstance;
+	u32		instanceCount;
+};
+
+//--------------------------------------------------------------------------------------
+
+// Counts for the last Build. The bind counts are what Record issues.
+struct DrawBatcherStats
+{
+	u32		submittedCount = 0;
+	u32		drawCount = 0;
+	u32		pipelineBindCount = 0;
+	u32		materialBindCount = 0;
+	u32		meshBindCount = 0;
+	u64		instanceBytes = 0;
+};
+
+//======================================================================================
+// Class DrawBatcher
+//======================================================================================
+
+class DrawBatcher
+{
+public:
+	// Every Submit copies instanceStride bytes of per instance data, which the
+	// pipelines read from vertex binding instanceBinding. Mesh vertices are bound to
+	// binding 0 and materials to descriptor set materialSet. With a frameAllocator,
+	// e.g. Renderer::GetFrameAllocator, Build takes its sort scratch from it.
+	DrawBatcher( u32 instanceStride, u32 instanceBinding, u32 materialSet, FrameAllocator* frameAllocator = nullptr );
+	~DrawBatcher();
+
+	// Register state once, the returned ids go into MakeDrawKey.
+	u32 AddPipeline( VkPipeline pipeline, VkPipelineLayout layout );
+	u32 AddMaterial( VkDescriptorSet descriptorSet );
+	u32 AddMesh( const DrawMesh& mesh );
+
+	// Clears the previous frame's draws.
+	void Begin();
+	// Not thread safe. instanceData points to instanceStride bytes.
+	void Submit( u64 key, const void* instanceData );
+
+	// Sorts and merges the submitted draws and writes their instance data to ring, whose
+	// buffer Record binds at instanceBinding, so it needs VERTEX_BUFFER usage. Returns
+	// false if the ring's frame segment is too small, nothing is drawn then.
+	bool Build( GpuRingBuffer& ring );
+	// Same as above with the sort and the instance copy spread across the job system.
+	bool Build( JobSystem& jobSystem, GpuRingBuffer& ring );
+
+	// Records the draws from the last Build, binding state only when it changes.
+	void Record( VkCommandBuffer commandBuffer ) const;
+
+	const std::vector<DrawCommand>&	GetDrawCommands() const					{ return mDrawCommands; }
+	const DrawBatcherStats&			GetStats() const						{ return mStats; }
+
+private:
+	NONCOPYABLE(DrawBatcher);
+
+	struct DrawPipeline
+	{
+		VkPipeline			pipeline;
+		VkPipelineLayout	layout;
+	};
+
+	bool BuildDraws( JobSystem* jobSystem, GpuRingBuffer& ring );
+
+private:
+	u32								mInstanceStride;
+	u32								mInstanceBinding;
+	u32								mMaterialSet;
+
+	std::vector<DrawPipeline>		mPipelines;
+	std::vector<VkDescriptorSet>	mMaterials;
+	std::vector<DrawMesh>			mMeshes;
+
+	// Per submitted draw, in submit order until sorted
+	std::vector<u64>				mKeys;
+	std::vector<u32>				mItems;
+	std::vector<u8>					mInstanceData;
+
+	RadixSorter						mSorter;
+	std::vector<DrawCommand>		mDrawCommands;
+	VkBuffer						mInstanceBuffer = VK_NULL_HANDLE;
+	VkDeviceSize					mInstanceOffset = 0;
+	DrawBatcherStats				mStats;
+};
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_DRAW_BATCHER_H__
@@ -0,0 +1,67 @@
+#ifndef ENGINE_GRAPHICS_DRAW_KEY_H__
+#define ENGINE_GRAPHICS_DRAW_KEY_H__
+//======================================================================================
+// Filename: DrawKey.h
+// Description: The 64-bit sort key DrawBatcher orders a frame's draws by. Kept apart
+//				from DrawBatcher so code without Vulkan can build and sort keys.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+// Key layout from the top bit down: pipeline | material | mesh | depth, so the sort
+// minimises the most expensive state changes first.
+constexpr u32 kDrawKeyDepthBits				= 20;
+constexpr u32 kDrawKeyMeshBits				= 16;
+constexpr u32 kDrawKeyMaterialBits			= 16;
+constexpr u32 kDrawKeyPipelineBits			= 12;
+
+constexpr u32 kDrawKeyMeshShift				= kDrawKeyDepthBits;
+constexpr u32 kDrawKeyMaterialShift			= kDrawKeyMeshShift + kDrawKeyMeshBits;
+constexpr u32 kDrawKeyPipelineShift			= kDrawKeyMaterialShift + kDrawKeyMaterialBits;
+
+static_assert(kDrawKeyPipelineShift + kDrawKeyPipelineBits == 64, "[DrawBatcher] Draw key fields must fill 64 bits!");
+
+//======================================================================================
+// Functions
+//======================================================================================
+
+// Each id must fit its field, depth is clamped to [0, 1] and sorts front to back
+inline u64 MakeDrawKey(u32 pipeline, u32 material, u32 mesh, f32 depth)
+{
+	ASSERT(pipeline < (1u << kDrawKeyPipelineBits), "[DrawBatcher] Pipeline id %u does not fit the draw key!", pipeline);
+	ASSERT(material < (1u << kDrawKeyMaterialBits), "[DrawBatcher] Material id %u does not fit the draw key!", material);
+	ASSERT(mesh < (1u << kDrawKeyMeshBits), "[DrawBatcher] Mesh id %u does not fit the draw key!", mesh);
+
+	//Masked too, so an id that doesn't fit can't spill into the field above it
+	const f32 clampedDepth = (depth > 0.0f) ? ((depth < 1.0f) ? depth : 1.0f) : 0.0f;
+	const u64 quantizedDepth = static_cast<u64>(clampedDepth * ((1u << kDrawKeyDepthBits) - 1));
+	return (static_cast<u64>(pipeline & ((1u << kDrawKeyPipelineBits) - 1)) << kDrawKeyPipelineShift)
+		| (static_cast<u64>(material & ((1u << kDrawKeyMaterialBits) - 1)) << kDrawKeyMaterialShift)
+		| (static_cast<u64>(mesh & ((1u << kDrawKeyMeshBits) - 1)) << kDrawKeyMeshShift)
+		| quantizedDepth;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Draws with the same key above the depth bits can share one instanced draw
+inline u64 GetDrawBatchKey(u64 key)
+{
+	return key >> kDrawKeyMeshShift;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline u32 GetDrawKeyField(u64 key, u32 shift, u32 bits)
+{
+	return static_cast<u32>(key >> shift) & ((1u << bits) - 1);
+}
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_DRAW_KEY_H__
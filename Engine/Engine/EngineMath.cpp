@@ -1,29 +0,0 @@
-//======================================================================================
-// Filename: EngineMath.cpp
-// Description:
-//======================================================================================
-
-//======================================================================================
-// Includes
-//======================================================================================
-#include "EngineMath.h"
-
-namespace Math
-{
-
-//======================================================================================
-// Constants
-//======================================================================================
-
-const f32 kPi = 3.14159265358979f;
-const f32 kTwoPi = 6.28318530717958f;
-const f32 kPiByTwo = 1.57079632679489f;
-const f32 kRootTwo = 1.41421356237309f;
-const f32 kRootThree = 1.73205080756887f;
-const f32 kDegToRad = kPi / 180.0f;
-const f32 kRadToDeg = 180.0f / kPi;
-
-
-}
-
-
@@ -7,7 +7,13 @@
 //======================================================================================
 #include "Vector2.h"
 #include "Vector3.h"
+#include "Vector3d.h"
+#include "Vector4.h"
+#include "VecReg.h"
 #include "Matrix.h"
+#include "Matrix34.h"
+#include "Matrix34d.h"
+#include "Quaternion.h"
 
 namespace Math
 {
@@ -17,7 +23,7 @@ namespace Math
 //======================================================================================
 
 template <typename T> 
-inline T Min(T a, T b)
+constexpr T Min(T a, T b)
 {
 	return (a > b) ? b : a;
 }
@@ -25,7 +31,7 @@ inline T Min(T a, T b)
 //--------------------------------------------------------------------------------------
 
 template <typename T>
-inline T Max(T a, T b)
+constexpr T Max(T a, T b)
 {
 	return (a > b) ? a : b;
 }
@@ -33,88 +39,236 @@ inline T Max(T a, T b)
 //--------------------------------------------------------------------------------------
 
 template <typename T> 
-inline T Clamp(T value, T min, T max)
+constexpr T Clamp(T value, T min, T max)
 {
 	return Max(min, Min(max, value));
 }
 
 //--------------------------------------------------------------------------------------
 
-inline f32 Abs(f32 value)
+constexpr f32 Abs(f32 value)
 {
 	return (value >= 0.0f) ? value : -value;
 }
 
 //--------------------------------------------------------------------------------------
 
-inline f32 Sign(f32 value)
+constexpr f32 Sign(f32 value)
 {
 	return (value > 0.0f) ? 1.0f : -1.0f;
 }
 
 //--------------------------------------------------------------------------------------
 
-inline f32 Sqr(f32 value)
+constexpr f32 Sqr(f32 value)
 {
 	return value * value;
 }
 
 //--------------------------------------------------------------------------------------
 
-inline f32 Sqrt(f32 value)
+namespace Internal
 {
+// Starting estimate for 1/sqrt(value), about 12 bits
+inline f32 RSqrtEstimate(f32 value)
+{
+#if MATH_SIMD_SSE4
+	//Broadcast rather than _mm_set_ss, which merges into whatever register it lands in
+	//and makes every call wait on the last one that wrote it
+	return _mm_cvtss_f32(_mm_rsqrt_ps(_mm_set1_ps(value)));
+#else
 	//https://en.wikipedia.org/wiki/Fast_inverse_square_root
-	const f32 threehalfs = 1.5f;
+	u32 i;
+	memcpy(&i, &value, sizeof(i));
+	i = 0x5f375a86 - (i >> 1);
+	f32 y;
+	memcpy(&y, &i, sizeof(y));
+	return y;
+#endif //MATH_SIMD_SSE4
+}
 
-	f32 x2 = value * 0.5F;
-	f32 y = value;
-	u32 i = *(u32*)&y;
-	i = 0x5f3759df - (i >> 1);              
-	y = *(f32 *)&i;
-	y = y * (threehalfs - (x2 * y * y));  
-										   
+//--------------------------------------------------------------------------------------
 
-	return y;
+inline f32 RSqrtNewtonStep(f32 value, f32 y)
+{
+	return y * (1.5f - (0.5f * value * y * y));
+}
+} // namespace Internal
+
+//--------------------------------------------------------------------------------------
+
+inline f32 RSqrt(f32 value, Precision precision)
+{
+	assert(value > 0.0f && "[Math] Cannot find the inverse square root of a non positive number!");
+	switch (precision)
+	{
+	case Precision::High:
+		return Internal::RSqrtNewtonStep(value, Internal::RSqrtNewtonStep(value, Internal::RSqrtEstimate(value)));
+	case Precision::Low:
+		return Internal::RSqrtNewtonStep(value, Internal::RSqrtEstimate(value));
+	default:
+		return 1.0f / std::sqrt(value);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 Sqrt(f32 value, Precision)
+{
+	return std::sqrt(value);
+}
+
+//--------------------------------------------------------------------------------------
+
+namespace Internal
+{
+// pi / 2 split so that quadrant * kSinCosPiByTwoHi and quadrant * kSinCosPiByTwoMid are
+// exact for the quadrant counts we care about (Cody-Waite reduction)
+inline constexpr f32 kSinCosTwoByPi			= 0.636619772367581f;
+inline constexpr f32 kSinCosPiByTwoHi		= 1.5703125f;
+inline constexpr f32 kSinCosPiByTwoMid		= 4.837512969970703125e-4f;
+inline constexpr f32 kSinCosPiByTwoLo		= 7.54978995489188216e-8f;
+// Largest quadrant count the reduction handles. The error of the split products reaches
+// 0.5 there, and a little past it an f32 angle has no fraction left to reduce.
+inline constexpr f32 kSinCosMaxQuadrant		= 8388608.0f;
+
+// Minimax polynomials for |x| <= pi / 4 (Cephes sinf / cosf)
+inline constexpr f32 kSinCoefficient0		= -1.6666654611e-1f;
+inline constexpr f32 kSinCoefficient1		= 8.3321608736e-3f;
+inline constexpr f32 kSinCoefficient2		= -1.9515295891e-4f;
+inline constexpr f32 kCosCoefficient0		= 4.166664568298827e-2f;
+inline constexpr f32 kCosCoefficient1		= -1.388731625493765e-3f;
+inline constexpr f32 kCosCoefficient2		= 2.443315711809948e-5f;
+
+//--------------------------------------------------------------------------------------
+
+// Returns the quadrant of rad and writes rad - quadrant * pi / 2 to x
+inline s32 SinCosReduce(f32 rad, f32& x)
+{
+	//Angles too large to reduce, inf and NaN use quadrant 0 so the conversion stays
+	//defined, and get all bits of x set, a NaN. Done on the bits since Clamp or a
+	//select keeps loops over SinCos from vectorizing.
+	const f32 scaled = rad * kSinCosTwoByPi;
+	const u32 unreducible = 0u - static_cast<u32>(!(std::fabs(scaled) <= kSinCosMaxQuadrant));
+	u32 bits;
+	memcpy(&bits, &scaled, sizeof(bits));
+	bits &= ~unreducible;
+	f32 reducible;
+	memcpy(&reducible, &bits, sizeof(reducible));
+
+	const s32 quadrant = static_cast<s32>(reducible + std::copysign(0.5f, reducible));
+	const f32 q = static_cast<f32>(quadrant);
+	x = ((rad - (q * kSinCosPiByTwoHi)) - (q * kSinCosPiByTwoMid)) - (q * kSinCosPiByTwoLo);
+	memcpy(&bits, &x, sizeof(bits));
+	bits |= unreducible;
+	memcpy(&x, &bits, sizeof(x));
+	return quadrant;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 SinPolynomial(f32 x, f32 x2)
+{
+	return x + (x * x2 * (kSinCoefficient0 + (x2 * (kSinCoefficient1 + (x2 * kSinCoefficient2)))));
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 CosPolynomial(f32 x2)
+{
+	return 1.0f - (0.5f * x2) + (x2 * x2 * (kCosCoefficient0 + (x2 * (kCosCoefficient1 + (x2 * kCosCoefficient2)))));
+}
+
+//--------------------------------------------------------------------------------------
+
+// b if bit 0 of swap is set, else a, negated if bit 1 of negate is set. Done on the bits
+// since the quadrant of a stream of angles is random and a branch on it mispredicts.
+inline f32 QuadrantSelect(f32 a, f32 b, s32 swap, s32 negate)
+{
+	u32 aBits, bBits;
+	memcpy(&aBits, &a, sizeof(aBits));
+	memcpy(&bBits, &b, sizeof(bBits));
+	const u32 mask = 0u - static_cast<u32>(swap & 1);
+	const u32 bits = ((aBits & ~mask) | (bBits & mask)) ^ (static_cast<u32>(negate & 2) << 30);
+	f32 result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+} // namespace Internal
+
+//--------------------------------------------------------------------------------------
+
+inline void SinCos(f32 rad, f32& sin, f32& cos)
+{
+	f32 x;
+	const s32 quadrant = Internal::SinCosReduce(rad, x);
+	const f32 x2 = x * x;
+	const f32 s = Internal::SinPolynomial(x, x2);
+	const f32 c = Internal::CosPolynomial(x2);
+
+	//Quadrants 0 to 3 give (s, c), (c, -s), (-s, -c) and (-c, s)
+	sin = Internal::QuadrantSelect(s, c, quadrant, quadrant);
+	cos = Internal::QuadrantSelect(c, s, quadrant, quadrant + 1);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 Sin(f32 rad)
+{
+	f32 x;
+	const s32 quadrant = Internal::SinCosReduce(rad, x);
+	const f32 x2 = x * x;
+	return Internal::QuadrantSelect(Internal::SinPolynomial(x, x2), Internal::CosPolynomial(x2), quadrant, quadrant);
 }
 
 //--------------------------------------------------------------------------------------
 
-bool Compare(f32 a, f32 b, f32 epsilon)
+inline f32 Cos(f32 rad)
+{
+	f32 x;
+	const s32 quadrant = Internal::SinCosReduce(rad, x);
+	const f32 x2 = x * x;
+	return Internal::QuadrantSelect(Internal::CosPolynomial(x2), Internal::SinPolynomial(x, x2), quadrant, quadrant + 1);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr bool Compare(f32 a, f32 b, f32 epsilon)
 {
 	return Abs(a - b) < epsilon;
 }
 
 //--------------------------------------------------------------------------------------
 
-bool IsZero(f32 value)
+constexpr bool IsZero(f32 value)
 {
 	return Compare(value, 0.0f);
 }
 
 //--------------------------------------------------------------------------------------
 
-bool IsZero(const Vector2 & v)
+constexpr bool IsZero(const Vector2& v)
 {
 	return IsZero(v.x) && IsZero(v.y);
 }
 
 //--------------------------------------------------------------------------------------
 
-bool IsZero(const Vector3 & v)
+constexpr bool IsZero(const Vector3& v)
 {
 	return IsZero(v.x) && IsZero(v.y) && IsZero(v.z);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline f32 MagnitudeSqr(const Vector2 &v)
+constexpr f32 MagnitudeSqr(const Vector2 &v)
 {
 	return Sqr(v.x) + Sqr(v.y);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline f32 MagnitudeSqr(const Vector3& v)
+constexpr f32 MagnitudeSqr(const Vector3& v)
 {
 	return Sqr(v.x) + Sqr(v.y) + Sqr(v.z);
 }
@@ -135,7 +289,7 @@ inline f32 Magnitude(const Vector3& v)
 
 //--------------------------------------------------------------------------------------
 
-inline f32 MagnitudeXZSqr(const Vector3& v)
+constexpr f32 MagnitudeXZSqr(const Vector3& v)
 {
 	return (v.x * v.x) + (v.z * v.z);
 }
@@ -149,30 +303,30 @@ inline f32 MagnitudeXZ(const Vector3& v)
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2 Normalize(const Vector2& v)
+inline Vector2 Normalize(const Vector2& v, Precision precision)
 {
-	return Vector2::Zero();
+	assert(!IsZero(v) && "[Math] Cannot normalize the zero vector");
+	return v * RSqrt(MagnitudeSqr(v), precision);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 Normalize(const Vector3& v)
+inline Vector3 Normalize(const Vector3& v, Precision precision)
 {
 	assert(!IsZero(v) && "[Math] Cannot normalize the zero vector");
-	const f32 inv = 1.0f / Magnitude(v);
-	return v * inv;
+	return v * RSqrt(MagnitudeSqr(v), precision);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline f32 DistanceSqr(const Vector2& a, const Vector2& b)
+constexpr f32 DistanceSqr(const Vector2& a, const Vector2& b)
 {
 	return MagnitudeSqr(a - b);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline f32 DistanceSqr(const Vector3& a, const Vector3& b)
+constexpr f32 DistanceSqr(const Vector3& a, const Vector3& b)
 {
 	return MagnitudeSqr(a - b);
 }
@@ -193,7 +347,7 @@ inline f32 Distance(const Vector3& a, const Vector3& b)
 
 //--------------------------------------------------------------------------------------
 
-inline f32 DistanceXZSqr(const Vector3& a, const Vector3& b)
+constexpr f32 DistanceXZSqr(const Vector3& a, const Vector3& b)
 {
 	return MagnitudeXZSqr(a - b);
 }
@@ -207,14 +361,14 @@ inline f32 DistanceXZ(const Vector3& a, const Vector3& b)
 
 //--------------------------------------------------------------------------------------
 
-inline f32 Dot(const Vector3& a, const Vector3& b)
+constexpr f32 Dot(const Vector3& a, const Vector3& b)
 {
 	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 Cross(const Vector3& a, const Vector3& b)
+constexpr Vector3 Cross(const Vector3& a, const Vector3& b)
 {
 	return Vector3
 	(
@@ -226,49 +380,72 @@ inline Vector3 Cross(const Vector3& a, const Vector3& b)
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 Project(const Vector3& v, const Vector3& n)
+constexpr Vector3 Project(const Vector3& v, const Vector3& n)
 {
 	return n * (Dot(v, n) / Dot(n, n));
 }
 
 //--------------------------------------------------------------------------------------
 
-inline f32 Determinant(const Matrix& m)
+constexpr f32 Determinant(const Matrix& m)
 {
-	f32 det = 0.0f;
-	det += (m._11) * ((m._22 * m._33 * m._44) + (m._32 * m._43 * m._21) + (m._42 * m._23 * m._34) - (m._42 * m._33 * m._24) - (m._22 * m._43 * m._34) - (m._44 * m._23 * m._32));
-	det -= (m._12) * ((m._21 * m._33 * m._44) + (m._34 * m._43 * m._21) + (m._41 * m._23 * m._34) - (m._42 * m._33 * m._41) - (m._34 * m._43 * m._21) - (m._44 * m._23 * m._31));
-	det += (m._13) * ((m._21 * m._32 * m._44) + (m._31 * m._44 * m._21) + (m._41 * m._22 * m._34) - (m._42 * m._32 * m._41) - (m._34 * m._42 * m._21) - (m._44 * m._22 * m._31));
-	det -= (m._14) * ((m._21 * m._32 * m._43) + (m._31 * m._44 * m._23) + (m._41 * m._22 * m._33) - (m._23 * m._32 * m._41) - (m._33 * m._42 * m._21) - (m._43 * m._22 * m._31));
-	return det;
+	//Laplace expansion over the 2x2 minors of the top and bottom row pairs
+	const f32 s0 = m._11 * m._22 - m._21 * m._12;
+	const f32 s1 = m._11 * m._23 - m._21 * m._13;
+	const f32 s2 = m._11 * m._24 - m._21 * m._14;
+	const f32 s3 = m._12 * m._23 - m._22 * m._13;
+	const f32 s4 = m._12 * m._24 - m._22 * m._14;
+	const f32 s5 = m._13 * m._24 - m._23 * m._14;
+
+	const f32 c5 = m._33 * m._44 - m._43 * m._34;
+	const f32 c4 = m._32 * m._44 - m._42 * m._34;
+	const f32 c3 = m._32 * m._43 - m._42 * m._33;
+	const f32 c2 = m._31 * m._44 - m._41 * m._34;
+	const f32 c1 = m._31 * m._43 - m._41 * m._33;
+	const f32 c0 = m._31 * m._42 - m._41 * m._32;
+
+	return (s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) - (s4 * c1) + (s5 * c0);
 }
 
 //--------------------------------------------------------------------------------------
 
-//@ToCheck: This matrix my be transposed...
-inline Matrix Adjoint(const Matrix& m)
+constexpr Matrix Adjoint(const Matrix& m)
 {
+	const f32 s0 = m._11 * m._22 - m._21 * m._12;
+	const f32 s1 = m._11 * m._23 - m._21 * m._13;
+	const f32 s2 = m._11 * m._24 - m._21 * m._14;
+	const f32 s3 = m._12 * m._23 - m._22 * m._13;
+	const f32 s4 = m._12 * m._24 - m._22 * m._14;
+	const f32 s5 = m._13 * m._24 - m._23 * m._14;
+
+	const f32 c5 = m._33 * m._44 - m._43 * m._34;
+	const f32 c4 = m._32 * m._44 - m._42 * m._34;
+	const f32 c3 = m._32 * m._43 - m._42 * m._33;
+	const f32 c2 = m._31 * m._44 - m._41 * m._34;
+	const f32 c1 = m._31 * m._43 - m._41 * m._33;
+	const f32 c0 = m._31 * m._42 - m._41 * m._32;
+
 	return Matrix
 	(
-		(m._22 * ((m._33 * m._44) - (m._43 * m._34)) - m._23 * ((m._32 * m._44) - (m._42 * m._34)) + m._24 * ((m._32 * m._43) - (m._42 * m._33))),
-		-(m._12 * ((m._33 * m._44) - (m._43 * m._34)) - m._13 * ((m._32 * m._44) - (m._42 * m._34)) + m._14 * ((m._32 * m._43) - (m._42 * m._33))),
-		(m._12 * ((m._23 * m._44) - (m._43 * m._24)) - m._13 * ((m._22 * m._44) - (m._42 * m._24)) + m._14 * ((m._22 * m._43) - (m._42 * m._23))),
-		-(m._12 * ((m._23 * m._34) - (m._33 * m._24)) - m._13 * ((m._22 * m._34) - (m._32 * m._24)) + m._14 * ((m._22 * m._33) - (m._32 * m._23))),
-
-		-(m._21 * ((m._33 * m._44) - (m._43 * m._34)) - m._31 * ((m._23 * m._44) - (m._24 * m._43)) + m._41 * ((m._23 * m._34) - (m._24 * m._33))),
-		(m._11 * ((m._33 * m._44) - (m._43 * m._34)) - m._13 * ((m._31 * m._44) - (m._41 * m._34)) + m._14 * ((m._31 * m._43) - (m._41 * m._33))),
-		-(m._11 * ((m._23 * m._44) - (m._43 * m._24)) - m._13 * ((m._21 * m._44) - (m._41 * m._24)) + m._14 * ((m._21 * m._43) - (m._41 * m._23))),
-		(m._11 * ((m._23 * m._34) - (m._33 * m._24)) - m._13 * ((m._21 * m._34) - (m._31 * m._24)) + m._14 * ((m._21 * m._33) - (m._31 * m._23))),
-
-		(m._21 * ((m._32 * m._44) - (m._42 * m._34)) - m._31 * ((m._22 * m._44) - (m._42 * m._24)) + m._41 * ((m._22 * m._34) - (m._32 * m._24))),
-		-(m._11 * ((m._32 * m._44) - (m._42 * m._34)) - m._31 * ((m._12 * m._44) - (m._42 * m._14)) + m._41 * ((m._12 * m._34) - (m._32 * m._14))),
-		(m._11 * ((m._22 * m._44) - (m._42 * m._24)) - m._12 * ((m._21 * m._44) - (m._41 * m._24)) + m._14 * ((m._21 * m._42) - (m._41 * m._22))),
-		-(m._11 * ((m._22 * m._34) - (m._32 * m._24)) - m._21 * ((m._12 * m._34) - (m._32 * m._14)) + m._31 * ((m._12 * m._24) - (m._22 * m._14))),
-
-		-(m._21 * ((m._32 * m._43) - (m._42 * m._33)) - m._31 * ((m._22 * m._43) - (m._42 * m._23)) + m._41 * ((m._22 * m._33) - (m._32 * m._23))),
-		(m._11 * ((m._32 * m._43) - (m._42 * m._33)) - m._12 * ((m._31 * m._43) - (m._41 * m._33)) + m._13 * ((m._31 * m._42) - (m._41 * m._32))),
-		-(m._11 * ((m._22 * m._43) - (m._42 * m._23)) - m._12 * ((m._21 * m._43) - (m._41 * m._23)) + m._13 * ((m._21 * m._42) - (m._41 * m._22))),
-		(m._11 * ((m._22 * m._33) - (m._32 * m._23)) - m._12 * ((m._21 * m._33) - (m._31 * m._23)) + m._13 * ((m._21 * m._32) - (m._31 * m._22)))
+		 m._22 * c5 - m._23 * c4 + m._24 * c3,
+		-m._12 * c5 + m._13 * c4 - m._14 * c3,
+		 m._42 * s5 - m._43 * s4 + m._44 * s3,
+		-m._32 * s5 + m._33 * s4 - m._34 * s3,
+
+		-m._21 * c5 + m._23 * c2 - m._24 * c1,
+		 m._11 * c5 - m._13 * c2 + m._14 * c1,
+		-m._41 * s5 + m._43 * s2 - m._44 * s1,
+		 m._31 * s5 - m._33 * s2 + m._34 * s1,
+
+		 m._21 * c4 - m._22 * c2 + m._24 * c0,
+		-m._11 * c4 + m._12 * c2 - m._14 * c0,
+		 m._41 * s4 - m._42 * s2 + m._44 * s0,
+		-m._31 * s4 + m._32 * s2 - m._34 * s0,
+
+		-m._21 * c3 + m._22 * c1 - m._23 * c0,
+		 m._11 * c3 - m._12 * c1 + m._13 * c0,
+		-m._41 * s3 + m._42 * s1 - m._43 * s0,
+		 m._31 * s3 - m._32 * s1 + m._33 * s0
 	);
 }
 
@@ -276,65 +453,507 @@ inline Matrix Adjoint(const Matrix& m)
 
 inline Matrix Inverse(const Matrix& m)
 {
+#if MATH_SIMD_SSE4
+	//2x2 block inverse. Works on the column major storage as is since
+	//inverse(transpose(M)) == transpose(inverse(M)).
+	const f32* src = &m._11;
+	const __m128 c0 = SIMD::Load(src + 0);
+	const __m128 c1 = SIMD::Load(src + 4);
+	const __m128 c2 = SIMD::Load(src + 8);
+	const __m128 c3 = SIMD::Load(src + 12);
+
+	const __m128 A = _mm_movelh_ps(c0, c1);
+	const __m128 B = _mm_movehl_ps(c1, c0);
+	const __m128 C = _mm_movelh_ps(c2, c3);
+	const __m128 D = _mm_movehl_ps(c3, c2);
+
+	//(|A|, |B|, |C|, |D|)
+	const __m128 detSub = _mm_sub_ps
+	(
+		_mm_mul_ps(MATH_SHUFFLE(c0, c2, 0, 2, 0, 2), MATH_SHUFFLE(c1, c3, 1, 3, 1, 3)),
+		_mm_mul_ps(MATH_SHUFFLE(c0, c2, 1, 3, 1, 3), MATH_SHUFFLE(c1, c3, 0, 2, 0, 2))
+	);
+	const __m128 detA = MATH_SWIZZLE(detSub, 0, 0, 0, 0);
+	const __m128 detB = MATH_SWIZZLE(detSub, 1, 1, 1, 1);
+	const __m128 detC = MATH_SWIZZLE(detSub, 2, 2, 2, 2);
+	const __m128 detD = MATH_SWIZZLE(detSub, 3, 3, 3, 3);
+
+	const __m128 adjDC = SIMD::Mat2AdjMul(D, C);
+	const __m128 adjAB = SIMD::Mat2AdjMul(A, B);
+
+	__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), SIMD::Mat2Mul(B, adjDC));
+	__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), SIMD::Mat2Mul(C, adjAB));
+	__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), SIMD::Mat2MulAdj(D, adjAB));
+	__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), SIMD::Mat2MulAdj(A, adjDC));
+
+	//|M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128 trace = _mm_mul_ps(adjAB, MATH_SWIZZLE(adjDC, 0, 2, 1, 3));
+	trace = _mm_hadd_ps(trace, trace);
+	trace = _mm_hadd_ps(trace, trace);
+	const __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+	assert(!IsZero(_mm_cvtss_f32(detM)) && "[Math] Cannot find inverse of matrix. Determinant equals 0.0!");
+
+	const __m128 invDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+	X = _mm_mul_ps(X, invDetM);
+	Y = _mm_mul_ps(Y, invDetM);
+	Z = _mm_mul_ps(Z, invDetM);
+	W = _mm_mul_ps(W, invDetM);
+
+	Matrix result;
+	f32* dst = &result._11;
+	SIMD::Store(dst + 0, MATH_SHUFFLE(X, Y, 3, 1, 3, 1));
+	SIMD::Store(dst + 4, MATH_SHUFFLE(X, Y, 2, 0, 2, 0));
+	SIMD::Store(dst + 8, MATH_SHUFFLE(Z, W, 3, 1, 3, 1));
+	SIMD::Store(dst + 12, MATH_SHUFFLE(Z, W, 2, 0, 2, 0));
+	return result;
+#else
 	const f32 determinat = Determinant(m);
 	assert(!IsZero(determinat) && "[Math] Cannot find inverse of matrix. Determinant equals 0.0!");
 	const f32 invDet = 1.0f / determinat;
 	return Adjoint(m) * invDet;
+#endif //MATH_SIMD_SSE4
 }
 
 //--------------------------------------------------------------------------------------
 
 inline Matrix Transpose(const Matrix& m)
 {
+	//SSE4.1 only, the shuffles ran 1.1x the scalar code streamed and 2x in cache. With
+	//AVX2, GCC vectorizes the scalar code better than either hand written version.
+#if MATH_SIMD_SSE4 && !MATH_SIMD_AVX2
+	const f32* src = &m._11;
+	__m128 c0 = SIMD::Load(src + 0);
+	__m128 c1 = SIMD::Load(src + 4);
+	__m128 c2 = SIMD::Load(src + 8);
+	__m128 c3 = SIMD::Load(src + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	Matrix result;
+	f32* dst = &result._11;
+	SIMD::Store(dst + 0, c0);
+	SIMD::Store(dst + 4, c1);
+	SIMD::Store(dst + 8, c2);
+	SIMD::Store(dst + 12, c3);
+	return result;
+#else
 	return Matrix
 	(
-		m._11, m._12, m._13, m._14,
-		m._21, m._22, m._23, m._42,
-		m._31, m._32, m._33, m._34,
-		m._41, m._42, m._43, m._44
+		m._11, m._21, m._31, m._41,
+		m._12, m._22, m._32, m._42,
+		m._13, m._23, m._33, m._43,
+		m._14, m._24, m._34, m._44
+	);
+#endif //MATH_SIMD_SSE4 && !MATH_SIMD_AVX2
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3 TransformCoord(const Vector3& v, const Matrix& m)
+{
+	return Vector3
+	(
+		v.x * m._11 + v.y * m._12 + v.z * m._13 + m._14,
+		v.x * m._21 + v.y * m._22 + v.z * m._23 + m._24,
+		v.x * m._31 + v.y * m._32 + v.z * m._33 + m._34
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3 TransformNormal(const Vector3& v, const Matrix& m)
+{
+	return Vector3
+	(
+		v.x * m._11 + v.y * m._12 + v.z * m._13,
+		v.x * m._21 + v.y * m._22 + v.z * m._23,
+		v.x * m._31 + v.y * m._32 + v.z * m._33
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Matrix34 Inverse(const Matrix34& m)
+{
+	//Rows of the inverse 3x3 are the cross products of the columns over the determinant
+	const Vector3 c0(m._11, m._21, m._31);
+	const Vector3 c1(m._12, m._22, m._32);
+	const Vector3 c2(m._13, m._23, m._33);
+	const Vector3 r0 = Cross(c1, c2);
+	const Vector3 r1 = Cross(c2, c0);
+	const Vector3 r2 = Cross(c0, c1);
+
+	const f32 determinant = Dot(c0, r0);
+	assert(!IsZero(determinant) && "[Math] Cannot find inverse of matrix. Determinant equals 0.0!");
+	const f32 invDet = 1.0f / determinant;
+
+	const Vector3 t(m._14, m._24, m._34);
+	return Matrix34
+	(
+		r0.x * invDet, r0.y * invDet, r0.z * invDet, -Dot(r0, t) * invDet,
+		r1.x * invDet, r1.y * invDet, r1.z * invDet, -Dot(r1, t) * invDet,
+		r2.x * invDet, r2.y * invDet, r2.z * invDet, -Dot(r2, t) * invDet
 	);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 TransformCoord(const Vector3& v, const Matrix& m)
+constexpr Matrix34 InverseOrthonormal(const Matrix34& m)
+{
+	return Matrix34
+	(
+		m._11, m._21, m._31, -((m._11 * m._14) + (m._21 * m._24) + (m._31 * m._34)),
+		m._12, m._22, m._32, -((m._12 * m._14) + (m._22 * m._24) + (m._32 * m._34)),
+		m._13, m._23, m._33, -((m._13 * m._14) + (m._23 * m._24) + (m._33 * m._34))
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3 TransformCoord(const Vector3& v, const Matrix34& m)
 {
 	return Vector3
 	(
-		v.x * m._11 + v.y * m._12 + v.z * m._14 + m._14,
-		v.x * m._21 + v.y * m._22 + v.z * m._24 + m._24,
-		v.x * m._31 + v.y * m._32 + v.z * m._34 + m._34 
+		v.x * m._11 + v.y * m._12 + v.z * m._13 + m._14,
+		v.x * m._21 + v.y * m._22 + v.z * m._23 + m._24,
+		v.x * m._31 + v.y * m._32 + v.z * m._33 + m._34
 	);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 TransformNormal(const Vector3& v, const Matrix& m)
+constexpr Vector3 TransformNormal(const Vector3& v, const Matrix34& m)
 {
 	return Vector3
 	(
-		v.x * m._11 + v.y * m._12 + v.z * m._14,
-		v.x * m._21 + v.y * m._22 + v.z * m._24,
-		v.x * m._31 + v.y * m._32 + v.z * m._34
+		v.x * m._11 + v.y * m._12 + v.z * m._13,
+		v.x * m._21 + v.y * m._22 + v.z * m._23,
+		v.x * m._31 + v.y * m._32 + v.z * m._33
 	);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2 Lerp(const Vector2& v0, const Vector2& v1, f32 t)
+constexpr Vector2 Lerp(const Vector2& v0, const Vector2& v1, f32 t)
+{
+	return v0 + ((v1 - v0) * t);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3 Lerp(const Vector3& v0, const Vector3& v1, f32 t)
 {
 	return v0 + ((v1 - v0) * t);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 Lerp(const Vector3& v0, const Vector3& v1, f32 t)
+constexpr f32 Dot(const Vector4& a, const Vector4& b)
+{
+	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z) + (a.w * b.w);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr f32 MagnitudeSqr(const Vector4& v)
+{
+	return Dot(v, v);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 Magnitude(const Vector4& v)
+{
+	return Sqrt(MagnitudeSqr(v));
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Vector4 Normalize(const Vector4& v, Precision precision)
+{
+	return v * RSqrt(MagnitudeSqr(v), precision);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Lerp(const Vector4& v0, const Vector4& v1, f32 t)
 {
 	return v0 + ((v1 - v0) * t);
 }
 
 //--------------------------------------------------------------------------------------
 
+constexpr Vector4 Transform(const Vector4& v, const Matrix& m)
+{
+	return Vector4
+	(
+		(m._11 * v.x) + (m._12 * v.y) + (m._13 * v.z) + (m._14 * v.w),
+		(m._21 * v.x) + (m._22 * v.y) + (m._23 * v.z) + (m._24 * v.w),
+		(m._31 * v.x) + (m._32 * v.y) + (m._33 * v.z) + (m._34 * v.w),
+		(m._41 * v.x) + (m._42 * v.y) + (m._43 * v.z) + (m._44 * v.w)
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 Dot(const VecReg& a, const VecReg& b)
+{
+#if MATH_SIMD_SSE4
+	return _mm_cvtss_f32(_mm_dp_ps(a.v, b.v, 0xF1));
+#else
+	return Dot(a.v, b.v);
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg Cross(const VecReg& a, const VecReg& b)
+{
+#if MATH_SIMD_SSE4
+	//a * b.yzx - a.yzx * b, then rotate back to xyz. w is a.w * b.w - a.w * b.w = 0
+	const __m128 aYZX = MATH_SWIZZLE(a.v, 1, 2, 0, 3);
+	const __m128 bYZX = MATH_SWIZZLE(b.v, 1, 2, 0, 3);
+	const __m128 c = _mm_sub_ps(_mm_mul_ps(a.v, bYZX), _mm_mul_ps(aYZX, b.v));
+	return VecReg(MATH_SWIZZLE(c, 1, 2, 0, 3));
+#else
+	return VecReg(Cross(a.v.ToVector3(), b.v.ToVector3()));
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 MagnitudeSqr(const VecReg& v)
+{
+	return Dot(v, v);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 Magnitude(const VecReg& v)
+{
+	return Sqrt(MagnitudeSqr(v));
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg Normalize(const VecReg& v, Precision precision)
+{
+#if MATH_SIMD_SSE4
+	//Keep the length splatted in a register rather than going through a scalar
+	const __m128 magnitudeSqr = _mm_dp_ps(v.v, v.v, 0xFF);
+	if (precision == Precision::Exact)
+	{
+		return VecReg(_mm_div_ps(v.v, _mm_sqrt_ps(magnitudeSqr)));
+	}
+
+	const __m128 half = _mm_mul_ps(magnitudeSqr, _mm_set1_ps(0.5f));
+	__m128 y = _mm_rsqrt_ps(magnitudeSqr);
+	for (int step = (precision == Precision::High) ? 2 : 1; step > 0; --step)
+	{
+		y = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, _mm_mul_ps(y, y))));
+	}
+	return VecReg(_mm_mul_ps(v.v, y));
+#else
+	return VecReg(Normalize(v.v, precision));
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg Lerp(const VecReg& v0, const VecReg& v1, f32 t)
+{
+#if MATH_SIMD_SSE4
+	return VecReg(SIMD::MulAdd(_mm_sub_ps(v1.v, v0.v), _mm_set1_ps(t), v0.v));
+#else
+	return VecReg(Lerp(v0.v, v1.v, t));
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg Transform(const VecReg& v, const Matrix& m)
+{
+#if MATH_SIMD_SSE4
+	//Linear combination of the columns
+	const f32* p = &m._11;
+	__m128 result = _mm_mul_ps(SIMD::Load(p + 12), MATH_SWIZZLE(v.v, 3, 3, 3, 3));
+	result = SIMD::MulAdd(SIMD::Load(p + 8), MATH_SWIZZLE(v.v, 2, 2, 2, 2), result);
+	result = SIMD::MulAdd(SIMD::Load(p + 4), MATH_SWIZZLE(v.v, 1, 1, 1, 1), result);
+	result = SIMD::MulAdd(SIMD::Load(p + 0), MATH_SWIZZLE(v.v, 0, 0, 0, 0), result);
+	return VecReg(result);
+#else
+	return VecReg(Transform(v.v, m));
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr f64 Dot(const Vector3d& a, const Vector3d& b)
+{
+	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr f64 MagnitudeSqr(const Vector3d& v)
+{
+	return Dot(v, v);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f64 Magnitude(const Vector3d& v)
+{
+	return std::sqrt(MagnitudeSqr(v));
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr f64 DistanceSqr(const Vector3d& a, const Vector3d& b)
+{
+	return MagnitudeSqr(a - b);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f64 Distance(const Vector3d& a, const Vector3d& b)
+{
+	return Magnitude(a - b);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d Lerp(const Vector3d& v0, const Vector3d& v1, f64 t)
+{
+	return v0 + ((v1 - v0) * t);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d TransformCoord(const Vector3d& v, const Matrix34d& m)
+{
+	return Vector3d
+	(
+		v.x * m._11 + v.y * m._12 + v.z * m._13 + m._14,
+		v.x * m._21 + v.y * m._22 + v.z * m._23 + m._24,
+		v.x * m._31 + v.y * m._32 + v.z * m._33 + m._34
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3 ToCameraRelative(const Vector3d& position, const Vector3d& camera)
+{
+	return (position - camera).ToVector3();
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34 ToCameraRelative(const Matrix34d& m, const Vector3d& camera)
+{
+	return Matrix34
+	(
+		static_cast<f32>(m._11), static_cast<f32>(m._12), static_cast<f32>(m._13), static_cast<f32>(m._14 - camera.x),
+		static_cast<f32>(m._21), static_cast<f32>(m._22), static_cast<f32>(m._23), static_cast<f32>(m._24 - camera.y),
+		static_cast<f32>(m._31), static_cast<f32>(m._32), static_cast<f32>(m._33), static_cast<f32>(m._34 - camera.z)
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr f32 Dot(const Quaternion& a, const Quaternion& b)
+{
+	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z) + (a.w * b.w);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr f32 MagnitudeSqr(const Quaternion& q)
+{
+	return Dot(q, q);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 Magnitude(const Quaternion& q)
+{
+	return Sqrt(MagnitudeSqr(q));
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Quaternion Normalize(const Quaternion& q, Precision precision)
+{
+	return q * RSqrt(MagnitudeSqr(q), precision);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Quaternion Conjugate(const Quaternion& q)
+{
+	return Quaternion(-q.x, -q.y, -q.z, q.w);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Quaternion Inverse(const Quaternion& q)
+{
+	const f32 magnitudeSqr = MagnitudeSqr(q);
+	assert(!IsZero(magnitudeSqr) && "[Math] Cannot find inverse of the zero quaternion!");
+	return Conjugate(q) * (1.0f / magnitudeSqr);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Vector3 Rotate(const Vector3& v, const Quaternion& q)
+{
+	//v + 2w(u x v) + 2u x (u x v), q must be unit length
+	const Vector3 u(q.x, q.y, q.z);
+	const Vector3 t = Cross(u, v) * 2.0f;
+	return v + (t * q.w) + Cross(u, t);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline void ToAxisAngle(const Quaternion& q, Vector3& axis, f32& rad)
+{
+	//atan2 keeps full precision for small angles where acos(w) does not
+	const Vector3 v(q.x, q.y, q.z);
+	const f32 sinHalfAngle = Magnitude(v);
+	rad = 2.0f * atan2(sinHalfAngle, q.w);
+	axis = (sinHalfAngle > 0.0f) ? v * (1.0f / sinHalfAngle) : Vector3::XAxis();
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, f32 t)
+{
+	const f32 t1 = (Dot(q0, q1) < 0.0f) ? -t : t;
+	return Normalize((q0 * (1.0f - t)) + (q1 * t1));
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, f32 t)
+{
+	f32 cosTheta = Dot(q0, q1);
+	const f32 sign = (cosTheta < 0.0f) ? -1.0f : 1.0f;
+	cosTheta *= sign;
+
+	//sin(theta) goes to 0 as the rotations converge, fall back to a straight blend
+	if (cosTheta > 0.9995f)
+	{
+		return Nlerp(q0, q1, t);
+	}
+
+	const f32 theta = acos(cosTheta);
+	const f32 invSinTheta = 1.0f / sin(theta);
+	const f32 c0 = sin((1.0f - t) * theta) * invSinTheta;
+	const f32 c1 = sin(t * theta) * invSinTheta * sign;
+	return (q0 * c0) + (q1 * c1);
+}
+
+//--------------------------------------------------------------------------------------
+
 
 } // namespace math
 
@@ -0,0 +1,379 @@
+//======================================================================================
+// Filename: EntityWorld.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "EntityWorld.h"
+
+#include <atomic>
+#include <cstring>
+#include <malloc.h>
+//======================================================================================
+
+namespace
+{
+
+//======================================================================================
+// Component Registry
+//======================================================================================
+
+ComponentInfo _componentInfos[kMaxComponentTypes];
+std::atomic<u32> _componentCount = { 0 };
+
+//--------------------------------------------------------------------------------------
+
+inline u32 AlignUp(u32 value, u32 alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+//--------------------------------------------------------------------------------------
+
+// Every array starts on its own 16 byte boundary so SIMD loops can use aligned loads
+inline u32 GetArrayAlignment(u32 componentId)
+{
+	const u32 alignment = GetComponentInfo(componentId).alignment;
+	return (alignment > 16) ? alignment : 16;
+}
+
+} // namespace
+
+//======================================================================================
+// Component Types
+//======================================================================================
+
+u32 RegisterComponent(u32 size, u32 alignment)
+{
+	ASSERT(alignment <= kEntityChunkAlignment, "[EntityWorld] Component alignment above %zu is not supported!", kEntityChunkAlignment);
+
+	const u32 id = _componentCount.fetch_add(1);
+	ASSERT(id < kMaxComponentTypes, "[EntityWorld] More than %u component types!", kMaxComponentTypes);
+	_componentInfos[id].size = size;
+	_componentInfos[id].alignment = alignment;
+	return id;
+}
+
+//--------------------------------------------------------------------------------------
+
+const ComponentInfo& GetComponentInfo(u32 componentId)
+{
+	ASSERT(componentId < _componentCount.load(), "[EntityWorld] Unknown component id %u!", componentId);
+	return _componentInfos[componentId];
+}
+
+//======================================================================================
+// Class EntityWorld
+//======================================================================================
+
+EntityWorld::EntityWorld()
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+EntityWorld::~EntityWorld()
+{
+	for (EntityArchetype* archetype : mArchetypes)
+	{
+		for (u8* chunk : archetype->chunks)
+		{
+			_aligned_free(chunk);
+		}
+		SAVE_DELETE(archetype);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+Entity EntityWorld::CreateEntity(ComponentMask mask)
+{
+	ASSERT(!mIsIterating, "[EntityWorld] Structural change during a query!");
+
+	Entity entity;
+	if (!mFreeIndices.empty())
+	{
+		entity.index = mFreeIndices.back();
+		mFreeIndices.pop_back();
+	}
+	else
+	{
+		entity.index = static_cast<u32>(mRecords.size());
+		mRecords.emplace_back();
+	}
+
+	EntityRecord& record = mRecords[entity.index];
+	entity.generation = record.generation;
+
+	EntityArchetype* archetype = GetArchetype(mask);
+	record.archetype = archetype;
+	record.row = AddRow(*archetype, entity);
+	for (u32 componentId : archetype->componentIds)
+	{
+		memset(GetRow(*archetype, record.row, componentId), 0, GetComponentInfo(componentId).size);
+	}
+
+	++mEntityCount;
+	return entity;
+}
+
+//--------------------------------------------------------------------------------------
+
+void EntityWorld::DestroyEntity(Entity entity)
+{
+	ASSERT(!mIsIterating, "[EntityWorld] Structural change during a query!");
+	ASSERT(IsAlive(entity), "[EntityWorld] Destroying a dead entity!");
+
+	EntityRecord& record = mRecords[entity.index];
+	RemoveRow(*record.archetype, record.row);
+	record.archetype = nullptr;
+	++record.generation;
+	mFreeIndices.push_back(entity.index);
+	--mEntityCount;
+}
+
+//--------------------------------------------------------------------------------------
+
+bool EntityWorld::IsAlive(Entity entity) const
+{
+	return entity.index < mRecords.size() && mRecords[entity.index].generation == entity.generation && nullptr != mRecords[entity.index].archetype;
+}
+
+//--------------------------------------------------------------------------------------
+
+void* EntityWorld::AddComponent(Entity entity, u32 componentId)
+{
+	ASSERT(IsAlive(entity), "[EntityWorld] Adding a component to a dead entity!");
+
+	const EntityRecord& record = mRecords[entity.index];
+	const ComponentMask bit = 1ull << componentId;
+	if ((record.archetype->mask & bit) == 0)
+	{
+		MoveEntity(entity, *GetArchetype(record.archetype->mask | bit));
+		memset(GetRow(*record.archetype, record.row, componentId), 0, GetComponentInfo(componentId).size);
+	}
+	return GetRow(*record.archetype, record.row, componentId);
+}
+
+//--------------------------------------------------------------------------------------
+
+void EntityWorld::RemoveComponent(Entity entity, u32 componentId)
+{
+	ASSERT(IsAlive(entity), "[EntityWorld] Removing a component from a dead entity!");
+
+	const EntityRecord& record = mRecords[entity.index];
+	const ComponentMask bit = 1ull << componentId;
+	if ((record.archetype->mask & bit) != 0)
+	{
+		MoveEntity(entity, *GetArchetype(record.archetype->mask & ~bit));
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void* EntityWorld::GetComponent(Entity entity, u32 componentId) const
+{
+	ASSERT(IsAlive(entity), "[EntityWorld] Reading a component of a dead entity!");
+
+	const EntityRecord& record = mRecords[entity.index];
+	if (record.archetype->offsets[componentId] == kComponentInvalid)
+	{
+		return nullptr;
+	}
+	return GetRow(*record.archetype, record.row, componentId);
+}
+
+//--------------------------------------------------------------------------------------
+
+void EntityWorld::RunSystems(JobSystem& jobSystem, Span<const EntitySystem> systems)
+{
+	ASSERT(!mIsIterating, "[EntityWorld] RunSystems from inside a query!");
+	mIsIterating = true;
+
+	size_t phaseBegin = 0;
+	while (phaseBegin < systems.size)
+	{
+		//Grow the phase while the next system doesn't write what the phase touches or
+		//touch what the phase writes. Only neighbours are grouped, so order is kept.
+		ComponentMask phaseReads = 0;
+		ComponentMask phaseWrites = 0;
+		size_t phaseEnd = phaseBegin;
+		for (; phaseEnd < systems.size; ++phaseEnd)
+		{
+			const EntitySystem& system = systems.data[phaseEnd];
+			const bool isConflict = ((system.writes & (phaseReads | phaseWrites)) != 0) || ((phaseWrites & system.reads) != 0);
+			if (isConflict)
+			{
+				break;
+			}
+			phaseReads |= system.reads;
+			phaseWrites |= system.writes;
+		}
+
+		//Every chunk of every system in the phase is one work item
+		mSystemChunks.clear();
+		for (size_t i = phaseBegin; i < phaseEnd; ++i)
+		{
+			const EntitySystem& system = systems.data[i];
+			ASSERT(nullptr != system.update, "[EntityWorld] System without an update function!");
+			GatherChunks(system.reads | system.writes, mQueryChunks);
+			for (const EntityChunk& chunk : mQueryChunks)
+			{
+				mSystemChunks.push_back({ &system, chunk });
+			}
+		}
+
+		const SystemChunk* items = mSystemChunks.data();
+		jobSystem.ParallelFor(mSystemChunks.size(), 1, [items](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				items[i].system->update(items[i].system->context, items[i].chunk);
+			}
+		});
+		phaseBegin = phaseEnd;
+	}
+
+	mIsIterating = false;
+}
+
+//--------------------------------------------------------------------------------------
+
+EntityArchetype* EntityWorld::GetArchetype(ComponentMask mask)
+{
+	auto it = mArchetypeLookup.find(mask);
+	if (it != mArchetypeLookup.end())
+	{
+		return it->second;
+	}
+
+	EntityArchetype* archetype = new EntityArchetype();
+	archetype->mask = mask;
+	for (u32 id = 0; id < kMaxComponentTypes; ++id)
+	{
+		archetype->offsets[id] = kComponentInvalid;
+		if (mask & (1ull << id))
+		{
+			archetype->componentIds.push_back(id);
+		}
+	}
+
+	//Start from the unpadded row size and back off until the aligned arrays fit
+	u32 rowSize = sizeof(Entity);
+	for (u32 id : archetype->componentIds)
+	{
+		rowSize += GetComponentInfo(id).size;
+	}
+	for (u32 capacity = static_cast<u32>(kEntityChunkSize) / rowSize; capacity > 0; --capacity)
+	{
+		u32 offset = AlignUp(capacity * sizeof(Entity), 16);
+		for (u32 id : archetype->componentIds)
+		{
+			offset = AlignUp(offset, GetArrayAlignment(id));
+			archetype->offsets[id] = offset;
+			offset += capacity * GetComponentInfo(id).size;
+		}
+
+		if (offset <= kEntityChunkSize)
+		{
+			archetype->chunkCapacity = capacity;
+			break;
+		}
+	}
+	ASSERT(archetype->chunkCapacity > 0, "[EntityWorld] Components don't fit a single entity in a chunk!");
+
+	mArchetypes.push_back(archetype);
+	mArchetypeLookup[mask] = archetype;
+	return archetype;
+}
+
+//--------------------------------------------------------------------------------------
+
+u8* EntityWorld::GetRow(const EntityArchetype& archetype, u32 row, u32 componentId) const
+{
+	const u32 chunk = row / archetype.chunkCapacity;
+	const u32 index = row - (chunk * archetype.chunkCapacity);
+	return archetype.chunks[chunk] + archetype.offsets[componentId] + (index * GetComponentInfo(componentId).size);
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 EntityWorld::AddRow(EntityArchetype& archetype, Entity entity)
+{
+	const u32 row = archetype.entityCount++;
+	const u32 chunk = row / archetype.chunkCapacity;
+	if (chunk == archetype.chunks.size())
+	{
+		u8* memory = static_cast<u8*>(_aligned_malloc(kEntityChunkSize, kEntityChunkAlignment));
+		ASSERT(nullptr != memory, "[EntityWorld] Failed to allocate a chunk!");
+		archetype.chunks.push_back(memory);
+	}
+
+	Entity* entities = reinterpret_cast<Entity*>(archetype.chunks[chunk]);
+	entities[row - (chunk * archetype.chunkCapacity)] = entity;
+	return row;
+}
+
+//--------------------------------------------------------------------------------------
+
+void EntityWorld::RemoveRow(EntityArchetype& archetype, u32 row)
+{
+	//Fill the hole with the last row so the arrays stay packed
+	const u32 last = --archetype.entityCount;
+	if (row == last)
+	{
+		return;
+	}
+
+	const u32 lastChunk = last / archetype.chunkCapacity;
+	const u32 rowChunk = row / archetype.chunkCapacity;
+	const Entity* lastEntities = reinterpret_cast<const Entity*>(archetype.chunks[lastChunk]);
+	Entity* rowEntities = reinterpret_cast<Entity*>(archetype.chunks[rowChunk]);
+	const Entity moved = lastEntities[last - (lastChunk * archetype.chunkCapacity)];
+	rowEntities[row - (rowChunk * archetype.chunkCapacity)] = moved;
+
+	for (u32 componentId : archetype.componentIds)
+	{
+		memcpy(GetRow(archetype, row, componentId), GetRow(archetype, last, componentId), GetComponentInfo(componentId).size);
+	}
+	mRecords[moved.index].row = row;
+}
+
+//--------------------------------------------------------------------------------------
+
+void EntityWorld::MoveEntity(Entity entity, EntityArchetype& target)
+{
+	ASSERT(!mIsIterating, "[EntityWorld] Structural change during a query!");
+
+	EntityRecord& record = mRecords[entity.index];
+	EntityArchetype& source = *record.archetype;
+	const u32 row = AddRow(target, entity);
+
+	//Shared components carry over, new ones are left for the caller to fill
+	for (u32 componentId : target.componentIds)
+	{
+		if (source.offsets[componentId] != kComponentInvalid)
+		{
+			memcpy(GetRow(target, row, componentId), GetRow(source, record.row, componentId), GetComponentInfo(componentId).size);
+		}
+	}
+
+	RemoveRow(source, record.row);
+	record.archetype = &target;
+	record.row = row;
+}
+
+//--------------------------------------------------------------------------------------
+
+void EntityWorld::GatherChunks(ComponentMask mask, std::vector<EntityChunk>& chunks) const
+{
+	chunks.clear();
+	ForEachChunk(mask, [&chunks](const EntityChunk& chunk)
+	{
+		chunks.push_back(chunk);
+	});
+}
+
+//======================================================================================
@@ -0,0 +1,334 @@
+#ifndef ENGINE_ENTITY_WORLD_H__
+#define ENGINE_ENTITY_WORLD_H__
+//======================================================================================
+// Filename: EntityWorld.h
+// Description: Archetype based entity storage. Entities with the same set of component
+//				types share an archetype, which packs them into 16 KB chunks holding one
+//				array per component type. Queries hand out whole chunks, so systems
+//				loop over plain arrays.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "JobSystem.h"
+#include "Span.h"
+
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+typedef u64 ComponentMask;
+
+constexpr u32 kMaxComponentTypes			= 64;
+constexpr u32 kComponentInvalid				= U32_MAX;
+constexpr size_t kEntityChunkSize			= 16 * 1024;
+constexpr size_t kEntityChunkAlignment		= 64;
+
+//======================================================================================
+// Component Types
+//======================================================================================
+
+struct ComponentInfo
+{
+	u32		size;
+	u32		alignment;
+};
+
+// Hands out the next component id, use GetComponentId instead.
+u32 RegisterComponent( u32 size, u32 alignment );
+const ComponentInfo& GetComponentInfo( u32 componentId );
+
+// Components are moved between chunks with memcpy and never destructed
+template <typename T>
+struct ComponentType
+{
+	static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value, "[EntityWorld] Components must be plain data!");
+
+	static u32 GetId()
+	{
+		static const u32 id = RegisterComponent(sizeof(T), alignof(T));
+		return id;
+	}
+};
+
+//--------------------------------------------------------------------------------------
+
+// const T shares the id of T so queries can ask for read only arrays
+template <typename T>
+u32 GetComponentId()
+{
+	return ComponentType<typename std::remove_const<T>::type>::GetId();
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename... Ts>
+ComponentMask MakeComponentMask()
+{
+	return (ComponentMask(0) | ... | (1ull << GetComponentId<Ts>()));
+}
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+// Generation is bumped whenever an index is reused, so stale handles fail IsAlive.
+struct Entity
+{
+	u32		index = U32_MAX;
+	u32		generation = 0;
+
+	bool operator==(const Entity& rhs) const								{ return index == rhs.index && generation == rhs.generation; }
+	bool operator!=(const Entity& rhs) const								{ return !(*this == rhs); }
+};
+
+//--------------------------------------------------------------------------------------
+
+struct EntityArchetype
+{
+	ComponentMask		mask = 0;
+	u32					chunkCapacity = 0;				// Entities per chunk
+	u32					entityCount = 0;
+	u32					offsets[kMaxComponentTypes];	// Array offset in a chunk or kComponentInvalid
+	std::vector<u32>	componentIds;
+	std::vector<u8*>	chunks;							// Never shrinks, only the first entityCount rows are live
+};
+
+//--------------------------------------------------------------------------------------
+
+// One chunk of a query result. Get returns arrays of GetCount elements.
+class EntityChunk
+{
+public:
+	EntityChunk() = default;
+	EntityChunk(const EntityArchetype* archetype, u8* memory, u32 count) : mArchetype(archetype), mMemory(memory), mCount(count) {}
+
+	u32 GetCount() const													{ return mCount; }
+	const Entity* GetEntities() const										{ return reinterpret_cast<const Entity*>(mMemory); }
+
+	template <typename T>
+	bool Has() const														{ return mArchetype->offsets[GetComponentId<T>()] != kComponentInvalid; }
+
+	template <typename T>
+	T* Get() const
+	{
+		const u32 offset = mArchetype->offsets[GetComponentId<T>()];
+		ASSERT(offset != kComponentInvalid, "[EntityWorld] Chunk does not have the component!");
+		return reinterpret_cast<T*>(mMemory + offset);
+	}
+
+private:
+	const EntityArchetype*	mArchetype = nullptr;
+	u8*						mMemory = nullptr;
+	u32						mCount = 0;
+};
+
+//--------------------------------------------------------------------------------------
+
+// Systems declare what they read and write so RunSystems can run the ones that don't
+// conflict at the same time. update is called once per matching chunk, possibly from
+// several threads at once.
+struct EntitySystem
+{
+	typedef void (*UpdateFunc)(void* context, const EntityChunk& chunk);
+
+	ComponentMask	reads = 0;
+	ComponentMask	writes = 0;
+	UpdateFunc		update = nullptr;
+	void*			context = nullptr;
+};
+
+//======================================================================================
+// Class EntityWorld
+//======================================================================================
+
+class EntityWorld
+{
+public:
+	EntityWorld();
+	~EntityWorld();
+
+	// Components start zeroed
+	Entity CreateEntity( ComponentMask mask );
+	template <typename... Ts>
+	Entity CreateEntity( const Ts&... components );
+	void DestroyEntity( Entity entity );
+	bool IsAlive( Entity entity ) const;
+
+	// Moves the entity to the archetype with or without the component, an added one
+	// starts zeroed. Pointers to the entity's components are invalidated, as are those
+	// of the last entity in its old archetype.
+	void* AddComponent( Entity entity, u32 componentId );
+	void RemoveComponent( Entity entity, u32 componentId );
+	// nullptr when the entity doesn't have the component
+	void* GetComponent( Entity entity, u32 componentId ) const;
+
+	template <typename T>
+	T* AddComponent( Entity entity, const T& component );
+	template <typename T>
+	void RemoveComponent( Entity entity )									{ RemoveComponent(entity, GetComponentId<T>()); }
+	template <typename T>
+	T* GetComponent( Entity entity ) const									{ return static_cast<T*>(GetComponent(entity, GetComponentId<T>())); }
+
+	// Calls func(const EntityChunk&) for every chunk holding all of the components in
+	// mask. The world must not be changed structurally from inside func.
+	template <typename Func>
+	void ForEachChunk( ComponentMask mask, const Func& func ) const;
+	template <typename Func>
+	void ForEachChunk( JobSystem& jobSystem, ComponentMask mask, const Func& func );
+
+	// Calls func(Ts&...) for every entity with all of Ts
+	template <typename... Ts, typename Func>
+	void ForEach( const Func& func ) const;
+	template <typename... Ts, typename Func>
+	void ForEach( JobSystem& jobSystem, const Func& func );
+
+	// Runs the systems in order. Neighbours that don't write anything the others touch
+	// are grouped into one phase and their chunks spread across the job system together.
+	void RunSystems( JobSystem& jobSystem, Span<const EntitySystem> systems );
+
+	u32 GetEntityCount() const												{ return mEntityCount; }
+	u32 GetArchetypeCount() const											{ return static_cast<u32>(mArchetypes.size()); }
+
+private:
+	NONCOPYABLE(EntityWorld);
+
+	struct EntityRecord
+	{
+		EntityArchetype*	archetype = nullptr;
+		u32					row = 0;
+		u32					generation = 0;
+	};
+
+	struct SystemChunk
+	{
+		const EntitySystem*	system;
+		EntityChunk			chunk;
+	};
+
+	// The arrays are fetched once per chunk so the row loop is just indexing
+	template <typename Func, typename... Ts>
+	static void ForEachRow( u32 count, const Func& func, Ts*... arrays );
+
+	EntityArchetype* GetArchetype( ComponentMask mask );
+	u8* GetRow( const EntityArchetype& archetype, u32 row, u32 componentId ) const;
+	u32 AddRow( EntityArchetype& archetype, Entity entity );
+	void RemoveRow( EntityArchetype& archetype, u32 row );
+	void MoveEntity( Entity entity, EntityArchetype& target );
+	void GatherChunks( ComponentMask mask, std::vector<EntityChunk>& chunks ) const;
+
+private:
+	std::vector<EntityArchetype*>						mArchetypes;
+	std::unordered_map<ComponentMask, EntityArchetype*>	mArchetypeLookup;
+
+	std::vector<EntityRecord>	mRecords;
+	std::vector<u32>			mFreeIndices;
+	u32							mEntityCount = 0;
+
+	std::vector<EntityChunk>	mQueryChunks;
+	std::vector<SystemChunk>	mSystemChunks;
+	bool						mIsIterating = false;
+};
+
+//======================================================================================
+// Template Definitions
+//======================================================================================
+
+template <typename... Ts>
+Entity EntityWorld::CreateEntity(const Ts&... components)
+{
+	const Entity entity = CreateEntity(MakeComponentMask<Ts...>());
+	(..., (*GetComponent<Ts>(entity) = components));
+	return entity;
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename T>
+T* EntityWorld::AddComponent(Entity entity, const T& component)
+{
+	T* result = static_cast<T*>(AddComponent(entity, GetComponentId<T>()));
+	*result = component;
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename Func>
+void EntityWorld::ForEachChunk(ComponentMask mask, const Func& func) const
+{
+	for (const EntityArchetype* archetype : mArchetypes)
+	{
+		if ((archetype->mask & mask) != mask)
+		{
+			continue;
+		}
+
+		for (u32 first = 0, chunk = 0; first < archetype->entityCount; first += archetype->chunkCapacity, ++chunk)
+		{
+			const u32 count = archetype->entityCount - first;
+			func(EntityChunk(archetype, archetype->chunks[chunk], (count < archetype->chunkCapacity) ? count : archetype->chunkCapacity));
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename Func>
+void EntityWorld::ForEachChunk(JobSystem& jobSystem, ComponentMask mask, const Func& func)
+{
+	ASSERT(!mIsIterating, "[EntityWorld] Nested parallel queries are not supported!");
+	mIsIterating = true;
+	GatherChunks(mask, mQueryChunks);
+	const EntityChunk* chunks = mQueryChunks.data();
+	jobSystem.ParallelFor(mQueryChunks.size(), 1, [chunks, &func](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			func(chunks[i]);
+		}
+	});
+	mIsIterating = false;
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename Func, typename... Ts>
+void EntityWorld::ForEachRow(u32 count, const Func& func, Ts*... arrays)
+{
+	for (u32 i = 0; i < count; ++i)
+	{
+		func(arrays[i]...);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename... Ts, typename Func>
+void EntityWorld::ForEach(const Func& func) const
+{
+	ForEachChunk(MakeComponentMask<Ts...>(), [&func](const EntityChunk& chunk)
+	{
+		ForEachRow(chunk.GetCount(), func, chunk.Get<Ts>()...);
+	});
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename... Ts, typename Func>
+void EntityWorld::ForEach(JobSystem& jobSystem, const Func& func)
+{
+	ForEachChunk(jobSystem, MakeComponentMask<Ts...>(), [&func](const EntityChunk& chunk)
+	{
+		ForEachRow(chunk.GetCount(), func, chunk.Get<Ts>()...);
+	});
+}
+
+//======================================================================================
+#endif // !ENGINE_ENTITY_WORLD_H__
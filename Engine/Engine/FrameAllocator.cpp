@@ -0,0 +1,56 @@
+//======================================================================================
+// Filename: FrameAllocator.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "FrameAllocator.h"
+
+#include <malloc.h>
+//======================================================================================
+
+FrameAllocator::FrameAllocator(size_t capacity)
+	: mCapacity( capacity )
+{
+	mMemory = static_cast<u8*>(_aligned_malloc(capacity, alignof(std::max_align_t)));
+	ASSERT(nullptr != mMemory, "[FrameAllocator] Failed to reserve frame memory!");
+}
+
+//--------------------------------------------------------------------------------------
+
+FrameAllocator::~FrameAllocator()
+{
+	_aligned_free(mMemory);
+}
+
+//--------------------------------------------------------------------------------------
+
+void FrameAllocator::Reset()
+{
+	if (mOffset > mHighWaterMark)
+	{
+		mHighWaterMark = mOffset;
+	}
+	mOffset = 0;
+}
+
+//--------------------------------------------------------------------------------------
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+	ASSERT((alignment & (alignment - 1)) == 0, "[FrameAllocator] Alignment must be a power of two!");
+
+	const size_t alignedOffset = (mOffset + alignment - 1) & ~(alignment - 1);
+	if (alignedOffset + size > mCapacity)
+	{
+		ASSERT(false, "[FrameAllocator] Frame budget of %zu bytes exhausted!", mCapacity);
+		return nullptr;
+	}
+
+	mOffset = alignedOffset + size;
+	return mMemory + alignedOffset;
+}
+
+//======================================================================================
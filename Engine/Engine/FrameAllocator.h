@@ -0,0 +1,55 @@
+#ifndef ENGINE_FRAME_ALLOCATOR_H__
+#define ENGINE_FRAME_ALLOCATOR_H__
+//======================================================================================
+// Filename: FrameAllocator.h
+// Description: Linear bump allocator that is reset wholesale at the start of every
+//				frame. Memory handed out is only valid until the next Reset.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Span.h"
+
+#include <cstddef>
+
+//======================================================================================
+// Class FrameAllocator
+//======================================================================================
+
+class FrameAllocator
+{
+public:
+	FrameAllocator( size_t capacity );
+	~FrameAllocator();
+
+	void Reset();
+
+	// Returns nullptr when the frame budget is exhausted.
+	void* Allocate( size_t size, size_t alignment = alignof(std::max_align_t) );
+
+	// Trivially default constructed, uninitialized storage for count elements.
+	template <typename T>
+	Span<T> AllocateArray( size_t count )
+	{
+		T* data = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+		return (nullptr != data) ? Span<T>(data, count) : Span<T>();
+	}
+
+	size_t GetCapacity() const												{ return mCapacity; }
+	size_t GetUsed() const													{ return mOffset; }
+	size_t GetHighWaterMark() const											{ return mHighWaterMark; }
+
+private:
+	NONCOPYABLE(FrameAllocator);
+
+private:
+	u8*		mMemory = nullptr;
+	size_t	mCapacity = 0;
+	size_t	mOffset = 0;
+	size_t	mHighWaterMark = 0;
+};
+
+//======================================================================================
+#endif // !ENGINE_FRAME_ALLOCATOR_H__
@@ -0,0 +1,55 @@
+#ifndef ENGINE_FRUSTUM_H__
+#define ENGINE_FRUSTUM_H__
+//======================================================================================
+// Filename: Frustum.h
+// Description: View frustum as six inward facing planes, (n.x, n.y, n.z, d) with
+//				Dot(n, p) + d >= 0 inside. Built from a view projection using the
+//				Vulkan clip volume, -w <= x, y <= w and 0 <= z <= w.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Vector4.h"
+
+namespace Math
+{
+
+struct Matrix;
+struct Vector3;
+
+//======================================================================================
+// Struct
+//======================================================================================
+
+struct Frustum
+{
+	enum Plane
+	{
+		kLeft,
+		kRight,
+		kTop,
+		kBottom,
+		kNear,
+		kFar,
+		kPlaneCount
+	};
+
+	Vector4 planes[kPlaneCount];
+
+	static Frustum FromMatrix(const Matrix& viewProjection);
+
+	bool TestSphere(const Vector3& center, f32 radius) const;
+	bool TestAABB(const Vector3& min, const Vector3& max) const;
+};
+
+} // namespace Math
+
+//======================================================================================
+// Inline
+//======================================================================================
+#include "Frustum.inl"
+
+//======================================================================================
+#endif // !ENGINE_FRUSTUM_H__
@@ -0,0 +1,76 @@
+//======================================================================================
+// Filename: Frustum.inl
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "EngineMath.h"
+
+namespace Math
+{
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+inline Frustum Frustum::FromMatrix(const Matrix& m)
+{
+	//Gribb/Hartmann, each plane is the w row plus or minus a clip axis row
+	const Vector4 x(m._11, m._12, m._13, m._14);
+	const Vector4 y(m._21, m._22, m._23, m._24);
+	const Vector4 z(m._31, m._32, m._33, m._34);
+	const Vector4 w(m._41, m._42, m._43, m._44);
+
+	Frustum frustum;
+	frustum.planes[kLeft]	= w + x;
+	frustum.planes[kRight]	= w - x;
+	frustum.planes[kTop]	= w + y;
+	frustum.planes[kBottom]	= w - y;
+	frustum.planes[kNear]	= z;
+	frustum.planes[kFar]	= w - z;
+
+	//Unit normals so sphere radii can be compared against the plane distance
+	for (Vector4& plane : frustum.planes)
+	{
+		plane *= RSqrt(MagnitudeSqr(plane.ToVector3()));
+	}
+	return frustum;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline bool Frustum::TestSphere(const Vector3& center, f32 radius) const
+{
+	for (const Vector4& plane : planes)
+	{
+		if (Dot(plane.ToVector3(), center) + plane.w < -radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline bool Frustum::TestAABB(const Vector3& min, const Vector3& max) const
+{
+	//Only the corner furthest along the plane normal needs testing
+	for (const Vector4& plane : planes)
+	{
+		const Vector3 corner
+		(
+			(plane.x > 0.0f) ? max.x : min.x,
+			(plane.y > 0.0f) ? max.y : min.y,
+			(plane.z > 0.0f) ? max.z : min.z
+		);
+		if (Dot(plane.ToVector3(), corner) + plane.w < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace Math
@@ -0,0 +1,51 @@
+#ifndef ENGINE_GRAPHICS_GPU_DRAW_CULL_LAYOUT_H__
+#define ENGINE_GRAPHICS_GPU_DRAW_CULL_LAYOUT_H__
+//======================================================================================
+// Filename: GpuDrawCullLayout.h
+// Description: Buffer and push constant layouts shared with GpuDrawCull.comp. Kept
+//				apart from GpuDrawCuller so they can be used without a Renderer, e.g.
+//				to run the shader headless.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Vector4.h"
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr u32 kGpuDrawCullGroupSize			= 64;	// local_size_x of GpuDrawCull.comp
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+// One per object in the shader's binding 0. The draw is indexed from the shared index
+// buffer, indexCount 0 leaves the slot empty.
+struct GpuCullObject
+{
+	Math::Vector4	sphere;			// xyz centre, w radius
+	u32				indexCount = 0;
+	u32				firstIndex = 0;
+	s32				vertexOffset = 0;
+	u32				padding = 0;
+};
+
+static_assert(sizeof(GpuCullObject) == 32, "[GpuDrawCuller] GpuCullObject must match the shader layout!");
+
+//--------------------------------------------------------------------------------------
+
+// The shader's push constants
+struct GpuCullConstants
+{
+	Math::Vector4	planes[6];		// Math::Frustum planes
+	u32				objectCount;
+	u32				compact;		// Append the visible objects through the count buffer
+	u32				firstInstance;	// Write the object index to firstInstance
+};
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_GPU_DRAW_CULL_LAYOUT_H__
@@ -0,0 +1,353 @@
+//======================================================================================
+// Filename: GpuDrawCuller.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "GpuDrawCuller.h"
+
+#include "DeletionQueue.h"
+#include "Frustum.h"
+#include "GpuRingBuffer.h"
+#include "GpuTimeline.h"
+#include "GraphicsCommon.h"
+#include "Renderer.h"
+#include "VulkanExtensions.h"
+
+#include <algorithm>
+#include <cstring>
+//======================================================================================
+
+namespace
+{
+	GpuDrawCullerDevice GetRendererDevice(Renderer* renderer)
+	{
+		GpuDrawCullerDevice device;
+		device.device						= renderer->GetVulkanDevice();
+		device.memoryProperties				= &renderer->GetVulkanPhysicalDeviceMemoryProperties();
+		device.enabledFeatures				= renderer->GetVulkanEnabledFeatures();
+		device.isDrawIndirectCountSupported	= renderer->IsDrawIndirectCountSupported();
+		device.deletionQueue				= renderer->GetDeletionQueue();
+		device.timeline						= renderer->GetGraphicsTimeline();
+		return device;
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+GpuDrawCuller::GpuDrawCuller(Renderer* renderer, u32 maxObjectCount, Span<const u32> cullShaderCode)
+	: GpuDrawCuller( GetRendererDevice(renderer), maxObjectCount, cullShaderCode )
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+GpuDrawCuller::GpuDrawCuller(const GpuDrawCullerDevice& device, u32 maxObjectCount, Span<const u32> cullShaderCode)
+	: mDevice( device )
+	, mMaxObjectCount( maxObjectCount )
+	, mObjects( maxObjectCount )
+	, mIsDirty( maxObjectCount, 0 )
+{
+	ASSERT(maxObjectCount > 0, "[GpuDrawCuller] Needs room for at least one object!");
+
+	const VkPhysicalDeviceFeatures& features = mDevice.enabledFeatures;
+
+	//firstInstance must be 0 without drawIndirectFirstInstance, so the object index is
+	//pushed instead, which needs each object in its own slot and its own draw call
+	mIsPushingObjectIndex = (features.drawIndirectFirstInstance != VK_TRUE);
+
+	//Without multi draw the count can't go above one, so every object is drawn from
+	//its own slot with a draw call each
+	mIsMultiDraw = (features.multiDrawIndirect == VK_TRUE) && !mIsPushingObjectIndex;
+	mIsCompacting = mIsMultiDraw && mDevice.isDrawIndirectCountSupported;
+
+	CreateBuffer(maxObjectCount * sizeof(GpuCullObject), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, mObjectBuffer, mObjectMemory);
+	CreateBuffer(maxObjectCount * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, mDrawBuffer, mDrawMemory);
+	CreateBuffer(sizeof(u32), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, mCountBuffer, mCountMemory);
+	CreatePipeline(cullShaderCode);
+}
+
+//--------------------------------------------------------------------------------------
+
+GpuDrawCuller::~GpuDrawCuller()
+{
+	DeletionQueue* deletionQueue = mDevice.deletionQueue;
+	GpuTimeline* timeline = mDevice.timeline;
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::Pipeline, HandleToU64(mPipeline), timeline);
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::PipelineLayout, HandleToU64(mPipelineLayout), timeline);
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::DescriptorPool, HandleToU64(mDescriptorPool), timeline);
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::DescriptorSetLayout, HandleToU64(mDescriptorSetLayout), timeline);
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::Buffer, HandleToU64(mObjectBuffer), timeline);
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::DeviceMemory, HandleToU64(mObjectMemory), timeline);
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::Buffer, HandleToU64(mDrawBuffer), timeline);
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::DeviceMemory, HandleToU64(mDrawMemory), timeline);
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::Buffer, HandleToU64(mCountBuffer), timeline);
+	deletionQueue->EnqueueAfterSubmitted(DeferredObjectType::DeviceMemory, HandleToU64(mCountMemory), timeline);
+}
+
+//--------------------------------------------------------------------------------------
+
+void GpuDrawCuller::SetObjectCount(u32 count)
+{
+	ASSERT(count <= mMaxObjectCount, "[GpuDrawCuller] %u objects requested, room for %u!", count, mMaxObjectCount);
+	mObjectCount = count;
+}
+
+//--------------------------------------------------------------------------------------
+
+void GpuDrawCuller::SetObject(u32 index, const GpuCullObject& object)
+{
+	ASSERT(index < mMaxObjectCount, "[GpuDrawCuller] Object index %u out of range!", index);
+	mObjects[index] = object;
+	if (mIsDirty[index] == 0)
+	{
+		mIsDirty[index] = 1;
+		mDirtyObjects.push_back(index);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+bool GpuDrawCuller::RecordCull(VkCommandBuffer commandBuffer, GpuRingBuffer& ring, const Math::Frustum& frustum)
+{
+	//The previous frame's draws and cull may still be reading what we are about to write
+	vkCmdPipelineBarrier(	commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+							VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr );
+
+	//Slots that were never set must read as empty
+	if (!mIsObjectBufferCleared)
+	{
+		vkCmdFillBuffer(commandBuffer, mObjectBuffer, 0, VK_WHOLE_SIZE, 0);
+
+		VkMemoryBarrier clearBarrier = {};
+		clearBarrier.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		clearBarrier.srcAccessMask	= VK_ACCESS_TRANSFER_WRITE_BIT;
+		clearBarrier.dstAccessMask	= VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(	commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+								0, 1, &clearBarrier, 0, nullptr, 0, nullptr );
+		mIsObjectBufferCleared = true;
+	}
+
+	bool isUploaded = true;
+	if (!mDirtyObjects.empty())
+	{
+		const GpuRingAllocation allocation = ring.Allocate(mDirtyObjects.size() * sizeof(GpuCullObject), alignof(GpuCullObject));
+		if (nullptr != allocation.data)
+		{
+			//Sorted so neighbouring objects go up as one copy region
+			std::sort(mDirtyObjects.begin(), mDirtyObjects.end());
+			GpuCullObject* staging = static_cast<GpuCullObject*>(allocation.data);
+			mCopyRegions.clear();
+			for (size_t i = 0; i < mDirtyObjects.size(); ++i)
+			{
+				const u32 index = mDirtyObjects[i];
+				memcpy(&staging[i], &mObjects[index], sizeof(GpuCullObject));
+				mIsDirty[index] = 0;
+
+				if (i > 0 && mDirtyObjects[i - 1] + 1 == index)
+				{
+					mCopyRegions.back().size += sizeof(GpuCullObject);
+					continue;
+				}
+
+				VkBufferCopy region = {};
+				region.srcOffset	= allocation.offset + i * sizeof(GpuCullObject);
+				region.dstOffset	= index * sizeof(GpuCullObject);
+				region.size			= sizeof(GpuCullObject);
+				mCopyRegions.push_back(region);
+			}
+			mDirtyObjects.clear();
+			vkCmdCopyBuffer(commandBuffer, allocation.buffer, mObjectBuffer, static_cast<uint32_t>(mCopyRegions.size()), mCopyRegions.data());
+		}
+		else
+		{
+			isUploaded = false;
+		}
+	}
+
+	if (mIsCompacting)
+	{
+		vkCmdFillBuffer(commandBuffer, mCountBuffer, 0, sizeof(u32), 0);
+	}
+
+	VkMemoryBarrier uploadBarrier = {};
+	uploadBarrier.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	uploadBarrier.srcAccessMask	= VK_ACCESS_TRANSFER_WRITE_BIT;
+	uploadBarrier.dstAccessMask	= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(	commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+							0, 1, &uploadBarrier, 0, nullptr, 0, nullptr );
+
+	GpuCullConstants constants = {};
+	memcpy(constants.planes, frustum.planes, sizeof(constants.planes));
+	constants.objectCount = mObjectCount;
+	constants.compact = mIsCompacting ? 1 : 0;
+	constants.firstInstance = mIsPushingObjectIndex ? 0 : 1;
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipelineLayout, 0, 1, &mDescriptorSet, 0, nullptr);
+	vkCmdPushConstants(commandBuffer, mPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GpuCullConstants), &constants);
+	if (mObjectCount > 0)
+	{
+		vkCmdDispatch(commandBuffer, (mObjectCount + kGpuDrawCullGroupSize - 1) / kGpuDrawCullGroupSize, 1, 1);
+	}
+
+	VkMemoryBarrier cullBarrier = {};
+	cullBarrier.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	cullBarrier.srcAccessMask	= VK_ACCESS_SHADER_WRITE_BIT;
+	cullBarrier.dstAccessMask	= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	vkCmdPipelineBarrier(	commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+							0, 1, &cullBarrier, 0, nullptr, 0, nullptr );
+	return isUploaded;
+}
+
+//--------------------------------------------------------------------------------------
+
+void GpuDrawCuller::RecordDraw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, u32 objectIndexOffset) const
+{
+	if (mObjectCount == 0)
+	{
+		return;
+	}
+
+	const u32 stride = sizeof(VkDrawIndexedIndirectCommand);
+	if (mIsCompacting)
+	{
+		fvkCmdDrawIndexedIndirectCountKHR(commandBuffer, mDrawBuffer, 0, mCountBuffer, 0, mObjectCount, stride);
+	}
+	else if (mIsMultiDraw)
+	{
+		vkCmdDrawIndexedIndirect(commandBuffer, mDrawBuffer, 0, mObjectCount, stride);
+	}
+	else
+	{
+		for (u32 object = 0; object < mObjectCount; ++object)
+		{
+			if (mIsPushingObjectIndex)
+			{
+				vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, objectIndexOffset, sizeof(u32), &object);
+			}
+			vkCmdDrawIndexedIndirect(commandBuffer, mDrawBuffer, object * stride, 1, stride);
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void GpuDrawCuller::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, VkDeviceMemory& memory)
+{
+	VkDevice device = mDevice.device;
+
+	VkBufferCreateInfo bufferCreateInfo = {};
+	bufferCreateInfo.sType			= VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.size			= size;
+	bufferCreateInfo.usage			= usage;
+	bufferCreateInfo.sharingMode	= VK_SHARING_MODE_EXCLUSIVE;
+	vkErrorCheck( vkCreateBuffer(device, &bufferCreateInfo, nullptr, &buffer) );
+
+	VkMemoryRequirements memoryRequirements = {};
+	vkGetBufferMemoryRequirements(device, buffer, &memoryRequirements);
+
+	VkMemoryAllocateInfo memoryAllocateInfo = {};
+	memoryAllocateInfo.sType			= VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memoryAllocateInfo.allocationSize	= memoryRequirements.size;
+	memoryAllocateInfo.memoryTypeIndex	= FindMemoryTypeIndex(	mDevice.memoryProperties, &memoryRequirements,
+																VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
+	vkErrorCheck( vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &memory) );
+	vkErrorCheck( vkBindBufferMemory(device, buffer, memory, 0) );
+}
+
+//--------------------------------------------------------------------------------------
+
+void GpuDrawCuller::CreatePipeline(Span<const u32> cullShaderCode)
+{
+	VkDevice device = mDevice.device;
+
+	//Objects, draws and count
+	VkDescriptorSetLayoutBinding bindings[3] = {};
+	for (u32 i = 0; i < 3; ++i)
+	{
+		bindings[i].binding			= i;
+		bindings[i].descriptorType	= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[i].descriptorCount	= 1;
+		bindings[i].stageFlags		= VK_SHADER_STAGE_COMPUTE_BIT;
+	}
+
+	VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo = {};
+	setLayoutCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	setLayoutCreateInfo.bindingCount	= 3;
+	setLayoutCreateInfo.pBindings		= bindings;
+	vkErrorCheck( vkCreateDescriptorSetLayout(device, &setLayoutCreateInfo, nullptr, &mDescriptorSetLayout) );
+
+	VkDescriptorPoolSize poolSize = {};
+	poolSize.type				= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	poolSize.descriptorCount	= 3;
+
+	VkDescriptorPoolCreateInfo poolCreateInfo = {};
+	poolCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolCreateInfo.maxSets			= 1;
+	poolCreateInfo.poolSizeCount	= 1;
+	poolCreateInfo.pPoolSizes		= &poolSize;
+	vkErrorCheck( vkCreateDescriptorPool(device, &poolCreateInfo, nullptr, &mDescriptorPool) );
+
+	VkDescriptorSetAllocateInfo setAllocateInfo = {};
+	setAllocateInfo.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	setAllocateInfo.descriptorPool		= mDescriptorPool;
+	setAllocateInfo.descriptorSetCount	= 1;
+	setAllocateInfo.pSetLayouts			= &mDescriptorSetLayout;
+	vkErrorCheck( vkAllocateDescriptorSets(device, &setAllocateInfo, &mDescriptorSet) );
+
+	//The buffers never change, so the set is written once
+	VkDescriptorBufferInfo bufferInfos[3] = {};
+	bufferInfos[0].buffer	= mObjectBuffer;
+	bufferInfos[0].range	= VK_WHOLE_SIZE;
+	bufferInfos[1].buffer	= mDrawBuffer;
+	bufferInfos[1].range	= VK_WHOLE_SIZE;
+	bufferInfos[2].buffer	= mCountBuffer;
+	bufferInfos[2].range	= VK_WHOLE_SIZE;
+
+	VkWriteDescriptorSet writes[3] = {};
+	for (u32 i = 0; i < 3; ++i)
+	{
+		writes[i].sType				= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[i].dstSet			= mDescriptorSet;
+		writes[i].dstBinding		= i;
+		writes[i].descriptorCount	= 1;
+		writes[i].descriptorType	= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[i].pBufferInfo		= &bufferInfos[i];
+	}
+	vkUpdateDescriptorSets(device, 3, writes, 0, nullptr);
+
+	VkPushConstantRange pushConstantRange = {};
+	pushConstantRange.stageFlags	= VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstantRange.size			= sizeof(GpuCullConstants);
+
+	VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+	pipelineLayoutCreateInfo.sType					= VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutCreateInfo.setLayoutCount			= 1;
+	pipelineLayoutCreateInfo.pSetLayouts			= &mDescriptorSetLayout;
+	pipelineLayoutCreateInfo.pushConstantRangeCount	= 1;
+	pipelineLayoutCreateInfo.pPushConstantRanges	= &pushConstantRange;
+	vkErrorCheck( vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &mPipelineLayout) );
+
+	VkShaderModuleCreateInfo shaderCreateInfo = {};
+	shaderCreateInfo.sType		= VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	shaderCreateInfo.codeSize	= cullShaderCode.size * sizeof(u32);
+	shaderCreateInfo.pCode		= cullShaderCode.data;
+	VkShaderModule shaderModule = VK_NULL_HANDLE;
+	vkErrorCheck( vkCreateShaderModule(device, &shaderCreateInfo, nullptr, &shaderModule) );
+
+	VkComputePipelineCreateInfo pipelineCreateInfo = {};
+	pipelineCreateInfo.sType		= VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineCreateInfo.stage.sType	= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipelineCreateInfo.stage.stage	= VK_SHADER_STAGE_COMPUTE_BIT;
+	pipelineCreateInfo.stage.module	= shaderModule;
+	pipelineCreateInfo.stage.pName	= "main";
+	pipelineCreateInfo.layout		= mPipelineLayout;
+	vkErrorCheck( vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &mPipeline) );
+
+	vkDestroyShaderModule(device, shaderModule, nullptr);
+}
+
+//======================================================================================
@@ -0,0 +1,118 @@
+#ifndef ENGINE_GRAPHICS_GPU_DRAW_CULLER_H__
+#define ENGINE_GRAPHICS_GPU_DRAW_CULLER_H__
+//======================================================================================
+// Filename: GpuDrawCuller.h
+// Description: GPU driven drawing of objects that share one pipeline and one vertex
+//				and index buffer. Object bounds live in a device local storage buffer,
+//				a compute pass (GpuDrawCull.comp) frustum culls them and writes the
+//				indirect draw commands, so the CPU only touches objects that changed.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "GpuDrawCullLayout.h"
+#include "Platform.h"
+#include "Span.h"
+
+#include <vector>
+
+class DeletionQueue;
+class GpuRingBuffer;
+class GpuTimeline;
+class Renderer;
+
+namespace Math
+{
+struct Frustum;
+}
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+// What GpuDrawCuller needs of the device. The Renderer constructor fills it in from
+// the Renderer, the tests fill it in for a headless device.
+struct GpuDrawCullerDevice
+{
+	VkDevice								device = VK_NULL_HANDLE;
+	const VkPhysicalDeviceMemoryProperties*	memoryProperties = nullptr;
+	VkPhysicalDeviceFeatures				enabledFeatures = {};
+	bool									isDrawIndirectCountSupported = false;
+	DeletionQueue*							deletionQueue = nullptr;
+	GpuTimeline*							timeline = nullptr;		// Buffers are released once what was submitted to it retires
+};
+
+//======================================================================================
+// Class GpuDrawCuller
+//======================================================================================
+
+class GpuDrawCuller
+{
+public:
+	// cullShaderCode is GpuDrawCull.comp compiled to SPIR-V.
+	GpuDrawCuller( Renderer* renderer, u32 maxObjectCount, Span<const u32> cullShaderCode );
+	GpuDrawCuller( const GpuDrawCullerDevice& device, u32 maxObjectCount, Span<const u32> cullShaderCode );
+	~GpuDrawCuller();
+
+	// Objects past count are ignored by the cull pass.
+	void SetObjectCount( u32 count );
+	// Only changed objects are uploaded by the next RecordCull.
+	void SetObject( u32 index, const GpuCullObject& object );
+
+	// Records the object upload, through ring which needs TRANSFER_SRC usage, and the
+	// cull dispatch. Must be outside a render pass. Returns false if ring is full, the
+	// changes are kept for the next call then.
+	bool RecordCull( VkCommandBuffer commandBuffer, GpuRingBuffer& ring, const Math::Frustum& frustum );
+	// Records the draws. Must be inside a render pass with the pipeline and the shared
+	// vertex and index buffers bound. gl_InstanceIndex is the object index, unless
+	// IsPushingObjectIndex() where every object is drawn on its own and its index is
+	// pushed as a u32 at objectIndexOffset of pipelineLayout's vertex stage range.
+	void RecordDraw( VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, u32 objectIndexOffset ) const;
+
+	u32 GetObjectCount() const												{ return mObjectCount; }
+	u32 GetMaxObjectCount() const											{ return mMaxObjectCount; }
+	// Visible objects are packed and counted on the GPU, needs an indirect count extension
+	bool IsCompacting() const												{ return mIsCompacting; }
+	// Without drawIndirectFirstInstance the indirect commands can't carry the object index
+	bool IsPushingObjectIndex() const										{ return mIsPushingObjectIndex; }
+
+private:
+	NONCOPYABLE(GpuDrawCuller);
+
+	void CreateBuffer( VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, VkDeviceMemory& memory );
+	void CreatePipeline( Span<const u32> cullShaderCode );
+
+private:
+	GpuDrawCullerDevice		mDevice;
+
+	u32						mMaxObjectCount = 0;
+	u32						mObjectCount = 0;
+	bool					mIsCompacting = false;
+	bool					mIsMultiDraw = false;
+	bool					mIsPushingObjectIndex = false;
+	bool					mIsObjectBufferCleared = false;
+
+	VkBuffer				mObjectBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory			mObjectMemory = VK_NULL_HANDLE;
+	VkBuffer				mDrawBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory			mDrawMemory = VK_NULL_HANDLE;
+	VkBuffer				mCountBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory			mCountMemory = VK_NULL_HANDLE;
+
+	VkDescriptorSetLayout	mDescriptorSetLayout = VK_NULL_HANDLE;
+	VkDescriptorPool		mDescriptorPool = VK_NULL_HANDLE;
+	VkDescriptorSet			mDescriptorSet = VK_NULL_HANDLE;
+	VkPipelineLayout		mPipelineLayout = VK_NULL_HANDLE;
+	VkPipeline				mPipeline = VK_NULL_HANDLE;
+
+	// CPU copy of every object and the ones changed since the last upload
+	std::vector<GpuCullObject>	mObjects;
+	std::vector<u8>				mIsDirty;
+	std::vector<u32>			mDirtyObjects;
+	std::vector<VkBufferCopy>	mCopyRegions;
+};
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_GPU_DRAW_CULLER_H__
@@ -0,0 +1,169 @@
+//======================================================================================
+// Filename: GpuRingBuffer.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "GpuRingBuffer.h"
+
+#include "GpuTimeline.h"
+#include "GraphicsCommon.h"
+#include "Renderer.h"
+//======================================================================================
+
+GpuRingBuffer::GpuRingBuffer(Renderer* renderer, VkDeviceSize frameSize, u32 frameCount, VkBufferUsageFlags usage)
+	: GpuRingBuffer(	renderer->GetVulkanDevice(), renderer->GetVulkanPhysicalDeviceProperties(), renderer->GetVulkanPhysicalDeviceMemoryProperties(),
+						renderer->GetGraphicsTimeline(), frameSize, frameCount, usage )
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+GpuRingBuffer::GpuRingBuffer(	VkDevice device, const VkPhysicalDeviceProperties& properties, const VkPhysicalDeviceMemoryProperties& memoryProperties,
+								GpuTimeline* timeline, VkDeviceSize frameSize, u32 frameCount, VkBufferUsageFlags usage )
+	: mDevice( device )
+	, mTimeline( timeline )
+	, mFrameCount( frameCount )
+	, mFrameValues( frameCount, 0 )
+{
+	ASSERT(frameCount > 0, "[GpuRingBuffer] Needs at least one frame!");
+
+	const VkPhysicalDeviceLimits& limits = properties.limits;
+	mUniformAlignment = limits.minUniformBufferOffsetAlignment;
+	mStorageAlignment = limits.minStorageBufferOffsetAlignment;
+	mAtomSize = limits.nonCoherentAtomSize;
+
+	//Segments start on an alignment every allocation and flush can use
+	VkDeviceSize segmentAlignment = mUniformAlignment;
+	segmentAlignment = (mStorageAlignment > segmentAlignment) ? mStorageAlignment : segmentAlignment;
+	segmentAlignment = (mAtomSize > segmentAlignment) ? mAtomSize : segmentAlignment;
+	mFrameSize = (frameSize + segmentAlignment - 1) / segmentAlignment * segmentAlignment;
+	ASSERT((usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) == 0 || mFrameSize * frameCount <= U32_MAX,
+		"[GpuRingBuffer] Dynamic offsets are 32-bit, the buffer is too large!");
+
+	VkBufferCreateInfo bufferCreateInfo = {};
+	bufferCreateInfo.sType			= VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.size			= mFrameSize * frameCount;
+	bufferCreateInfo.usage			= usage;
+	bufferCreateInfo.sharingMode	= VK_SHARING_MODE_EXCLUSIVE;
+	vkErrorCheck( vkCreateBuffer(device, &bufferCreateInfo, nullptr, &mBuffer) );
+
+	VkMemoryRequirements memoryRequirements = {};
+	vkGetBufferMemoryRequirements(device, mBuffer, &memoryRequirements);
+
+	//Take the first host visible type, Flush covers it if that isn't coherent
+	VkMemoryAllocateInfo memoryAllocateInfo = {};
+	memoryAllocateInfo.sType			= VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memoryAllocateInfo.allocationSize	= memoryRequirements.size;
+	memoryAllocateInfo.memoryTypeIndex	= FindMemoryTypeIndex(&memoryProperties, &memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+	vkErrorCheck( vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &mMemory) );
+	mMemorySize = memoryRequirements.size;
+	mIsCoherent = (memoryProperties.memoryTypes[memoryAllocateInfo.memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+	vkErrorCheck( vkBindBufferMemory(device, mBuffer, mMemory, 0) );
+
+	void* mappedMemory = nullptr;
+	vkErrorCheck( vkMapMemory(device, mMemory, 0, VK_WHOLE_SIZE, 0, &mappedMemory) );
+	mMappedMemory = static_cast<u8*>(mappedMemory);
+
+	//Start on the last segment so the first BeginFrame lands on segment 0
+	mFrameIndex = frameCount - 1;
+	mFrameBegin = mFrameIndex * mFrameSize;
+	mOffset = mFrameBegin;
+	mFlushedOffset = mFrameBegin;
+}
+
+//--------------------------------------------------------------------------------------
+
+GpuRingBuffer::~GpuRingBuffer()
+{
+	//Segments may still be read by frames in flight
+	for (u64 value : mFrameValues)
+	{
+		mTimeline->Wait(value);
+	}
+
+	vkUnmapMemory(mDevice, mMemory);
+	vkDestroyBuffer(mDevice, mBuffer, nullptr);
+	vkFreeMemory(mDevice, mMemory, nullptr);
+}
+
+//--------------------------------------------------------------------------------------
+
+void GpuRingBuffer::BeginFrame()
+{
+	mFrameIndex = (mFrameIndex + 1) % mFrameCount;
+	mTimeline->Wait(mFrameValues[mFrameIndex]);
+
+	mFrameBegin = mFrameIndex * mFrameSize;
+	mOffset = mFrameBegin;
+	mFlushedOffset = mFrameBegin;
+}
+
+//--------------------------------------------------------------------------------------
+
+void GpuRingBuffer::Flush()
+{
+	if (mIsCoherent || mOffset == mFlushedOffset)
+	{
+		return;
+	}
+
+	//Segments are atom aligned, so rounding out never reaches into another frame
+	VkMappedMemoryRange range = {};
+	range.sType		= VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	range.memory	= mMemory;
+	range.offset	= mFlushedOffset / mAtomSize * mAtomSize;
+	const VkDeviceSize end = (mOffset + mAtomSize - 1) / mAtomSize * mAtomSize;
+	range.size		= (end < mMemorySize) ? end - range.offset : VK_WHOLE_SIZE;
+	vkErrorCheck( vkFlushMappedMemoryRanges(mDevice, 1, &range) );
+
+	mFlushedOffset = mOffset;
+}
+
+//--------------------------------------------------------------------------------------
+
+void GpuRingBuffer::EndFrame(u64 value)
+{
+	ASSERT(mIsCoherent || mOffset == mFlushedOffset, "[GpuRingBuffer] Frame was submitted with unflushed writes!");
+	mFrameValues[mFrameIndex] = value;
+	if (GetUsed() > mHighWaterMark)
+	{
+		mHighWaterMark = GetUsed();
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+GpuRingAllocation GpuRingBuffer::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+	ASSERT((alignment & (alignment - 1)) == 0, "[GpuRingBuffer] Alignment must be a power of two!");
+
+	GpuRingAllocation allocation;
+	const VkDeviceSize alignedOffset = (mOffset + alignment - 1) & ~(alignment - 1);
+	if (alignedOffset + size > mFrameBegin + mFrameSize)
+	{
+		ASSERT(false, "[GpuRingBuffer] Frame budget of %llu bytes exhausted!", static_cast<u64>(mFrameSize));
+		return allocation;
+	}
+
+	mOffset = alignedOffset + size;
+	allocation.buffer = mBuffer;
+	allocation.offset = alignedOffset;
+	allocation.data = mMappedMemory + alignedOffset;
+	return allocation;
+}
+
+//--------------------------------------------------------------------------------------
+
+VkDescriptorBufferInfo GpuRingBuffer::GetDescriptorBufferInfo(VkDeviceSize range) const
+{
+	VkDescriptorBufferInfo bufferInfo = {};
+	bufferInfo.buffer	= mBuffer;
+	bufferInfo.offset	= 0;
+	bufferInfo.range	= range;
+	return bufferInfo;
+}
+
+//======================================================================================
@@ -0,0 +1,106 @@
+#ifndef ENGINE_GRAPHICS_GPU_RING_BUFFER_H__
+#define ENGINE_GRAPHICS_GPU_RING_BUFFER_H__
+//======================================================================================
+// Filename: GpuRingBuffer.h
+// Description: One persistently mapped buffer split into a segment per frame in
+//				flight. Each frame bump allocates from its own segment, which is only
+//				reused once the graphics timeline shows the GPU is done reading it.
+//				Bind the whole buffer once as a dynamic uniform or storage buffer and
+//				pass each allocation's offset as the dynamic offset.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Platform.h"
+
+#include <vector>
+
+class GpuTimeline;
+class Renderer;
+//======================================================================================
+// Structs
+//======================================================================================
+
+// data is nullptr when the frame's segment is full
+struct GpuRingAllocation
+{
+	VkBuffer		buffer = VK_NULL_HANDLE;
+	VkDeviceSize	offset = 0;
+	void*			data = nullptr;
+
+	u32 GetDynamicOffset() const											{ return static_cast<u32>(offset); }
+};
+
+//======================================================================================
+// Class GpuRingBuffer
+//======================================================================================
+
+class GpuRingBuffer
+{
+public:
+	// usage is whatever the allocations are read as: UNIFORM or STORAGE when bound with a
+	// dynamic offset, TRANSFER_SRC for GpuDrawCuller::RecordCull's upload, VERTEX_BUFFER
+	// for DrawBatcher's instance data.
+	GpuRingBuffer( Renderer* renderer, VkDeviceSize frameSize, u32 frameCount, VkBufferUsageFlags usage );
+	// Without a Renderer, e.g. for a headless device in the tests.
+	GpuRingBuffer(	VkDevice device, const VkPhysicalDeviceProperties& properties, const VkPhysicalDeviceMemoryProperties& memoryProperties,
+					GpuTimeline* timeline, VkDeviceSize frameSize, u32 frameCount, VkBufferUsageFlags usage );
+	~GpuRingBuffer();
+
+	// Moves to the next segment, waiting on the graphics timeline if the GPU may still
+	// be reading it.
+	void BeginFrame();
+	// Makes this frame's writes visible to the GPU with a single flush, call it once
+	// before submitting. Does nothing when the memory is host coherent.
+	void Flush();
+	// value is the graphics timeline value of the last submit reading this frame's data.
+	void EndFrame( u64 value );
+
+	// alignment must be a power of two
+	GpuRingAllocation Allocate( VkDeviceSize size, VkDeviceSize alignment );
+	// Aligned for use as a dynamic uniform or storage buffer offset
+	GpuRingAllocation AllocateUniform( VkDeviceSize size )					{ return Allocate(size, mUniformAlignment); }
+	GpuRingAllocation AllocateStorage( VkDeviceSize size )					{ return Allocate(size, mStorageAlignment); }
+
+	// For writing the buffer into a dynamic descriptor, range is the largest size read
+	// through one binding.
+	VkDescriptorBufferInfo GetDescriptorBufferInfo( VkDeviceSize range ) const;
+
+	VkBuffer		GetVulkanBuffer() const									{ return mBuffer; }
+	VkDeviceSize	GetFrameSize() const									{ return mFrameSize; }
+	VkDeviceSize	GetUsed() const											{ return mOffset - mFrameBegin; }
+	VkDeviceSize	GetHighWaterMark() const								{ return mHighWaterMark; }
+	bool			IsCoherent() const										{ return mIsCoherent; }
+
+private:
+	NONCOPYABLE(GpuRingBuffer);
+
+private:
+	VkDevice		mDevice = VK_NULL_HANDLE;
+	GpuTimeline*	mTimeline = nullptr;	// Segments are reused once it passes their value
+
+	VkBuffer		mBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory	mMemory = VK_NULL_HANDLE;
+	u8*				mMappedMemory = nullptr;
+	VkDeviceSize	mMemorySize = 0;
+	bool			mIsCoherent = false;
+
+	VkDeviceSize	mUniformAlignment = 1;
+	VkDeviceSize	mStorageAlignment = 1;
+	VkDeviceSize	mAtomSize = 1;		// nonCoherentAtomSize, flushes are rounded to it
+
+	VkDeviceSize	mFrameSize = 0;
+	u32				mFrameCount = 0;
+	u32				mFrameIndex = 0;
+	VkDeviceSize	mFrameBegin = 0;
+	VkDeviceSize	mOffset = 0;
+	VkDeviceSize	mFlushedOffset = 0;
+	VkDeviceSize	mHighWaterMark = 0;
+
+	std::vector<u64>	mFrameValues;	// Timeline value that last read each segment
+};
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_GPU_RING_BUFFER_H__
@@ -0,0 +1,265 @@
+//======================================================================================
+// Filename: GpuTimeline.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "GpuTimeline.h"
+
+#include "GraphicsCommon.h"
+#include "SyncObjectPool.h"
+//======================================================================================
+
+GpuTimeline::GpuTimeline(VkDevice device, VkQueue queue, std::mutex* queueMutex, SyncObjectPool* syncObjectPool, bool useTimelineSemaphore)
+	: mDevice( device )
+	, mQueue( queue )
+	, mQueueMutex( queueMutex )
+	, mSyncObjectPool( syncObjectPool )
+{
+	if (useTimelineSemaphore)
+	{
+		VkSemaphoreTypeCreateInfoKHR semaphoreTypeInfo = {};
+		semaphoreTypeInfo.sType			= VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+		semaphoreTypeInfo.semaphoreType	= VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+		semaphoreTypeInfo.initialValue	= 0;
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreCreateInfo.pNext = &semaphoreTypeInfo;
+
+		vkErrorCheck( vkCreateSemaphore(mDevice, &semaphoreCreateInfo, nullptr, &mSemaphore) );
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+GpuTimeline::~GpuTimeline()
+{
+	WaitIdle();
+
+	if (mSemaphore != VK_NULL_HANDLE)
+	{
+		vkDestroySemaphore(mDevice, mSemaphore, nullptr);
+	}
+
+	std::lock_guard<std::mutex> lock(mFenceMutex);
+	RetireFences();
+	ASSERT(mInFlightFences.empty(), "[GpuTimeline] Work still in flight on shutdown!");
+}
+
+//--------------------------------------------------------------------------------------
+
+u64 GpuTimeline::Submit(const VkSubmitInfo& submitInfo, const GpuTimelineWait* dependencies, u32 dependencyCount)
+{
+	ASSERT(submitInfo.waitSemaphoreCount + dependencyCount <= kGpuTimelineMaxWaits, "[GpuTimeline] Too many waits!");
+	ASSERT(submitInfo.signalSemaphoreCount < kGpuTimelineMaxSignals, "[GpuTimeline] Too many signals!");
+
+	return IsTimelineSemaphore()
+		? SubmitTimeline(submitInfo, dependencies, dependencyCount)
+		: SubmitFenced(submitInfo, dependencies, dependencyCount);
+}
+
+//--------------------------------------------------------------------------------------
+
+u64 GpuTimeline::GetCompletedValue()
+{
+	if (IsTimelineSemaphore())
+	{
+		uint64_t value = 0;
+		vkErrorCheck( fvkGetSemaphoreCounterValueKHR(mDevice, mSemaphore, &value) );
+		return value;
+	}
+
+	std::lock_guard<std::mutex> lock(mFenceMutex);
+	RetireFences();
+	return mCompletedValue;
+}
+
+//--------------------------------------------------------------------------------------
+
+bool GpuTimeline::Wait(u64 value, u64 timeout)
+{
+	if (value == 0)
+	{
+		return true;
+	}
+	ASSERT(value <= mSubmittedValue, "[GpuTimeline] Waiting on a value that was never submitted!");
+
+	if (IsTimelineSemaphore())
+	{
+		const uint64_t waitValue = value;
+
+		VkSemaphoreWaitInfoKHR waitInfo = {};
+		waitInfo.sType			= VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+		waitInfo.semaphoreCount	= 1;
+		waitInfo.pSemaphores	= &mSemaphore;
+		waitInfo.pValues		= &waitValue;
+
+		const VkResult result = fvkWaitSemaphoresKHR(mDevice, &waitInfo, timeout);
+		vkErrorCheck(result);
+		return result == VK_SUCCESS;
+	}
+
+	//Wait without the lock so submits and other waits aren't held up. Counting the
+	//waiter keeps the fence out of the pool until it returns.
+	VkFence fence = VK_NULL_HANDLE;
+	{
+		std::lock_guard<std::mutex> lock(mFenceMutex);
+		RetireFences();
+		for (size_t i = mInFlightHead; i < mInFlightFences.size(); ++i)
+		{
+			if (mInFlightFences[i].value >= value)
+			{
+				fence = mInFlightFences[i].fence;
+				break;
+			}
+		}
+		if (fence == VK_NULL_HANDLE)
+		{
+			return mCompletedValue >= value;
+		}
+		++mFenceWaiterCount;
+	}
+
+	const VkResult result = vkWaitForFences(mDevice, 1, &fence, VK_TRUE, timeout);
+	vkErrorCheck(result);
+
+	std::lock_guard<std::mutex> lock(mFenceMutex);
+	--mFenceWaiterCount;
+	RetireFences();
+	return result == VK_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+
+u64 GpuTimeline::SubmitTimeline(const VkSubmitInfo& submitInfo, const GpuTimelineWait* dependencies, u32 dependencyCount)
+{
+	VkSemaphore				waitSemaphores[kGpuTimelineMaxWaits] = {};
+	uint64_t				waitValues[kGpuTimelineMaxWaits] = {};
+	VkPipelineStageFlags	waitStages[kGpuTimelineMaxWaits] = {};
+	VkSemaphore				signalSemaphores[kGpuTimelineMaxSignals] = {};
+	uint64_t				signalValues[kGpuTimelineMaxSignals] = {};
+
+	uint32_t waitCount = 0;
+	for (uint32_t i = 0; i < submitInfo.waitSemaphoreCount; ++i, ++waitCount)
+	{
+		waitSemaphores[waitCount]	= submitInfo.pWaitSemaphores[i];
+		waitStages[waitCount]		= submitInfo.pWaitDstStageMask[i];
+	}
+	for (u32 i = 0; i < dependencyCount; ++i)
+	{
+		const GpuTimelineWait& dependency = dependencies[i];
+		if (dependency.timeline == this || dependency.value == 0)
+		{
+			continue; //Same queue work is already ordered
+		}
+		waitSemaphores[waitCount]	= dependency.timeline->GetVulkanSemaphore();
+		waitValues[waitCount]		= dependency.value;
+		waitStages[waitCount]		= dependency.stageMask;
+		++waitCount;
+	}
+
+	uint32_t signalCount = 0;
+	for (uint32_t i = 0; i < submitInfo.signalSemaphoreCount; ++i, ++signalCount)
+	{
+		signalSemaphores[signalCount] = submitInfo.pSignalSemaphores[i];
+	}
+
+	std::lock_guard<std::mutex> lock(*mQueueMutex);
+	const u64 value = mSubmittedValue + 1;
+	signalSemaphores[signalCount]	= mSemaphore;
+	signalValues[signalCount]		= value;
+	++signalCount;
+
+	VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {};
+	timelineInfo.sType						= VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+	timelineInfo.pNext						= submitInfo.pNext;
+	timelineInfo.waitSemaphoreValueCount	= waitCount;
+	timelineInfo.pWaitSemaphoreValues		= waitValues;
+	timelineInfo.signalSemaphoreValueCount	= signalCount;
+	timelineInfo.pSignalSemaphoreValues		= signalValues;
+
+	VkSubmitInfo timelineSubmitInfo = submitInfo;
+	timelineSubmitInfo.pNext				= &timelineInfo;
+	timelineSubmitInfo.waitSemaphoreCount	= waitCount;
+	timelineSubmitInfo.pWaitSemaphores		= waitSemaphores;
+	timelineSubmitInfo.pWaitDstStageMask	= waitStages;
+	timelineSubmitInfo.signalSemaphoreCount	= signalCount;
+	timelineSubmitInfo.pSignalSemaphores	= signalSemaphores;
+
+	vkErrorCheck( vkQueueSubmit(mQueue, 1, &timelineSubmitInfo, VK_NULL_HANDLE) );
+	mSubmittedValue = value;
+	return value;
+}
+
+//--------------------------------------------------------------------------------------
+
+u64 GpuTimeline::SubmitFenced(const VkSubmitInfo& submitInfo, const GpuTimelineWait* dependencies, u32 dependencyCount)
+{
+	//Binary semaphores cannot express "value N reached", so cross queue
+	//dependencies are resolved on the CPU before submitting
+	for (u32 i = 0; i < dependencyCount; ++i)
+	{
+		const GpuTimelineWait& dependency = dependencies[i];
+		if (dependency.timeline != this)
+		{
+			dependency.timeline->Wait(dependency.value);
+		}
+	}
+
+	std::lock_guard<std::mutex> fenceLock(mFenceMutex);
+	RetireFences();
+
+	VkFence fence = mSyncObjectPool->AcquireFence();
+
+	std::lock_guard<std::mutex> queueLock(*mQueueMutex);
+	vkErrorCheck( vkQueueSubmit(mQueue, 1, &submitInfo, fence) );
+
+	const u64 value = mSubmittedValue + 1;
+	mInFlightFences.push_back({ value, fence });
+	mSubmittedValue = value;
+	return value;
+}
+
+//--------------------------------------------------------------------------------------
+
+void GpuTimeline::RetireFences()
+{
+	while (mInFlightHead < mInFlightFences.size())
+	{
+		const InFlightFence& inFlight = mInFlightFences[mInFlightHead];
+		if (vkGetFenceStatus(mDevice, inFlight.fence) != VK_SUCCESS)
+		{
+			break;
+		}
+
+		mCompletedValue = inFlight.value;
+		++mInFlightHead;
+	}
+
+	//Only signalled fences go back to the pool, and none while a Wait may be on one
+	if (mFenceWaiterCount == 0)
+	{
+		for (; mReleasedHead < mInFlightHead; ++mReleasedHead)
+		{
+			mSyncObjectPool->ReleaseFence(mInFlightFences[mReleasedHead].fence);
+		}
+	}
+
+	if (mReleasedHead == mInFlightFences.size())
+	{
+		mInFlightFences.clear();
+		mInFlightHead = 0;
+		mReleasedHead = 0;
+	}
+	else if (mReleasedHead > mInFlightFences.size() / 2)
+	{
+		mInFlightFences.erase(mInFlightFences.begin(), mInFlightFences.begin() + mReleasedHead);
+		mInFlightHead -= mReleasedHead;
+		mReleasedHead = 0;
+	}
+}
+
+//======================================================================================
@@ -11,7 +11,9 @@
 #include "Common.h"
 
 #include <assert.h>
-#include <vulkan\vulkan.hpp>
+#include <stdint.h>
+#include <type_traits>
+#include <vulkan/vulkan.h>
 
 //======================================================================================
 // Functions
@@ -23,4 +25,32 @@ uint32_t FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties* gpuMemoryPr
 								const VkMemoryRequirements* memoryRequirements,
 								const VkMemoryPropertyFlags memoryProperties);
 
+// Non-dispatchable handles are pointers on 64-bit builds and uint64_t on 32-bit ones
+template <typename T>
+inline u64 HandleToU64(T handle)
+{
+	if constexpr (std::is_pointer<T>::value)
+	{
+		return static_cast<u64>(reinterpret_cast<uintptr_t>(handle));
+	}
+	else
+	{
+		return static_cast<u64>(handle);
+	}
+}
+
+// The inverse of HandleToU64, e.g. U64ToHandle<VkBuffer>(value)
+template <typename T>
+inline T U64ToHandle(u64 value)
+{
+	if constexpr (std::is_pointer<T>::value)
+	{
+		return reinterpret_cast<T>(static_cast<uintptr_t>(value));
+	}
+	else
+	{
+		return static_cast<T>(value);
+	}
+}
+
 #endif // INCLUDE_GRAPHICS_COMMON_H__
\ No newline at end of file
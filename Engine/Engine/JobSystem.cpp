@@ -0,0 +1,149 @@
+//======================================================================================
+// Filename: JobSystem.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "JobSystem.h"
+//======================================================================================
+
+namespace
+{
+	thread_local bool _isJobWorker = false;
+}
+
+//--------------------------------------------------------------------------------------
+
+JobSystem::JobSystem(u32 workerCount)
+{
+	if (workerCount == 0)
+	{
+		const u32 hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 0;
+	}
+
+	mWorkers.reserve(workerCount);
+	for (u32 i = 0; i < workerCount; ++i)
+	{
+		mWorkers.emplace_back(&JobSystem::Run, this);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mJobMutex);
+		mIsRunning = false;
+	}
+	mJobReady.notify_all();
+
+	for (std::thread& worker : mWorkers)
+	{
+		worker.join();
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void JobSystem::Dispatch(size_t count, size_t grainSize, RangeFunc func, const void* context)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	grainSize = (grainSize > 0) ? grainSize : 1;
+
+	//Nothing to share, or we are already on a worker and waiting would deadlock
+	if (count <= grainSize || mWorkers.empty() || _isJobWorker)
+	{
+		for (size_t begin = 0; begin < count; begin += grainSize)
+		{
+			func(context, begin, (count - begin < grainSize) ? count : begin + grainSize);
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> submitLock(mSubmitMutex);
+	{
+		//Workers still inside the previous job may be reading its parameters
+		std::unique_lock<std::mutex> lock(mJobMutex);
+		mJobDone.wait(lock, [this]() { return mActiveWorkers == 0; });
+
+		mJobFunc		= func;
+		mJobContext		= context;
+		mJobCount		= count;
+		mJobGrainSize	= grainSize;
+		mJobRangeCount	= (count + grainSize - 1) / grainSize;
+		mJobNextRange.store(0, std::memory_order_relaxed);
+		mJobPendingRanges.store(mJobRangeCount, std::memory_order_relaxed);
+		++mJobGeneration;
+	}
+	mJobReady.notify_all();
+
+	_isJobWorker = true;
+	RunRanges();
+	_isJobWorker = false;
+
+	std::unique_lock<std::mutex> lock(mJobMutex);
+	mJobDone.wait(lock, [this]() { return mJobPendingRanges.load(std::memory_order_acquire) == 0; });
+}
+
+//--------------------------------------------------------------------------------------
+
+void JobSystem::RunRanges()
+{
+	for (;;)
+	{
+		const size_t range = mJobNextRange.fetch_add(1, std::memory_order_relaxed);
+		if (range >= mJobRangeCount)
+		{
+			return;
+		}
+
+		const size_t begin = range * mJobGrainSize;
+		const size_t end = (mJobCount - begin < mJobGrainSize) ? mJobCount : begin + mJobGrainSize;
+		mJobFunc(mJobContext, begin, end);
+
+		if (mJobPendingRanges.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::lock_guard<std::mutex> lock(mJobMutex);
+			mJobDone.notify_all();
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void JobSystem::Run()
+{
+	_isJobWorker = true;
+
+	u64 generation = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mJobMutex);
+			mJobReady.wait(lock, [this, generation]() { return !mIsRunning || mJobGeneration != generation; });
+			if (!mIsRunning)
+			{
+				return;
+			}
+			generation = mJobGeneration;
+			++mActiveWorkers;
+		}
+
+		RunRanges();
+
+		{
+			std::lock_guard<std::mutex> lock(mJobMutex);
+			--mActiveWorkers;
+		}
+		mJobDone.notify_all();
+	}
+}
+
+//======================================================================================
@@ -0,0 +1,84 @@
+#ifndef ENGINE_JOB_SYSTEM_H__
+#define ENGINE_JOB_SYSTEM_H__
+//======================================================================================
+// Filename: JobSystem.h
+// Description: Fixed pool of worker threads for data parallel loops. The calling
+//				thread works on its own ParallelFor too, so a pool with no workers
+//				still makes progress.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//======================================================================================
+// Class JobSystem
+//======================================================================================
+
+class JobSystem
+{
+public:
+	// workerCount 0 uses one worker per hardware thread minus the caller
+	JobSystem( u32 workerCount = 0 );
+	~JobSystem();
+
+	// Splits [0, count) into ranges of at most grainSize and calls func(begin, end) for
+	// each, blocking until all of them are done. Calls made from inside a job run
+	// inline on that worker.
+	template <typename Func>
+	void ParallelFor( size_t count, size_t grainSize, const Func& func );
+
+	u32 GetWorkerCount() const												{ return static_cast<u32>(mWorkers.size()); }
+
+private:
+	NONCOPYABLE(JobSystem);
+
+	typedef void (*RangeFunc)(const void* context, size_t begin, size_t end);
+
+	void Dispatch( size_t count, size_t grainSize, RangeFunc func, const void* context );
+	void RunRanges();
+	void Run();
+
+private:
+	std::vector<std::thread>	mWorkers;
+
+	std::mutex					mSubmitMutex;	// One ParallelFor in flight at a time
+	std::mutex					mJobMutex;
+	std::condition_variable		mJobReady;
+	std::condition_variable		mJobDone;
+	u64							mJobGeneration = 0;
+	u32							mActiveWorkers = 0;
+	bool						mIsRunning = true;
+
+	RangeFunc					mJobFunc = nullptr;
+	const void*					mJobContext = nullptr;
+	size_t						mJobCount = 0;
+	size_t						mJobGrainSize = 0;
+	size_t						mJobRangeCount = 0;
+	std::atomic<size_t>			mJobNextRange = { 0 };
+	std::atomic<size_t>			mJobPendingRanges = { 0 };
+};
+
+//======================================================================================
+// Template Definitions
+//======================================================================================
+
+template <typename Func>
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const Func& func)
+{
+	RangeFunc invoke = [](const void* context, size_t begin, size_t end)
+	{
+		(*static_cast<const Func*>(context))(begin, end);
+	};
+	Dispatch(count, grainSize, invoke, &func);
+}
+
+//======================================================================================
+#endif // !ENGINE_JOB_SYSTEM_H__
@@ -0,0 +1,812 @@
+//======================================================================================
+// Filename: MathBatch.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "MathBatch.h"
+//======================================================================================
+
+namespace Math
+{
+
+static_assert(sizeof(Vector3) == sizeof(f32) * 3, "[Math] Vector3 must be tightly packed for the AoS kernels!");
+static_assert(sizeof(Quaternion) == sizeof(f32) * 4, "[Math] Quaternion must be tightly packed for the AoS kernels!");
+static_assert(sizeof(Matrix34d) == sizeof(f64) * 12, "[Math] Matrix34d must be tightly packed for the AoS kernels!");
+
+namespace
+{
+
+//======================================================================================
+// SIMD Helpers
+//======================================================================================
+#if MATH_SIMD_SSE4
+
+// The top three rows of m, each element splatted across a register
+struct MatrixSplat4
+{
+	__m128 e[3][4];
+
+	explicit MatrixSplat4(const Matrix& m)
+	{
+		const f32* p = &m._11;
+		for (int r = 0; r < 3; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				e[r][c] = _mm_set1_ps(p[c * 4 + r]);
+			}
+		}
+	}
+};
+
+//--------------------------------------------------------------------------------------
+
+template <bool kCoord>
+inline __m128 TransformRow(const __m128 (&row)[4], __m128 x, __m128 y, __m128 z)
+{
+	__m128 result = kCoord ? row[3] : _mm_setzero_ps();
+	result = SIMD::MulAdd(z, row[2], result);
+	result = SIMD::MulAdd(y, row[1], result);
+	return SIMD::MulAdd(x, row[0], result);
+}
+
+//--------------------------------------------------------------------------------------
+
+// Rows spelled out rather than looped over, a loop over e[r] is left rolled and spills
+// the splats and results to the stack
+template <bool kCoord>
+inline void Transform(const MatrixSplat4& m, __m128 x, __m128 y, __m128 z, __m128& outX, __m128& outY, __m128& outZ)
+{
+	outX = TransformRow<kCoord>(m.e[0], x, y, z);
+	outY = TransformRow<kCoord>(m.e[1], x, y, z);
+	outZ = TransformRow<kCoord>(m.e[2], x, y, z);
+}
+
+//--------------------------------------------------------------------------------------
+
+// 4 packed Vector3s (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) to 3 registers
+inline void Deinterleave(const f32* p, __m128& x, __m128& y, __m128& z)
+{
+	const __m128 a = _mm_loadu_ps(p + 0);
+	const __m128 b = _mm_loadu_ps(p + 4);
+	const __m128 c = _mm_loadu_ps(p + 8);
+
+	x = MATH_SHUFFLE(a, MATH_SHUFFLE(b, c, 2, 0, 1, 0), 0, 3, 0, 2);
+	y = MATH_SHUFFLE(MATH_SHUFFLE(a, b, 1, 0, 0, 0), MATH_SHUFFLE(b, c, 3, 0, 2, 0), 0, 2, 0, 2);
+	z = MATH_SHUFFLE(MATH_SHUFFLE(a, b, 2, 0, 1, 0), c, 0, 2, 0, 3);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline void Interleave(f32* p, __m128 x, __m128 y, __m128 z)
+{
+	_mm_storeu_ps(p + 0, MATH_SHUFFLE(MATH_SHUFFLE(x, y, 0, 0, 0, 0), MATH_SHUFFLE(z, x, 0, 0, 1, 1), 0, 2, 0, 2));
+	_mm_storeu_ps(p + 4, MATH_SHUFFLE(MATH_SHUFFLE(y, z, 1, 1, 1, 1), MATH_SHUFFLE(x, y, 2, 2, 2, 2), 0, 2, 0, 2));
+	_mm_storeu_ps(p + 8, MATH_SHUFFLE(MATH_SHUFFLE(z, x, 2, 2, 3, 3), MATH_SHUFFLE(y, z, 3, 3, 3, 3), 0, 2, 0, 2));
+}
+
+//--------------------------------------------------------------------------------------
+
+template <Precision kPrecision>
+inline __m128 RSqrt(__m128 v)
+{
+	if (kPrecision == Precision::Exact)
+	{
+		return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(v));
+	}
+
+	const __m128 half = _mm_mul_ps(v, _mm_set1_ps(0.5f));
+	__m128 y = _mm_rsqrt_ps(v);
+	for (int step = (kPrecision == Precision::High) ? 2 : 1; step > 0; --step)
+	{
+		y = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, _mm_mul_ps(y, y))));
+	}
+	return y;
+}
+
+//--------------------------------------------------------------------------------------
+
+template <Precision kPrecision>
+inline __m128 Sqrt(__m128 v)
+{
+	if (kPrecision == Precision::Exact)
+	{
+		return _mm_sqrt_ps(v);
+	}
+	//v * 1/sqrt(v) is NaN at 0, so mask those lanes back to 0
+	const __m128 positive = _mm_cmpgt_ps(v, _mm_setzero_ps());
+	return _mm_and_ps(_mm_mul_ps(v, RSqrt<kPrecision>(v)), positive);
+}
+
+//--------------------------------------------------------------------------------------
+
+// Same reduction and polynomials as Math::SinCos, the quadrant swap and signs are
+// applied with masks instead of a switch
+inline void SinCos(__m128 rad, __m128& sin, __m128& cos)
+{
+	const __m128 scaled = _mm_mul_ps(rad, _mm_set1_ps(Internal::kSinCosTwoByPi));
+	const __m128i quadrant = _mm_cvtps_epi32(scaled);
+	const __m128 q = _mm_cvtepi32_ps(quadrant);
+	__m128 x = _mm_sub_ps(rad, _mm_mul_ps(q, _mm_set1_ps(Internal::kSinCosPiByTwoHi)));
+	x = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(Internal::kSinCosPiByTwoMid)));
+	x = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(Internal::kSinCosPiByTwoLo)));
+	//Lanes too large to reduce get all bits set, a NaN, like Math::SinCos gives them
+	const __m128 absScaled = _mm_andnot_ps(_mm_set1_ps(-0.0f), scaled);
+	x = _mm_or_ps(x, _mm_cmpgt_ps(absScaled, _mm_set1_ps(Internal::kSinCosMaxQuadrant)));
+	const __m128 x2 = _mm_mul_ps(x, x);
+
+	__m128 s = SIMD::MulAdd(x2, _mm_set1_ps(Internal::kSinCoefficient2), _mm_set1_ps(Internal::kSinCoefficient1));
+	s = SIMD::MulAdd(x2, s, _mm_set1_ps(Internal::kSinCoefficient0));
+	s = SIMD::MulAdd(_mm_mul_ps(x, x2), s, x);
+
+	__m128 c = SIMD::MulAdd(x2, _mm_set1_ps(Internal::kCosCoefficient2), _mm_set1_ps(Internal::kCosCoefficient1));
+	c = SIMD::MulAdd(x2, c, _mm_set1_ps(Internal::kCosCoefficient0));
+	c = SIMD::MulAdd(_mm_mul_ps(x2, x2), c, _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, _mm_set1_ps(0.5f))));
+
+	const __m128i one = _mm_set1_epi32(1);
+	const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+	const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+	const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), _mm_set1_epi32(2)), 30));
+	sin = _mm_xor_ps(_mm_blendv_ps(s, c, swap), sinSign);
+	cos = _mm_xor_ps(_mm_blendv_ps(c, s, swap), cosSign);
+}
+
+//--------------------------------------------------------------------------------------
+
+// 4 quaternions transposed into one register per component
+struct QuaternionSoA4
+{
+	__m128 x, y, z, w;
+
+	explicit QuaternionSoA4(const Quaternion* q)
+	{
+		x = _mm_loadu_ps(&q[0].x);
+		y = _mm_loadu_ps(&q[1].x);
+		z = _mm_loadu_ps(&q[2].x);
+		w = _mm_loadu_ps(&q[3].x);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+	}
+
+	QuaternionSoA4(__m128 x, __m128 y, __m128 z, __m128 w) : x(x), y(y), z(z), w(w) {}
+
+	void Store(Quaternion* q) const
+	{
+		__m128 r0 = x, r1 = y, r2 = z, r3 = w;
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_storeu_ps(&q[0].x, r0);
+		_mm_storeu_ps(&q[1].x, r1);
+		_mm_storeu_ps(&q[2].x, r2);
+		_mm_storeu_ps(&q[3].x, r3);
+	}
+};
+
+//--------------------------------------------------------------------------------------
+
+inline QuaternionSoA4 Multiply(const QuaternionSoA4& a, const QuaternionSoA4& b)
+{
+	const __m128 x = _mm_sub_ps(SIMD::MulAdd(a.w, b.x, SIMD::MulAdd(a.x, b.w, _mm_mul_ps(a.y, b.z))), _mm_mul_ps(a.z, b.y));
+	const __m128 y = _mm_sub_ps(SIMD::MulAdd(a.w, b.y, SIMD::MulAdd(a.y, b.w, _mm_mul_ps(a.z, b.x))), _mm_mul_ps(a.x, b.z));
+	const __m128 z = _mm_sub_ps(SIMD::MulAdd(a.w, b.z, SIMD::MulAdd(a.z, b.w, _mm_mul_ps(a.x, b.y))), _mm_mul_ps(a.y, b.x));
+	const __m128 w = _mm_sub_ps(_mm_mul_ps(a.w, b.w), SIMD::MulAdd(a.x, b.x, SIMD::MulAdd(a.y, b.y, _mm_mul_ps(a.z, b.z))));
+	return QuaternionSoA4(x, y, z, w);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline __m128 Dot(const QuaternionSoA4& a, const QuaternionSoA4& b)
+{
+	return SIMD::MulAdd(a.x, b.x, SIMD::MulAdd(a.y, b.y, SIMD::MulAdd(a.z, b.z, _mm_mul_ps(a.w, b.w))));
+}
+
+//--------------------------------------------------------------------------------------
+
+inline QuaternionSoA4 Blend(const QuaternionSoA4& a, __m128 c0, const QuaternionSoA4& b, __m128 c1)
+{
+	return QuaternionSoA4
+	(
+		SIMD::MulAdd(a.x, c0, _mm_mul_ps(b.x, c1)),
+		SIMD::MulAdd(a.y, c0, _mm_mul_ps(b.y, c1)),
+		SIMD::MulAdd(a.z, c0, _mm_mul_ps(b.z, c1)),
+		SIMD::MulAdd(a.w, c0, _mm_mul_ps(b.w, c1))
+	);
+}
+
+#endif //MATH_SIMD_SSE4
+
+//--------------------------------------------------------------------------------------
+#if MATH_SIMD_AVX2
+
+struct MatrixSplat8
+{
+	__m256 e[3][4];
+
+	explicit MatrixSplat8(const Matrix& m)
+	{
+		const f32* p = &m._11;
+		for (int r = 0; r < 3; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				e[r][c] = _mm256_set1_ps(p[c * 4 + r]);
+			}
+		}
+	}
+};
+
+//--------------------------------------------------------------------------------------
+
+template <bool kCoord>
+inline __m256 TransformRow(const __m256 (&row)[4], __m256 x, __m256 y, __m256 z)
+{
+	__m256 result = kCoord ? row[3] : _mm256_setzero_ps();
+	result = _mm256_fmadd_ps(z, row[2], result);
+	result = _mm256_fmadd_ps(y, row[1], result);
+	return _mm256_fmadd_ps(x, row[0], result);
+}
+
+//--------------------------------------------------------------------------------------
+
+// Rows spelled out rather than looped over, a loop over e[r] is left rolled and spills
+// the splats and results to the stack
+template <bool kCoord>
+inline void Transform(const MatrixSplat8& m, __m256 x, __m256 y, __m256 z, __m256& outX, __m256& outY, __m256& outZ)
+{
+	outX = TransformRow<kCoord>(m.e[0], x, y, z);
+	outY = TransformRow<kCoord>(m.e[1], x, y, z);
+	outZ = TransformRow<kCoord>(m.e[2], x, y, z);
+}
+
+//--------------------------------------------------------------------------------------
+
+template <Precision kPrecision>
+inline __m256 RSqrt(__m256 v)
+{
+	if (kPrecision == Precision::Exact)
+	{
+		return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(v));
+	}
+
+	const __m256 half = _mm256_mul_ps(v, _mm256_set1_ps(0.5f));
+	__m256 y = _mm256_rsqrt_ps(v);
+	for (int step = (kPrecision == Precision::High) ? 2 : 1; step > 0; --step)
+	{
+		y = _mm256_mul_ps(y, _mm256_fnmadd_ps(half, _mm256_mul_ps(y, y), _mm256_set1_ps(1.5f)));
+	}
+	return y;
+}
+
+//--------------------------------------------------------------------------------------
+
+template <Precision kPrecision>
+inline __m256 Sqrt(__m256 v)
+{
+	if (kPrecision == Precision::Exact)
+	{
+		return _mm256_sqrt_ps(v);
+	}
+	const __m256 positive = _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GT_OQ);
+	return _mm256_and_ps(_mm256_mul_ps(v, RSqrt<kPrecision>(v)), positive);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline void SinCos(__m256 rad, __m256& sin, __m256& cos)
+{
+	const __m256 scaled = _mm256_mul_ps(rad, _mm256_set1_ps(Internal::kSinCosTwoByPi));
+	const __m256i quadrant = _mm256_cvtps_epi32(scaled);
+	const __m256 q = _mm256_cvtepi32_ps(quadrant);
+	__m256 x = _mm256_fnmadd_ps(q, _mm256_set1_ps(Internal::kSinCosPiByTwoHi), rad);
+	x = _mm256_fnmadd_ps(q, _mm256_set1_ps(Internal::kSinCosPiByTwoMid), x);
+	x = _mm256_fnmadd_ps(q, _mm256_set1_ps(Internal::kSinCosPiByTwoLo), x);
+	const __m256 absScaled = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), scaled);
+	x = _mm256_or_ps(x, _mm256_cmp_ps(absScaled, _mm256_set1_ps(Internal::kSinCosMaxQuadrant), _CMP_GT_OQ));
+	const __m256 x2 = _mm256_mul_ps(x, x);
+
+	__m256 s = _mm256_fmadd_ps(x2, _mm256_set1_ps(Internal::kSinCoefficient2), _mm256_set1_ps(Internal::kSinCoefficient1));
+	s = _mm256_fmadd_ps(x2, s, _mm256_set1_ps(Internal::kSinCoefficient0));
+	s = _mm256_fmadd_ps(_mm256_mul_ps(x, x2), s, x);
+
+	__m256 c = _mm256_fmadd_ps(x2, _mm256_set1_ps(Internal::kCosCoefficient2), _mm256_set1_ps(Internal::kCosCoefficient1));
+	c = _mm256_fmadd_ps(x2, c, _mm256_set1_ps(Internal::kCosCoefficient0));
+	c = _mm256_fmadd_ps(_mm256_mul_ps(x2, x2), c, _mm256_fnmadd_ps(x2, _mm256_set1_ps(0.5f), _mm256_set1_ps(1.0f)));
+
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+	const __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+	const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), _mm256_set1_epi32(2)), 30));
+	sin = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+	cos = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+}
+
+#endif //MATH_SIMD_AVX2
+
+//======================================================================================
+// Kernels
+//======================================================================================
+
+template <bool kCoord>
+inline Vector3 TransformOne(const Vector3& v, const Matrix& m)
+{
+	return kCoord ? TransformCoord(v, m) : TransformNormal(v, m);
+}
+
+//--------------------------------------------------------------------------------------
+
+template <bool kCoord>
+void TransformAoS(Span<const Vector3> v, const Matrix& m, Span<Vector3> out)
+{
+	ASSERT(out.size >= v.size, "[Math] Output span is smaller than the input!");
+
+	size_t i = 0;
+#if MATH_SIMD_SSE4
+	const f32* src = reinterpret_cast<const f32*>(v.data);
+	f32* dst = reinterpret_cast<f32*>(out.data);
+
+#if MATH_SIMD_AVX2
+	const MatrixSplat8 m8(m);
+	for (; i + 8 <= v.size; i += 8)
+	{
+		__m128 x0, y0, z0, x1, y1, z1;
+		Deinterleave(src + i * 3, x0, y0, z0);
+		Deinterleave(src + i * 3 + 12, x1, y1, z1);
+
+		__m256 x, y, z;
+		Transform<kCoord>(m8, _mm256_set_m128(x1, x0), _mm256_set_m128(y1, y0), _mm256_set_m128(z1, z0), x, y, z);
+
+		Interleave(dst + i * 3, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z));
+		Interleave(dst + i * 3 + 12, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1));
+	}
+#endif //MATH_SIMD_AVX2
+
+	const MatrixSplat4 m4(m);
+	for (; i + 4 <= v.size; i += 4)
+	{
+		__m128 x, y, z;
+		Deinterleave(src + i * 3, x, y, z);
+		Transform<kCoord>(m4, x, y, z, x, y, z);
+		Interleave(dst + i * 3, x, y, z);
+	}
+#endif //MATH_SIMD_SSE4
+
+	for (; i < v.size; ++i)
+	{
+		out.data[i] = TransformOne<kCoord>(v.data[i], m);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+// Streams taken by copy so the stores through them can't alias the pointers, which
+// would reload them every iteration
+template <bool kCoord>
+void TransformSoA(Vector3SoA v, const Matrix& m, Vector3SoA out)
+{
+	ASSERT(out.count >= v.count, "[Math] Output stream is smaller than the input!");
+
+	size_t i = 0;
+#if MATH_SIMD_AVX2
+	const MatrixSplat8 m8(m);
+	for (; i + 8 <= v.count; i += 8)
+	{
+		__m256 x, y, z;
+		Transform<kCoord>(m8, _mm256_loadu_ps(v.x + i), _mm256_loadu_ps(v.y + i), _mm256_loadu_ps(v.z + i), x, y, z);
+		_mm256_storeu_ps(out.x + i, x);
+		_mm256_storeu_ps(out.y + i, y);
+		_mm256_storeu_ps(out.z + i, z);
+	}
+#endif //MATH_SIMD_AVX2
+
+#if MATH_SIMD_SSE4
+	const MatrixSplat4 m4(m);
+	for (; i + 4 <= v.count; i += 4)
+	{
+		__m128 x, y, z;
+		Transform<kCoord>(m4, _mm_loadu_ps(v.x + i), _mm_loadu_ps(v.y + i), _mm_loadu_ps(v.z + i), x, y, z);
+		_mm_storeu_ps(out.x + i, x);
+		_mm_storeu_ps(out.y + i, y);
+		_mm_storeu_ps(out.z + i, z);
+	}
+#endif //MATH_SIMD_SSE4
+
+	for (; i < v.count; ++i)
+	{
+		const Vector3 result = TransformOne<kCoord>(Vector3(v.x[i], v.y[i], v.z[i]), m);
+		out.x[i] = result.x;
+		out.y[i] = result.y;
+		out.z[i] = result.z;
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+template <Precision kPrecision, bool kInverse>
+void SqrtArray(Span<const f32> v, Span<f32> out)
+{
+	ASSERT(out.size >= v.size, "[Math] Output span is smaller than the input!");
+
+	size_t i = 0;
+#if MATH_SIMD_AVX2
+	for (; i + 8 <= v.size; i += 8)
+	{
+		const __m256 x = _mm256_loadu_ps(v.data + i);
+		_mm256_storeu_ps(out.data + i, kInverse ? RSqrt<kPrecision>(x) : Sqrt<kPrecision>(x));
+	}
+#endif //MATH_SIMD_AVX2
+
+#if MATH_SIMD_SSE4
+	for (; i + 4 <= v.size; i += 4)
+	{
+		const __m128 x = _mm_loadu_ps(v.data + i);
+		_mm_storeu_ps(out.data + i, kInverse ? RSqrt<kPrecision>(x) : Sqrt<kPrecision>(x));
+	}
+#endif //MATH_SIMD_SSE4
+
+	for (; i < v.size; ++i)
+	{
+		out.data[i] = kInverse ? Math::RSqrt(v.data[i], kPrecision) : Math::Sqrt(v.data[i], kPrecision);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+template <bool kInverse>
+void SqrtArray(Span<const f32> v, Span<f32> out, Precision precision)
+{
+	switch (precision)
+	{
+	case Precision::High:	SqrtArray<Precision::High, kInverse>(v, out); break;
+	case Precision::Low:	SqrtArray<Precision::Low, kInverse>(v, out); break;
+	default:				SqrtArray<Precision::Exact, kInverse>(v, out); break;
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+template <bool kSin, bool kCos>
+void SinCosArray(Span<const f32> rad, f32* sinOut, f32* cosOut)
+{
+	size_t i = 0;
+#if MATH_SIMD_AVX2
+	for (; i + 8 <= rad.size; i += 8)
+	{
+		__m256 s, c;
+		SinCos(_mm256_loadu_ps(rad.data + i), s, c);
+		if (kSin)
+		{
+			_mm256_storeu_ps(sinOut + i, s);
+		}
+		if (kCos)
+		{
+			_mm256_storeu_ps(cosOut + i, c);
+		}
+	}
+#endif //MATH_SIMD_AVX2
+
+#if MATH_SIMD_SSE4
+	for (; i + 4 <= rad.size; i += 4)
+	{
+		__m128 s, c;
+		SinCos(_mm_loadu_ps(rad.data + i), s, c);
+		if (kSin)
+		{
+			_mm_storeu_ps(sinOut + i, s);
+		}
+		if (kCos)
+		{
+			_mm_storeu_ps(cosOut + i, c);
+		}
+	}
+#endif //MATH_SIMD_SSE4
+
+	for (; i < rad.size; ++i)
+	{
+		f32 s, c;
+		Math::SinCos(rad.data[i], s, c);
+		if (kSin)
+		{
+			sinOut[i] = s;
+		}
+		if (kCos)
+		{
+			cosOut[i] = c;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+// Eberly, "A Fast and Accurate Algorithm for Computing SLERP". Evaluates
+// sin(t * theta) / sin(theta) from cos(theta) >= 0 as a polynomial in t^2.
+struct SlerpPolynomial
+{
+	static constexpr int kTerms = 8;
+	f32 u[kTerms];
+	f32 v[kTerms];
+
+	SlerpPolynomial()
+	{
+		const f32 onePlusMu = 1.90110745351730037f;
+		for (int i = 0; i < kTerms; ++i)
+		{
+			const f32 n = static_cast<f32>(i + 1);
+			u[i] = 1.0f / (n * (2.0f * n + 1.0f));
+			v[i] = n / (2.0f * n + 1.0f);
+		}
+		u[kTerms - 1] *= onePlusMu;
+		v[kTerms - 1] *= onePlusMu;
+	}
+
+	f32 Evaluate(f32 cosTheta, f32 t) const
+	{
+		const f32 xm1 = cosTheta - 1.0f;
+		const f32 t2 = t * t;
+		f32 c = 1.0f;
+		for (int i = kTerms - 1; i >= 0; --i)
+		{
+			c = 1.0f + ((u[i] * t2) - v[i]) * xm1 * c;
+		}
+		return t * c;
+	}
+
+#if MATH_SIMD_SSE4
+	__m128 Evaluate(__m128 cosTheta, f32 t) const
+	{
+		const __m128 xm1 = _mm_sub_ps(cosTheta, _mm_set1_ps(1.0f));
+		const __m128 one = _mm_set1_ps(1.0f);
+		__m128 c = one;
+		for (int i = kTerms - 1; i >= 0; --i)
+		{
+			const __m128 b = _mm_mul_ps(_mm_set1_ps((u[i] * t * t) - v[i]), xm1);
+			c = SIMD::MulAdd(b, c, one);
+		}
+		return _mm_mul_ps(_mm_set1_ps(t), c);
+	}
+#endif //MATH_SIMD_SSE4
+};
+
+//--------------------------------------------------------------------------------------
+
+inline Quaternion SlerpOne(const SlerpPolynomial& polynomial, const Quaternion& q0, const Quaternion& q1, f32 t)
+{
+	const f32 cosTheta = Dot(q0, q1);
+	const f32 sign = (cosTheta < 0.0f) ? -1.0f : 1.0f;
+	const f32 c0 = polynomial.Evaluate(cosTheta * sign, 1.0f - t);
+	const f32 c1 = polynomial.Evaluate(cosTheta * sign, t) * sign;
+	return (q0 * c0) + (q1 * c1);
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void TransformCoord(Span<const Vector3> v, const Matrix& m, Span<Vector3> out)
+{
+	TransformAoS<true>(v, m, out);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformNormal(Span<const Vector3> v, const Matrix& m, Span<Vector3> out)
+{
+	TransformAoS<false>(v, m, out);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformCoord(const Vector3SoA& v, const Matrix& m, const Vector3SoA& out)
+{
+	TransformSoA<true>(v, m, out);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformNormal(const Vector3SoA& v, const Matrix& m, const Vector3SoA& out)
+{
+	TransformSoA<false>(v, m, out);
+}
+
+//--------------------------------------------------------------------------------------
+
+void Sqrt(Span<const f32> v, Span<f32> out, Precision precision)
+{
+	SqrtArray<false>(v, out, precision);
+}
+
+//--------------------------------------------------------------------------------------
+
+void RSqrt(Span<const f32> v, Span<f32> out, Precision precision)
+{
+	SqrtArray<true>(v, out, precision);
+}
+
+//--------------------------------------------------------------------------------------
+
+void SinCos(Span<const f32> rad, Span<f32> sin, Span<f32> cos)
+{
+	ASSERT(sin.size >= rad.size && cos.size >= rad.size, "[Math] Output span is smaller than the input!");
+	SinCosArray<true, true>(rad, sin.data, cos.data);
+}
+
+//--------------------------------------------------------------------------------------
+
+void Sin(Span<const f32> rad, Span<f32> out)
+{
+	ASSERT(out.size >= rad.size, "[Math] Output span is smaller than the input!");
+	SinCosArray<true, false>(rad, out.data, nullptr);
+}
+
+//--------------------------------------------------------------------------------------
+
+void Cos(Span<const f32> rad, Span<f32> out)
+{
+	ASSERT(out.size >= rad.size, "[Math] Output span is smaller than the input!");
+	SinCosArray<false, true>(rad, nullptr, out.data);
+}
+
+//--------------------------------------------------------------------------------------
+
+void Multiply(Span<const Quaternion> a, Span<const Quaternion> b, Span<Quaternion> out)
+{
+	ASSERT(a.size == b.size && out.size >= a.size, "[Math] Mismatched quaternion spans!");
+
+	size_t i = 0;
+#if MATH_SIMD_SSE4
+	for (; i + 4 <= a.size; i += 4)
+	{
+		Multiply(QuaternionSoA4(a.data + i), QuaternionSoA4(b.data + i)).Store(out.data + i);
+	}
+#endif //MATH_SIMD_SSE4
+
+	for (; i < a.size; ++i)
+	{
+		out.data[i] = a.data[i] * b.data[i];
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void Nlerp(Span<const Quaternion> q0, Span<const Quaternion> q1, f32 t, Span<Quaternion> out)
+{
+	ASSERT(q0.size == q1.size && out.size >= q0.size, "[Math] Mismatched quaternion spans!");
+
+	size_t i = 0;
+#if MATH_SIMD_SSE4
+	const __m128 c0 = _mm_set1_ps(1.0f - t);
+	const __m128 c1 = _mm_set1_ps(t);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= q0.size; i += 4)
+	{
+		const QuaternionSoA4 a(q0.data + i);
+		const QuaternionSoA4 b(q1.data + i);
+
+		//Negate t where the quaternions are in opposite hemispheres
+		const __m128 sign = _mm_and_ps(Dot(a, b), signBit);
+		const QuaternionSoA4 q = Blend(a, c0, b, _mm_xor_ps(c1, sign));
+
+		const __m128 invMagnitude = RSqrt<Precision::Exact>(Dot(q, q));
+		QuaternionSoA4
+		(
+			_mm_mul_ps(q.x, invMagnitude),
+			_mm_mul_ps(q.y, invMagnitude),
+			_mm_mul_ps(q.z, invMagnitude),
+			_mm_mul_ps(q.w, invMagnitude)
+		).Store(out.data + i);
+	}
+#endif //MATH_SIMD_SSE4
+
+	for (; i < q0.size; ++i)
+	{
+		out.data[i] = Nlerp(q0.data[i], q1.data[i], t);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void Slerp(Span<const Quaternion> q0, Span<const Quaternion> q1, f32 t, Span<Quaternion> out)
+{
+	ASSERT(q0.size == q1.size && out.size >= q0.size, "[Math] Mismatched quaternion spans!");
+
+	const SlerpPolynomial polynomial;
+
+	size_t i = 0;
+#if MATH_SIMD_SSE4
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= q0.size; i += 4)
+	{
+		const QuaternionSoA4 a(q0.data + i);
+		const QuaternionSoA4 b(q1.data + i);
+
+		const __m128 cosTheta = Dot(a, b);
+		const __m128 sign = _mm_and_ps(cosTheta, signBit);
+		const __m128 absCosTheta = _mm_xor_ps(cosTheta, sign);
+
+		const __m128 c0 = polynomial.Evaluate(absCosTheta, 1.0f - t);
+		const __m128 c1 = _mm_xor_ps(polynomial.Evaluate(absCosTheta, t), sign);
+		Blend(a, c0, b, c1).Store(out.data + i);
+	}
+#endif //MATH_SIMD_SSE4
+
+	for (; i < q0.size; ++i)
+	{
+		out.data[i] = SlerpOne(polynomial, q0.data[i], q1.data[i], t);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void PackAffine(Span<const Matrix> m, Span<Matrix34> out)
+{
+	ASSERT(out.size >= m.size, "[Math] Output span is smaller than the input!");
+
+	for (size_t i = 0; i < m.size; ++i)
+	{
+#if MATH_SIMD_SSE4
+		//Transposing the column major storage gives the rows, the 4th row is dropped
+		const f32* src = &m.data[i]._11;
+		__m128 r0 = SIMD::Load(src + 0);
+		__m128 r1 = SIMD::Load(src + 4);
+		__m128 r2 = SIMD::Load(src + 8);
+		__m128 r3 = SIMD::Load(src + 12);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+		f32* dst = &out.data[i]._11;
+		_mm_storeu_ps(dst + 0, r0);
+		_mm_storeu_ps(dst + 4, r1);
+		_mm_storeu_ps(dst + 8, r2);
+#else
+		out.data[i] = Matrix34(m.data[i]);
+#endif //MATH_SIMD_SSE4
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void ToCameraRelative(Span<const Matrix34d> m, const Vector3d& camera, Span<Matrix34> out)
+{
+	ASSERT(out.size >= m.size, "[Math] Output span is smaller than the input!");
+
+	const f64 cameraRow[3] = { camera.x, camera.y, camera.z };
+	for (size_t i = 0; i < m.size; ++i)
+	{
+		const f64* src = &m.data[i]._11;
+		f32* dst = &out.data[i]._11;
+		for (int r = 0; r < 3; ++r)
+		{
+			//Each row is the 3 basis values plus the translation, only the last lane
+			//has the camera subtracted
+#if MATH_SIMD_AVX2
+			const __m256d row = _mm256_sub_pd(_mm256_loadu_pd(src + r * 4), _mm256_set_pd(cameraRow[r], 0.0, 0.0, 0.0));
+			_mm_storeu_ps(dst + r * 4, _mm256_cvtpd_ps(row));
+#elif MATH_SIMD_SSE4
+			const __m128d lo = _mm_loadu_pd(src + r * 4);
+			const __m128d hi = _mm_sub_pd(_mm_loadu_pd(src + r * 4 + 2), _mm_set_pd(cameraRow[r], 0.0));
+			_mm_storeu_ps(dst + r * 4, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+#else
+			dst[r * 4 + 0] = static_cast<f32>(src[r * 4 + 0]);
+			dst[r * 4 + 1] = static_cast<f32>(src[r * 4 + 1]);
+			dst[r * 4 + 2] = static_cast<f32>(src[r * 4 + 2]);
+			dst[r * 4 + 3] = static_cast<f32>(src[r * 4 + 3] - cameraRow[r]);
+#endif //MATH_SIMD_AVX2
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void ToCameraRelative(Span<const Vector3d> positions, const Vector3d& camera, Span<Vector3> out)
+{
+	ASSERT(out.size >= positions.size, "[Math] Output span is smaller than the input!");
+
+	for (size_t i = 0; i < positions.size; ++i)
+	{
+		out.data[i] = ToCameraRelative(positions.data[i], camera);
+	}
+}
+
+} // namespace Math
+//======================================================================================
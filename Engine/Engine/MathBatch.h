@@ -0,0 +1,76 @@
+#ifndef ENGINE_MATH_BATCH_H__
+#define ENGINE_MATH_BATCH_H__
+//======================================================================================
+// Filename: MathBatch.h
+// Description: Array versions of the EngineMath functions for per-vertex and
+//				per-particle loops. Results match the single element functions unless
+//				noted, the SIMD paths just process 4 or 8 elements per iteration.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "EngineMath.h"
+#include "Span.h"
+
+namespace Math
+{
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+// Structure of arrays position stream. All three arrays hold count elements.
+struct Vector3SoA
+{
+	f32*	x = nullptr;
+	f32*	y = nullptr;
+	f32*	z = nullptr;
+	size_t	count = 0;
+
+	Vector3SoA() = default;
+	Vector3SoA(f32* x, f32* y, f32* z, size_t count) : x(x), y(y), z(z), count(count) {}
+};
+
+//======================================================================================
+// Function Declarations
+//======================================================================================
+
+// out may alias v. out.size must be at least v.size.
+void TransformCoord(Span<const Vector3> v, const Matrix& m, Span<Vector3> out);
+void TransformNormal(Span<const Vector3> v, const Matrix& m, Span<Vector3> out);
+
+// out may alias v. out.count must be at least v.count.
+void TransformCoord(const Vector3SoA& v, const Matrix& m, const Vector3SoA& out);
+void TransformNormal(const Vector3SoA& v, const Matrix& m, const Vector3SoA& out);
+
+// out may alias v. Same error bounds as the scalar versions, see Precision.
+void Sqrt(Span<const f32> v, Span<f32> out, Precision precision = Precision::Exact);
+void RSqrt(Span<const f32> v, Span<f32> out, Precision precision = Precision::Exact);
+
+// Same error bound as the scalar versions. Outputs may alias rad.
+void SinCos(Span<const f32> rad, Span<f32> sin, Span<f32> cos);
+void Sin(Span<const f32> rad, Span<f32> out);
+void Cos(Span<const f32> rad, Span<f32> out);
+
+// Per element a[i] * b[i]. out may alias a or b.
+void Multiply(Span<const Quaternion> a, Span<const Quaternion> b, Span<Quaternion> out);
+
+// Blends q0[i] towards q1[i] by t, e.g. two animation poses. out may alias q0 or q1.
+// Slerp uses a trig free polynomial (Eberly), max error 4e-5 per component.
+void Nlerp(Span<const Quaternion> q0, Span<const Quaternion> q1, f32 t, Span<Quaternion> out);
+void Slerp(Span<const Quaternion> q0, Span<const Quaternion> q1, f32 t, Span<Quaternion> out);
+
+// Drops the bottom row of each affine Matrix. out can point straight into a mapped
+// buffer to upload 48 bytes per transform instead of 64.
+void PackAffine(Span<const Matrix> m, Span<Matrix34> out);
+
+// Per frame camera relative conversion of the world state, see the scalar versions.
+// out can point straight into a mapped buffer.
+void ToCameraRelative(Span<const Matrix34d> m, const Vector3d& camera, Span<Matrix34> out);
+void ToCameraRelative(Span<const Vector3d> positions, const Vector3d& camera, Span<Vector3> out);
+
+} // namespace Math
+
+//======================================================================================
+#endif // !ENGINE_MATH_BATCH_H__
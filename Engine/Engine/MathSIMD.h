@@ -0,0 +1,103 @@
+#ifndef ENGINE_MATH_SIMD_H__
+#define ENGINE_MATH_SIMD_H__
+//======================================================================================
+// Filename: MathSIMD.h
+// Description: Instruction set selection and small helpers shared by the SIMD paths
+//				of the math library. SSE4.1 is the baseline, AVX2/FMA is used when the
+//				compiler is allowed to emit it (/arch:AVX2).
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+
+//======================================================================================
+// Defines
+//======================================================================================
+
+#if BUILD_ENABLE_MATH_SIMD
+#define MATH_SIMD_SSE4 1
+#include <smmintrin.h>
+
+#if defined(__AVX2__)
+#define MATH_SIMD_AVX2 1
+#include <immintrin.h>
+#else
+#define MATH_SIMD_AVX2 0
+#endif
+
+#else
+#define MATH_SIMD_SSE4 0
+#define MATH_SIMD_AVX2 0
+#endif //BUILD_ENABLE_MATH_SIMD
+
+#if BUILD_ENABLE_MATH_ALIGNED_MATRIX
+#define MATH_MATRIX_ALIGN alignas(16)
+#else
+#define MATH_MATRIX_ALIGN
+#endif
+
+//======================================================================================
+// Helpers
+//======================================================================================
+#if MATH_SIMD_SSE4
+
+#define MATH_SHUFFLE_MASK(x, y, z, w)		((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define MATH_SWIZZLE(v, x, y, z, w)			_mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), MATH_SHUFFLE_MASK(x, y, z, w)))
+#define MATH_SHUFFLE(a, b, x, y, z, w)		_mm_shuffle_ps(a, b, MATH_SHUFFLE_MASK(x, y, z, w))
+
+namespace Math
+{
+namespace SIMD
+{
+
+#if BUILD_ENABLE_MATH_ALIGNED_MATRIX
+inline __m128 Load(const f32* p)							{ return _mm_load_ps(p); }
+inline void Store(f32* p, __m128 v)							{ _mm_store_ps(p, v); }
+#else
+inline __m128 Load(const f32* p)							{ return _mm_loadu_ps(p); }
+inline void Store(f32* p, __m128 v)							{ _mm_storeu_ps(p, v); }
+#endif
+
+// a * b + c
+inline __m128 MulAdd(__m128 a, __m128 b, __m128 c)
+{
+#if MATH_SIMD_AVX2
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+//--------------------------------------------------------------------------------------
+// 2x2 blocks packed as (m00, m01, m10, m11), used by the block inverse
+
+// A * B
+inline __m128 Mat2Mul(__m128 a, __m128 b)
+{
+	return _mm_add_ps(_mm_mul_ps(a, MATH_SWIZZLE(b, 0, 3, 0, 3)),
+					  _mm_mul_ps(MATH_SWIZZLE(a, 1, 0, 3, 2), MATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adj(A) * B
+inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(MATH_SWIZZLE(a, 3, 3, 0, 0), b),
+					  _mm_mul_ps(MATH_SWIZZLE(a, 1, 1, 2, 2), MATH_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// A * adj(B)
+inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(a, MATH_SWIZZLE(b, 3, 0, 3, 0)),
+					  _mm_mul_ps(MATH_SWIZZLE(a, 1, 0, 3, 2), MATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+} // namespace SIMD
+} // namespace Math
+
+#endif //MATH_SIMD_SSE4
+
+//======================================================================================
+#endif // !ENGINE_MATH_SIMD_H__
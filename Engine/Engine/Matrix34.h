@@ -0,0 +1,74 @@
+#ifndef ENGINE_MATRIX34_H__
+#define ENGINE_MATRIX34_H__
+//======================================================================================
+// Filename: Matrix34.h
+// Description: Affine transform with the constant bottom row of a Matrix dropped.
+//				Stored as three rows so the 48 bytes can be uploaded as is and applied
+//				in a shader with one dot product per row:
+//					vec3(dot(m[0], p), dot(m[1], p), dot(m[2], p)) with p.w = 1
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "MathSIMD.h"
+
+namespace Math
+{
+
+struct Matrix;
+struct Quaternion;
+struct Vector3;
+
+//======================================================================================
+// Struct
+//======================================================================================
+
+struct MATH_MATRIX_ALIGN Matrix34
+{
+	f32 _11, _12, _13, _14;
+	f32 _21, _22, _23, _24;
+	f32 _31, _32, _33, _34;
+
+	constexpr Matrix34()
+		: _11(1.0f), _12(0.0f), _13(0.0f), _14(0.0f)
+		, _21(0.0f), _22(1.0f), _23(0.0f), _24(0.0f)
+		, _31(0.0f), _32(0.0f), _33(1.0f), _34(0.0f)
+	{}
+
+	constexpr Matrix34(	f32 _11, f32 _12, f32 _13, f32 _14,
+				f32 _21, f32 _22, f32 _23, f32 _24,
+				f32 _31, f32 _32, f32 _33, f32 _34	)
+		: _11(_11), _12(_12), _13(_13), _14(_14)
+		, _21(_21), _22(_22), _23(_23), _24(_24)
+		, _31(_31), _32(_32), _33(_33), _34(_34)
+	{}
+
+	// m must be affine, the bottom row is ignored
+	explicit constexpr Matrix34(const Matrix& m);
+
+	static constexpr Matrix34 Identity();
+	static constexpr Matrix34 Translation(const Vector3& v);
+	static constexpr Matrix34 Scaling(const Vector3& s);
+	static constexpr Matrix34 RotationQuaternion(const Quaternion& q);
+	// Translation * Rotation * Scaling
+	static constexpr Matrix34 Compose(const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
+
+	constexpr Matrix ToMatrix() const;
+	constexpr Vector3 GetTranslation() const;
+
+	Matrix34 operator*(const Matrix34& rhs) const;
+};
+
+static_assert(sizeof(Matrix34) == 48, "[Math] Matrix34 must stay 48 bytes for uploads!");
+
+} // namespace Math
+
+//======================================================================================
+// Inline
+//======================================================================================
+#include "Matrix34.inl"
+
+//======================================================================================
+#endif // !ENGINE_MATRIX34_H__
@@ -0,0 +1,154 @@
+//======================================================================================
+// Filename: Matrix34.inl
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Matrix.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+
+namespace Math
+{
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+constexpr Matrix34::Matrix34(const Matrix& m)
+	: _11(m._11), _12(m._12), _13(m._13), _14(m._14)
+	, _21(m._21), _22(m._22), _23(m._23), _24(m._24)
+	, _31(m._31), _32(m._32), _33(m._33), _34(m._34)
+{}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34 Matrix34::Identity()
+{
+	return Matrix34();
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34 Matrix34::Translation(const Vector3& v)
+{
+	return Matrix34
+	(
+		1.0f, 0.0f, 0.0f, v.x,
+		0.0f, 1.0f, 0.0f, v.y,
+		0.0f, 0.0f, 1.0f, v.z
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34 Matrix34::Scaling(const Vector3& s)
+{
+	return Matrix34
+	(
+		s.x, 0.0f, 0.0f, 0.0f,
+		0.0f, s.y, 0.0f, 0.0f,
+		0.0f, 0.0f, s.z, 0.0f
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34 Matrix34::RotationQuaternion(const Quaternion& q)
+{
+	return Compose(Vector3::Zero(), q, Vector3::One());
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34 Matrix34::Compose(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+{
+	//rotation must be unit length
+	const Quaternion& q = rotation;
+	const f32 xx = q.x * q.x;
+	const f32 yy = q.y * q.y;
+	const f32 zz = q.z * q.z;
+	const f32 xy = q.x * q.y;
+	const f32 xz = q.x * q.z;
+	const f32 yz = q.y * q.z;
+	const f32 wx = q.w * q.x;
+	const f32 wy = q.w * q.y;
+	const f32 wz = q.w * q.z;
+	return Matrix34
+	(
+		(1.0f - 2.0f * (yy + zz)) * scale.x, 2.0f * (xy - wz) * scale.y, 2.0f * (xz + wy) * scale.z, translation.x,
+		2.0f * (xy + wz) * scale.x, (1.0f - 2.0f * (xx + zz)) * scale.y, 2.0f * (yz - wx) * scale.z, translation.y,
+		2.0f * (xz - wy) * scale.x, 2.0f * (yz + wx) * scale.y, (1.0f - 2.0f * (xx + yy)) * scale.z, translation.z
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix Matrix34::ToMatrix() const
+{
+	return Matrix
+	(
+		_11, _12, _13, _14,
+		_21, _22, _23, _24,
+		_31, _32, _33, _34,
+		0.0f, 0.0f, 0.0f, 1.0f
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3 Matrix34::GetTranslation() const
+{
+	return Vector3(_14, _24, _34);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Matrix34 Matrix34::operator*(const Matrix34& rhs) const
+{
+#if MATH_SIMD_SSE4
+	//Row i of the result is row i of this applied to the rows of rhs, the implicit
+	//(0, 0, 0, 1) bottom row of rhs only passes the translation through
+	const __m128 b0 = _mm_loadu_ps(&rhs._11);
+	const __m128 b1 = _mm_loadu_ps(&rhs._21);
+	const __m128 b2 = _mm_loadu_ps(&rhs._31);
+	const __m128 translationMask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+
+	Matrix34 result;
+	const f32* a = &_11;
+	f32* r = &result._11;
+	for (int i = 0; i < 3; ++i)
+	{
+		const __m128 ai = _mm_loadu_ps(a + i * 4);
+		__m128 ri = _mm_and_ps(ai, translationMask);
+		ri = SIMD::MulAdd(MATH_SWIZZLE(ai, 0, 0, 0, 0), b0, ri);
+		ri = SIMD::MulAdd(MATH_SWIZZLE(ai, 1, 1, 1, 1), b1, ri);
+		ri = SIMD::MulAdd(MATH_SWIZZLE(ai, 2, 2, 2, 2), b2, ri);
+		_mm_storeu_ps(r + i * 4, ri);
+	}
+	return result;
+#else
+	return Matrix34
+	(
+		(_11 * rhs._11) + (_12 * rhs._21) + (_13 * rhs._31),
+		(_11 * rhs._12) + (_12 * rhs._22) + (_13 * rhs._32),
+		(_11 * rhs._13) + (_12 * rhs._23) + (_13 * rhs._33),
+		(_11 * rhs._14) + (_12 * rhs._24) + (_13 * rhs._34) + _14,
+
+		(_21 * rhs._11) + (_22 * rhs._21) + (_23 * rhs._31),
+		(_21 * rhs._12) + (_22 * rhs._22) + (_23 * rhs._32),
+		(_21 * rhs._13) + (_22 * rhs._23) + (_23 * rhs._33),
+		(_21 * rhs._14) + (_22 * rhs._24) + (_23 * rhs._34) + _24,
+
+		(_31 * rhs._11) + (_32 * rhs._21) + (_33 * rhs._31),
+		(_31 * rhs._12) + (_32 * rhs._22) + (_33 * rhs._32),
+		(_31 * rhs._13) + (_32 * rhs._23) + (_33 * rhs._33),
+		(_31 * rhs._14) + (_32 * rhs._24) + (_33 * rhs._34) + _34
+	);
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+} // namespace Math
@@ -0,0 +1,67 @@
+#ifndef ENGINE_MATRIX34D_H__
+#define ENGINE_MATRIX34D_H__
+//======================================================================================
+// Filename: Matrix34d.h
+// Description: Double precision Matrix34 for world transforms. Compose and chain in
+//				Matrix34d, then convert to camera relative Matrix34s once per frame
+//				for rendering, see ToCameraRelative.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+
+namespace Math
+{
+
+struct Matrix34;
+struct Quaternion;
+struct Vector3;
+struct Vector3d;
+
+//======================================================================================
+// Struct
+//======================================================================================
+
+struct Matrix34d
+{
+	f64 _11, _12, _13, _14;
+	f64 _21, _22, _23, _24;
+	f64 _31, _32, _33, _34;
+
+	constexpr Matrix34d()
+		: _11(1.0), _12(0.0), _13(0.0), _14(0.0)
+		, _21(0.0), _22(1.0), _23(0.0), _24(0.0)
+		, _31(0.0), _32(0.0), _33(1.0), _34(0.0)
+	{}
+
+	constexpr Matrix34d(	f64 _11, f64 _12, f64 _13, f64 _14,
+				f64 _21, f64 _22, f64 _23, f64 _24,
+				f64 _31, f64 _32, f64 _33, f64 _34	)
+		: _11(_11), _12(_12), _13(_13), _14(_14)
+		, _21(_21), _22(_22), _23(_23), _24(_24)
+		, _31(_31), _32(_32), _33(_33), _34(_34)
+	{}
+
+	explicit constexpr Matrix34d(const Matrix34& m);
+
+	static constexpr Matrix34d Identity();
+	static constexpr Matrix34d Translation(const Vector3d& v);
+	// Translation * Rotation * Scaling
+	static constexpr Matrix34d Compose(const Vector3d& translation, const Quaternion& rotation, const Vector3& scale);
+
+	constexpr Vector3d GetTranslation() const;
+
+	constexpr Matrix34d operator*(const Matrix34d& rhs) const;
+};
+
+} // namespace Math
+
+//======================================================================================
+// Inline
+//======================================================================================
+#include "Matrix34d.inl"
+
+//======================================================================================
+#endif // !ENGINE_MATRIX34D_H__
@@ -0,0 +1,90 @@
+//======================================================================================
+// Filename: Matrix34d.inl
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Matrix34.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+#include "Vector3d.h"
+
+namespace Math
+{
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+constexpr Matrix34d::Matrix34d(const Matrix34& m)
+	: _11(m._11), _12(m._12), _13(m._13), _14(m._14)
+	, _21(m._21), _22(m._22), _23(m._23), _24(m._24)
+	, _31(m._31), _32(m._32), _33(m._33), _34(m._34)
+{}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34d Matrix34d::Identity()
+{
+	return Matrix34d();
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34d Matrix34d::Translation(const Vector3d& v)
+{
+	return Matrix34d
+	(
+		1.0, 0.0, 0.0, v.x,
+		0.0, 1.0, 0.0, v.y,
+		0.0, 0.0, 1.0, v.z
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34d Matrix34d::Compose(const Vector3d& translation, const Quaternion& rotation, const Vector3& scale)
+{
+	//The basis is built in f32 like Matrix34, only the translation needs the range
+	const Matrix34 basis = Matrix34::Compose(Vector3::Zero(), rotation, scale);
+	Matrix34d result(basis);
+	result._14 = translation.x;
+	result._24 = translation.y;
+	result._34 = translation.z;
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d Matrix34d::GetTranslation() const
+{
+	return Vector3d(_14, _24, _34);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Matrix34d Matrix34d::operator*(const Matrix34d& rhs) const
+{
+	return Matrix34d
+	(
+		(_11 * rhs._11) + (_12 * rhs._21) + (_13 * rhs._31),
+		(_11 * rhs._12) + (_12 * rhs._22) + (_13 * rhs._32),
+		(_11 * rhs._13) + (_12 * rhs._23) + (_13 * rhs._33),
+		(_11 * rhs._14) + (_12 * rhs._24) + (_13 * rhs._34) + _14,
+
+		(_21 * rhs._11) + (_22 * rhs._21) + (_23 * rhs._31),
+		(_21 * rhs._12) + (_22 * rhs._22) + (_23 * rhs._32),
+		(_21 * rhs._13) + (_22 * rhs._23) + (_23 * rhs._33),
+		(_21 * rhs._14) + (_22 * rhs._24) + (_23 * rhs._34) + _24,
+
+		(_31 * rhs._11) + (_32 * rhs._21) + (_33 * rhs._31),
+		(_31 * rhs._12) + (_32 * rhs._22) + (_33 * rhs._32),
+		(_31 * rhs._13) + (_32 * rhs._23) + (_33 * rhs._33),
+		(_31 * rhs._14) + (_32 * rhs._24) + (_33 * rhs._34) + _34
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+} // namespace Math
@@ -15,6 +15,12 @@
 #define PLATFORM_SURFACE_EXTENSION_NAME "VK_KHR_win32_surface"
 #include <Windows.h>
 
+//======================================================================================
+// HEADLESS
+//======================================================================================
+// Engine/Tests runs the GPU classes on Linux without a window, so there's no surface
+#elif defined( ENGINE_TESTS_VULKAN )
+
 //======================================================================================
 // LINUX
 //======================================================================================
@@ -0,0 +1,167 @@
+//======================================================================================
+// Filename: PresentThread.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "PresentThread.h"
+
+#include "GraphicsCommon.h"
+
+#include <chrono>
+//======================================================================================
+
+PresentThread::PresentThread(VkQueue queue, std::mutex* queueMutex, std::mutex* swapchainMutex)
+	: mQueue( queue )
+	, mQueueMutex( queueMutex )
+	, mSwapchainMutex( swapchainMutex )
+{
+	mThread = std::thread(&PresentThread::Run, this);
+}
+
+//--------------------------------------------------------------------------------------
+
+PresentThread::~PresentThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(mRequestMutex);
+		mIsRunning = false;
+	}
+	mRequestNotEmpty.notify_all();
+	mRequestNotFull.notify_all();
+
+	if (mThread.joinable())
+	{
+		mThread.join();
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+bool PresentThread::Enqueue(const PresentRequest& request)
+{
+	ASSERT(request.waitSemaphoreCount <= kPresentMaxWaitSemaphores, "[PresentThread] Too many wait semaphores!");
+	{
+		std::unique_lock<std::mutex> lock(mRequestMutex);
+		mRequestNotFull.wait(lock, [this]() { return !mIsRunning || mRequestCount < kPresentQueueCapacity; });
+		if (!mIsRunning)
+		{
+			return false;
+		}
+
+		const u32 tail = (mRequestHead + mRequestCount) % kPresentQueueCapacity;
+		mRequests[tail] = request;
+		mRequests[tail].enqueueTime = GetTimeMs();
+		++mRequestCount;
+	}
+	mRequestNotEmpty.notify_one();
+	return true;
+}
+
+//--------------------------------------------------------------------------------------
+
+void PresentThread::WaitForPending(u32 maxPending)
+{
+	std::unique_lock<std::mutex> lock(mRequestMutex);
+	mRequestNotFull.wait(lock, [this, maxPending]()
+	{
+		return !mIsRunning || (mRequestCount + (mIsPresenting ? 1 : 0)) <= maxPending;
+	});
+}
+
+//--------------------------------------------------------------------------------------
+
+bool PresentThread::PopTiming(PresentTiming& timing)
+{
+	std::lock_guard<std::mutex> lock(mTimingMutex);
+	if (mTimingCount == 0)
+	{
+		return false;
+	}
+
+	const u32 oldest = (mTimingHead + kPresentTimingHistory - mTimingCount) % kPresentTimingHistory;
+	timing = mTimings[oldest];
+	--mTimingCount;
+	return true;
+}
+
+//--------------------------------------------------------------------------------------
+
+f64 PresentThread::GetTimeMs()
+{
+	using namespace std::chrono;
+	return duration<f64, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+//--------------------------------------------------------------------------------------
+
+void PresentThread::Run()
+{
+	for (;;)
+	{
+		PresentRequest request;
+		{
+			std::unique_lock<std::mutex> lock(mRequestMutex);
+			mRequestNotEmpty.wait(lock, [this]() { return !mIsRunning || mRequestCount > 0; });
+
+			// Drain what is left on shutdown so no acquired image is leaked
+			if (mRequestCount == 0)
+			{
+				return;
+			}
+
+			request = mRequests[mRequestHead];
+			mRequestHead = (mRequestHead + 1) % kPresentQueueCapacity;
+			--mRequestCount;
+			mIsPresenting = true;
+		}
+		mRequestNotFull.notify_all();
+
+		VkResult presentResult = VK_RESULT_MAX_ENUM;
+
+		VkPresentInfoKHR presentInfo = {};
+		presentInfo.sType				= VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+		presentInfo.waitSemaphoreCount	= request.waitSemaphoreCount;
+		presentInfo.pWaitSemaphores		= request.waitSemaphores;
+		presentInfo.swapchainCount		= 1;
+		presentInfo.pSwapchains			= &request.swapchain;
+		presentInfo.pImageIndices		= &request.imageIndex;
+		presentInfo.pResults			= &presentResult;
+
+		PresentTiming timing;
+		timing.frameID = request.frameID;
+
+		const f64 presentStart = GetTimeMs();
+		{
+			std::lock_guard<std::mutex> swapchainLock(*mSwapchainMutex);
+			std::lock_guard<std::mutex> queueLock(*mQueueMutex);
+			vkErrorCheck(vkQueuePresentKHR(mQueue, &presentInfo));
+		}
+		const f64 presentEnd = GetTimeMs();
+		vkErrorCheck(presentResult);
+
+		timing.queuedMs		= presentStart - request.enqueueTime;
+		timing.presentMs	= presentEnd - presentStart;
+		timing.result		= presentResult;
+
+		{
+			std::lock_guard<std::mutex> lock(mTimingMutex);
+			mTimings[mTimingHead] = timing;
+			mTimingHead = (mTimingHead + 1) % kPresentTimingHistory;
+			if (mTimingCount < kPresentTimingHistory)
+			{
+				++mTimingCount;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mRequestMutex);
+			mIsPresenting = false;
+		}
+		mRequestNotFull.notify_all();
+	}
+}
+
+//======================================================================================
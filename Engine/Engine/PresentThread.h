@@ -0,0 +1,102 @@
+#ifndef ENGINE_GRAPHICS_PRESENT_THREAD_H__
+#define ENGINE_GRAPHICS_PRESENT_THREAD_H__
+//======================================================================================
+// Filename: PresentThread.h
+// Description: Worker thread that owns vkQueuePresentKHR so the main thread does not
+//				block inside the driver waiting for vblank.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Platform.h"
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr u32 kPresentQueueCapacity			= 2;
+constexpr u32 kPresentMaxWaitSemaphores		= 4;
+constexpr u32 kPresentTimingHistory			= 16;
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+struct PresentRequest
+{
+	VkSwapchainKHR	swapchain = VK_NULL_HANDLE;
+	uint32_t		imageIndex = UINT32_MAX;
+	uint32_t		waitSemaphoreCount = 0;
+	VkSemaphore		waitSemaphores[kPresentMaxWaitSemaphores] = {};
+	u64				frameID = 0;
+	f64				enqueueTime = 0.0;
+};
+
+//--------------------------------------------------------------------------------------
+
+struct PresentTiming
+{
+	u64			frameID = 0;
+	f64			queuedMs = 0.0;		// Time the request sat in the queue before presenting
+	f64			presentMs = 0.0;	// Time spent blocked inside vkQueuePresentKHR
+	VkResult	result = VK_SUCCESS;
+};
+
+//======================================================================================
+// Class PresentThread
+//======================================================================================
+
+class PresentThread
+{
+public:
+	PresentThread( VkQueue queue, std::mutex* queueMutex, std::mutex* swapchainMutex );
+	~PresentThread();
+
+	// Blocks while the queue is full. Returns false once the thread is stopping.
+	bool Enqueue( const PresentRequest& request );
+
+	// Blocks until at most maxPending requests are queued or being presented.
+	void WaitForPending( u32 maxPending );
+	void WaitIdle()															{ WaitForPending(0); }
+
+	// Drains one timing record, oldest first. Returns false when none are pending.
+	bool PopTiming( PresentTiming& timing );
+
+	static f64 GetTimeMs();
+
+private:
+	NONCOPYABLE(PresentThread);
+
+	void Run();
+
+private:
+	VkQueue			mQueue = VK_NULL_HANDLE;
+	std::mutex*		mQueueMutex = nullptr;
+	std::mutex*		mSwapchainMutex = nullptr;
+
+	std::thread		mThread;
+
+	std::mutex							mRequestMutex;
+	std::condition_variable				mRequestNotEmpty;
+	std::condition_variable				mRequestNotFull;
+	std::array<PresentRequest, kPresentQueueCapacity> mRequests;
+	u32									mRequestHead = 0;
+	u32									mRequestCount = 0;
+	bool								mIsPresenting = false;
+	bool								mIsRunning = true;
+
+	std::mutex							mTimingMutex;
+	std::array<PresentTiming, kPresentTimingHistory> mTimings;
+	u32									mTimingHead = 0;
+	u32									mTimingCount = 0;
+};
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_PRESENT_THREAD_H__
@@ -0,0 +1,59 @@
+#ifndef ENGINE_QUATERNION_H__
+#define	ENGINE_QUATERNION_H__
+//======================================================================================
+// Filename: Quaternion.h
+// Description: Unit quaternion rotation. a * b applies b first, the same order as
+//				Matrix products.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "MathSIMD.h"
+
+namespace Math
+{
+
+struct Matrix;
+struct Vector3;
+
+//======================================================================================
+// Struct
+//======================================================================================
+
+struct Quaternion
+{
+	f32 x;
+	f32 y;
+	f32 z;
+	f32 w;
+
+	constexpr Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+	constexpr Quaternion(f32 x, f32 y, f32 z, f32 w) : x(x), y(y), z(z), w(w) {}
+
+	static constexpr Quaternion Identity();
+	static Quaternion RotationAxis(const Vector3& axis, f32 rad);
+	static Quaternion RotationMatrix(const Matrix& m);
+
+	constexpr Quaternion operator-() const;
+	constexpr Quaternion operator+(const Quaternion& rhs) const;
+	constexpr Quaternion operator-(const Quaternion& rhs) const;
+	Quaternion operator*(const Quaternion& rhs) const;
+	constexpr Quaternion operator*(f32 s) const;
+
+	Quaternion& operator*=(const Quaternion& rhs);
+
+	constexpr bool operator== (const Quaternion& rhs) const;
+	constexpr bool operator!= (const Quaternion& rhs) const;
+};
+
+} // namespace Math
+
+//======================================================================================
+// Inline
+//======================================================================================
+#include "Quaternion.inl"
+
+//======================================================================================
+#endif //!ENGINE_QUATERNION_H__
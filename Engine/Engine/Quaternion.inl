@@ -0,0 +1,139 @@
+//======================================================================================
+// Filename: Quaternion.inl
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "EngineMath.h"
+#include "Matrix.h"
+#include "Vector3.h"
+#include <cmath>
+
+namespace Math
+{
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+constexpr Quaternion Quaternion::Identity()
+{
+	return Quaternion();
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Quaternion Quaternion::RotationAxis(const Vector3& axis, f32 rad)
+{
+	//axis must be unit length
+	f32 s, c;
+	SinCos(rad * 0.5f, s, c);
+	return Quaternion(axis.x * s, axis.y * s, axis.z * s, c);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Quaternion Quaternion::RotationMatrix(const Matrix& m)
+{
+	//Pick the largest diagonal term to divide by so the result stays accurate
+	const f32 trace = m._11 + m._22 + m._33;
+	if (trace > 0.0f)
+	{
+		const f32 s = 0.5f / sqrt(trace + 1.0f);
+		return Quaternion((m._32 - m._23) * s, (m._13 - m._31) * s, (m._21 - m._12) * s, 0.25f / s);
+	}
+	if (m._11 > m._22 && m._11 > m._33)
+	{
+		const f32 s = 0.5f / sqrt(1.0f + m._11 - m._22 - m._33);
+		return Quaternion(0.25f / s, (m._12 + m._21) * s, (m._13 + m._31) * s, (m._32 - m._23) * s);
+	}
+	if (m._22 > m._33)
+	{
+		const f32 s = 0.5f / sqrt(1.0f + m._22 - m._11 - m._33);
+		return Quaternion((m._12 + m._21) * s, 0.25f / s, (m._23 + m._32) * s, (m._13 - m._31) * s);
+	}
+	const f32 s = 0.5f / sqrt(1.0f + m._33 - m._11 - m._22);
+	return Quaternion((m._13 + m._31) * s, (m._23 + m._32) * s, 0.25f / s, (m._21 - m._12) * s);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Quaternion Quaternion::operator-() const
+{
+	return Quaternion(-x, -y, -z, -w);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Quaternion Quaternion::operator+(const Quaternion& rhs) const
+{
+	return Quaternion(x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Quaternion Quaternion::operator-(const Quaternion& rhs) const
+{
+	return Quaternion(x - rhs.x, y - rhs.y, z - rhs.z, w - rhs.w);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Quaternion Quaternion::operator*(const Quaternion& rhs) const
+{
+#if MATH_SIMD_SSE4
+	const __m128 a = _mm_loadu_ps(&x);
+	const __m128 b = _mm_loadu_ps(&rhs.x);
+
+	__m128 result = _mm_mul_ps(MATH_SWIZZLE(a, 3, 3, 3, 3), b);
+	result = SIMD::MulAdd(MATH_SWIZZLE(a, 0, 0, 0, 0), _mm_xor_ps(MATH_SWIZZLE(b, 3, 2, 1, 0), _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)), result);
+	result = SIMD::MulAdd(MATH_SWIZZLE(a, 1, 1, 1, 1), _mm_xor_ps(MATH_SWIZZLE(b, 2, 3, 0, 1), _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f)), result);
+	result = SIMD::MulAdd(MATH_SWIZZLE(a, 2, 2, 2, 2), _mm_xor_ps(MATH_SWIZZLE(b, 1, 0, 3, 2), _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f)), result);
+
+	Quaternion q;
+	_mm_storeu_ps(&q.x, result);
+	return q;
+#else
+	return Quaternion
+	(
+		(w * rhs.x) + (x * rhs.w) + (y * rhs.z) - (z * rhs.y),
+		(w * rhs.y) - (x * rhs.z) + (y * rhs.w) + (z * rhs.x),
+		(w * rhs.z) + (x * rhs.y) - (y * rhs.x) + (z * rhs.w),
+		(w * rhs.w) - (x * rhs.x) - (y * rhs.y) - (z * rhs.z)
+	);
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Quaternion Quaternion::operator*(f32 s) const
+{
+	return Quaternion(x * s, y * s, z * s, w * s);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Quaternion& Quaternion::operator*=(const Quaternion& rhs)
+{
+	*this = *this * rhs;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr bool Quaternion::operator== (const Quaternion& rhs) const
+{
+	return (x == rhs.x && y == rhs.y && z == rhs.z && w == rhs.w);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr bool Quaternion::operator!= (const Quaternion& rhs) const
+{
+	return !(*this == rhs);
+}
+
+//--------------------------------------------------------------------------------------
+
+} // namespace Math
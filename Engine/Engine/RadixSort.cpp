@@ -0,0 +1,267 @@
+//======================================================================================
+// Filename: RadixSort.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "RadixSort.h"
+
+#include "FrameAllocator.h"
+#include "JobSystem.h"
+
+#include <cstring>
+#include <utility>
+//======================================================================================
+
+namespace
+{
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+inline u32 GetDigit(u64 key, u32 shift)
+{
+	return static_cast<u32>(key >> shift) & (kRadixSortBucketCount - 1);
+}
+
+//--------------------------------------------------------------------------------------
+
+// True when every key has the same digit, so scattering by it would be a copy
+inline bool IsSingleBucket(const u32* histogram, size_t count)
+{
+	for (u32 bucket = 0; bucket < kRadixSortBucketCount; ++bucket)
+	{
+		if (histogram[bucket] == count)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Runs func(block) for every block across the job system
+template <typename Func>
+void ForEachBlock(JobSystem& jobSystem, size_t blockCount, const Func& func)
+{
+	jobSystem.ParallelFor(blockCount, 1, [&func](size_t begin, size_t end)
+	{
+		for (size_t block = begin; block < end; ++block)
+		{
+			func(block);
+		}
+	});
+}
+
+} // namespace
+
+//======================================================================================
+// Class RadixSorter
+//======================================================================================
+
+RadixSorter::RadixSorter(FrameAllocator* frameAllocator)
+	: mFrameAllocator( frameAllocator )
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+RadixSorter::~RadixSorter()
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+void RadixSorter::Sort(Span<u64> keys, Span<u32> values)
+{
+	ASSERT(keys.size == values.size, "[RadixSort] Key and value counts differ!");
+	ASSERT(keys.size <= U32_MAX, "[RadixSort] Too many keys!");
+
+	const size_t count = keys.size;
+	if (count < 2)
+	{
+		return;
+	}
+	u64* targetKeys = nullptr;
+	u32* targetValues = nullptr;
+	GetScratch(count, targetKeys, targetValues);
+
+	//A stable scatter keeps how many keys have each digit, so one read up front counts
+	//the digits of every pass
+	mBlockOffsets.assign(kRadixSortPassCount * kRadixSortBucketCount, 0);
+	u32* histograms = mBlockOffsets.data();
+	for (size_t i = 0; i < count; ++i)
+	{
+		const u64 key = keys.data[i];
+		for (u32 pass = 0; pass < kRadixSortPassCount; ++pass)
+		{
+			++histograms[(pass * kRadixSortBucketCount) + GetDigit(key, pass * kRadixSortDigitBits)];
+		}
+	}
+
+	u64* sourceKeys = keys.data;
+	u32* sourceValues = values.data;
+	for (u32 pass = 0; pass < kRadixSortPassCount; ++pass)
+	{
+		u32* offsets = histograms + (pass * kRadixSortBucketCount);
+		if (IsSingleBucket(offsets, count))
+		{
+			continue;
+		}
+
+		u32 offset = 0;
+		for (u32 bucket = 0; bucket < kRadixSortBucketCount; ++bucket)
+		{
+			const u32 bucketCount = offsets[bucket];
+			offsets[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		const u32 shift = pass * kRadixSortDigitBits;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const u32 target = offsets[GetDigit(sourceKeys[i], shift)]++;
+			targetKeys[target] = sourceKeys[i];
+			targetValues[target] = sourceValues[i];
+		}
+
+		std::swap(sourceKeys, targetKeys);
+		std::swap(sourceValues, targetValues);
+	}
+
+	CopyBack(keys, values, sourceKeys, sourceValues);
+}
+
+//--------------------------------------------------------------------------------------
+
+void RadixSorter::Sort(JobSystem& jobSystem, Span<u64> keys, Span<u32> values)
+{
+	ASSERT(keys.size == values.size, "[RadixSort] Key and value counts differ!");
+	ASSERT(keys.size <= U32_MAX, "[RadixSort] Too many keys!");
+
+	//One block has nothing to spread
+	const size_t count = keys.size;
+	if (count <= kRadixSortBlockSize)
+	{
+		Sort(keys, values);
+		return;
+	}
+	u64* targetKeys = nullptr;
+	u32* targetValues = nullptr;
+	GetScratch(count, targetKeys, targetValues);
+
+	const size_t blockCount = (count + kRadixSortBlockSize - 1) / kRadixSortBlockSize;
+	mBlockOffsets.resize(blockCount * kRadixSortBucketCount);
+
+	u64* sourceKeys = keys.data;
+	u32* sourceValues = values.data;
+	u32* blockOffsets = mBlockOffsets.data();
+
+	//Each block's share of a digit changes with every pass, so unlike the serial sort
+	//the blocks are counted again before each one
+	for (u32 shift = 0; shift < 64; shift += kRadixSortDigitBits)
+	{
+		ForEachBlock(jobSystem, blockCount, [=](size_t block)
+		{
+			u32* histogram = blockOffsets + (block * kRadixSortBucketCount);
+			memset(histogram, 0, sizeof(u32) * kRadixSortBucketCount);
+
+			const size_t end = (block + 1 < blockCount) ? (block + 1) * kRadixSortBlockSize : count;
+			for (size_t i = block * kRadixSortBlockSize; i < end; ++i)
+			{
+				++histogram[GetDigit(sourceKeys[i], shift)];
+			}
+		});
+
+		//A pass where one bucket holds every key across all blocks would be a copy
+		bool isSorted = false;
+		for (u32 bucket = 0; bucket < kRadixSortBucketCount && !isSorted; ++bucket)
+		{
+			size_t bucketTotal = 0;
+			for (size_t block = 0; block < blockCount; ++block)
+			{
+				bucketTotal += blockOffsets[(block * kRadixSortBucketCount) + bucket];
+			}
+			isSorted = (bucketTotal == count);
+		}
+		if (isSorted)
+		{
+			continue;
+		}
+
+		//Turn the counts into write offsets, bucket major so each block's share of a
+		//bucket follows the blocks before it and the sort stays stable
+		u32 offset = 0;
+		for (u32 bucket = 0; bucket < kRadixSortBucketCount; ++bucket)
+		{
+			for (size_t block = 0; block < blockCount; ++block)
+			{
+				u32& blockCountInBucket = blockOffsets[(block * kRadixSortBucketCount) + bucket];
+				const u32 bucketCount = blockCountInBucket;
+				blockCountInBucket = offset;
+				offset += bucketCount;
+			}
+		}
+
+		ForEachBlock(jobSystem, blockCount, [=](size_t block)
+		{
+			u32* offsets = blockOffsets + (block * kRadixSortBucketCount);
+			const size_t end = (block + 1 < blockCount) ? (block + 1) * kRadixSortBlockSize : count;
+			for (size_t i = block * kRadixSortBlockSize; i < end; ++i)
+			{
+				const u32 target = offsets[GetDigit(sourceKeys[i], shift)]++;
+				targetKeys[target] = sourceKeys[i];
+				targetValues[target] = sourceValues[i];
+			}
+		});
+
+		std::swap(sourceKeys, targetKeys);
+		std::swap(sourceValues, targetValues);
+	}
+
+	CopyBack(keys, values, sourceKeys, sourceValues);
+}
+
+//--------------------------------------------------------------------------------------
+
+void RadixSorter::GetScratch(size_t count, u64*& keys, u32*& values)
+{
+	if (nullptr != mFrameAllocator)
+	{
+		const Span<u64> frameKeys = mFrameAllocator->AllocateArray<u64>(count);
+		const Span<u32> frameValues = mFrameAllocator->AllocateArray<u32>(count);
+		if (nullptr != frameKeys.data && nullptr != frameValues.data)
+		{
+			keys = frameKeys.data;
+			values = frameValues.data;
+			return;
+		}
+	}
+
+	//Past the frame budget this falls back to the owned scratch, which grows to fit
+	if (mKeyScratch.size() < count)
+	{
+		mKeyScratch.resize(count);
+		mValueScratch.resize(count);
+	}
+	keys = mKeyScratch.data();
+	values = mValueScratch.data();
+}
+
+//--------------------------------------------------------------------------------------
+
+// An odd number of passes leaves the result in the scratch arrays
+void RadixSorter::CopyBack(Span<u64> keys, Span<u32> values, const u64* sortedKeys, const u32* sortedValues)
+{
+	if (sortedKeys != keys.data)
+	{
+		memcpy(keys.data, sortedKeys, sizeof(u64) * keys.size);
+		memcpy(values.data, sortedValues, sizeof(u32) * values.size);
+	}
+}
+
+//======================================================================================
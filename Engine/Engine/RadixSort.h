@@ -0,0 +1,64 @@
+#ifndef ENGINE_RADIX_SORT_H__
+#define ENGINE_RADIX_SORT_H__
+//======================================================================================
+// Filename: RadixSort.h
+// Description: Stable least significant digit radix sort of 64-bit keys carrying a
+//				32-bit value each, e.g. draw keys and the index of what they describe.
+//				8 bits per pass, passes where every key has the same digit are skipped.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Span.h"
+
+#include <vector>
+
+class FrameAllocator;
+class JobSystem;
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr u32 kRadixSortDigitBits			= 8;
+constexpr u32 kRadixSortBucketCount			= 1 << kRadixSortDigitBits;
+constexpr u32 kRadixSortPassCount			= 64 / kRadixSortDigitBits;
+constexpr size_t kRadixSortBlockSize		= 16 * 1024;
+
+//======================================================================================
+// Class RadixSorter
+//======================================================================================
+
+// Owns the scratch memory so sorting the same amount every frame doesn't allocate.
+// Given a FrameAllocator the key and value scratch is taken from it on every sort
+// instead, and only lives until its next Reset.
+class RadixSorter
+{
+public:
+	explicit RadixSorter( FrameAllocator* frameAllocator = nullptr );
+	~RadixSorter();
+
+	// Sorts keys ascending and applies the same permutation to values. Both spans must
+	// be the same size.
+	void Sort( Span<u64> keys, Span<u32> values );
+	// Same result, blocks of kRadixSortBlockSize keys are histogrammed and scattered on
+	// the job system.
+	void Sort( JobSystem& jobSystem, Span<u64> keys, Span<u32> values );
+
+private:
+	NONCOPYABLE(RadixSorter);
+
+	void GetScratch( size_t count, u64*& keys, u32*& values );
+	static void CopyBack( Span<u64> keys, Span<u32> values, const u64* sortedKeys, const u32* sortedValues );
+
+private:
+	FrameAllocator*		mFrameAllocator;
+	std::vector<u64>	mKeyScratch;
+	std::vector<u32>	mValueScratch;
+	std::vector<u32>	mBlockOffsets;	// kRadixSortBucketCount per block, or per pass in the serial sort
+};
+
+//======================================================================================
+#endif // !ENGINE_RADIX_SORT_H__
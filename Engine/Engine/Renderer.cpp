@@ -7,15 +7,35 @@
 //======================================================================================
 // Includes
 //======================================================================================
+#include "BindlessTable.h"
+#include "DeletionQueue.h"
+#include "DescriptorAllocator.h"
+#include "FrameAllocator.h"
+#include "GpuRingBuffer.h"
+#include "GpuTimeline.h"
 #include "GraphicsCommon.h"
 #include "Renderer.h"
+#include "SyncObjectPool.h"
+#include "VulkanExtensions.h"
 #include "Window.h"
 
 #include <memory>
 #include <sstream>
 //======================================================================================
 
+namespace
+{
+	const size_t kFrameAllocatorSize = 1024 * 1024;
+	const VkDeviceSize kFrameConstantsSize = 1024 * 1024;
+	const u32 kFrameResourceCount = 2;
+	const u32 kBindlessImageCount = 16 * 1024;
+	const u32 kBindlessBufferCount = 4 * 1024;
+}
+
+//--------------------------------------------------------------------------------------
+
 Renderer::Renderer() 
+	: mFrameAllocator( new FrameAllocator(kFrameAllocatorSize) )
 {
 	SetupLayersAndExtensions();
 	SetupDebug();
@@ -23,6 +43,7 @@ Renderer::Renderer()
 	InitDebug();
 	InitVulkanDevice();
 	InitVulkanCommandPool();
+	InitVulkanSynchronization();
 }
 
 //--------------------------------------------------------------------------------------
@@ -31,10 +52,13 @@ Renderer::~Renderer()
 {
 	SAVE_DELETE(mWindow);
 	
+	TerminateVulkanSynchronization();
 	TerminateVulkanCommandPool();
 	TerminateVulkanPhysicalDevice();
 	TerminateDebug();
 	TerminateVulkanInstance();
+
+	SAVE_DELETE(mFrameAllocator);
 }
 
 //--------------------------------------------------------------------------------------
@@ -49,6 +73,12 @@ void Renderer::InitializeWindow(const std::string& appName, int width, int heigh
 
 bool Renderer::Run()
 {
+	mFrameAllocator->Reset();
+	mFrameConstants->BeginFrame();
+	mDescriptorAllocator->BeginFrame();
+	mBindlessTable->BeginFrame();
+	mDeletionQueue->Collect();
+
 	if (nullptr != mWindow) 
 	{
 		return mWindow->Update();
@@ -64,6 +94,12 @@ void Renderer::SetupLayersAndExtensions()
 	mInstanceExtensions.push_back( PLATFORM_SURFACE_EXTENSION_NAME );
 	
 	mDeviceExtensions.push_back( VK_KHR_SWAPCHAIN_EXTENSION_NAME );
+
+	//Needed to query features of newer device extensions
+	if (IsInstanceExtensionAvailable(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		mInstanceExtensions.push_back( VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME );
+	}
 }
 
 //--------------------------------------------------------------------------------------
@@ -87,6 +123,8 @@ void Renderer::InitVulkanInstance()
 	instanceInfo.pNext = &mDebugCallbackCreateInfo;
 
 	vkErrorCheck( vkCreateInstance( &instanceInfo, nullptr, &mInstance ) );
+
+	LoadInstanceExtensionFunctions(mInstance);
 }
 
 //--------------------------------------------------------------------------------------
@@ -116,13 +154,110 @@ void Renderer::InitVulkanDevice()
 	//	vkEnumerateDeviceLayerProperties(mPhysicalDevice, &extensionCount, extensionPropertiesList.data());
 	//}
 
-	float queuePriorities[] = { 1.0f };
+	float queuePriorities[] = { 1.0f, 1.0f };
 	mGraphicsFamilyIndex = FindGraphicsFamilyIndex();
 
+	uint32_t queueCount = 1;
+#if BUILD_ENABLE_PRESENT_THREAD
+	{
+		//Give the present thread its own queue when the family allows it so
+		//a blocking present never holds up submission
+		uint32_t familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(mPhysicalDevice, &familyCount, nullptr);
+		std::vector< VkQueueFamilyProperties > familyPropertiesList(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(mPhysicalDevice, &familyCount, familyPropertiesList.data());
+		if (familyPropertiesList[mGraphicsFamilyIndex].queueCount > 1)
+		{
+			queueCount = 2;
+		}
+	}
+#endif //BUILD_ENABLE_PRESENT_THREAD
+
+	VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures = {};
+	timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+	if (nullptr != fvkGetPhysicalDeviceFeatures2KHR
+		&& IsDeviceExtensionAvailable(mPhysicalDevice, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceFeatures2KHR features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &timelineFeatures;
+		fvkGetPhysicalDeviceFeatures2KHR(mPhysicalDevice, &features);
+
+		mTimelineSemaphoreSupported = (timelineFeatures.timelineSemaphore == VK_TRUE);
+	}
+	if (mTimelineSemaphoreSupported)
+	{
+		mDeviceExtensions.push_back( VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME );
+	}
+
+	//Bindless needs update after bind arrays that may be partially bound and indexed
+	//non uniformly, and slots that can be rewritten while other slots are in flight
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+	indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+	if (nullptr != fvkGetPhysicalDeviceFeatures2KHR && nullptr != fvkGetPhysicalDeviceProperties2KHR
+		&& IsDeviceExtensionAvailable(mPhysicalDevice, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)
+		&& IsDeviceExtensionAvailable(mPhysicalDevice, VK_KHR_MAINTENANCE3_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceFeatures2KHR features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &indexingFeatures;
+		fvkGetPhysicalDeviceFeatures2KHR(mPhysicalDevice, &features);
+
+		mDescriptorIndexingSupported = indexingFeatures.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE
+			&& indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE
+			&& indexingFeatures.descriptorBindingUpdateUnusedWhilePending == VK_TRUE
+			&& indexingFeatures.descriptorBindingPartiallyBound == VK_TRUE
+			&& indexingFeatures.shaderSampledImageArrayNonUniformIndexing == VK_TRUE
+			&& indexingFeatures.runtimeDescriptorArray == VK_TRUE;
+	}
+	if (mDescriptorIndexingSupported)
+	{
+		mDeviceExtensions.push_back( VK_KHR_MAINTENANCE3_EXTENSION_NAME );
+		mDeviceExtensions.push_back( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME );
+
+		mDescriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+		VkPhysicalDeviceProperties2KHR properties = {};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+		properties.pNext = &mDescriptorIndexingProperties;
+		fvkGetPhysicalDeviceProperties2KHR(mPhysicalDevice, &properties);
+		mDescriptorIndexingProperties.pNext = nullptr;
+
+		//Enable only what BindlessTable uses
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT supportedFeatures = indexingFeatures;
+		indexingFeatures = {};
+		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+		indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+		indexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+		indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		indexingFeatures.shaderStorageBufferArrayNonUniformIndexing = supportedFeatures.shaderStorageBufferArrayNonUniformIndexing;
+		indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+	}
+
+	//Needed to draw many objects from one indirect buffer, the GPU culling path
+	//falls back to one draw call per object without them
+	VkPhysicalDeviceFeatures supportedFeatures = {};
+	vkGetPhysicalDeviceFeatures(mPhysicalDevice, &supportedFeatures);
+	mEnabledFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+	mEnabledFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+
+	bool drawIndirectCountEnabled = false;
+	if (IsDeviceExtensionAvailable(mPhysicalDevice, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+	{
+		mDeviceExtensions.push_back( VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME );
+		drawIndirectCountEnabled = true;
+	}
+	else if (IsDeviceExtensionAvailable(mPhysicalDevice, VK_AMD_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+	{
+		mDeviceExtensions.push_back( VK_AMD_DRAW_INDIRECT_COUNT_EXTENSION_NAME );
+		drawIndirectCountEnabled = true;
+	}
+
 	VkDeviceQueueCreateInfo deviceQueueCreateInfo = {};
 	deviceQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 	deviceQueueCreateInfo.queueFamilyIndex = mGraphicsFamilyIndex;
-	deviceQueueCreateInfo.queueCount = 1;
+	deviceQueueCreateInfo.queueCount = queueCount;
 	deviceQueueCreateInfo.pQueuePriorities = queuePriorities;
 
 	VkDeviceCreateInfo deviceInfo = {};
@@ -131,10 +266,35 @@ void Renderer::InitVulkanDevice()
 	deviceInfo.pQueueCreateInfos = &deviceQueueCreateInfo;
 	deviceInfo.enabledExtensionCount = static_cast<uint32_t>( mDeviceExtensions.size() );
 	deviceInfo.ppEnabledExtensionNames = mDeviceExtensions.data();
+	deviceInfo.pEnabledFeatures = &mEnabledFeatures;
+
+	//Chain the extension features that are being enabled
+	void* featureChain = nullptr;
+	if (mTimelineSemaphoreSupported)
+	{
+		timelineFeatures.pNext = featureChain;
+		featureChain = &timelineFeatures;
+	}
+	if (mDescriptorIndexingSupported)
+	{
+		indexingFeatures.pNext = featureChain;
+		featureChain = &indexingFeatures;
+	}
+	deviceInfo.pNext = featureChain;
 
 	vkErrorCheck( vkCreateDevice(mPhysicalDevice, &deviceInfo, nullptr, &mDevice) );
+	LoadDeviceExtensionFunctions(mDevice, mDeviceExtensions);
+	mDrawIndirectCountSupported = drawIndirectCountEnabled && (nullptr != fvkCmdDrawIndexedIndirectCountKHR);
 	
 	vkGetDeviceQueue(mDevice, mGraphicsFamilyIndex, 0, &mQueue);
+	if (queueCount > 1)
+	{
+		vkGetDeviceQueue(mDevice, mGraphicsFamilyIndex, 1, &mPresentQueue);
+	}
+	else
+	{
+		mPresentQueue = mQueue;
+	}
 }
 
 //--------------------------------------------------------------------------------------
@@ -145,6 +305,10 @@ void Renderer::TerminateVulkanPhysicalDevice()
 	mDevice = nullptr;
 	mPhysicalDevice = nullptr;
 	mPhysicalDeviceProperties = {};
+	mEnabledFeatures = {};
+	mDrawIndirectCountSupported = false;
+	mDescriptorIndexingSupported = false;
+	mDescriptorIndexingProperties = {};
 }
 
 //--------------------------------------------------------------------------------------
@@ -177,6 +341,36 @@ void Renderer::TerminateVulkanCommandPool()
 
 //--------------------------------------------------------------------------------------
 
+void Renderer::InitVulkanSynchronization()
+{
+	const u32 kInitialFenceCount = 4;
+	const u32 kInitialSemaphoreCount = 4;
+	mSyncObjectPool = new SyncObjectPool(mDevice, kInitialFenceCount, kInitialSemaphoreCount);
+
+	mGraphicsTimeline = new GpuTimeline(mDevice, mQueue, &mQueueMutex, mSyncObjectPool, mTimelineSemaphoreSupported);
+	mDeletionQueue = new DeletionQueue(mDevice);
+	//Also the staging for GpuDrawCuller::RecordCull's object upload and the instance
+	//vertex buffer DrawBatcher::Build writes
+	mFrameConstants = new GpuRingBuffer(this, kFrameConstantsSize, kFrameResourceCount,
+										VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	mDescriptorAllocator = new DescriptorAllocator(this, kFrameResourceCount);
+	mBindlessTable = new BindlessTable(this, kFrameResourceCount, kBindlessImageCount, kBindlessBufferCount);
+}
+
+//--------------------------------------------------------------------------------------
+
+void Renderer::TerminateVulkanSynchronization()
+{
+	SAVE_DELETE(mBindlessTable);
+	SAVE_DELETE(mDescriptorAllocator);
+	SAVE_DELETE(mFrameConstants);
+	SAVE_DELETE(mDeletionQueue);
+	SAVE_DELETE(mGraphicsTimeline);
+	SAVE_DELETE(mSyncObjectPool);
+}
+
+//--------------------------------------------------------------------------------------
+
 void Renderer::FindPhysicalDevice()
 {
 	uint32_t gpuCount = 0;
@@ -10,10 +10,19 @@
 // Includes
 //======================================================================================
 #include "Platform.h"
+#include "VulkanExtensions.h"
 
+#include <mutex>
 #include <vector>
 #include <string>
 
+class BindlessTable;
+class DeletionQueue;
+class DescriptorAllocator;
+class FrameAllocator;
+class GpuRingBuffer;
+class GpuTimeline;
+class SyncObjectPool;
 class Window;
 //======================================================================================
 
@@ -37,9 +46,31 @@ public:
 	const VkPhysicalDevice					GetVulkanPhysicalDevice() const						{ return mPhysicalDevice; }
 	const VkDevice							GetVulkanDevice() const								{ return mDevice; }
 	const VkQueue							GetVulkanQueue() const								{ return mQueue; }
+	const VkQueue							GetVulkanPresentQueue() const						{ return mPresentQueue; }
+	std::mutex&								GetVulkanQueueMutex()								{ return mQueueMutex; }
+	std::mutex&								GetVulkanPresentQueueMutex()						{ return (mPresentQueue == mQueue) ? mQueueMutex : mPresentQueueMutex; }
 	const uint32_t							GetVulkanGraphicsQueueFamily() const				{ return mGraphicsFamilyIndex; }
 	const VkPhysicalDeviceProperties&		GetVulkanPhysicalDeviceProperties() const			{ return mPhysicalDeviceProperties; }
 	const VkPhysicalDeviceMemoryProperties& GetVulkanPhysicalDeviceMemoryProperties() const		{ return mPhysicalDeviceMemoryProperties; }
+	const VkPhysicalDeviceFeatures&			GetVulkanEnabledFeatures() const					{ return mEnabledFeatures; }
+
+	GpuTimeline*							GetGraphicsTimeline()								{ return mGraphicsTimeline; }
+	SyncObjectPool*							GetSyncObjectPool()									{ return mSyncObjectPool; }
+	DeletionQueue*							GetDeletionQueue()									{ return mDeletionQueue; }
+	FrameAllocator*							GetFrameAllocator()									{ return mFrameAllocator; }
+	// Per frame uniform and storage data, flush before submitting and end the frame with
+	// the submit's timeline value
+	GpuRingBuffer*							GetFrameConstants()									{ return mFrameConstants; }
+	// Per frame descriptor sets, end the frame with the submit's timeline value
+	DescriptorAllocator*					GetDescriptorAllocator()							{ return mDescriptorAllocator; }
+	// Always present, check IsEnabled before using it. End the frame like the above.
+	BindlessTable*							GetBindlessTable()									{ return mBindlessTable; }
+	bool									IsTimelineSemaphoreSupported() const				{ return mTimelineSemaphoreSupported; }
+	// fvkCmdDrawIndexedIndirectCountKHR is loaded, from the KHR or AMD extension
+	bool									IsDrawIndirectCountSupported() const				{ return mDrawIndirectCountSupported; }
+	// VK_EXT_descriptor_indexing with the features BindlessTable needs
+	bool									IsDescriptorIndexingSupported() const				{ return mDescriptorIndexingSupported; }
+	const VkPhysicalDeviceDescriptorIndexingPropertiesEXT& GetVulkanDescriptorIndexingProperties() const { return mDescriptorIndexingProperties; }
 
 private:
 	NONCOPYABLE(Renderer);
@@ -55,6 +86,9 @@ private:
 	void InitVulkanCommandPool();
 	void TerminateVulkanCommandPool();
 
+	void InitVulkanSynchronization();
+	void TerminateVulkanSynchronization();
+
 	void SetupDebug();
 	void InitDebug();
 	void TerminateDebug();
@@ -75,6 +109,7 @@ private:
 	VkPhysicalDevice  mPhysicalDevice = VK_NULL_HANDLE;
 	VkPhysicalDeviceProperties mPhysicalDeviceProperties = {};
 	VkPhysicalDeviceMemoryProperties mPhysicalDeviceMemoryProperties = {};
+	VkPhysicalDeviceFeatures mEnabledFeatures = {};
 
 	VkCommandPool mCmdPool = VK_NULL_HANDLE;
 	VkCommandBuffer mCmdBuffer = VK_NULL_HANDLE;
@@ -84,6 +119,17 @@ private:
 	
 	std::vector<const char*> mDeviceExtensions;
 
+	bool mTimelineSemaphoreSupported = false;
+	bool mDrawIndirectCountSupported = false;
+	bool mDescriptorIndexingSupported = false;
+	VkPhysicalDeviceDescriptorIndexingPropertiesEXT mDescriptorIndexingProperties = {};
+	GpuTimeline* mGraphicsTimeline = nullptr;
+	SyncObjectPool* mSyncObjectPool = nullptr;
+	DeletionQueue* mDeletionQueue = nullptr;
+	FrameAllocator* mFrameAllocator = nullptr;
+	GpuRingBuffer* mFrameConstants = nullptr;
+	DescriptorAllocator* mDescriptorAllocator = nullptr;
+	BindlessTable* mBindlessTable = nullptr;
 
 
 	VkDebugReportCallbackEXT mDebugReport = VK_NULL_HANDLE;
@@ -91,6 +137,11 @@ private:
 
 	uint32_t mGraphicsFamilyIndex = 0;
 	VkQueue mQueue;
+	VkQueue mPresentQueue = VK_NULL_HANDLE;
+
+	// Queues are externally synchronized, lock before submitting or presenting
+	std::mutex mQueueMutex;
+	std::mutex mPresentQueueMutex;
 };
 
 //======================================================================================
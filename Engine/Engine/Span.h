@@ -0,0 +1,51 @@
+#ifndef ENGINE_SPAN_H__
+#define ENGINE_SPAN_H__
+//======================================================================================
+// Filename: Span.h
+// Description: Non-owning view over contiguous memory, used on the frame path instead
+//				of passing containers by value.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+//======================================================================================
+// Struct Span
+//======================================================================================
+
+template <typename T>
+struct Span
+{
+	T*		data = nullptr;
+	size_t	size = 0;
+
+	Span() = default;
+	Span(T* data, size_t size) : data(data), size(size) {}
+	template <size_t N>
+	Span(T (&array)[N]) : data(array), size(N) {}
+	template <typename U>
+	Span(std::vector<U>& v) : data(v.data()), size(v.size()) {}
+	template <typename U>
+	Span(const std::vector<U>& v) : data(v.data()), size(v.size()) {}
+	// Only valid for the duration of the full expression, e.g. a call argument
+	Span(std::initializer_list<typename std::remove_const<T>::type> list) : data(list.begin()), size(list.size()) {}
+
+	T& operator[](size_t index) const
+	{
+		ASSERT(index < size, "[Span] Index out of range!");
+		return data[index];
+	}
+
+	T* begin() const														{ return data; }
+	T* end() const															{ return data + size; }
+	bool empty() const														{ return size == 0; }
+};
+
+//======================================================================================
+#endif // !ENGINE_SPAN_H__
@@ -0,0 +1,324 @@
+//======================================================================================
+// Filename: SpatialHash.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "SpatialHash.h"
+
+#include "EngineMath.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+//======================================================================================
+
+namespace
+{
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+// Keeps the cell coordinates and the query loops clear of integer overflow
+constexpr f32 kMaxCell = static_cast<f32>(1 << 30);
+
+//--------------------------------------------------------------------------------------
+
+inline u32 ToBits(f32 value)
+{
+	u32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 FromBits(u32 bits)
+{
+	f32 value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline u32 RoundUpToPowerOfTwo(u32 value)
+{
+	u32 result = 1;
+	while (result < value)
+	{
+		result <<= 1;
+	}
+	return result;
+}
+
+} // namespace
+
+//======================================================================================
+// Class SpatialHash
+//======================================================================================
+
+SpatialHash::SpatialHash(f32 cellSize, u32 bucketCount)
+	: mCellSize(cellSize)
+	, mInvCellSize(1.0f / cellSize)
+	, mBucketMask(RoundUpToPowerOfTwo(Math::Max(bucketCount, 1u)) - 1)
+	, mBuckets(mBucketMask + 1)
+	, mInsertedCount(0)
+	, mMaxRadius(0)
+{
+	ASSERT(cellSize > 0.0f, "[SpatialHash] Cell size must be positive!");
+	Reset(0);
+}
+
+//--------------------------------------------------------------------------------------
+
+SpatialHash::~SpatialHash()
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+void SpatialHash::Reset(u32 objectCount)
+{
+	for (std::atomic<u32>& bucket : mBuckets)
+	{
+		bucket.store(kSpatialHashInvalid, std::memory_order_relaxed);
+	}
+	BeginGeneration(objectCount);
+}
+
+//--------------------------------------------------------------------------------------
+
+void SpatialHash::Insert(u32 object, const Math::Vector3& position, f32 radius)
+{
+	ASSERT(object < mObjects.size(), "[SpatialHash] Object index out of range, Reset with a larger count!");
+	ASSERT(radius >= 0.0f, "[SpatialHash] Negative radius!");
+
+	ASSERT(!IsInserted(object), "[SpatialHash] Object %u inserted twice!", object);
+
+	Object& entry = mObjects[object];
+	entry.position = position;
+	entry.radius = radius;
+	entry.cellX = ToCell(position.x);
+	entry.cellY = ToCell(position.y);
+	entry.cellZ = ToCell(position.z);
+
+	//Objects are only ever added until the next Reset so a plain exchange can't suffer
+	//from ABA, the previous head just becomes our next
+	std::atomic<u32>& bucket = mBuckets[GetBucket(entry.cellX, entry.cellY, entry.cellZ)];
+	entry.next = bucket.exchange(object, std::memory_order_acq_rel);
+	mGenerations[object] = mGeneration;
+	mInsertedCount.fetch_add(1, std::memory_order_relaxed);
+
+	//Adding +0 turns -0 into +0, its sign bit would otherwise order above every positive radius
+	const u32 radiusBits = ToBits(radius + 0.0f);
+	u32 maxRadiusBits = mMaxRadius.load(std::memory_order_relaxed);
+	while (radiusBits > maxRadiusBits && !mMaxRadius.compare_exchange_weak(maxRadiusBits, radiusBits, std::memory_order_relaxed))
+	{
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void SpatialHash::Rebuild(Span<const Math::Vector3> positions, Span<const f32> radii)
+{
+	ASSERT(positions.size == radii.size, "[SpatialHash] Position and radius counts differ!");
+
+	Reset(static_cast<u32>(positions.size));
+	for (size_t i = 0; i < positions.size; ++i)
+	{
+		Insert(static_cast<u32>(i), positions.data[i], radii.data[i]);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void SpatialHash::Rebuild(JobSystem& jobSystem, Span<const Math::Vector3> positions, Span<const f32> radii)
+{
+	ASSERT(positions.size == radii.size, "[SpatialHash] Position and radius counts differ!");
+
+	BeginGeneration(static_cast<u32>(positions.size));
+	jobSystem.ParallelFor(mBuckets.size(), kSpatialHashGrainSize, [this](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			mBuckets[i].store(kSpatialHashInvalid, std::memory_order_relaxed);
+		}
+	});
+
+	//Insert order within a bucket varies from frame to frame, the contents don't
+	jobSystem.ParallelFor(positions.size, kSpatialHashGrainSize, [this, positions, radii](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			Insert(static_cast<u32>(i), positions.data[i], radii.data[i]);
+		}
+	});
+}
+
+//--------------------------------------------------------------------------------------
+
+template <typename Overlaps>
+size_t SpatialHash::Query(const Math::Vector3& min, const Math::Vector3& max, const Overlaps& overlaps, Span<u32> results) const
+{
+	//Objects are filed under their centre only, so anything within the largest radius
+	//outside the query bounds can still reach in
+	const f32 maxRadius = FromBits(mMaxRadius.load(std::memory_order_relaxed));
+	const s32 minX = ToCell(min.x - maxRadius);
+	const s32 minY = ToCell(min.y - maxRadius);
+	const s32 minZ = ToCell(min.z - maxRadius);
+	const s32 maxX = ToCell(max.x + maxRadius);
+	const s32 maxY = ToCell(max.y + maxRadius);
+	const s32 maxZ = ToCell(max.z + maxRadius);
+
+	size_t found = 0;
+	const u64 cellCount = static_cast<u64>(static_cast<s64>(maxX) - minX + 1) * static_cast<u64>(static_cast<s64>(maxY) - minY + 1) * static_cast<u64>(static_cast<s64>(maxZ) - minZ + 1);
+	if (cellCount > Math::Min<u64>(mObjects.size(), mBuckets.size()))
+	{
+		//Visiting the cells would cost more than testing every object, past the bucket
+		//count every bucket gets walked more than once. Slots not inserted since the
+		//last Reset still hold stale objects.
+		for (u32 i = 0; i < mObjects.size(); ++i)
+		{
+			if (IsInserted(i) && overlaps(mObjects[i].position, mObjects[i].radius))
+			{
+				if (found < results.size)
+				{
+					results.data[found] = i;
+				}
+				++found;
+			}
+		}
+		return found;
+	}
+
+	for (s32 z = minZ; z <= maxZ; ++z)
+	{
+		for (s32 y = minY; y <= maxY; ++y)
+		{
+			for (s32 x = minX; x <= maxX; ++x)
+			{
+				//Other cells can share the bucket, their objects are skipped so nothing
+				//is reported twice
+				for (u32 i = mBuckets[GetBucket(x, y, z)].load(std::memory_order_relaxed); i != kSpatialHashInvalid; i = mObjects[i].next)
+				{
+					const Object& object = mObjects[i];
+					if (object.cellX != x || object.cellY != y || object.cellZ != z)
+					{
+						continue;
+					}
+
+					if (overlaps(object.position, object.radius))
+					{
+						if (found < results.size)
+						{
+							results.data[found] = i;
+						}
+						++found;
+					}
+				}
+			}
+		}
+	}
+	return found;
+}
+
+//--------------------------------------------------------------------------------------
+
+size_t SpatialHash::QueryRadius(const Math::Vector3& center, f32 radius, Span<u32> results) const
+{
+	const Math::Vector3 extent(radius, radius, radius);
+	return Query(center - extent, center + extent, [&center, radius](const Math::Vector3& position, f32 objectRadius)
+	{
+		const f32 reach = radius + objectRadius;
+		return Math::MagnitudeSqr(position - center) <= reach * reach;
+	}, results);
+}
+
+//--------------------------------------------------------------------------------------
+
+size_t SpatialHash::QueryBox(const Math::Vector3& min, const Math::Vector3& max, Span<u32> results) const
+{
+	return Query(min, max, [&min, &max](const Math::Vector3& position, f32 radius)
+	{
+		//Distance from the sphere centre to the closest point of the box
+		const Math::Vector3 closest
+		(
+			Math::Clamp(position.x, min.x, max.x),
+			Math::Clamp(position.y, min.y, max.y),
+			Math::Clamp(position.z, min.z, max.z)
+		);
+		return Math::MagnitudeSqr(position - closest) <= radius * radius;
+	}, results);
+}
+
+//--------------------------------------------------------------------------------------
+
+SpatialHashStats SpatialHash::GetStats() const
+{
+	SpatialHashStats stats;
+	stats.objectCount = GetInsertedCount();
+	stats.bucketCount = static_cast<u32>(mBuckets.size());
+	stats.maxRadius = FromBits(mMaxRadius.load(std::memory_order_relaxed));
+
+	for (const std::atomic<u32>& bucket : mBuckets)
+	{
+		u32 size = 0;
+		for (u32 i = bucket.load(std::memory_order_relaxed); i != kSpatialHashInvalid; i = mObjects[i].next)
+		{
+			++size;
+		}
+		if (size == 0)
+		{
+			continue;
+		}
+
+		++stats.occupiedBuckets;
+		stats.maxBucketSize = Math::Max(stats.maxBucketSize, size);
+		++stats.histogram[Math::Min(size, kSpatialHashHistogramSize) - 1];
+	}
+
+	if (stats.occupiedBuckets > 0)
+	{
+		stats.averageBucketSize = static_cast<f32>(stats.objectCount) / stats.occupiedBuckets;
+	}
+	return stats;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Every slot counts as not inserted until Insert stamps it with the new generation
+void SpatialHash::BeginGeneration(u32 objectCount)
+{
+	mObjects.resize(objectCount);
+	mGenerations.resize(objectCount, 0);
+	if (++mGeneration == 0)
+	{
+		std::fill(mGenerations.begin(), mGenerations.end(), 0);
+		mGeneration = 1;
+	}
+	mInsertedCount.store(0, std::memory_order_relaxed);
+	mMaxRadius.store(0, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------
+
+s32 SpatialHash::ToCell(f32 coordinate) const
+{
+	return static_cast<s32>(std::floor(Math::Clamp(coordinate * mInvCellSize, -kMaxCell, kMaxCell)));
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 SpatialHash::GetBucket(s32 x, s32 y, s32 z) const
+{
+	//Teschner et al. "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+	const u32 hash = (static_cast<u32>(x) * 73856093u) ^ (static_cast<u32>(y) * 19349663u) ^ (static_cast<u32>(z) * 83492791u);
+	return hash & mBucketMask;
+}
+
+//======================================================================================
@@ -0,0 +1,121 @@
+#ifndef ENGINE_SPATIAL_HASH_H__
+#define ENGINE_SPATIAL_HASH_H__
+//======================================================================================
+// Filename: SpatialHash.h
+// Description: Loose uniform grid over moving spheres, stored in a fixed hash table
+//				instead of a dense array so the world has no bounds. Each object lives
+//				only in the cell holding its centre, queries widen their search by the
+//				largest radius inserted. Meant to be rebuilt from scratch every frame.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Span.h"
+#include "Vector3.h"
+
+#include <atomic>
+#include <vector>
+
+class JobSystem;
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr u32 kSpatialHashInvalid			= U32_MAX;
+constexpr u32 kSpatialHashHistogramSize		= 8;
+constexpr size_t kSpatialHashGrainSize		= 4096;
+
+//======================================================================================
+// Structs
+//======================================================================================
+
+// Occupancy of the hash buckets, one bucket per cell unless cells collide. Use it to
+// tune the cell size and bucket count.
+struct SpatialHashStats
+{
+	u32		objectCount = 0;
+	u32		bucketCount = 0;
+	u32		occupiedBuckets = 0;
+	u32		maxBucketSize = 0;
+	f32		averageBucketSize = 0.0f;	// Over occupied buckets only
+	f32		maxRadius = 0.0f;
+	// Buckets holding 1, 2, ... objects, the last entry counts everything larger
+	u32		histogram[kSpatialHashHistogramSize] = {};
+};
+
+//======================================================================================
+// Class SpatialHash
+//======================================================================================
+
+class SpatialHash
+{
+public:
+	// cellSize works best around the diameter of a typical object. bucketCount is
+	// rounded up to a power of two and never changes.
+	SpatialHash( f32 cellSize, u32 bucketCount );
+	~SpatialHash();
+
+	// Empties the grid and makes room for objectCount objects. Not thread safe.
+	void Reset( u32 objectCount );
+	// Can be called from any number of threads at once between Reset and the first
+	// query, as long as each object index is only inserted once. Slots that are never
+	// inserted are left out of queries and stats.
+	void Insert( u32 object, const Math::Vector3& position, f32 radius );
+
+	// Reset followed by inserting every object, radii.size must match positions.size.
+	void Rebuild( Span<const Math::Vector3> positions, Span<const f32> radii );
+	void Rebuild( JobSystem& jobSystem, Span<const Math::Vector3> positions, Span<const f32> radii );
+
+	// Write the indices of every object overlapping the sphere or box, in no particular
+	// order. Returns the number found, only the first results.size are written so a
+	// larger return value means the buffer was too small.
+	size_t QueryRadius( const Math::Vector3& center, f32 radius, Span<u32> results ) const;
+	size_t QueryBox( const Math::Vector3& min, const Math::Vector3& max, Span<u32> results ) const;
+
+	SpatialHashStats GetStats() const;
+
+	f32 GetCellSize() const													{ return mCellSize; }
+	u32 GetObjectCount() const												{ return static_cast<u32>(mObjects.size()); }
+	u32 GetInsertedCount() const											{ return mInsertedCount.load(std::memory_order_relaxed); }
+
+private:
+	NONCOPYABLE(SpatialHash);
+
+	// 32 bytes so two objects share a cache line while a bucket is walked
+	struct Object
+	{
+		Math::Vector3	position;
+		f32				radius;
+		s32				cellX;
+		s32				cellY;
+		s32				cellZ;
+		u32				next;
+	};
+
+	void BeginGeneration( u32 objectCount );
+	bool IsInserted( u32 object ) const										{ return mGenerations[object] == mGeneration; }
+
+	s32 ToCell( f32 coordinate ) const;
+	u32 GetBucket( s32 x, s32 y, s32 z ) const;
+
+	template <typename Overlaps>
+	size_t Query( const Math::Vector3& min, const Math::Vector3& max, const Overlaps& overlaps, Span<u32> results ) const;
+
+private:
+	f32								mCellSize;
+	f32								mInvCellSize;
+	u32								mBucketMask;
+
+	std::vector<std::atomic<u32>>	mBuckets;	// First object in each bucket
+	std::vector<Object>				mObjects;
+	std::vector<u32>				mGenerations;	// Per object, mGeneration once inserted since the last Reset
+	u32								mGeneration = 0;
+	std::atomic<u32>				mInsertedCount;
+	std::atomic<u32>				mMaxRadius;	// f32 bits, positive floats order like u32
+};
+
+//======================================================================================
+#endif // !ENGINE_SPATIAL_HASH_H__
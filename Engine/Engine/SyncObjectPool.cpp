@@ -0,0 +1,131 @@
+//======================================================================================
+// Filename: SyncObjectPool.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "SyncObjectPool.h"
+
+#include "GraphicsCommon.h"
+//======================================================================================
+
+SyncObjectPool::SyncObjectPool(VkDevice device, u32 initialFenceCount, u32 initialSemaphoreCount)
+	: mDevice( device )
+{
+	mFreeFences.reserve(initialFenceCount);
+	for (u32 i = 0; i < initialFenceCount; ++i)
+	{
+		mFreeFences.push_back(AllocateFence());
+	}
+
+	mFreeSemaphores.reserve(initialSemaphoreCount);
+	for (u32 i = 0; i < initialSemaphoreCount; ++i)
+	{
+		mFreeSemaphores.push_back(AllocateSemaphore());
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+SyncObjectPool::~SyncObjectPool()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	ASSERT(mFreeFences.size() == mFenceCreateCount, "[SyncObjectPool] Fences still in use on shutdown!");
+	ASSERT(mFreeSemaphores.size() == mSemaphoreCreateCount, "[SyncObjectPool] Semaphores still in use on shutdown!");
+
+	for (auto fence : mFreeFences)
+	{
+		vkDestroyFence(mDevice, fence, nullptr);
+	}
+	for (auto semaphore : mFreeSemaphores)
+	{
+		vkDestroySemaphore(mDevice, semaphore, nullptr);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+VkFence SyncObjectPool::AcquireFence()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!mFreeFences.empty())
+		{
+			VkFence fence = mFreeFences.back();
+			mFreeFences.pop_back();
+			return fence;
+		}
+	}
+	return AllocateFence();
+}
+
+//--------------------------------------------------------------------------------------
+
+void SyncObjectPool::ReleaseFence(VkFence fence)
+{
+	ASSERT(fence != VK_NULL_HANDLE, "[SyncObjectPool] Releasing a null fence!");
+	vkErrorCheck( vkResetFences(mDevice, 1, &fence) );
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mFreeFences.push_back(fence);
+}
+
+//--------------------------------------------------------------------------------------
+
+VkSemaphore SyncObjectPool::AcquireSemaphore()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!mFreeSemaphores.empty())
+		{
+			VkSemaphore semaphore = mFreeSemaphores.back();
+			mFreeSemaphores.pop_back();
+			return semaphore;
+		}
+	}
+	return AllocateSemaphore();
+}
+
+//--------------------------------------------------------------------------------------
+
+void SyncObjectPool::ReleaseSemaphore(VkSemaphore semaphore)
+{
+	ASSERT(semaphore != VK_NULL_HANDLE, "[SyncObjectPool] Releasing a null semaphore!");
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mFreeSemaphores.push_back(semaphore);
+}
+
+//--------------------------------------------------------------------------------------
+
+VkFence SyncObjectPool::AllocateFence()
+{
+	VkFenceCreateInfo fenceCreateInfo = {};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	VkFence fence = VK_NULL_HANDLE;
+	vkErrorCheck( vkCreateFence(mDevice, &fenceCreateInfo, nullptr, &fence) );
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	++mFenceCreateCount;
+	return fence;
+}
+
+//--------------------------------------------------------------------------------------
+
+VkSemaphore SyncObjectPool::AllocateSemaphore()
+{
+	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	VkSemaphore semaphore = VK_NULL_HANDLE;
+	vkErrorCheck( vkCreateSemaphore(mDevice, &semaphoreCreateInfo, nullptr, &semaphore) );
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	++mSemaphoreCreateCount;
+	return semaphore;
+}
+
+//======================================================================================
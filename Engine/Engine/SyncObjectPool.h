@@ -0,0 +1,59 @@
+#ifndef ENGINE_GRAPHICS_SYNC_OBJECT_POOL_H__
+#define ENGINE_GRAPHICS_SYNC_OBJECT_POOL_H__
+//======================================================================================
+// Filename: SyncObjectPool.h
+// Description: Thread safe pool of fences and binary semaphores so per operation
+//				synchronization never has to call vkCreate* or vkDestroy*.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Platform.h"
+
+#include <mutex>
+#include <vector>
+
+//======================================================================================
+// Class SyncObjectPool
+//======================================================================================
+
+class SyncObjectPool
+{
+public:
+	SyncObjectPool( VkDevice device, u32 initialFenceCount = 0, u32 initialSemaphoreCount = 0 );
+	~SyncObjectPool();
+
+	// Returns an unsignaled fence.
+	VkFence AcquireFence();
+	// The fence must not be pending on any queue. It is reset before it is handed out again.
+	void ReleaseFence( VkFence fence );
+
+	// Returns an unsignaled binary semaphore.
+	VkSemaphore AcquireSemaphore();
+	// The semaphore must be unsignaled with no pending signal or wait operation.
+	void ReleaseSemaphore( VkSemaphore semaphore );
+
+	u32 GetFenceCreateCount() const											{ return mFenceCreateCount; }
+	u32 GetSemaphoreCreateCount() const										{ return mSemaphoreCreateCount; }
+
+private:
+	NONCOPYABLE(SyncObjectPool);
+
+	VkFence AllocateFence();
+	VkSemaphore AllocateSemaphore();
+
+private:
+	VkDevice					mDevice = VK_NULL_HANDLE;
+
+	std::mutex					mMutex;
+	std::vector<VkFence>		mFreeFences;
+	std::vector<VkSemaphore>	mFreeSemaphores;
+
+	u32							mFenceCreateCount = 0;
+	u32							mSemaphoreCreateCount = 0;
+};
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_SYNC_OBJECT_POOL_H__
@@ -0,0 +1,380 @@
+//======================================================================================
+// Filename: TransformHierarchy.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TransformHierarchy.h"
+
+#include "JobSystem.h"
+//======================================================================================
+
+namespace
+{
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+// values[i] = old values[order[i]]
+template <typename T>
+void Permute(std::vector<T>& values, const std::vector<u32>& order)
+{
+	std::vector<T> sorted;
+	sorted.reserve(order.size());
+	for (u32 slot : order)
+	{
+		sorted.push_back(values[slot]);
+	}
+	values.swap(sorted);
+}
+
+} // namespace
+
+//======================================================================================
+// Class TransformHierarchy
+//======================================================================================
+
+TransformHierarchy::TransformHierarchy()
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+TransformHierarchy::~TransformHierarchy()
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+TransformId TransformHierarchy::Create(TransformId parent)
+{
+	TransformId id;
+	if (!mFreeIds.empty())
+	{
+		id = mFreeIds.back();
+		mFreeIds.pop_back();
+	}
+	else
+	{
+		id = static_cast<TransformId>(mSlots.size());
+		mSlots.push_back(kTransformInvalid);
+	}
+
+	//Appended out of order, the next Update sorts it into its level
+	const u32 slot = static_cast<u32>(mIds.size());
+	mPositions.push_back(Math::Vector3::Zero());
+	mRotations.push_back(Math::Quaternion::Identity());
+	mScales.push_back(Math::Vector3::One());
+	mWorlds.push_back(Math::Matrix34::Identity());
+	mParents.push_back((parent != kTransformInvalid) ? GetSlot(parent) : kTransformInvalid);
+	mFirstChilds.push_back(0);
+	mChildCounts.push_back(0);
+	mDepths.push_back(0);
+	mDirty.push_back(1);
+	mIds.push_back(id);
+
+	mSlots[id] = slot;
+	mIsStructureDirty = true;
+	return id;
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::Destroy(TransformId id)
+{
+	ASSERT(id < mSlots.size() && mSlots[id] != kTransformInvalid, "[TransformHierarchy] Invalid transform id %u!", id);
+	mDestroyedIds.push_back(id);
+	mIsStructureDirty = true;
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::SetParent(TransformId id, TransformId parent)
+{
+	const u32 slot = GetSlot(id);
+	const u32 parentSlot = (parent != kTransformInvalid) ? GetSlot(parent) : kTransformInvalid;
+	for (u32 ancestor = parentSlot; ancestor != kTransformInvalid; ancestor = mParents[ancestor])
+	{
+		ASSERT(ancestor != slot, "[TransformHierarchy] Parenting a transform to its own descendant!");
+	}
+
+	mParents[slot] = parentSlot;
+	mIsStructureDirty = true;
+	MarkDirty(slot);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::SetLocal(TransformId id, const Math::Vector3& position, const Math::Quaternion& rotation, const Math::Vector3& scale)
+{
+	const u32 slot = GetSlot(id);
+	mPositions[slot] = position;
+	mRotations[slot] = rotation;
+	mScales[slot] = scale;
+	MarkDirty(slot);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::SetPosition(TransformId id, const Math::Vector3& position)
+{
+	const u32 slot = GetSlot(id);
+	mPositions[slot] = position;
+	MarkDirty(slot);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::SetRotation(TransformId id, const Math::Quaternion& rotation)
+{
+	const u32 slot = GetSlot(id);
+	mRotations[slot] = rotation;
+	MarkDirty(slot);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::SetScale(TransformId id, const Math::Vector3& scale)
+{
+	const u32 slot = GetSlot(id);
+	mScales[slot] = scale;
+	MarkDirty(slot);
+}
+
+//--------------------------------------------------------------------------------------
+
+TransformId TransformHierarchy::GetParent(TransformId id) const
+{
+	const u32 parentSlot = mParents[GetSlot(id)];
+	return (parentSlot != kTransformInvalid) ? mIds[parentSlot] : kTransformInvalid;
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::Update()
+{
+	UpdateLevels(nullptr);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::Update(JobSystem& jobSystem)
+{
+	UpdateLevels(&jobSystem);
+}
+
+//--------------------------------------------------------------------------------------
+
+u32 TransformHierarchy::GetSlot(TransformId id) const
+{
+	ASSERT(id < mSlots.size() && mSlots[id] != kTransformInvalid, "[TransformHierarchy] Invalid transform id %u!", id);
+	return mSlots[id];
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::MarkDirty(u32 slot)
+{
+	if (mDirty[slot] != 0)
+	{
+		return;
+	}
+
+	//The levels are rebuilt from the flags after a structural change
+	mDirty[slot] = 1;
+	if (!mIsStructureDirty)
+	{
+		mDirtyLevels[mDepths[slot]].push_back(slot);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::UpdateLevels(JobSystem* jobSystem)
+{
+	if (mIsStructureDirty)
+	{
+		Restructure();
+	}
+
+	mLastUpdateCount = 0;
+	const size_t levelCount = mDirtyLevels.size();
+	for (size_t depth = 0; depth < levelCount; ++depth)
+	{
+		std::vector<u32>& level = mDirtyLevels[depth];
+		if (level.empty())
+		{
+			continue;
+		}
+
+		//Parents are a level up and already final, so the level has no dependencies
+		if (nullptr != jobSystem && level.size() > kTransformGrainSize)
+		{
+			jobSystem->ParallelFor(level.size(), kTransformGrainSize, [this, &level](size_t begin, size_t end)
+			{
+				UpdateWorlds(Span<const u32>(level.data() + begin, end - begin));
+			});
+		}
+		else
+		{
+			UpdateWorlds(level);
+		}
+		mLastUpdateCount += static_cast<u32>(level.size());
+
+		//Push the change down to the children, they are contiguous in the next level
+		if (depth + 1 < levelCount)
+		{
+			std::vector<u32>& nextLevel = mDirtyLevels[depth + 1];
+			for (u32 slot : level)
+			{
+				const u32 end = mFirstChilds[slot] + mChildCounts[slot];
+				for (u32 child = mFirstChilds[slot]; child < end; ++child)
+				{
+					if (mDirty[child] == 0)
+					{
+						mDirty[child] = 1;
+						nextLevel.push_back(child);
+					}
+				}
+			}
+		}
+		level.clear();
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::UpdateWorlds(Span<const u32> slots)
+{
+	for (u32 slot : slots)
+	{
+		const Math::Matrix34 local = Math::Matrix34::Compose(mPositions[slot], mRotations[slot], mScales[slot]);
+		const u32 parent = mParents[slot];
+		mWorlds[slot] = (parent != kTransformInvalid) ? mWorlds[parent] * local : local;
+		mDirty[slot] = 0;
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void TransformHierarchy::Restructure()
+{
+	const u32 count = static_cast<u32>(mIds.size());
+
+	std::vector<u8> isDestroyed(count, 0);
+	for (TransformId id : mDestroyedIds)
+	{
+		isDestroyed[mSlots[id]] = 1;
+	}
+
+	//Bucket every slot under its parent
+	std::vector<u32> childOffsets(count + 1, 0);
+	for (u32 slot = 0; slot < count; ++slot)
+	{
+		if (mParents[slot] != kTransformInvalid)
+		{
+			++childOffsets[mParents[slot] + 1];
+		}
+	}
+	for (u32 slot = 0; slot < count; ++slot)
+	{
+		childOffsets[slot + 1] += childOffsets[slot];
+	}
+	std::vector<u32> children(childOffsets[count]);
+	std::vector<u32> childWrite(childOffsets.begin(), childOffsets.end() - 1);
+	for (u32 slot = 0; slot < count; ++slot)
+	{
+		if (mParents[slot] != kTransformInvalid)
+		{
+			children[childWrite[mParents[slot]]++] = slot;
+		}
+	}
+
+	//Breadth first from the roots gives depth sorted levels with siblings packed
+	//together. Destroyed subtrees are never reached.
+	std::vector<u32> order;
+	order.reserve(count);
+	for (u32 slot = 0; slot < count; ++slot)
+	{
+		if (mParents[slot] == kTransformInvalid && isDestroyed[slot] == 0)
+		{
+			order.push_back(slot);
+		}
+	}
+
+	std::vector<u32> newSlots(count, kTransformInvalid);
+	std::vector<u32> depths(count, 0);
+	for (u32 i = 0; i < order.size(); ++i)
+	{
+		const u32 slot = order[i];
+		newSlots[slot] = i;
+		mFirstChilds[slot] = static_cast<u32>(order.size());
+		for (u32 c = childOffsets[slot]; c < childOffsets[slot + 1]; ++c)
+		{
+			const u32 child = children[c];
+			if (isDestroyed[child] == 0)
+			{
+				depths[child] = depths[slot] + 1;
+				order.push_back(child);
+			}
+		}
+		mChildCounts[slot] = static_cast<u32>(order.size()) - mFirstChilds[slot];
+	}
+
+	for (u32 slot = 0; slot < count; ++slot)
+	{
+		if (newSlots[slot] == kTransformInvalid)
+		{
+			mSlots[mIds[slot]] = kTransformInvalid;
+			mFreeIds.push_back(mIds[slot]);
+		}
+	}
+
+	for (u32 slot = 0; slot < count; ++slot)
+	{
+		if (mParents[slot] != kTransformInvalid)
+		{
+			mParents[slot] = newSlots[mParents[slot]];
+		}
+	}
+	mDepths.swap(depths);
+
+	Permute(mPositions, order);
+	Permute(mRotations, order);
+	Permute(mScales, order);
+	Permute(mWorlds, order);
+	Permute(mParents, order);
+	Permute(mFirstChilds, order);
+	Permute(mChildCounts, order);
+	Permute(mDepths, order);
+	Permute(mDirty, order);
+	Permute(mIds, order);
+
+	for (u32 slot = 0; slot < mIds.size(); ++slot)
+	{
+		mSlots[mIds[slot]] = slot;
+	}
+
+	//Rebuild the dirty levels from the flags, keeping the old vectors for their memory
+	const size_t levelCount = mDepths.empty() ? 0 : mDepths.back() + 1;
+	mDirtyLevels.resize(levelCount);
+	for (std::vector<u32>& level : mDirtyLevels)
+	{
+		level.clear();
+	}
+	for (u32 slot = 0; slot < mIds.size(); ++slot)
+	{
+		if (mDirty[slot] != 0)
+		{
+			mDirtyLevels[mDepths[slot]].push_back(slot);
+		}
+	}
+
+	mDestroyedIds.clear();
+	mIsStructureDirty = false;
+}
+
+//======================================================================================
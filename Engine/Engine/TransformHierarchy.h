@@ -0,0 +1,109 @@
+#ifndef ENGINE_TRANSFORM_HIERARCHY_H__
+#define ENGINE_TRANSFORM_HIERARCHY_H__
+//======================================================================================
+// Filename: TransformHierarchy.h
+// Description: Owns the local TRS and world matrix of every scene transform. Storage
+//				is structure of arrays sorted breadth first, so each depth is one
+//				contiguous level and the children of a transform sit next to each
+//				other. Update only recomputes transforms that were changed and their
+//				descendants, one level at a time.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "Matrix34.h"
+#include "Quaternion.h"
+#include "Span.h"
+#include "Vector3.h"
+
+#include <vector>
+
+class JobSystem;
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+typedef u32 TransformId;
+
+constexpr TransformId kTransformInvalid		= U32_MAX;
+constexpr size_t kTransformGrainSize		= 512;
+
+//======================================================================================
+// Class TransformHierarchy
+//======================================================================================
+
+class TransformHierarchy
+{
+public:
+	TransformHierarchy();
+	~TransformHierarchy();
+
+	// Ids stay valid until destroyed, they don't follow the storage order.
+	TransformId Create( TransformId parent = kTransformInvalid );
+	// Also destroys every descendant. Ids are released on the next Update.
+	void Destroy( TransformId id );
+	// The transform keeps its local values, so it moves along with the new parent.
+	void SetParent( TransformId id, TransformId parent );
+
+	void SetLocal( TransformId id, const Math::Vector3& position, const Math::Quaternion& rotation, const Math::Vector3& scale );
+	void SetPosition( TransformId id, const Math::Vector3& position );
+	// rotation must be unit length
+	void SetRotation( TransformId id, const Math::Quaternion& rotation );
+	void SetScale( TransformId id, const Math::Vector3& scale );
+
+	const Math::Vector3& GetPosition( TransformId id ) const				{ return mPositions[GetSlot(id)]; }
+	const Math::Quaternion& GetRotation( TransformId id ) const				{ return mRotations[GetSlot(id)]; }
+	const Math::Vector3& GetScale( TransformId id ) const					{ return mScales[GetSlot(id)]; }
+	TransformId GetParent( TransformId id ) const;
+	// As of the last Update
+	const Math::Matrix34& GetWorld( TransformId id ) const					{ return mWorlds[GetSlot(id)]; }
+
+	// Brings every world matrix up to date. Structural changes since the last Update
+	// re-sort the storage first, which touches every transform once.
+	void Update();
+	// Same as above with each level spread across the job system.
+	void Update( JobSystem& jobSystem );
+
+	u32 GetCount() const													{ return static_cast<u32>(mIds.size()); }
+	u32 GetLevelCount() const												{ return static_cast<u32>(mDirtyLevels.size()); }
+	// World matrices recomputed by the last Update
+	u32 GetLastUpdateCount() const											{ return mLastUpdateCount; }
+
+private:
+	NONCOPYABLE(TransformHierarchy);
+
+	u32 GetSlot( TransformId id ) const;
+	void MarkDirty( u32 slot );
+
+	void UpdateLevels( JobSystem* jobSystem );
+	void UpdateWorlds( Span<const u32> slots );
+	void Restructure();
+
+private:
+	// Per slot, in storage order
+	std::vector<Math::Vector3>		mPositions;
+	std::vector<Math::Quaternion>	mRotations;
+	std::vector<Math::Vector3>		mScales;
+	std::vector<Math::Matrix34>		mWorlds;
+	std::vector<u32>				mParents;		// Parent slot or kTransformInvalid
+	std::vector<u32>				mFirstChilds;
+	std::vector<u32>				mChildCounts;
+	std::vector<u32>				mDepths;
+	std::vector<u8>					mDirty;			// Queued in mDirtyLevels
+	std::vector<TransformId>		mIds;
+
+	// Per id
+	std::vector<u32>				mSlots;			// kTransformInvalid when free
+	std::vector<TransformId>		mFreeIds;
+	std::vector<TransformId>		mDestroyedIds;
+
+	std::vector<std::vector<u32>>	mDirtyLevels;	// Dirty slots per depth
+	u32								mLastUpdateCount = 0;
+	bool							mIsStructureDirty = false;
+};
+
+//======================================================================================
+#endif // !ENGINE_TRANSFORM_HIERARCHY_H__
@@ -0,0 +1,74 @@
+#ifndef ENGINE_VECREG_H__
+#define	ENGINE_VECREG_H__
+//======================================================================================
+// Filename: VecReg.h
+// Description: Register resident 4 float vector with the same operator surface as
+//				Vector4. Load once at the top of a hot loop, do the math on VecRegs and
+//				store once at the end. Not meant for storage, keep Vector4 in arrays.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+#include "MathSIMD.h"
+#include "Vector4.h"
+
+namespace Math
+{
+
+//======================================================================================
+// Struct
+//======================================================================================
+
+struct VecReg
+{
+#if MATH_SIMD_SSE4
+	__m128 v;
+
+	explicit VecReg(__m128 v) : v(v) {}
+#else
+	Vector4 v;
+#endif //MATH_SIMD_SSE4
+
+	VecReg();
+	VecReg(f32 x, f32 y, f32 z, f32 w);
+	explicit VecReg(const Vector4& value);
+	explicit VecReg(const Vector3& value, f32 w = 0.0f);
+
+	static VecReg Zero();
+	static VecReg One();
+	static VecReg Splat(f32 s);
+
+	Vector4 ToVector4() const;
+	Vector3 ToVector3() const;
+
+	f32 GetX() const;
+	f32 GetY() const;
+	f32 GetZ() const;
+	f32 GetW() const;
+
+	VecReg operator-() const;
+	VecReg operator+(const VecReg& rhs) const;
+	VecReg operator-(const VecReg& rhs) const;
+	VecReg operator*(f32 s) const;
+	VecReg operator/(f32 s) const;
+
+	VecReg& operator+=(const VecReg& rhs);
+	VecReg& operator-=(const VecReg& rhs);
+	VecReg& operator*=(f32 s);
+	VecReg& operator/=(f32 s);
+
+	bool operator== (const VecReg& rhs) const;
+	bool operator!= (const VecReg& rhs) const;
+};
+
+} // namespace Math
+
+//======================================================================================
+// Inline
+//======================================================================================
+#include "VecReg.inl"
+
+//======================================================================================
+#endif //!ENGINE_VECREG_H__
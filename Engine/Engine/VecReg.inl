@@ -0,0 +1,244 @@
+//======================================================================================
+// Filename: VecReg.inl
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Vector3.h"
+
+namespace Math
+{
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+inline VecReg::VecReg()
+#if MATH_SIMD_SSE4
+	: v(_mm_setzero_ps())
+#endif //MATH_SIMD_SSE4
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg::VecReg(f32 x, f32 y, f32 z, f32 w)
+#if MATH_SIMD_SSE4
+	: v(_mm_set_ps(w, z, y, x))
+#else
+	: v(x, y, z, w)
+#endif //MATH_SIMD_SSE4
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg::VecReg(const Vector4& value)
+#if MATH_SIMD_SSE4
+	: v(_mm_load_ps(&value.x))
+#else
+	: v(value)
+#endif //MATH_SIMD_SSE4
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg::VecReg(const Vector3& value, f32 w)
+	: VecReg(value.x, value.y, value.z, w)
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg VecReg::Zero()
+{
+	return VecReg();
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg VecReg::One()
+{
+	return Splat(1.0f);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg VecReg::Splat(f32 s)
+{
+#if MATH_SIMD_SSE4
+	return VecReg(_mm_set1_ps(s));
+#else
+	return VecReg(s, s, s, s);
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Vector4 VecReg::ToVector4() const
+{
+#if MATH_SIMD_SSE4
+	Vector4 result;
+	_mm_store_ps(&result.x, v);
+	return result;
+#else
+	return v;
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Vector3 VecReg::ToVector3() const
+{
+	return ToVector4().ToVector3();
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 VecReg::GetX() const
+{
+#if MATH_SIMD_SSE4
+	return _mm_cvtss_f32(v);
+#else
+	return v.x;
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 VecReg::GetY() const
+{
+#if MATH_SIMD_SSE4
+	return _mm_cvtss_f32(MATH_SWIZZLE(v, 1, 1, 1, 1));
+#else
+	return v.y;
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 VecReg::GetZ() const
+{
+#if MATH_SIMD_SSE4
+	return _mm_cvtss_f32(_mm_movehl_ps(v, v));
+#else
+	return v.z;
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline f32 VecReg::GetW() const
+{
+#if MATH_SIMD_SSE4
+	return _mm_cvtss_f32(MATH_SWIZZLE(v, 3, 3, 3, 3));
+#else
+	return v.w;
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg VecReg::operator-() const
+{
+#if MATH_SIMD_SSE4
+	return VecReg(_mm_xor_ps(v, _mm_set1_ps(-0.0f)));
+#else
+	return VecReg(-v);
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg VecReg::operator+(const VecReg& rhs) const
+{
+#if MATH_SIMD_SSE4
+	return VecReg(_mm_add_ps(v, rhs.v));
+#else
+	return VecReg(v + rhs.v);
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg VecReg::operator-(const VecReg& rhs) const
+{
+#if MATH_SIMD_SSE4
+	return VecReg(_mm_sub_ps(v, rhs.v));
+#else
+	return VecReg(v - rhs.v);
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg VecReg::operator*(f32 s) const
+{
+#if MATH_SIMD_SSE4
+	return VecReg(_mm_mul_ps(v, _mm_set1_ps(s)));
+#else
+	return VecReg(v * s);
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg VecReg::operator/(f32 s) const
+{
+	assert(s != 0.0f && "[Math] Cannot divide by zero!");
+	return *this * (1.0f / s);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg& VecReg::operator+=(const VecReg& rhs)
+{
+	*this = *this + rhs;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg& VecReg::operator-=(const VecReg& rhs)
+{
+	*this = *this - rhs;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg& VecReg::operator*=(f32 s)
+{
+	*this = *this * s;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline VecReg& VecReg::operator/=(f32 s)
+{
+	*this = *this / s;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline bool VecReg::operator== (const VecReg& rhs) const
+{
+#if MATH_SIMD_SSE4
+	return _mm_movemask_ps(_mm_cmpeq_ps(v, rhs.v)) == 0xF;
+#else
+	return v == rhs.v;
+#endif //MATH_SIMD_SSE4
+}
+
+//--------------------------------------------------------------------------------------
+
+inline bool VecReg::operator!= (const VecReg& rhs) const
+{
+	return !(*this == rhs);
+}
+
+} // namespace Math
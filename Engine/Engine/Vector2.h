@@ -20,25 +20,25 @@ struct Vector2
 	f32 x;
 	f32 y;
 
-	Vector2() : x(0.0f), y(0.0f) {}
-	Vector2(f32 x, f32 y) : x(x), y(y) {}
+	constexpr Vector2() : x(0.0f), y(0.0f) {}
+	constexpr Vector2(f32 x, f32 y) : x(x), y(y) {}
 
-	static Vector2 Zero();
-	static Vector2 One();
+	static constexpr Vector2 Zero();
+	static constexpr Vector2 One();
 
-	Vector2 operator-() const;
-	Vector2 operator+(const Vector2& rhs) const;
-	Vector2 operator-(const Vector2& rhs) const;
-	Vector2 operator*(f32 s) const;
+	constexpr Vector2 operator-() const;
+	constexpr Vector2 operator+(const Vector2& rhs) const;
+	constexpr Vector2 operator-(const Vector2& rhs) const;
+	constexpr Vector2 operator*(f32 s) const;
 	Vector2 operator/(f32 s) const;
 
-	Vector2& operator+=(const Vector2& rhs);
-	Vector2& operator-=(const Vector2& rhs);
-	Vector2& operator*=(f32 s);
+	constexpr Vector2& operator+=(const Vector2& rhs);
+	constexpr Vector2& operator-=(const Vector2& rhs);
+	constexpr Vector2& operator*=(f32 s);
 	Vector2& operator/=(f32 s);
 
-	bool operator== (const Vector2& rhs) const;
-	bool operator!= (const Vector2& rhs) const;
+	constexpr bool operator== (const Vector2& rhs) const;
+	constexpr bool operator!= (const Vector2& rhs) const;
 };
 
 } //Namespace Math
@@ -12,42 +12,42 @@ namespace Math
 //======================================================================================
 // Function Definitions
 //======================================================================================
-inline Vector2 Vector2::Zero()
+constexpr Vector2 Vector2::Zero()
 {
 	return Vector2(0.0f, 0.0f);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2 Vector2::One()
+constexpr Vector2 Vector2::One()
 {
 	return Vector2(1.0f, 1.0f);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2 Vector2::operator-() const
+constexpr Vector2 Vector2::operator-() const
 {
 	return Vector2(-x, -y);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2 Vector2::operator+(const Vector2& rhs) const
+constexpr Vector2 Vector2::operator+(const Vector2& rhs) const
 {
 	return Vector2(x + rhs.x, y + rhs.y);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2 Vector2::operator-(const Vector2& rhs) const
+constexpr Vector2 Vector2::operator-(const Vector2& rhs) const
 {
 	return Vector2(x - rhs.x, y - rhs.y);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2 Vector2::operator*(f32 s) const
+constexpr Vector2 Vector2::operator*(f32 s) const
 {
 	return Vector2(x * s, y * s);
 }
@@ -64,7 +64,7 @@ inline Vector2 Vector2::operator/(f32 s) const
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2& Vector2::operator+=(const Vector2& rhs)
+constexpr Vector2& Vector2::operator+=(const Vector2& rhs)
 {
 	x += rhs.x;
 	y += rhs.y;
@@ -73,7 +73,7 @@ inline Vector2& Vector2::operator+=(const Vector2& rhs)
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2& Vector2::operator-=(const Vector2& rhs)
+constexpr Vector2& Vector2::operator-=(const Vector2& rhs)
 {
 	x -= rhs.x;
 	y -= rhs.y;
@@ -82,7 +82,7 @@ inline Vector2& Vector2::operator-=(const Vector2& rhs)
 
 //--------------------------------------------------------------------------------------
 
-inline Vector2& Vector2::operator*=(f32 s)
+constexpr Vector2& Vector2::operator*=(f32 s)
 {
 	x *= s;
 	y *= s;
@@ -102,14 +102,14 @@ inline Vector2& Vector2::operator/=(f32 s)
 
 //--------------------------------------------------------------------------------------
 
-inline bool Vector2::operator== (const Vector2& rhs) const
+constexpr bool Vector2::operator== (const Vector2& rhs) const
 {
 	return x == rhs.x && y == rhs.y;
 }
 
 //--------------------------------------------------------------------------------------
 
-inline bool Vector2::operator!= (const Vector2& rhs) const
+constexpr bool Vector2::operator!= (const Vector2& rhs) const
 {
 	return !(x == rhs.x && y == rhs.y);
 }
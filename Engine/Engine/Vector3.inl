@@ -11,80 +11,79 @@ namespace Math
 // Function Definitions
 //======================================================================================
 
-inline Vector3 Vector3::Zero()
+constexpr Vector3 Vector3::Zero()
 {
 	return Vector3();
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 Vector3::One()
+constexpr Vector3 Vector3::One()
 {
 	return Vector3(1.0f, 1.0f, 1.0f);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 Vector3::XAxis()
+constexpr Vector3 Vector3::XAxis()
 {
 	return Vector3(1.0f, 0.0f, 0.0f);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 Vector3::YAxis()
+constexpr Vector3 Vector3::YAxis()
 {
 	return Vector3(0.0f, 1.0f, 0.0f);
 }
 
 //--------------------------------------------------------------------------------------
 
-inline Vector3 Vector3::ZAxis()
+constexpr Vector3 Vector3::ZAxis()
 {
 	return Vector3(0.0f, 0.0f, 1.0f);
 }
 
 //--------------------------------------------------------------------------------------
 
-Vector3 Vector3::operator-() const
+constexpr Vector3 Vector3::operator-() const
 {
 	return Vector3(-x, -y, -z);
 }
 
 //--------------------------------------------------------------------------------------
 
-Vector3 Vector3::operator+(const Vector3& rhs) const
+constexpr Vector3 Vector3::operator+(const Vector3& rhs) const
 {
 	return Vector3(x + rhs.x, y + rhs.y, z + rhs.z);
 }
 
 //--------------------------------------------------------------------------------------
 
-Vector3 Vector3::operator-(const Vector3& rhs) const 
+constexpr Vector3 Vector3::operator-(const Vector3& rhs) const 
 {
 	return Vector3(x - rhs.x, y - rhs.y, z - rhs.z);
 }
 
 //--------------------------------------------------------------------------------------
 
-Vector3 Vector3::operator*(f32 s) const
+constexpr Vector3 Vector3::operator*(f32 s) const
 {
 	return Vector3(x * s, y * s, z * s);
 }
 
 //--------------------------------------------------------------------------------------
 
-
-Vector3 Vector3::operator/(f32 s) const
+inline Vector3 Vector3::operator/(f32 s) const
 {
 	assert(s != 0.0f && "[Math] Cannot divide by zero!");
-	const f32 inv = 1 / s;
+	const f32 inv = 1.0f / s;
 	return Vector3(x * inv, y * inv, z * inv);
 }
 
 //--------------------------------------------------------------------------------------
 
-Vector3& Vector3::operator+=(const Vector3& rhs)
+constexpr Vector3& Vector3::operator+=(const Vector3& rhs)
 {
 	x += rhs.x;
 	y += rhs.y;
@@ -94,7 +93,7 @@ Vector3& Vector3::operator+=(const Vector3& rhs)
 
 //--------------------------------------------------------------------------------------
 
-Vector3& Vector3::operator-=(const Vector3& rhs)
+constexpr Vector3& Vector3::operator-=(const Vector3& rhs)
 {
 	x -= rhs.x;
 	y -= rhs.y;
@@ -104,7 +103,7 @@ Vector3& Vector3::operator-=(const Vector3& rhs)
 
 //--------------------------------------------------------------------------------------
 
-Vector3& Vector3::operator*=(f32 s)
+constexpr Vector3& Vector3::operator*=(f32 s)
 {
 	x *= s;
 	y *= s;
@@ -114,10 +113,10 @@ Vector3& Vector3::operator*=(f32 s)
 
 //--------------------------------------------------------------------------------------
 
-Vector3& Vector3::operator/=(f32 s)
+inline Vector3& Vector3::operator/=(f32 s)
 {
 	assert(s != 0.0f && "[Math] Cannot divide by zero!");
-	const f32 inv = 1 / s;
+	const f32 inv = 1.0f / s;
 	x *= inv;
 	y *= inv;
 	z *= inv;
@@ -126,14 +125,14 @@ Vector3& Vector3::operator/=(f32 s)
 
 //--------------------------------------------------------------------------------------
 
-bool Vector3::operator== (const Vector3& rhs) const
+constexpr bool Vector3::operator== (const Vector3& rhs) const
 {
 	return (x == rhs.x && y == rhs.y && z == rhs.z);
 }
 
 //--------------------------------------------------------------------------------------
 
-bool Vector3::operator!= (const Vector3& rhs) const
+constexpr bool Vector3::operator!= (const Vector3& rhs) const
 {
 	return !(x == rhs.x && y == rhs.y && z == rhs.z);
 }
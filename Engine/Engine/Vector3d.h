@@ -0,0 +1,62 @@
+#ifndef ENGINE_VECTOR3D_H__
+#define	ENGINE_VECTOR3D_H__
+//======================================================================================
+// Filename: Vector3d.h
+// Description: Double precision position for world state. f32 runs out of precision
+//				a few kilometres from the origin, so keep world positions in Vector3d
+//				and only drop to f32 once they are relative to the camera.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+
+namespace Math
+{
+
+struct Vector3;
+
+//======================================================================================
+// Struct
+//======================================================================================
+
+struct Vector3d
+{
+	f64 x;
+	f64 y;
+	f64 z;
+
+	constexpr Vector3d() : x(0.0), y(0.0), z(0.0) {}
+	constexpr Vector3d(f64 x, f64 y, f64 z) : x(x), y(y), z(z) {}
+	explicit constexpr Vector3d(const Vector3& v);
+
+	static constexpr Vector3d Zero();
+
+	// Rounds to f32, only use on values already near the origin
+	constexpr Vector3 ToVector3() const;
+
+	constexpr Vector3d operator-() const;
+	constexpr Vector3d operator+(const Vector3d& rhs) const;
+	constexpr Vector3d operator-(const Vector3d& rhs) const;
+	constexpr Vector3d operator*(f64 s) const;
+	Vector3d operator/(f64 s) const;
+
+	constexpr Vector3d& operator+=(const Vector3d& rhs);
+	constexpr Vector3d& operator-=(const Vector3d& rhs);
+	constexpr Vector3d& operator*=(f64 s);
+	Vector3d& operator/=(f64 s);
+
+	constexpr bool operator== (const Vector3d& rhs) const;
+	constexpr bool operator!= (const Vector3d& rhs) const;
+};
+
+} // namespace Math
+
+//======================================================================================
+// Inline
+//======================================================================================
+#include "Vector3d.inl"
+
+//======================================================================================
+#endif //!ENGINE_VECTOR3D_H__
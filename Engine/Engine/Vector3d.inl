@@ -0,0 +1,129 @@
+//======================================================================================
+// Filename: Vector3d.inl
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Vector3.h"
+
+namespace Math
+{
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+constexpr Vector3d::Vector3d(const Vector3& v)
+	: x(v.x), y(v.y), z(v.z)
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d Vector3d::Zero()
+{
+	return Vector3d();
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3 Vector3d::ToVector3() const
+{
+	return Vector3(static_cast<f32>(x), static_cast<f32>(y), static_cast<f32>(z));
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d Vector3d::operator-() const
+{
+	return Vector3d(-x, -y, -z);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d Vector3d::operator+(const Vector3d& rhs) const
+{
+	return Vector3d(x + rhs.x, y + rhs.y, z + rhs.z);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d Vector3d::operator-(const Vector3d& rhs) const
+{
+	return Vector3d(x - rhs.x, y - rhs.y, z - rhs.z);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d Vector3d::operator*(f64 s) const
+{
+	return Vector3d(x * s, y * s, z * s);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Vector3d Vector3d::operator/(f64 s) const
+{
+	assert(s != 0.0 && "[Math] Cannot divide by zero!");
+	const f64 inv = 1.0 / s;
+	return Vector3d(x * inv, y * inv, z * inv);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d& Vector3d::operator+=(const Vector3d& rhs)
+{
+	x += rhs.x;
+	y += rhs.y;
+	z += rhs.z;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d& Vector3d::operator-=(const Vector3d& rhs)
+{
+	x -= rhs.x;
+	y -= rhs.y;
+	z -= rhs.z;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3d& Vector3d::operator*=(f64 s)
+{
+	x *= s;
+	y *= s;
+	z *= s;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Vector3d& Vector3d::operator/=(f64 s)
+{
+	assert(s != 0.0 && "[Math] Cannot divide by zero!");
+	const f64 inv = 1.0 / s;
+	x *= inv;
+	y *= inv;
+	z *= inv;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr bool Vector3d::operator== (const Vector3d& rhs) const
+{
+	return (x == rhs.x && y == rhs.y && z == rhs.z);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr bool Vector3d::operator!= (const Vector3d& rhs) const
+{
+	return !(*this == rhs);
+}
+
+} // namespace Math
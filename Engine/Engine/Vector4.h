@@ -0,0 +1,68 @@
+#ifndef ENGINE_VECTOR4_H__
+#define	ENGINE_VECTOR4_H__
+//======================================================================================
+// Filename: Vector4.h
+// Description: 16 byte aligned storage vector. Loads straight into a VecReg, use it
+//				for arrays that hot loops stream through.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+
+namespace Math
+{
+
+struct Vector3;
+
+//======================================================================================
+// Struct
+//======================================================================================
+
+struct alignas(16) Vector4
+{
+	f32 x;
+	f32 y;
+	f32 z;
+	f32 w;
+
+	constexpr Vector4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+	constexpr Vector4(f32 x, f32 y, f32 z, f32 w) : x(x), y(y), z(z), w(w) {}
+	explicit constexpr Vector4(const Vector3& v, f32 w = 0.0f);
+
+	static constexpr Vector4 Zero();
+	static constexpr Vector4 One();
+	static constexpr Vector4 XAxis();
+	static constexpr Vector4 YAxis();
+	static constexpr Vector4 ZAxis();
+	static constexpr Vector4 WAxis();
+
+	constexpr Vector3 ToVector3() const;
+
+	constexpr Vector4 operator-() const;
+	constexpr Vector4 operator+(const Vector4& rhs) const;
+	constexpr Vector4 operator-(const Vector4& rhs) const;
+	constexpr Vector4 operator*(f32 s) const;
+	Vector4 operator/(f32 s) const;
+
+	constexpr Vector4& operator+=(const Vector4& rhs);
+	constexpr Vector4& operator-=(const Vector4& rhs);
+	constexpr Vector4& operator*=(f32 s);
+	Vector4& operator/=(f32 s);
+
+	constexpr bool operator== (const Vector4& rhs) const;
+	constexpr bool operator!= (const Vector4& rhs) const;
+};
+
+static_assert(sizeof(Vector4) == 16, "[Math] Vector4 must be exactly one SIMD register!");
+
+} // namespace Math
+
+//======================================================================================
+// Inline
+//======================================================================================
+#include "Vector4.inl"
+
+//======================================================================================
+#endif //!ENGINE_VECTOR4_H__
@@ -0,0 +1,168 @@
+//======================================================================================
+// Filename: Vector4.inl
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Vector3.h"
+
+namespace Math
+{
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+constexpr Vector4::Vector4(const Vector3& v, f32 w)
+	: x(v.x), y(v.y), z(v.z), w(w)
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::Zero()
+{
+	return Vector4();
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::One()
+{
+	return Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::XAxis()
+{
+	return Vector4(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::YAxis()
+{
+	return Vector4(0.0f, 1.0f, 0.0f, 0.0f);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::ZAxis()
+{
+	return Vector4(0.0f, 0.0f, 1.0f, 0.0f);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::WAxis()
+{
+	return Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector3 Vector4::ToVector3() const
+{
+	return Vector3(x, y, z);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::operator-() const
+{
+	return Vector4(-x, -y, -z, -w);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::operator+(const Vector4& rhs) const
+{
+	return Vector4(x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::operator-(const Vector4& rhs) const
+{
+	return Vector4(x - rhs.x, y - rhs.y, z - rhs.z, w - rhs.w);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4 Vector4::operator*(f32 s) const
+{
+	return Vector4(x * s, y * s, z * s, w * s);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Vector4 Vector4::operator/(f32 s) const
+{
+	assert(s != 0.0f && "[Math] Cannot divide by zero!");
+	const f32 inv = 1.0f / s;
+	return Vector4(x * inv, y * inv, z * inv, w * inv);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4& Vector4::operator+=(const Vector4& rhs)
+{
+	x += rhs.x;
+	y += rhs.y;
+	z += rhs.z;
+	w += rhs.w;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4& Vector4::operator-=(const Vector4& rhs)
+{
+	x -= rhs.x;
+	y -= rhs.y;
+	z -= rhs.z;
+	w -= rhs.w;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr Vector4& Vector4::operator*=(f32 s)
+{
+	x *= s;
+	y *= s;
+	z *= s;
+	w *= s;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+inline Vector4& Vector4::operator/=(f32 s)
+{
+	assert(s != 0.0f && "[Math] Cannot divide by zero!");
+	const f32 inv = 1.0f / s;
+	x *= inv;
+	y *= inv;
+	z *= inv;
+	w *= inv;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr bool Vector4::operator== (const Vector4& rhs) const
+{
+	return (x == rhs.x && y == rhs.y && z == rhs.z && w == rhs.w);
+}
+
+//--------------------------------------------------------------------------------------
+
+constexpr bool Vector4::operator!= (const Vector4& rhs) const
+{
+	return !(*this == rhs);
+}
+
+} // namespace Math
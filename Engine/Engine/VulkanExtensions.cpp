@@ -0,0 +1,116 @@
+//======================================================================================
+// Filename: VulkanExtensions.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "VulkanExtensions.h"
+
+#include <cstring>
+#include <vector>
+//======================================================================================
+
+PFN_vkGetPhysicalDeviceFeatures2KHR	fvkGetPhysicalDeviceFeatures2KHR	= nullptr;
+PFN_vkGetPhysicalDeviceProperties2KHR	fvkGetPhysicalDeviceProperties2KHR	= nullptr;
+
+PFN_vkGetSemaphoreCounterValueKHR	fvkGetSemaphoreCounterValueKHR		= nullptr;
+PFN_vkWaitSemaphoresKHR				fvkWaitSemaphoresKHR				= nullptr;
+PFN_vkSignalSemaphoreKHR			fvkSignalSemaphoreKHR				= nullptr;
+
+PFN_vkCmdDrawIndexedIndirectCountKHR	fvkCmdDrawIndexedIndirectCountKHR	= nullptr;
+
+//======================================================================================
+// Functions
+//======================================================================================
+
+bool IsInstanceExtensionAvailable(const char* extensionName)
+{
+	uint32_t extensionCount = 0;
+	vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+	std::vector<VkExtensionProperties> extensions(extensionCount);
+	vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, extensions.data());
+
+	for (const auto& extension : extensions)
+	{
+		if (strcmp(extension.extensionName, extensionName) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------------------------------
+
+bool IsDeviceExtensionAvailable(VkPhysicalDevice physicalDevice, const char* extensionName)
+{
+	uint32_t extensionCount = 0;
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+	std::vector<VkExtensionProperties> extensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data());
+
+	for (const auto& extension : extensions)
+	{
+		if (strcmp(extension.extensionName, extensionName) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------------------------------
+
+void LoadInstanceExtensionFunctions(VkInstance instance)
+{
+	fvkGetPhysicalDeviceFeatures2KHR
+		= (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR");
+	fvkGetPhysicalDeviceProperties2KHR
+		= (PFN_vkGetPhysicalDeviceProperties2KHR)vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceProperties2KHR");
+}
+
+//--------------------------------------------------------------------------------------
+
+void LoadDeviceExtensionFunctions(VkDevice device, Span<const char* const> enabledExtensions)
+{
+	auto isEnabled = [enabledExtensions](const char* extensionName)
+	{
+		for (const char* enabledExtension : enabledExtensions)
+		{
+			if (strcmp(enabledExtension, extensionName) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	fvkGetSemaphoreCounterValueKHR = nullptr;
+	fvkWaitSemaphoresKHR = nullptr;
+	fvkSignalSemaphoreKHR = nullptr;
+	if (isEnabled(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+	{
+		fvkGetSemaphoreCounterValueKHR
+			= (PFN_vkGetSemaphoreCounterValueKHR)vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR");
+		fvkWaitSemaphoresKHR
+			= (PFN_vkWaitSemaphoresKHR)vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR");
+		fvkSignalSemaphoreKHR
+			= (PFN_vkSignalSemaphoreKHR)vkGetDeviceProcAddr(device, "vkSignalSemaphoreKHR");
+	}
+
+	fvkCmdDrawIndexedIndirectCountKHR = nullptr;
+	if (isEnabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+	{
+		fvkCmdDrawIndexedIndirectCountKHR
+			= (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCountKHR");
+	}
+	else if (isEnabled(VK_AMD_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+	{
+		fvkCmdDrawIndexedIndirectCountKHR
+			= (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCountAMD");
+	}
+}
+
+//======================================================================================
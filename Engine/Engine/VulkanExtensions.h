@@ -0,0 +1,210 @@
+#ifndef ENGINE_GRAPHICS_VULKAN_EXTENSIONS_H__
+#define ENGINE_GRAPHICS_VULKAN_EXTENSIONS_H__
+//======================================================================================
+// Filename: VulkanExtensions.h
+// Description: Declarations for extensions that are newer than the vendored Vulkan
+//				headers, and the entry points that have to be loaded at runtime.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Platform.h"
+#include "Span.h"
+
+//======================================================================================
+// VK_KHR_timeline_semaphore
+//======================================================================================
+#ifndef VK_KHR_timeline_semaphore
+#define VK_KHR_timeline_semaphore 1
+#define VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME "VK_KHR_timeline_semaphore"
+
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR	static_cast<VkStructureType>(1000207000)
+#define VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR					static_cast<VkStructureType>(1000207002)
+#define VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR				static_cast<VkStructureType>(1000207003)
+#define VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR							static_cast<VkStructureType>(1000207004)
+#define VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR							static_cast<VkStructureType>(1000207005)
+
+typedef enum VkSemaphoreTypeKHR {
+	VK_SEMAPHORE_TYPE_BINARY_KHR = 0,
+	VK_SEMAPHORE_TYPE_TIMELINE_KHR = 1,
+	VK_SEMAPHORE_TYPE_MAX_ENUM_KHR = 0x7FFFFFFF
+} VkSemaphoreTypeKHR;
+
+typedef VkFlags VkSemaphoreWaitFlagsKHR;
+
+typedef struct VkPhysicalDeviceTimelineSemaphoreFeaturesKHR {
+	VkStructureType		sType;
+	void*				pNext;
+	VkBool32			timelineSemaphore;
+} VkPhysicalDeviceTimelineSemaphoreFeaturesKHR;
+
+typedef struct VkSemaphoreTypeCreateInfoKHR {
+	VkStructureType		sType;
+	const void*			pNext;
+	VkSemaphoreTypeKHR	semaphoreType;
+	uint64_t			initialValue;
+} VkSemaphoreTypeCreateInfoKHR;
+
+typedef struct VkTimelineSemaphoreSubmitInfoKHR {
+	VkStructureType		sType;
+	const void*			pNext;
+	uint32_t			waitSemaphoreValueCount;
+	const uint64_t*		pWaitSemaphoreValues;
+	uint32_t			signalSemaphoreValueCount;
+	const uint64_t*		pSignalSemaphoreValues;
+} VkTimelineSemaphoreSubmitInfoKHR;
+
+typedef struct VkSemaphoreWaitInfoKHR {
+	VkStructureType				sType;
+	const void*					pNext;
+	VkSemaphoreWaitFlagsKHR		flags;
+	uint32_t					semaphoreCount;
+	const VkSemaphore*			pSemaphores;
+	const uint64_t*				pValues;
+} VkSemaphoreWaitInfoKHR;
+
+typedef struct VkSemaphoreSignalInfoKHR {
+	VkStructureType		sType;
+	const void*			pNext;
+	VkSemaphore			semaphore;
+	uint64_t			value;
+} VkSemaphoreSignalInfoKHR;
+
+typedef VkResult (VKAPI_PTR *PFN_vkGetSemaphoreCounterValueKHR)(VkDevice device, VkSemaphore semaphore, uint64_t* pValue);
+typedef VkResult (VKAPI_PTR *PFN_vkWaitSemaphoresKHR)(VkDevice device, const VkSemaphoreWaitInfoKHR* pWaitInfo, uint64_t timeout);
+typedef VkResult (VKAPI_PTR *PFN_vkSignalSemaphoreKHR)(VkDevice device, const VkSemaphoreSignalInfoKHR* pSignalInfo);
+#endif // !VK_KHR_timeline_semaphore
+
+//======================================================================================
+// VK_KHR_draw_indirect_count
+//======================================================================================
+#ifndef VK_KHR_draw_indirect_count
+#define VK_KHR_draw_indirect_count 1
+#define VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME "VK_KHR_draw_indirect_count"
+
+typedef void (VKAPI_PTR *PFN_vkCmdDrawIndexedIndirectCountKHR)(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride);
+#endif // !VK_KHR_draw_indirect_count
+
+//======================================================================================
+// VK_KHR_maintenance3
+//======================================================================================
+#ifndef VK_KHR_maintenance3
+#define VK_KHR_maintenance3 1
+#define VK_KHR_MAINTENANCE3_EXTENSION_NAME "VK_KHR_maintenance3"
+#endif // !VK_KHR_maintenance3
+
+//======================================================================================
+// VK_EXT_descriptor_indexing
+//======================================================================================
+#ifndef VK_EXT_descriptor_indexing
+#define VK_EXT_descriptor_indexing 1
+#define VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME "VK_EXT_descriptor_indexing"
+
+#define VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT	static_cast<VkStructureType>(1000161000)
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT		static_cast<VkStructureType>(1000161001)
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT	static_cast<VkStructureType>(1000161002)
+
+#define VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT					static_cast<VkDescriptorPoolCreateFlagBits>(0x00000002)
+#define VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT			static_cast<VkDescriptorSetLayoutCreateFlags>(0x00000002)
+
+typedef enum VkDescriptorBindingFlagBitsEXT {
+	VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT = 0x00000001,
+	VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT = 0x00000002,
+	VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT = 0x00000004,
+	VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT = 0x00000008,
+	VK_DESCRIPTOR_BINDING_FLAG_BITS_MAX_ENUM_EXT = 0x7FFFFFFF
+} VkDescriptorBindingFlagBitsEXT;
+
+typedef VkFlags VkDescriptorBindingFlagsEXT;
+
+typedef struct VkDescriptorSetLayoutBindingFlagsCreateInfoEXT {
+	VkStructureType						sType;
+	const void*							pNext;
+	uint32_t							bindingCount;
+	const VkDescriptorBindingFlagsEXT*	pBindingFlags;
+} VkDescriptorSetLayoutBindingFlagsCreateInfoEXT;
+
+typedef struct VkPhysicalDeviceDescriptorIndexingFeaturesEXT {
+	VkStructureType		sType;
+	void*				pNext;
+	VkBool32			shaderInputAttachmentArrayDynamicIndexing;
+	VkBool32			shaderUniformTexelBufferArrayDynamicIndexing;
+	VkBool32			shaderStorageTexelBufferArrayDynamicIndexing;
+	VkBool32			shaderUniformBufferArrayNonUniformIndexing;
+	VkBool32			shaderSampledImageArrayNonUniformIndexing;
+	VkBool32			shaderStorageBufferArrayNonUniformIndexing;
+	VkBool32			shaderStorageImageArrayNonUniformIndexing;
+	VkBool32			shaderInputAttachmentArrayNonUniformIndexing;
+	VkBool32			shaderUniformTexelBufferArrayNonUniformIndexing;
+	VkBool32			shaderStorageTexelBufferArrayNonUniformIndexing;
+	VkBool32			descriptorBindingUniformBufferUpdateAfterBind;
+	VkBool32			descriptorBindingSampledImageUpdateAfterBind;
+	VkBool32			descriptorBindingStorageImageUpdateAfterBind;
+	VkBool32			descriptorBindingStorageBufferUpdateAfterBind;
+	VkBool32			descriptorBindingUniformTexelBufferUpdateAfterBind;
+	VkBool32			descriptorBindingStorageTexelBufferUpdateAfterBind;
+	VkBool32			descriptorBindingUpdateUnusedWhilePending;
+	VkBool32			descriptorBindingPartiallyBound;
+	VkBool32			descriptorBindingVariableDescriptorCount;
+	VkBool32			runtimeDescriptorArray;
+} VkPhysicalDeviceDescriptorIndexingFeaturesEXT;
+
+typedef struct VkPhysicalDeviceDescriptorIndexingPropertiesEXT {
+	VkStructureType		sType;
+	void*				pNext;
+	uint32_t			maxUpdateAfterBindDescriptorsInAllPools;
+	VkBool32			shaderUniformBufferArrayNonUniformIndexingNative;
+	VkBool32			shaderSampledImageArrayNonUniformIndexingNative;
+	VkBool32			shaderStorageBufferArrayNonUniformIndexingNative;
+	VkBool32			shaderStorageImageArrayNonUniformIndexingNative;
+	VkBool32			shaderInputAttachmentArrayNonUniformIndexingNative;
+	VkBool32			robustBufferAccessUpdateAfterBind;
+	VkBool32			quadDivergentImplicitLod;
+	uint32_t			maxPerStageDescriptorUpdateAfterBindSamplers;
+	uint32_t			maxPerStageDescriptorUpdateAfterBindUniformBuffers;
+	uint32_t			maxPerStageDescriptorUpdateAfterBindStorageBuffers;
+	uint32_t			maxPerStageDescriptorUpdateAfterBindSampledImages;
+	uint32_t			maxPerStageDescriptorUpdateAfterBindStorageImages;
+	uint32_t			maxPerStageDescriptorUpdateAfterBindInputAttachments;
+	uint32_t			maxPerStageUpdateAfterBindResources;
+	uint32_t			maxDescriptorSetUpdateAfterBindSamplers;
+	uint32_t			maxDescriptorSetUpdateAfterBindUniformBuffers;
+	uint32_t			maxDescriptorSetUpdateAfterBindUniformBuffersDynamic;
+	uint32_t			maxDescriptorSetUpdateAfterBindStorageBuffers;
+	uint32_t			maxDescriptorSetUpdateAfterBindStorageBuffersDynamic;
+	uint32_t			maxDescriptorSetUpdateAfterBindSampledImages;
+	uint32_t			maxDescriptorSetUpdateAfterBindStorageImages;
+	uint32_t			maxDescriptorSetUpdateAfterBindInputAttachments;
+} VkPhysicalDeviceDescriptorIndexingPropertiesEXT;
+#endif // !VK_EXT_descriptor_indexing
+
+//======================================================================================
+// Runtime Entry Points
+//======================================================================================
+
+extern PFN_vkGetPhysicalDeviceFeatures2KHR	fvkGetPhysicalDeviceFeatures2KHR;
+extern PFN_vkGetPhysicalDeviceProperties2KHR	fvkGetPhysicalDeviceProperties2KHR;
+
+extern PFN_vkGetSemaphoreCounterValueKHR	fvkGetSemaphoreCounterValueKHR;
+extern PFN_vkWaitSemaphoresKHR				fvkWaitSemaphoresKHR;
+extern PFN_vkSignalSemaphoreKHR				fvkSignalSemaphoreKHR;
+
+// Loaded from VK_AMD_draw_indirect_count instead when that is the one enabled, the
+// signature is the same
+extern PFN_vkCmdDrawIndexedIndirectCountKHR	fvkCmdDrawIndexedIndirectCountKHR;
+
+//======================================================================================
+// Functions
+//======================================================================================
+
+bool IsInstanceExtensionAvailable(const char* extensionName);
+bool IsDeviceExtensionAvailable(VkPhysicalDevice physicalDevice, const char* extensionName);
+
+void LoadInstanceExtensionFunctions(VkInstance instance);
+// Only loads the entry points of enabledExtensions, the rest are left null. Loaders may
+// hand out pointers for extensions that exist but were never enabled.
+void LoadDeviceExtensionFunctions(VkDevice device, Span<const char* const> enabledExtensions);
+
+//======================================================================================
+#endif // !ENGINE_GRAPHICS_VULKAN_EXTENSIONS_H__
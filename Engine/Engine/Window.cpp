@@ -10,7 +10,9 @@
 
 #include "Common.h"
 #include "GraphicsCommon.h"
+#include "PresentThread.h"
 #include "Renderer.h"
+#include "SyncObjectPool.h"
 
 #include <array>
 
@@ -31,12 +33,14 @@ Window::Window(Renderer* renderer, uint32_t windowWidth, uint32_t windowHeight,
 	InitRenderPass();
 	InitFrameBuffers();
 	InitSynchronizations();
+	InitPresentThread();
 }
 
 //--------------------------------------------------------------------------------------
 
 Window::~Window() 
 {
+	TerminatePresentThread();
 	TerminateSynchronizations();
 	TerminateFrameBuffers();
 	TerminateRenderPass();
@@ -66,41 +70,85 @@ bool Window::Update()
 
 void Window::BeginRender()
 {
-	vkErrorCheck( vkAcquireNextImageKHR(
-						mRenderer->GetVulkanDevice(), 
-						mSwapchain, 
-						U64_MAX,
-						VK_NULL_HANDLE,
-						mSwapchainImageAvailable, 
-						&mActiveSwapchainImageID) );
+	if (nullptr != mPresentThread)
+	{
+		//Never hold more acquired images than the swapchain guarantees forward progress for
+		const uint32_t maxPending = mSwapchainImageCount - mSurfaceCapabilities.minImageCount - 1;
+		mPresentThread->WaitForPending(maxPending);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mSwapchainMutex);
+		vkErrorCheck( vkAcquireNextImageKHR(
+							mRenderer->GetVulkanDevice(), 
+							mSwapchain, 
+							U64_MAX,
+							VK_NULL_HANDLE,
+							mSwapchainImageAvailable, 
+							&mActiveSwapchainImageID) );
+	}
 	vkErrorCheck( vkWaitForFences(	mRenderer->GetVulkanDevice(), 1, 
 									&mSwapchainImageAvailable, VK_TRUE, UINT64_MAX));
 	vkErrorCheck( vkResetFences(mRenderer->GetVulkanDevice(), 
 								1, &mSwapchainImageAvailable));
-	vkErrorCheck( vkQueueWaitIdle(mRenderer->GetVulkanQueue()) );
 }
 
 //--------------------------------------------------------------------------------------
 
-void Window::EndRender(std::vector<VkSemaphore> waitSemaphores)
+void Window::EndRender(Span<const VkSemaphore> waitSemaphores)
 {
+	++mFrameID;
+
+	//More waits than a request holds fall back to presenting here, after the queued
+	//presents so frames stay in order
+	ASSERT(waitSemaphores.size <= kPresentMaxWaitSemaphores, "[Window] %zu present wait semaphores, the present thread takes %u!", waitSemaphores.size, kPresentMaxWaitSemaphores);
+	if (nullptr != mPresentThread && waitSemaphores.size > kPresentMaxWaitSemaphores)
+	{
+		mPresentThread->WaitIdle();
+	}
+	else if (nullptr != mPresentThread)
+	{
+		PresentRequest request;
+		request.swapchain			= mSwapchain;
+		request.imageIndex			= mActiveSwapchainImageID;
+		request.waitSemaphoreCount	= static_cast<uint32_t>(waitSemaphores.size);
+		request.frameID				= mFrameID;
+		for (uint32_t i = 0; i < request.waitSemaphoreCount; ++i)
+		{
+			request.waitSemaphores[i] = waitSemaphores[i];
+		}
+
+		mPresentThread->Enqueue(request);
+		return;
+	}
+
 	VkResult presentResult = VkResult::VK_RESULT_MAX_ENUM;
 
 	VkPresentInfoKHR presentInfo = {};
 	presentInfo.sType				= VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-	presentInfo.waitSemaphoreCount	= static_cast<uint32_t>(waitSemaphores.size());
-	presentInfo.pWaitSemaphores		= waitSemaphores.data();
+	presentInfo.waitSemaphoreCount	= static_cast<uint32_t>(waitSemaphores.size);
+	presentInfo.pWaitSemaphores		= waitSemaphores.data;
 	presentInfo.swapchainCount		= 1;
 	presentInfo.pSwapchains			= &mSwapchain;
 	presentInfo.pImageIndices		= &mActiveSwapchainImageID;
 	presentInfo.pResults			= &presentResult;
 
-	vkErrorCheck(vkQueuePresentKHR(mRenderer->GetVulkanQueue(), &presentInfo));
+	{
+		std::lock_guard<std::mutex> lock(mRenderer->GetVulkanPresentQueueMutex());
+		vkErrorCheck(vkQueuePresentKHR(mRenderer->GetVulkanPresentQueue(), &presentInfo));
+	}
 	vkErrorCheck(presentResult);
 }
 
 //--------------------------------------------------------------------------------------
 
+bool Window::PopPresentTiming(PresentTiming& timing)
+{
+	return (nullptr != mPresentThread) && mPresentThread->PopTiming(timing);
+}
+
+//--------------------------------------------------------------------------------------
+
 void Window::InitSurface() 
 {
 	InitOSSurface();
@@ -159,10 +207,15 @@ void Window::TerminateSurface()
 
 void Window::InitSwapchain()
 {
-	
-	if (mSwapchainImageCount < mSurfaceCapabilities.minImageCount + 1)
+#if BUILD_ENABLE_PRESENT_THREAD
+	//One extra image so the next frame can be acquired while the last one waits on the present thread
+	const uint32_t kExtraImages = 2;
+#else
+	const uint32_t kExtraImages = 1;
+#endif
+	if (mSwapchainImageCount < mSurfaceCapabilities.minImageCount + kExtraImages)
 	{
-		mSwapchainImageCount = mSurfaceCapabilities.minImageCount + 1;
+		mSwapchainImageCount = mSurfaceCapabilities.minImageCount + kExtraImages;
 	}
 	if (mSurfaceCapabilities.maxImageCount > 0 
 				&& mSwapchainImageCount > mSurfaceCapabilities.maxImageCount)
@@ -468,17 +521,62 @@ void Window::TerminateFrameBuffers()
 
 void Window::InitSynchronizations()
 {
-	VkFenceCreateInfo fenceCreateInfo = {};
-	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	SyncObjectPool* pool = mRenderer->GetSyncObjectPool();
 
-	vkCreateFence(mRenderer->GetVulkanDevice(), &fenceCreateInfo, nullptr, &mSwapchainImageAvailable);
+	mSwapchainImageAvailable = pool->AcquireFence();
+
+	//One per swapchain image, an image is only re-acquired once its last present has been queued
+	mRenderCompleteSemaphores.resize(mSwapchainImageCount);
+	for (auto& semaphore : mRenderCompleteSemaphores)
+	{
+		semaphore = pool->AcquireSemaphore();
+	}
 }
 
 //--------------------------------------------------------------------------------------
 
 void Window::TerminateSynchronizations()
 {
-	vkDestroyFence(mRenderer->GetVulkanDevice(), mSwapchainImageAvailable, nullptr);
+	SyncObjectPool* pool = mRenderer->GetSyncObjectPool();
+
+	for (auto semaphore : mRenderCompleteSemaphores)
+	{
+		pool->ReleaseSemaphore(semaphore);
+	}
+	mRenderCompleteSemaphores.clear();
+
+	pool->ReleaseFence(mSwapchainImageAvailable);
+	mSwapchainImageAvailable = VK_NULL_HANDLE;
+}
+
+//--------------------------------------------------------------------------------------
+
+void Window::InitPresentThread()
+{
+#if BUILD_ENABLE_PRESENT_THREAD
+	//Without a spare image the present thread could never run ahead of the main thread
+	if (mSwapchainImageCount > mSurfaceCapabilities.minImageCount + 1)
+	{
+		mPresentThread = new PresentThread(	mRenderer->GetVulkanPresentQueue(),
+											&mRenderer->GetVulkanPresentQueueMutex(),
+											&mSwapchainMutex );
+	}
+#endif //BUILD_ENABLE_PRESENT_THREAD
+}
+
+//--------------------------------------------------------------------------------------
+
+void Window::TerminatePresentThread()
+{
+	if (nullptr != mPresentThread)
+	{
+		mPresentThread->WaitIdle();
+		SAVE_DELETE(mPresentThread);
+	}
+
+	//The last presents may still be waiting on the render complete semaphores
+	std::lock_guard<std::mutex> lock(mRenderer->GetVulkanPresentQueueMutex());
+	vkErrorCheck( vkQueueWaitIdle(mRenderer->GetVulkanPresentQueue()) );
 }
 
 //--------------------------------------------------------------------------------------
\ No newline at end of file
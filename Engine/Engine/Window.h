@@ -10,10 +10,14 @@
 //======================================================================================
 #include "Common.h"
 #include "Platform.h"
+#include "Span.h"
 
+#include <mutex>
 #include <vector>
 
+class PresentThread;
 class Renderer;
+struct PresentTiming;
 //======================================================================================
 // WINDOW CLASS
 //======================================================================================
@@ -28,11 +32,15 @@ public:
 	bool Update();
 
 	void BeginRender();
-	void EndRender( std::vector<VkSemaphore> waitSemaphores );
+	void EndRender( Span<const VkSemaphore> waitSemaphores );
 
 	VkRenderPass	GetVulkanRenderPass() const				{ return mRenderPass; }
 	VkFramebuffer	GetVulkanActiveFrameBuffer() const		{ return mFrameBuffers[mActiveSwapchainImageID]; }
 	VkExtent2D		GetVulkanSurfaceSize() const			{ return{ mSurfaceWidth, mSurfaceHeight }; }
+	VkSemaphore		GetVulkanRenderCompleteSemaphore() const	{ return mRenderCompleteSemaphores[mActiveSwapchainImageID]; }
+
+	// Timings of finished presents, oldest first. Always false without the present thread.
+	bool PopPresentTiming( PresentTiming& timing );
 
 private:
 	NONCOPYABLE(Window);
@@ -64,6 +72,9 @@ private:
 	void InitSynchronizations();
 	void TerminateSynchronizations();
 
+	void InitPresentThread();
+	void TerminatePresentThread();
+
 private:
 	
 	Renderer* mRenderer = nullptr;
@@ -79,6 +90,11 @@ private:
 	uint32_t mActiveSwapchainImageID = UINT32_MAX;
 
 	VkFence mSwapchainImageAvailable = VK_NULL_HANDLE;
+	std::vector<VkSemaphore> mRenderCompleteSemaphores;
+
+	PresentThread* mPresentThread = nullptr;
+	std::mutex mSwapchainMutex;
+	u64 mFrameID = 0;
 
 	std::vector<VkImage> mSwapchainImages;
 	std::vector<VkImageView> mSwapchainImageViews;
@@ -0,0 +1,263 @@
+//======================================================================================
+// Filename: AllocationTests.cpp
+// Description: Counts global heap allocations across steady state frames, only built
+//				into the allocation tracking variant which replaces operator new. That
+//				variant is built with _DEBUG, so the frames LOG and a frame that
+//				allocates fails FrameAllocationCheck's ASSERT.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "AllocationTracking.h"
+#include "Bvh.h"
+#include "Culling.h"
+#include "DrawKey.h"
+#include "EngineMath.h"
+#include "EntityWorld.h"
+#include "FrameAllocator.h"
+#include "JobSystem.h"
+#include "RadixSort.h"
+
+#include <vector>
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr size_t kObjectCount = 20000;
+constexpr size_t kEntityCount = 20000;
+constexpr size_t kFrameAllocatorSize = 1024 * 1024;
+
+// The first frames grow the persistent containers to their working size
+constexpr u32 kWarmupFrames = 4;
+constexpr u32 kFrameCount = 64;
+constexpr u32 kLogInterval = 16;
+
+constexpr f32 kSceneHalfSize = 500.0f;
+constexpr f32 kNearZ = 0.1f;
+constexpr f32 kFarZ = 1000.0f;
+constexpr f32 kDeltaTime = 1.0f / 60.0f;
+constexpr u32 kMeshCount = 1024;
+
+//======================================================================================
+// Types
+//======================================================================================
+
+struct Position
+{
+	Vector3 value;
+};
+
+struct Velocity
+{
+	Vector3 value;
+};
+
+//--------------------------------------------------------------------------------------
+
+// Everything a frame touches that outlives it
+struct FrameState
+{
+	std::vector<f32>		x, y, z, radius;
+	std::vector<BvhBounds>	bounds;
+	Frustum					frustum;
+	Bvh						bvh;
+	EntityWorld				world;
+	JobSystem				jobSystem;
+	FrameAllocator			frameAllocator{ kFrameAllocatorSize };
+	RadixSorter				sorter{ &frameAllocator };
+};
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+void InitFrameState(FrameState& state)
+{
+	for (size_t i = 0; i < kObjectCount; ++i)
+	{
+		const Vector3 center(RandomFloat(-kSceneHalfSize, kSceneHalfSize), RandomFloat(-kSceneHalfSize, kSceneHalfSize), RandomFloat(-kSceneHalfSize, kSceneHalfSize));
+		const f32 radius = RandomFloat(0.5f, 10.0f);
+		state.x.push_back(center.x);
+		state.y.push_back(center.y);
+		state.z.push_back(center.z);
+		state.radius.push_back(radius);
+
+		BvhBounds bounds;
+		bounds.min = center - Vector3(radius, radius, radius);
+		bounds.max = center + Vector3(radius, radius, radius);
+		state.bounds.push_back(bounds);
+	}
+	state.bvh.Build(state.bounds);
+
+	for (size_t i = 0; i < kEntityCount; ++i)
+	{
+		const Position position = { Vector3(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f)) };
+		const Velocity velocity = { Vector3(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f)) };
+		state.world.CreateEntity(position, velocity);
+	}
+
+	//Right handed perspective to [0, 1] depth, 90 degree field of view
+	const Matrix projection
+	(
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, kFarZ / (kNearZ - kFarZ), (kNearZ * kFarZ) / (kNearZ - kFarZ),
+		0.0f, 0.0f, -1.0f, 0.0f
+	);
+	state.frustum = Frustum::FromMatrix(projection);
+}
+
+//--------------------------------------------------------------------------------------
+
+// The CPU side of a frame, as far as it builds without Vulkan. Scratch whose size
+// depends on the frame comes from the frame allocator.
+void RunFrame(FrameState& state)
+{
+	state.frameAllocator.Reset();
+
+	state.world.ForEach<Position, const Velocity>(state.jobSystem, [](Position& position, const Velocity& velocity)
+	{
+		position.value += velocity.value * kDeltaTime;
+	});
+	state.bvh.Refit(state.bounds);
+
+	SphereSoA spheres;
+	spheres.x = state.x.data();
+	spheres.y = state.y.data();
+	spheres.z = state.z.data();
+	spheres.radius = state.radius.data();
+	spheres.count = kObjectCount;
+	const Span<u32> visible = state.frameAllocator.AllocateArray<u32>(kObjectCount);
+	const size_t visibleCount = CullSpheres(state.jobSystem, state.frustum, spheres, visible);
+	DoNotOptimize(state.bvh.QueryFrustum(state.frustum, visible));
+
+	const Span<u64> keys = state.frameAllocator.AllocateArray<u64>(visibleCount);
+	const Span<u32> items = state.frameAllocator.AllocateArray<u32>(visibleCount);
+	for (size_t i = 0; i < visibleCount; ++i)
+	{
+		const u32 object = visible[i];
+		const u32 mesh = object % kMeshCount;
+		keys[i] = MakeDrawKey(mesh % 8, mesh % 256, mesh, -state.z[object] / kFarZ);
+		items[i] = object;
+	}
+	state.sorter.Sort(state.jobSystem, keys, items);
+	DoNotOptimize(items.data);
+}
+
+//--------------------------------------------------------------------------------------
+
+// Counted allocations made by func
+template <typename Func>
+u64 CountAllocations(const Func& func)
+{
+	const u64 allocationsBefore = GetGlobalAllocationCount();
+	func();
+	return GetGlobalAllocationCount() - allocationsBefore;
+}
+
+//======================================================================================
+// Tests
+//======================================================================================
+
+void TestTracking(TestContext& context)
+{
+	context.BeginGroup("Allocation tracking");
+	if (!context.IsEnabled("Allocations"))
+	{
+		return;
+	}
+
+	//Over-aligned types go through the std::align_val_t overloads, sized delete
+	//through the size_t ones. The pointers escape so the pairs aren't elided.
+	context.Check("new and delete", CountAllocations([]()
+	{
+		u64* value = new u64(0);
+		DoNotOptimize(value);
+		delete value;
+	}) == 1);
+	context.Check("new[] and delete[]", CountAllocations([]()
+	{
+		u64* values = new u64[16];
+		DoNotOptimize(values);
+		delete[] values;
+	}) == 1);
+	context.Check("Aligned new, std::vector<BvhNode>", CountAllocations([]()
+	{
+		std::vector<BvhNode> nodes(16);
+		DoNotOptimize(nodes.data());
+	}) == 1);
+	context.Check("Aligned new[] and delete[]", CountAllocations([]()
+	{
+		BvhNode* nodes = new BvhNode[16];
+		DoNotOptimize(nodes);
+		const bool isAligned = (reinterpret_cast<uintptr_t>(nodes) % alignof(BvhNode) == 0);
+		delete[] nodes;
+		ASSERT(isAligned, "[AllocationTests] BvhNode storage is misaligned!");
+	}) == 1);
+
+	//Warm-up frames report what they allocate without failing
+	FrameAllocationCheck check(1);
+	check.BeginFrame();
+	std::vector<u32> grown(16);
+	DoNotOptimize(grown.data());
+	context.Check("FrameAllocationCheck, warm-up frame counted", check.EndFrame() == 1 && check.GetSteadyAllocationCount() == 0);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestSteadyStateFrames(TestContext& context)
+{
+	FrameState state;
+	context.BeginGroup(Name("Allocations, %u frames, %u job workers", kFrameCount, state.jobSystem.GetWorkerCount()));
+	if (!context.IsEnabled("Allocations"))
+	{
+		return;
+	}
+	InitFrameState(state);
+
+	//The same check Application::Run wraps its frames in
+	FrameAllocationCheck check(kWarmupFrames);
+	u64 warmupAllocations = 0;
+	for (u32 frame = 0; frame < kWarmupFrames + kFrameCount; ++frame)
+	{
+		check.BeginFrame();
+		RunFrame(state);
+		if (frame % kLogInterval == 0)
+		{
+			LOG("[AllocationTests] Frame %u, frame allocator high water mark %zu", frame, state.frameAllocator.GetHighWaterMark());
+		}
+		const u64 allocations = check.EndFrame();
+		warmupAllocations += (frame < kWarmupFrames) ? allocations : 0;
+	}
+
+	context.ReportRate("Heap allocations during warm-up", static_cast<f64>(warmupAllocations), "");
+	context.ReportRate("Heap allocations after warm-up", static_cast<f64>(check.GetSteadyAllocationCount()), "");
+	context.ReportRate("Frame allocator high water mark", static_cast<f64>(state.frameAllocator.GetHighWaterMark()), "bytes");
+	context.Check("No heap allocations after warm-up", check.GetSteadyAllocationCount() == 0);
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunAllocationTests(TestContext& context)
+{
+	TestTracking(context);
+	TestSteadyStateFrames(context);
+}
+
+} // namespace Tests
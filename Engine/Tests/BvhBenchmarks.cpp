@@ -0,0 +1,291 @@
+//======================================================================================
+// Filename: BvhBenchmarks.cpp
+// Description: Bvh build and refit times, and its frustum and ray queries against
+//				testing every object.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "Bvh.h"
+#include "Culling.h"
+#include "EngineMath.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr size_t kObjectCounts[] = { 100000, 1000000 };
+
+// Boxes a few units across in a cube 1000 units across, seen by a camera at the
+// origin that looks down -z with a 60 degree field of view and a 250 unit far plane
+constexpr f32 kSceneHalfSize = 500.0f;
+constexpr f32 kNearZ = 0.1f;
+constexpr f32 kFarZ = 250.0f;
+constexpr f32 kFocal = 1.7320508f;
+
+// Rays start inside the scene in random directions. Brute force tests every box per
+// ray, so it gets fewer of them.
+constexpr size_t kRayCount = 4096;
+constexpr size_t kBruteForceRayCount = 32;
+
+// The partial refit moves every kRefitStride-th box
+constexpr u32 kRefitStride = 100;
+
+//======================================================================================
+// Scene
+//======================================================================================
+
+struct Scene
+{
+	std::vector<BvhBounds> bounds;
+	std::vector<f32> minX, minY, minZ, maxX, maxY, maxZ;
+
+	AABBSoA Boxes(size_t count) const
+	{
+		AABBSoA boxes;
+		boxes.minX = minX.data();
+		boxes.minY = minY.data();
+		boxes.minZ = minZ.data();
+		boxes.maxX = maxX.data();
+		boxes.maxY = maxY.data();
+		boxes.maxZ = maxZ.data();
+		boxes.count = count;
+		return boxes;
+	}
+};
+
+//--------------------------------------------------------------------------------------
+
+Vector3 RandomPoint()
+{
+	return Vector3(RandomFloat(-kSceneHalfSize, kSceneHalfSize), RandomFloat(-kSceneHalfSize, kSceneHalfSize), RandomFloat(-kSceneHalfSize, kSceneHalfSize));
+}
+
+//--------------------------------------------------------------------------------------
+
+Scene MakeScene(size_t count)
+{
+	Scene scene;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Vector3 center = RandomPoint();
+		const Vector3 extent(RandomFloat(0.25f, 2.5f), RandomFloat(0.25f, 2.5f), RandomFloat(0.25f, 2.5f));
+		BvhBounds bounds;
+		bounds.min = center - extent;
+		bounds.max = center + extent;
+		scene.bounds.push_back(bounds);
+		scene.minX.push_back(bounds.min.x);
+		scene.minY.push_back(bounds.min.y);
+		scene.minZ.push_back(bounds.min.z);
+		scene.maxX.push_back(bounds.max.x);
+		scene.maxY.push_back(bounds.max.y);
+		scene.maxZ.push_back(bounds.max.z);
+	}
+	return scene;
+}
+
+//--------------------------------------------------------------------------------------
+
+Frustum MakeFrustum()
+{
+	//Right handed perspective to [0, 1] depth
+	const Matrix projection
+	(
+		kFocal, 0.0f, 0.0f, 0.0f,
+		0.0f, kFocal, 0.0f, 0.0f,
+		0.0f, 0.0f, kFarZ / (kNearZ - kFarZ), (kNearZ * kFarZ) / (kNearZ - kFarZ),
+		0.0f, 0.0f, -1.0f, 0.0f
+	);
+	return Frustum::FromMatrix(projection);
+}
+
+//--------------------------------------------------------------------------------------
+
+std::vector<BvhRay> MakeRays()
+{
+	std::vector<BvhRay> rays(kRayCount);
+	for (BvhRay& ray : rays)
+	{
+		ray.origin = RandomPoint();
+		ray.direction = Normalize(Vector3(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f)));
+	}
+	return rays;
+}
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+// The first count indices of visible, sorted, since the queries write them in no
+// particular order
+std::vector<u32> SortedIndices(const std::vector<u32>& visible, size_t count)
+{
+	std::vector<u32> indices(visible.begin(), visible.begin() + count);
+	std::sort(indices.begin(), indices.end());
+	return indices;
+}
+
+//======================================================================================
+// Brute Force
+//======================================================================================
+
+// The nearest box the ray enters, with the slab test Bvh uses
+BvhHit RayCastBruteForce(const BvhRay& ray, Span<const BvhBounds> bounds)
+{
+	const Vector3 invDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+	BvhHit hit;
+	hit.t = ray.tMax;
+	for (size_t i = 0; i < bounds.size; ++i)
+	{
+		const BvhBounds& box = bounds.data[i];
+		const f32 t0x = (box.min.x - ray.origin.x) * invDirection.x;
+		const f32 t1x = (box.max.x - ray.origin.x) * invDirection.x;
+		const f32 t0y = (box.min.y - ray.origin.y) * invDirection.y;
+		const f32 t1y = (box.max.y - ray.origin.y) * invDirection.y;
+		const f32 t0z = (box.min.z - ray.origin.z) * invDirection.z;
+		const f32 t1z = (box.max.z - ray.origin.z) * invDirection.z;
+
+		const f32 enter = Max(Max(Min(t0x, t1x), Min(t0y, t1y)), Max(Min(t0z, t1z), 0.0f));
+		const f32 exit = Min(Min(Max(t0x, t1x), Max(t0y, t1y)), Min(Max(t0z, t1z), hit.t));
+		if (enter <= exit && enter < hit.t)
+		{
+			hit.t = enter;
+			hit.primitive = static_cast<u32>(i);
+		}
+	}
+	if (hit.primitive == kBvhInvalid)
+	{
+		hit.t = F32_MAX;
+	}
+	return hit;
+}
+
+//======================================================================================
+// Benchmarks
+//======================================================================================
+
+void BenchmarkBvh(TestContext& context)
+{
+	const Scene scene = MakeScene(kObjectCounts[1]);
+	const Frustum frustum = MakeFrustum();
+	const std::vector<BvhRay> rays = MakeRays();
+	std::vector<u32> visible(kObjectCounts[1]);
+	std::vector<BvhHit> hits(kRayCount);
+	std::vector<BvhHit> bruteForceHits(kBruteForceRayCount);
+	JobSystem jobSystem;
+
+	for (const size_t count : kObjectCounts)
+	{
+		context.BeginGroup(Name("Bvh, %zu objects, %u job workers", count, jobSystem.GetWorkerCount()));
+		const Span<const BvhBounds> bounds(scene.bounds.data(), count);
+		const f64 objectScale = 1.0 / static_cast<f64>(count);
+
+		Bvh bvh;
+		if (context.IsEnabled("Build"))
+		{
+			const f64 buildNs = MeasureNs(1, [&](size_t) { bvh.Build(bounds); });
+			context.ReportTiming("Build", buildNs * objectScale);
+			context.ReportRate("Build, whole tree", buildNs * 1e-6, "ms");
+			const f64 refitNs = MeasureNs(1, [&](size_t) { bvh.Refit(bounds); });
+			context.ReportTiming("Refit", refitNs * objectScale);
+			context.ReportRate("Refit, whole tree", refitNs * 1e-6, "ms");
+		}
+		else
+		{
+			bvh.Build(bounds);
+		}
+
+		if (context.IsEnabled("Frustum"))
+		{
+			size_t bvhCount = 0;
+			size_t bruteForceCount = 0;
+			const AABBSoA boxes = scene.Boxes(count);
+			const f64 bvhNs = MeasureNs(1, [&](size_t) { bvhCount = bvh.QueryFrustum(frustum, Span<u32>(visible.data(), count)); });
+			const std::vector<u32> bvhVisible = SortedIndices(visible, bvhCount);
+			const f64 bruteForceNs = MeasureNs(1, [&](size_t) { bruteForceCount = CullAABBs(frustum, boxes, Span<u32>(visible.data(), count)); });
+			context.ReportRate("Frustum, visible objects", static_cast<f64>(bvhCount), "");
+			context.ReportRate("Frustum, Bvh::QueryFrustum", bvhNs * 1e-6, "ms");
+			context.ReportRate("Frustum, CullAABBs on every object", bruteForceNs * 1e-6, "ms");
+			context.ReportRate("Frustum, speedup", bruteForceNs / bvhNs, "x");
+			context.Check("Frustum, same visible objects", bvhVisible == SortedIndices(visible, bruteForceCount));
+		}
+
+		if (context.IsEnabled("Refit"))
+		{
+			//Moves a few boxes anywhere in the scene and refits only those, in a tree of
+			//its own so the ray casts below still see the original boxes
+			std::vector<BvhBounds> moved(bounds.begin(), bounds.end());
+			std::vector<u32> changed;
+			for (u32 i = 0; i < count; i += kRefitStride)
+			{
+				const Vector3 extent = (moved[i].max - moved[i].min) * 0.5f;
+				const Vector3 center = RandomPoint();
+				moved[i].min = center - extent;
+				moved[i].max = center + extent;
+				changed.push_back(i);
+			}
+
+			Bvh refitted;
+			refitted.Build(bounds);
+			const f64 refitNs = MeasureNs(1, [&](size_t) { refitted.Refit(moved, changed); });
+			context.ReportRate("Refit, 1% changed", refitNs * 1e-6, "ms");
+
+			//A tree built over the moved boxes has to see the same objects
+			Bvh rebuilt;
+			rebuilt.Build(moved);
+			const size_t refittedCount = refitted.QueryFrustum(frustum, Span<u32>(visible.data(), count));
+			const std::vector<u32> refittedVisible = SortedIndices(visible, refittedCount);
+			const size_t rebuiltCount = rebuilt.QueryFrustum(frustum, Span<u32>(visible.data(), count));
+			context.Check("Refit, 1% changed, same objects as Build", refittedVisible == SortedIndices(visible, rebuiltCount));
+		}
+
+		if (context.IsEnabled("RayCast"))
+		{
+			const Span<const BvhRay> rayInput(rays.data(), kRayCount);
+			const f64 bvhNs = MeasureNs(1, [&](size_t) { bvh.RayCast(rayInput, Span<BvhHit>(hits.data(), kRayCount)); }) / static_cast<f64>(kRayCount);
+			const f64 jobNs = MeasureNs(1, [&](size_t) { bvh.RayCast(jobSystem, rayInput, Span<BvhHit>(hits.data(), kRayCount)); }) / static_cast<f64>(kRayCount);
+			const f64 bruteForceNs = MeasureNs(kBruteForceRayCount, [&](size_t i) { bruteForceHits[i] = RayCastBruteForce(rays[i], bounds); });
+			context.ReportTiming("RayCast, Bvh::RayCast", bvhNs);
+			context.ReportRate("RayCast, Bvh::RayCast, throughput", 1e3 / bvhNs, "M rays/s");
+			context.ReportTiming("RayCast, Bvh::RayCast on the job system", jobNs);
+			context.ReportTiming("RayCast, every object", bruteForceNs);
+			context.ReportRate("RayCast, speedup", bruteForceNs / bvhNs, "x");
+
+			//Boxes can overlap, so compare the distances rather than which one was hit
+			bool sameHits = true;
+			for (size_t i = 0; i < kBruteForceRayCount; ++i)
+			{
+				sameHits = sameHits && (hits[i].t == bruteForceHits[i].t);
+			}
+			context.Check("RayCast, same nearest hits", sameHits);
+		}
+	}
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunBvhBenchmarks(TestContext& context)
+{
+	BenchmarkBvh(context);
+}
+
+} // namespace Tests
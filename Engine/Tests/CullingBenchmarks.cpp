@@ -0,0 +1,203 @@
+//======================================================================================
+// Filename: CullingBenchmarks.cpp
+// Description: Objects culled per millisecond by Culling.h against testing each one
+//				with Frustum, on one thread and spread across the job system.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "Culling.h"
+#include "EngineMath.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr size_t kObjectCounts[] = { 100000, 1000000 };
+
+// Objects fill a cube around a camera at the origin that looks down -z with a 90
+// degree field of view, about a sixth of them are visible
+constexpr f32 kSceneHalfSize = 500.0f;
+constexpr f32 kNearZ = 0.1f;
+constexpr f32 kFarZ = 1000.0f;
+
+//======================================================================================
+// Scene
+//======================================================================================
+
+struct Scene
+{
+	std::vector<f32> x, y, z, radius;
+	std::vector<f32> minX, minY, minZ, maxX, maxY, maxZ;
+
+	SphereSoA Spheres(size_t count) const
+	{
+		SphereSoA spheres;
+		spheres.x = x.data();
+		spheres.y = y.data();
+		spheres.z = z.data();
+		spheres.radius = radius.data();
+		spheres.count = count;
+		return spheres;
+	}
+
+	AABBSoA Boxes(size_t count) const
+	{
+		AABBSoA boxes;
+		boxes.minX = minX.data();
+		boxes.minY = minY.data();
+		boxes.minZ = minZ.data();
+		boxes.maxX = maxX.data();
+		boxes.maxY = maxY.data();
+		boxes.maxZ = maxZ.data();
+		boxes.count = count;
+		return boxes;
+	}
+};
+
+//--------------------------------------------------------------------------------------
+
+Scene MakeScene(size_t count)
+{
+	Scene scene;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const f32 x = RandomFloat(-kSceneHalfSize, kSceneHalfSize);
+		const f32 y = RandomFloat(-kSceneHalfSize, kSceneHalfSize);
+		const f32 z = RandomFloat(-kSceneHalfSize, kSceneHalfSize);
+		const f32 radius = RandomFloat(0.5f, 10.0f);
+		scene.x.push_back(x);
+		scene.y.push_back(y);
+		scene.z.push_back(z);
+		scene.radius.push_back(radius);
+
+		//The box the sphere fits in
+		scene.minX.push_back(x - radius);
+		scene.minY.push_back(y - radius);
+		scene.minZ.push_back(z - radius);
+		scene.maxX.push_back(x + radius);
+		scene.maxY.push_back(y + radius);
+		scene.maxZ.push_back(z + radius);
+	}
+	return scene;
+}
+
+//--------------------------------------------------------------------------------------
+
+Frustum MakeFrustum()
+{
+	//Right handed perspective to [0, 1] depth
+	const Matrix projection
+	(
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, kFarZ / (kNearZ - kFarZ), (kNearZ * kFarZ) / (kNearZ - kFarZ),
+		0.0f, 0.0f, -1.0f, 0.0f
+	);
+	return Frustum::FromMatrix(projection);
+}
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+// One culling pass over count objects into output, timed. Reports ns per object and
+// objects per millisecond, and returns the indices the last pass found visible, sorted
+// since the job system versions write them in any order.
+template <typename Cull>
+std::vector<u32> ReportCull(TestContext& context, const char* name, size_t count, Span<u32> output, const Cull& cull)
+{
+	size_t visibleCount = 0;
+	const f64 nsPerObject = MeasureNs(1, [&](size_t) { visibleCount = cull(); DoNotOptimize(visibleCount); }) / static_cast<f64>(count);
+	context.ReportTiming(name, nsPerObject);
+	context.ReportRate(Name("%s, throughput", name), 1e6 / nsPerObject, "objects/ms");
+
+	std::vector<u32> visible(output.data, output.data + visibleCount);
+	std::sort(visible.begin(), visible.end());
+	return visible;
+}
+
+//======================================================================================
+// Benchmarks
+//======================================================================================
+
+void BenchmarkCulling(TestContext& context)
+{
+	const Scene scene = MakeScene(kObjectCounts[1]);
+	const Frustum frustum = MakeFrustum();
+	std::vector<u32> visible(kObjectCounts[1]);
+	JobSystem jobSystem;
+
+	for (const size_t count : kObjectCounts)
+	{
+		context.BeginGroup(Name("Culling, %zu objects, %u job workers", count, jobSystem.GetWorkerCount()));
+		const Span<u32> output(visible.data(), count);
+
+		if (context.IsEnabled("Spheres"))
+		{
+			const SphereSoA spheres = scene.Spheres(count);
+			const std::vector<u32> frustumVisible = ReportCull(context, "Spheres, Frustum::TestSphere each", count, output, [&]()
+			{
+				size_t visibleCount = 0;
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (frustum.TestSphere(Vector3(scene.x[i], scene.y[i], scene.z[i]), scene.radius[i]))
+					{
+						output[visibleCount++] = static_cast<u32>(i);
+					}
+				}
+				return visibleCount;
+			});
+			const std::vector<u32> cullVisible = ReportCull(context, "Spheres, CullSpheres", count, output, [&]() { return CullSpheres(frustum, spheres, output); });
+			const std::vector<u32> jobVisible = ReportCull(context, "Spheres, CullSpheres on the job system", count, output, [&]() { return CullSpheres(jobSystem, frustum, spheres, output); });
+			context.Check("Spheres, same visible objects", (frustumVisible == cullVisible) && (cullVisible == jobVisible));
+		}
+		if (context.IsEnabled("AABBs"))
+		{
+			const AABBSoA boxes = scene.Boxes(count);
+			const std::vector<u32> frustumVisible = ReportCull(context, "AABBs, Frustum::TestAABB each", count, output, [&]()
+			{
+				size_t visibleCount = 0;
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (frustum.TestAABB(Vector3(scene.minX[i], scene.minY[i], scene.minZ[i]), Vector3(scene.maxX[i], scene.maxY[i], scene.maxZ[i])))
+					{
+						output[visibleCount++] = static_cast<u32>(i);
+					}
+				}
+				return visibleCount;
+			});
+			const std::vector<u32> cullVisible = ReportCull(context, "AABBs, CullAABBs", count, output, [&]() { return CullAABBs(frustum, boxes, output); });
+			const std::vector<u32> jobVisible = ReportCull(context, "AABBs, CullAABBs on the job system", count, output, [&]() { return CullAABBs(jobSystem, frustum, boxes, output); });
+			context.Check("AABBs, same visible objects", (frustumVisible == cullVisible) && (cullVisible == jobVisible));
+		}
+	}
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunCullingBenchmarks(TestContext& context)
+{
+	BenchmarkCulling(context);
+}
+
+} // namespace Tests
@@ -0,0 +1,205 @@
+//======================================================================================
+// Filename: EntityBenchmarks.cpp
+// Description: EntityWorld iteration over 1M entities against the same update on an
+//				array of game objects.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "EngineMath.h"
+#include "EntityWorld.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr size_t kEntityCount = 1000000;
+constexpr f32 kDeltaTime = 1.0f / 60.0f;
+
+//======================================================================================
+// Types
+//======================================================================================
+
+struct Position
+{
+	Vector3 value;
+};
+
+struct Velocity
+{
+	Vector3 value;
+};
+
+struct Health
+{
+	f32 value;
+};
+
+struct WorldTransform
+{
+	Matrix34 value;
+};
+
+//--------------------------------------------------------------------------------------
+
+// The baseline, every entity as one object holding all of its state whether a given
+// update reads it or not
+struct GameObject
+{
+	Vector3		position;
+	Vector3		velocity;
+	f32			health = 0.0f;
+	Matrix34	world;
+	const char*	name = nullptr;
+	u32			flags = 0;
+};
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+f64 SumPositions(const std::vector<GameObject>& objects)
+{
+	f64 sum = 0.0;
+	for (const GameObject& object : objects)
+	{
+		sum += static_cast<f64>(object.position.x) + object.position.y + object.position.z;
+	}
+	return sum;
+}
+
+//--------------------------------------------------------------------------------------
+
+f64 SumPositions(const EntityWorld& world)
+{
+	f64 sum = 0.0;
+	world.ForEach<const Position>([&sum](const Position& position)
+	{
+		sum += static_cast<f64>(position.value.x) + position.value.y + position.value.z;
+	});
+	return sum;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Times one update over every entity, reporting ns per entity, throughput and the
+// speedup over baselineNs if there is one
+template <typename Update>
+f64 ReportUpdate(TestContext& context, const char* name, f64 baselineNs, const Update& update)
+{
+	const f64 ns = MeasureNs(1, [&](size_t) { update(); }) / static_cast<f64>(kEntityCount);
+	context.ReportTiming(name, ns);
+	context.ReportRate(Name("%s, throughput", name), 1e3 / ns, "M entities/s per core");
+	if (baselineNs > 0.0)
+	{
+		context.ReportRate(Name("%s, speedup", name), baselineNs / ns, "x");
+	}
+	return ns;
+}
+
+//======================================================================================
+// Benchmarks
+//======================================================================================
+
+void BenchmarkEntityIteration(TestContext& context)
+{
+	JobSystem jobSystem;
+	context.BeginGroup(Name("EntityWorld, %zu moving entities, %u job workers", kEntityCount, jobSystem.GetWorkerCount()));
+	if (!context.IsEnabled("EntityWorld"))
+	{
+		return;
+	}
+
+	//Every entity moves, only some have the other components, which spreads them over
+	//4 archetypes
+	std::vector<GameObject> objects(kEntityCount);
+	EntityWorld world;
+	for (size_t i = 0; i < kEntityCount; ++i)
+	{
+		GameObject& object = objects[i];
+		object.position = Vector3(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f));
+		object.velocity = Vector3(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f));
+		object.health = 100.0f;
+
+		const Position position = { object.position };
+		const Velocity velocity = { object.velocity };
+		switch (i % 4)
+		{
+		case 0:		world.CreateEntity(position, velocity);															break;
+		case 1:		world.CreateEntity(position, velocity, Health{ object.health });								break;
+		case 2:		world.CreateEntity(position, velocity, WorldTransform{ object.world });							break;
+		default:	world.CreateEntity(position, velocity, Health{ object.health }, WorldTransform{ object.world });	break;
+		}
+	}
+
+	//Objects allocated one at a time and visited in an order unrelated to where they
+	//live, as they end up after a while of spawning and despawning
+	std::vector<std::unique_ptr<GameObject>> heapObjects;
+	heapObjects.reserve(kEntityCount);
+	for (const GameObject& object : objects)
+	{
+		heapObjects.push_back(std::make_unique<GameObject>(object));
+	}
+	std::shuffle(heapObjects.begin(), heapObjects.end(), GetRandom());
+
+	const auto updateObjects = [&]()
+	{
+		for (GameObject& object : objects)
+		{
+			object.position += object.velocity * kDeltaTime;
+		}
+	};
+	const auto updateHeapObjects = [&]()
+	{
+		for (const std::unique_ptr<GameObject>& object : heapObjects)
+		{
+			object->position += object->velocity * kDeltaTime;
+		}
+	};
+	const auto update = [](Position& position, const Velocity& velocity)
+	{
+		position.value += velocity.value * kDeltaTime;
+	};
+
+	//Every update is position += velocity * dt. One step of each from the same start
+	//has to land in the same place.
+	updateObjects();
+	world.ForEach<Position, const Velocity>(update);
+	const f64 objectSum = SumPositions(objects);
+	context.Check("ForEach, same result as the objects", std::abs(SumPositions(world) - objectSum) <= 1e-9 * std::abs(objectSum) + 1e-3);
+
+	const f64 baselineNs = ReportUpdate(context, "std::vector<GameObject>", 0.0, updateObjects);
+	ReportUpdate(context, "Shuffled GameObject pointers", baselineNs, updateHeapObjects);
+	ReportUpdate(context, "ForEach", baselineNs, [&]() { world.ForEach<Position, const Velocity>(update); });
+	ReportUpdate(context, "ForEach on the job system", baselineNs, [&]() { world.ForEach<Position, const Velocity>(jobSystem, update); });
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunEntityBenchmarks(TestContext& context)
+{
+	BenchmarkEntityIteration(context);
+}
+
+} // namespace Tests
@@ -0,0 +1,710 @@
+//======================================================================================
+// Filename: GpuCullTests.cpp
+// Description: Drives GpuDrawCuller headless on whatever Vulkan device there is, e.g.
+//				lavapipe, through each of its draw paths and checks the objects
+//				RecordDraw draws are the ones CullSpheres keeps, before and after
+//				objects move. Only built when CMake finds Vulkan and glslangValidator.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "Culling.h"
+#include "DeletionQueue.h"
+#include "EngineMath.h"
+#include "GpuDrawCuller.h"
+#include "GpuRingBuffer.h"
+#include "GpuTimeline.h"
+#include "SyncObjectPool.h"
+#include "VulkanExtensions.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// kGpuDrawCullSpirv and kGpuDrawCountSpirv, GpuDrawCull.comp and GpuDrawCount.vert
+// compiled by the build
+#include "GpuDrawCull.spv.h"
+#include "GpuDrawCount.spv.h"
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+// The per object paths record a draw call each, this keeps them quick on a CPU device
+constexpr u32 kObjectCount = 20000;
+constexpr u32 kEmptySlotInterval = 16;	// Every 16th object has no draw
+constexpr u32 kIndexCount = 36;
+
+// Same scene as the culling benchmarks, about a sixth of it is visible
+constexpr f32 kSceneHalfSize = 500.0f;
+constexpr f32 kNearZ = 0.1f;
+constexpr f32 kFarZ = 1000.0f;
+
+// Moved between frames: one run that goes up as a single copy region and scattered
+// objects that go up one region each
+constexpr u32 kMovedRunBegin = 1000;
+constexpr u32 kMovedRunLength = 2000;
+constexpr u32 kMovedInterval = 97;
+
+// The first frame uploads every object
+constexpr u32 kRingFrameCount = 2;
+constexpr VkDeviceSize kRingFrameSize = kObjectCount * sizeof(GpuCullObject);
+
+constexpr u32 kNoObjectIndex = ~0u;		// GpuDrawCount.vert falls back to gl_InstanceIndex
+
+//======================================================================================
+// Types
+//======================================================================================
+
+struct HostBuffer
+{
+	VkBuffer		buffer = VK_NULL_HANDLE;
+	VkDeviceMemory	memory = VK_NULL_HANDLE;
+	void*			data = nullptr;
+};
+
+//--------------------------------------------------------------------------------------
+
+// A device with one graphics and compute queue and the pipeline GpuDrawCount.vert
+// counts the draws with, nothing to present to
+struct HeadlessDevice
+{
+	VkInstance							instance = VK_NULL_HANDLE;
+	VkPhysicalDevice					physicalDevice = VK_NULL_HANDLE;
+	VkPhysicalDeviceProperties			properties = {};
+	VkPhysicalDeviceMemoryProperties	memoryProperties = {};
+	VkPhysicalDeviceFeatures			enabledFeatures = {};
+	bool								isDrawIndirectCountSupported = false;
+	VkDevice							device = VK_NULL_HANDLE;
+	VkQueue								queue = VK_NULL_HANDLE;
+	std::mutex							queueMutex;
+	VkCommandPool						commandPool = VK_NULL_HANDLE;
+	VkCommandBuffer						commandBuffer = VK_NULL_HANDLE;
+
+	HostBuffer							counts;		// Vertices drawn per object
+	HostBuffer							indices;	// Every object's indices are all 0
+
+	VkDescriptorSetLayout				descriptorSetLayout = VK_NULL_HANDLE;
+	VkDescriptorPool					descriptorPool = VK_NULL_HANDLE;
+	VkDescriptorSet						descriptorSet = VK_NULL_HANDLE;
+	VkPipelineLayout					pipelineLayout = VK_NULL_HANDLE;
+	VkRenderPass						renderPass = VK_NULL_HANDLE;
+	VkFramebuffer						framebuffer = VK_NULL_HANDLE;
+	VkPipeline							pipeline = VK_NULL_HANDLE;
+
+	~HeadlessDevice();
+};
+
+//--------------------------------------------------------------------------------------
+
+// The engine objects GpuDrawCuller and GpuRingBuffer run on, as the Renderer sets them
+// up but on the fence fallback so no extension is needed
+struct FrameResources
+{
+	explicit FrameResources(HeadlessDevice& device);
+
+	SyncObjectPool	syncObjectPool;
+	GpuTimeline		timeline;
+	DeletionQueue	deletionQueue;
+	GpuRingBuffer	ring;
+};
+
+//--------------------------------------------------------------------------------------
+
+struct Scene
+{
+	std::vector<f32>			x, y, z, radius;
+	std::vector<GpuCullObject>	objects;
+};
+
+//--------------------------------------------------------------------------------------
+
+// The features each GpuDrawCuller draw path is picked by
+struct DrawPath
+{
+	const char*	name;
+	bool		isCompacting;		// One vkCmdDrawIndexedIndirectCount
+	bool		isMultiDraw;		// One vkCmdDrawIndexedIndirect over every slot
+	bool		isFirstInstance;	// The object index goes through firstInstance, not a push
+};
+
+constexpr DrawPath kDrawPaths[] =
+{
+	{ "Compacted",				true,	true,	true },
+	{ "Multi draw",				false,	true,	true },
+	{ "Draw per object",		false,	false,	true },
+	{ "Pushed object index",	false,	false,	false },
+};
+
+//======================================================================================
+// Headless Vulkan
+//======================================================================================
+
+HeadlessDevice::~HeadlessDevice()
+{
+	if (VK_NULL_HANDLE != device)
+	{
+		vkDeviceWaitIdle(device);
+		vkDestroyPipeline(device, pipeline, nullptr);
+		vkDestroyFramebuffer(device, framebuffer, nullptr);
+		vkDestroyRenderPass(device, renderPass, nullptr);
+		vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+		vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+		vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+		for (HostBuffer* hostBuffer : { &counts, &indices })
+		{
+			vkDestroyBuffer(device, hostBuffer->buffer, nullptr);
+			vkFreeMemory(device, hostBuffer->memory, nullptr);
+		}
+		vkDestroyCommandPool(device, commandPool, nullptr);
+		vkDestroyDevice(device, nullptr);
+	}
+	if (VK_NULL_HANDLE != instance)
+	{
+		vkDestroyInstance(instance, nullptr);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+FrameResources::FrameResources(HeadlessDevice& device)
+	: syncObjectPool( device.device )
+	, timeline( device.device, device.queue, &device.queueMutex, &syncObjectPool, false )
+	, deletionQueue( device.device )
+	, ring( device.device, device.properties, device.memoryProperties, &timeline, kRingFrameSize, kRingFrameCount, VK_BUFFER_USAGE_TRANSFER_SRC_BIT )
+{
+}
+
+//--------------------------------------------------------------------------------------
+
+// False when there is no loader, or no device with a graphics and compute queue that
+// can store from the vertex stage
+bool CreateDevice(HeadlessDevice& device)
+{
+	VkApplicationInfo applicationInfo = {};
+	applicationInfo.sType				= VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	applicationInfo.pApplicationName	= "EngineTests";
+	applicationInfo.apiVersion			= VK_API_VERSION_1_0;
+
+	VkInstanceCreateInfo instanceCreateInfo = {};
+	instanceCreateInfo.sType			= VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	instanceCreateInfo.pApplicationInfo	= &applicationInfo;
+	if (vkCreateInstance(&instanceCreateInfo, nullptr, &device.instance) != VK_SUCCESS)
+	{
+		return false;
+	}
+
+	uint32_t deviceCount = 0;
+	vkEnumeratePhysicalDevices(device.instance, &deviceCount, nullptr);
+	std::vector<VkPhysicalDevice> physicalDevices(deviceCount);
+	vkEnumeratePhysicalDevices(device.instance, &deviceCount, physicalDevices.data());
+
+	const VkQueueFlags queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+	uint32_t queueFamily = U32_MAX;
+	VkPhysicalDeviceFeatures supportedFeatures = {};
+	for (uint32_t i = 0; i < deviceCount && U32_MAX == queueFamily; ++i)
+	{
+		vkGetPhysicalDeviceFeatures(physicalDevices[i], &supportedFeatures);
+		if (supportedFeatures.vertexPipelineStoresAndAtomics != VK_TRUE)
+		{
+			continue;
+		}
+
+		uint32_t familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[i], &familyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[i], &familyCount, families.data());
+		for (uint32_t family = 0; family < familyCount; ++family)
+		{
+			if ((families[family].queueFlags & queueFlags) == queueFlags)
+			{
+				device.physicalDevice = physicalDevices[i];
+				queueFamily = family;
+				break;
+			}
+		}
+	}
+	if (U32_MAX == queueFamily)
+	{
+		return false;
+	}
+	vkGetPhysicalDeviceProperties(device.physicalDevice, &device.properties);
+	vkGetPhysicalDeviceMemoryProperties(device.physicalDevice, &device.memoryProperties);
+
+	//Everything GpuDrawCuller picks its path by, each path is then tested with the
+	//features it needs turned off again
+	device.enabledFeatures.vertexPipelineStoresAndAtomics	= VK_TRUE;
+	device.enabledFeatures.multiDrawIndirect				= supportedFeatures.multiDrawIndirect;
+	device.enabledFeatures.drawIndirectFirstInstance		= supportedFeatures.drawIndirectFirstInstance;
+
+	std::vector<const char*> extensions;
+	if (IsDeviceExtensionAvailable(device.physicalDevice, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+	{
+		extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+	}
+
+	const float queuePriority = 1.0f;
+	VkDeviceQueueCreateInfo queueCreateInfo = {};
+	queueCreateInfo.sType				= VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queueCreateInfo.queueFamilyIndex	= queueFamily;
+	queueCreateInfo.queueCount			= 1;
+	queueCreateInfo.pQueuePriorities	= &queuePriority;
+
+	VkDeviceCreateInfo deviceCreateInfo = {};
+	deviceCreateInfo.sType					= VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceCreateInfo.queueCreateInfoCount	= 1;
+	deviceCreateInfo.pQueueCreateInfos		= &queueCreateInfo;
+	deviceCreateInfo.enabledExtensionCount	= static_cast<uint32_t>(extensions.size());
+	deviceCreateInfo.ppEnabledExtensionNames	= extensions.data();
+	deviceCreateInfo.pEnabledFeatures		= &device.enabledFeatures;
+	if (vkCreateDevice(device.physicalDevice, &deviceCreateInfo, nullptr, &device.device) != VK_SUCCESS)
+	{
+		return false;
+	}
+	vkGetDeviceQueue(device.device, queueFamily, 0, &device.queue);
+
+	//As the Renderer decides it
+	LoadDeviceExtensionFunctions(device.device, Span<const char* const>(extensions));
+	device.isDrawIndirectCountSupported = !extensions.empty() && (nullptr != fvkCmdDrawIndexedIndirectCountKHR);
+
+	VkCommandPoolCreateInfo poolCreateInfo = {};
+	poolCreateInfo.sType			= VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolCreateInfo.flags			= VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	poolCreateInfo.queueFamilyIndex	= queueFamily;
+	vkCreateCommandPool(device.device, &poolCreateInfo, nullptr, &device.commandPool);
+
+	VkCommandBufferAllocateInfo bufferAllocateInfo = {};
+	bufferAllocateInfo.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	bufferAllocateInfo.commandPool			= device.commandPool;
+	bufferAllocateInfo.level				= VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	bufferAllocateInfo.commandBufferCount	= 1;
+	return vkAllocateCommandBuffers(device.device, &bufferAllocateInfo, &device.commandBuffer) == VK_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Host visible and mapped, so the test reads the results without a staging copy
+bool CreateHostBuffer(HeadlessDevice& device, VkDeviceSize size, VkBufferUsageFlags usage, HostBuffer& hostBuffer)
+{
+	VkBufferCreateInfo bufferCreateInfo = {};
+	bufferCreateInfo.sType			= VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.size			= size;
+	bufferCreateInfo.usage			= usage;
+	bufferCreateInfo.sharingMode	= VK_SHARING_MODE_EXCLUSIVE;
+	if (vkCreateBuffer(device.device, &bufferCreateInfo, nullptr, &hostBuffer.buffer) != VK_SUCCESS)
+	{
+		return false;
+	}
+
+	VkMemoryRequirements memoryRequirements = {};
+	vkGetBufferMemoryRequirements(device.device, hostBuffer.buffer, &memoryRequirements);
+	const VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	uint32_t memoryType = U32_MAX;
+	for (uint32_t i = 0; i < device.memoryProperties.memoryTypeCount && U32_MAX == memoryType; ++i)
+	{
+		if ((memoryRequirements.memoryTypeBits & (1u << i)) != 0 && (device.memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+		{
+			memoryType = i;
+		}
+	}
+	if (U32_MAX == memoryType)
+	{
+		return false;
+	}
+
+	VkMemoryAllocateInfo memoryAllocateInfo = {};
+	memoryAllocateInfo.sType			= VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memoryAllocateInfo.allocationSize	= memoryRequirements.size;
+	memoryAllocateInfo.memoryTypeIndex	= memoryType;
+	return (vkAllocateMemory(device.device, &memoryAllocateInfo, nullptr, &hostBuffer.memory) == VK_SUCCESS)
+		&& (vkBindBufferMemory(device.device, hostBuffer.buffer, hostBuffer.memory, 0) == VK_SUCCESS)
+		&& (vkMapMemory(device.device, hostBuffer.memory, 0, VK_WHOLE_SIZE, 0, &hostBuffer.data) == VK_SUCCESS);
+}
+
+//--------------------------------------------------------------------------------------
+
+// GpuDrawCount.vert with rasterization discarded, in a render pass with no
+// attachments. Its push constant range is the one RecordDraw pushes the index into.
+bool CreateDrawPipeline(HeadlessDevice& device)
+{
+	if (!CreateHostBuffer(device, kObjectCount * sizeof(u32), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, device.counts)
+		|| !CreateHostBuffer(device, (kObjectCount + kIndexCount) * sizeof(u32), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, device.indices))
+	{
+		return false;
+	}
+	memset(device.indices.data, 0, (kObjectCount + kIndexCount) * sizeof(u32));
+
+	VkDescriptorSetLayoutBinding binding = {};
+	binding.binding			= 0;
+	binding.descriptorType	= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	binding.descriptorCount	= 1;
+	binding.stageFlags		= VK_SHADER_STAGE_VERTEX_BIT;
+
+	VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo = {};
+	setLayoutCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	setLayoutCreateInfo.bindingCount	= 1;
+	setLayoutCreateInfo.pBindings		= &binding;
+	vkCreateDescriptorSetLayout(device.device, &setLayoutCreateInfo, nullptr, &device.descriptorSetLayout);
+
+	VkDescriptorPoolSize poolSize = {};
+	poolSize.type				= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	poolSize.descriptorCount	= 1;
+
+	VkDescriptorPoolCreateInfo poolCreateInfo = {};
+	poolCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolCreateInfo.maxSets			= 1;
+	poolCreateInfo.poolSizeCount	= 1;
+	poolCreateInfo.pPoolSizes		= &poolSize;
+	vkCreateDescriptorPool(device.device, &poolCreateInfo, nullptr, &device.descriptorPool);
+
+	VkDescriptorSetAllocateInfo setAllocateInfo = {};
+	setAllocateInfo.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	setAllocateInfo.descriptorPool		= device.descriptorPool;
+	setAllocateInfo.descriptorSetCount	= 1;
+	setAllocateInfo.pSetLayouts			= &device.descriptorSetLayout;
+	vkAllocateDescriptorSets(device.device, &setAllocateInfo, &device.descriptorSet);
+
+	VkDescriptorBufferInfo bufferInfo = {};
+	bufferInfo.buffer	= device.counts.buffer;
+	bufferInfo.range	= VK_WHOLE_SIZE;
+
+	VkWriteDescriptorSet write = {};
+	write.sType				= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet			= device.descriptorSet;
+	write.dstBinding		= 0;
+	write.descriptorCount	= 1;
+	write.descriptorType	= VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	write.pBufferInfo		= &bufferInfo;
+	vkUpdateDescriptorSets(device.device, 1, &write, 0, nullptr);
+
+	VkPushConstantRange pushConstantRange = {};
+	pushConstantRange.stageFlags	= VK_SHADER_STAGE_VERTEX_BIT;
+	pushConstantRange.size			= sizeof(u32);
+
+	VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+	pipelineLayoutCreateInfo.sType					= VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutCreateInfo.setLayoutCount			= 1;
+	pipelineLayoutCreateInfo.pSetLayouts			= &device.descriptorSetLayout;
+	pipelineLayoutCreateInfo.pushConstantRangeCount	= 1;
+	pipelineLayoutCreateInfo.pPushConstantRanges	= &pushConstantRange;
+	vkCreatePipelineLayout(device.device, &pipelineLayoutCreateInfo, nullptr, &device.pipelineLayout);
+
+	VkSubpassDescription subpass = {};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+	VkRenderPassCreateInfo renderPassCreateInfo = {};
+	renderPassCreateInfo.sType			= VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassCreateInfo.subpassCount	= 1;
+	renderPassCreateInfo.pSubpasses		= &subpass;
+	vkCreateRenderPass(device.device, &renderPassCreateInfo, nullptr, &device.renderPass);
+
+	VkFramebufferCreateInfo framebufferCreateInfo = {};
+	framebufferCreateInfo.sType			= VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferCreateInfo.renderPass	= device.renderPass;
+	framebufferCreateInfo.width			= 1;
+	framebufferCreateInfo.height		= 1;
+	framebufferCreateInfo.layers		= 1;
+	vkCreateFramebuffer(device.device, &framebufferCreateInfo, nullptr, &device.framebuffer);
+
+	VkShaderModuleCreateInfo shaderCreateInfo = {};
+	shaderCreateInfo.sType		= VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	shaderCreateInfo.codeSize	= sizeof(kGpuDrawCountSpirv);
+	shaderCreateInfo.pCode		= kGpuDrawCountSpirv;
+	VkShaderModule shaderModule = VK_NULL_HANDLE;
+	if (vkCreateShaderModule(device.device, &shaderCreateInfo, nullptr, &shaderModule) != VK_SUCCESS)
+	{
+		return false;
+	}
+
+	VkPipelineShaderStageCreateInfo stage = {};
+	stage.sType		= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stage.stage		= VK_SHADER_STAGE_VERTEX_BIT;
+	stage.module	= shaderModule;
+	stage.pName		= "main";
+
+	VkPipelineVertexInputStateCreateInfo vertexInputState = {};
+	vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {};
+	inputAssemblyState.sType	= VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssemblyState.topology	= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+	//Discarded, so no viewport, multisample or blend state is read
+	VkPipelineRasterizationStateCreateInfo rasterizationState = {};
+	rasterizationState.sType					= VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizationState.rasterizerDiscardEnable	= VK_TRUE;
+	rasterizationState.polygonMode				= VK_POLYGON_MODE_FILL;
+	rasterizationState.cullMode					= VK_CULL_MODE_NONE;
+	rasterizationState.lineWidth				= 1.0f;
+
+	VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
+	pipelineCreateInfo.sType				= VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineCreateInfo.stageCount			= 1;
+	pipelineCreateInfo.pStages				= &stage;
+	pipelineCreateInfo.pVertexInputState	= &vertexInputState;
+	pipelineCreateInfo.pInputAssemblyState	= &inputAssemblyState;
+	pipelineCreateInfo.pRasterizationState	= &rasterizationState;
+	pipelineCreateInfo.layout				= device.pipelineLayout;
+	pipelineCreateInfo.renderPass			= device.renderPass;
+	const VkResult result = vkCreateGraphicsPipelines(device.device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &device.pipeline);
+	vkDestroyShaderModule(device.device, shaderModule, nullptr);
+	return result == VK_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+
+// One frame as the engine records it, the cull outside the render pass and the draws
+// inside, waited on. Returns the objects drawn, sorted, or a U32_MAX marker if
+// RecordCull couldn't upload or the submit failed.
+std::vector<u32> DrawFrame(HeadlessDevice& device, FrameResources& frame, GpuDrawCuller& culler, const Frustum& frustum)
+{
+	frame.deletionQueue.Collect();
+	frame.ring.BeginFrame();
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(device.commandBuffer, &beginInfo);
+
+	vkCmdFillBuffer(device.commandBuffer, device.counts.buffer, 0, VK_WHOLE_SIZE, 0);
+	VkMemoryBarrier fillBarrier = {};
+	fillBarrier.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	fillBarrier.srcAccessMask	= VK_ACCESS_TRANSFER_WRITE_BIT;
+	fillBarrier.dstAccessMask	= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(	device.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+							0, 1, &fillBarrier, 0, nullptr, 0, nullptr );
+
+	const bool isUploaded = culler.RecordCull(device.commandBuffer, frame.ring, frustum);
+
+	VkRenderPassBeginInfo renderPassBeginInfo = {};
+	renderPassBeginInfo.sType						= VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.renderPass					= device.renderPass;
+	renderPassBeginInfo.framebuffer					= device.framebuffer;
+	renderPassBeginInfo.renderArea.extent.width		= 1;
+	renderPassBeginInfo.renderArea.extent.height	= 1;
+	vkCmdBeginRenderPass(device.commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	vkCmdBindPipeline(device.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, device.pipeline);
+	vkCmdBindDescriptorSets(device.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, device.pipelineLayout, 0, 1, &device.descriptorSet, 0, nullptr);
+	vkCmdBindIndexBuffer(device.commandBuffer, device.indices.buffer, 0, VK_INDEX_TYPE_UINT32);
+	vkCmdPushConstants(device.commandBuffer, device.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(u32), &kNoObjectIndex);
+	culler.RecordDraw(device.commandBuffer, device.pipelineLayout, 0);
+	vkCmdEndRenderPass(device.commandBuffer);
+
+	VkMemoryBarrier readBarrier = {};
+	readBarrier.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	readBarrier.srcAccessMask	= VK_ACCESS_SHADER_WRITE_BIT;
+	readBarrier.dstAccessMask	= VK_ACCESS_HOST_READ_BIT;
+	vkCmdPipelineBarrier(	device.commandBuffer, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+							0, 1, &readBarrier, 0, nullptr, 0, nullptr );
+	vkEndCommandBuffer(device.commandBuffer);
+
+	frame.ring.Flush();
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType				= VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount	= 1;
+	submitInfo.pCommandBuffers		= &device.commandBuffer;
+	const u64 value = frame.timeline.Submit(submitInfo);
+	frame.ring.EndFrame(value);
+	if (!frame.timeline.Wait(value) || !isUploaded)
+	{
+		return { U32_MAX };
+	}
+
+	std::vector<u32> drawn;
+	const u32* counts = static_cast<const u32*>(device.counts.data);
+	for (u32 object = 0; object < kObjectCount; ++object)
+	{
+		if (counts[object] != 0)
+		{
+			drawn.push_back(object);
+		}
+	}
+	return drawn;
+}
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+void SetRandomObject(Scene& scene, u32 object)
+{
+	scene.x[object] = RandomFloat(-kSceneHalfSize, kSceneHalfSize);
+	scene.y[object] = RandomFloat(-kSceneHalfSize, kSceneHalfSize);
+	scene.z[object] = RandomFloat(-kSceneHalfSize, kSceneHalfSize);
+	scene.radius[object] = RandomFloat(0.5f, 10.0f);
+
+	GpuCullObject& cullObject = scene.objects[object];
+	cullObject.sphere = Vector4(scene.x[object], scene.y[object], scene.z[object], scene.radius[object]);
+	cullObject.indexCount = (object % kEmptySlotInterval == 0) ? 0 : kIndexCount;
+	cullObject.firstIndex = object;
+}
+
+//--------------------------------------------------------------------------------------
+
+Scene MakeScene()
+{
+	Scene scene;
+	scene.x.resize(kObjectCount);
+	scene.y.resize(kObjectCount);
+	scene.z.resize(kObjectCount);
+	scene.radius.resize(kObjectCount);
+	scene.objects.resize(kObjectCount);
+	for (u32 object = 0; object < kObjectCount; ++object)
+	{
+		SetRandomObject(scene, object);
+	}
+	return scene;
+}
+
+//--------------------------------------------------------------------------------------
+
+// What the culler should draw: what CullSpheres keeps, less the empty slots and those
+// past objectCount
+std::vector<u32> CullReference(const Scene& scene, const Frustum& frustum, u32 objectCount)
+{
+	SphereSoA spheres;
+	spheres.x = scene.x.data();
+	spheres.y = scene.y.data();
+	spheres.z = scene.z.data();
+	spheres.radius = scene.radius.data();
+	spheres.count = objectCount;
+
+	std::vector<u32> visible(objectCount);
+	visible.resize(CullSpheres(frustum, spheres, visible));
+	visible.erase(std::remove_if(visible.begin(), visible.end(), [](u32 object) { return object % kEmptySlotInterval == 0; }), visible.end());
+	return visible;
+}
+
+//======================================================================================
+// Tests
+//======================================================================================
+
+void TestDrawPath(TestContext& context, HeadlessDevice& device, FrameResources& frame, const Frustum& frustum, const DrawPath& path)
+{
+	const VkPhysicalDeviceFeatures& features = device.enabledFeatures;
+	const bool isSupported = (!path.isCompacting || device.isDrawIndirectCountSupported)
+		&& (!path.isMultiDraw || features.multiDrawIndirect == VK_TRUE)
+		&& (!path.isFirstInstance || features.drawIndirectFirstInstance == VK_TRUE);
+	if (!isSupported)
+	{
+		context.ReportRate(Name("%s, skipped, device lacks it", path.name), 0.0, "");
+		return;
+	}
+
+	//The Renderer's device with only this path's features left on
+	GpuDrawCullerDevice cullerDevice;
+	cullerDevice.device									= device.device;
+	cullerDevice.memoryProperties						= &device.memoryProperties;
+	cullerDevice.enabledFeatures						= features;
+	cullerDevice.enabledFeatures.multiDrawIndirect		= path.isMultiDraw ? VK_TRUE : VK_FALSE;
+	cullerDevice.enabledFeatures.drawIndirectFirstInstance	= path.isFirstInstance ? VK_TRUE : VK_FALSE;
+	cullerDevice.isDrawIndirectCountSupported			= path.isCompacting;
+	cullerDevice.deletionQueue							= &frame.deletionQueue;
+	cullerDevice.timeline								= &frame.timeline;
+
+	GpuDrawCuller culler(cullerDevice, kObjectCount, Span<const u32>(kGpuDrawCullSpirv));
+	context.Check(Name("%s, path picked", path.name), culler.IsCompacting() == path.isCompacting && culler.IsPushingObjectIndex() == !path.isFirstInstance);
+
+	//First frame uploads every object
+	Scene scene = MakeScene();
+	culler.SetObjectCount(kObjectCount);
+	for (u32 object = 0; object < kObjectCount; ++object)
+	{
+		culler.SetObject(object, scene.objects[object]);
+	}
+	const std::vector<u32> firstVisible = CullReference(scene, frustum, kObjectCount);
+	const std::vector<u32> firstDrawn = DrawFrame(device, frame, culler, frustum);
+	context.Check(Name("%s, same objects", path.name), firstDrawn == firstVisible);
+
+	//Nothing changed, nothing is uploaded and the same objects are drawn
+	context.Check(Name("%s, unchanged, same objects", path.name), DrawFrame(device, frame, culler, frustum) == firstVisible);
+
+	//A run of neighbours and scattered objects move, only those go up
+	for (u32 object = kMovedRunBegin; object < kMovedRunBegin + kMovedRunLength; ++object)
+	{
+		SetRandomObject(scene, object);
+		culler.SetObject(object, scene.objects[object]);
+	}
+	for (u32 object = 0; object < kObjectCount; object += kMovedInterval)
+	{
+		SetRandomObject(scene, object);
+		culler.SetObject(object, scene.objects[object]);
+	}
+	const std::vector<u32> movedVisible = CullReference(scene, frustum, kObjectCount);
+	context.Check(Name("%s, moved, same objects", path.name), DrawFrame(device, frame, culler, frustum) == movedVisible);
+
+	//Objects past the count are neither culled nor drawn
+	culler.SetObjectCount(kObjectCount / 2);
+	const std::vector<u32> halfVisible = CullReference(scene, frustum, kObjectCount / 2);
+	context.Check(Name("%s, half the count, same objects", path.name), DrawFrame(device, frame, culler, frustum) == halfVisible);
+	context.ReportRate(Name("%s, drawn objects", path.name), static_cast<f64>(firstDrawn.size()), "");
+}
+
+//--------------------------------------------------------------------------------------
+
+bool TestGpuCull(TestContext& context)
+{
+	HeadlessDevice device;
+	if (!CreateDevice(device))
+	{
+		return false;
+	}
+
+	context.BeginGroup(Name("GpuDrawCuller, %u objects, %.24s", kObjectCount, device.properties.deviceName));
+	if (!context.IsEnabled("GpuDrawCull"))
+	{
+		return true;
+	}
+
+	const bool isCreated = CreateDrawPipeline(device);
+	context.Check("Draw counting pipeline created", isCreated);
+	if (!isCreated)
+	{
+		return true;
+	}
+
+	//Right handed perspective to [0, 1] depth, 90 degree field of view
+	const Matrix projection
+	(
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, kFarZ / (kNearZ - kFarZ), (kNearZ * kFarZ) / (kNearZ - kFarZ),
+		0.0f, 0.0f, -1.0f, 0.0f
+	);
+	const Frustum frustum = Frustum::FromMatrix(projection);
+
+	//Each path's culler is freed through the deletion queue, as in the engine
+	FrameResources frame(device);
+	for (const DrawPath& path : kDrawPaths)
+	{
+		TestDrawPath(context, device, frame, frustum, path);
+	}
+	return true;
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+bool RunGpuCullTests(TestContext& context)
+{
+	return TestGpuCull(context);
+}
+
+} // namespace Tests
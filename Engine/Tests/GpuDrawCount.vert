@@ -0,0 +1,26 @@
+//======================================================================================
+// Filename: GpuDrawCount.vert
+// Description: Counts the vertices drawn for each object, so GpuCullTests can read
+//				back what GpuDrawCuller::RecordDraw drew. Drawn with rasterization
+//				discarded, there is nothing to shade.
+//======================================================================================
+#version 450
+
+// GpuDrawCuller pushes the object index when it can't pass it as firstInstance, the
+// test pushes ~0 first so the other paths fall back to gl_InstanceIndex
+layout(push_constant) uniform Constants
+{
+	uint	objectIndex;
+} constants;
+
+layout(std430, binding = 0) buffer Counts
+{
+	uint	counts[];
+};
+
+void main()
+{
+	const uint object = (constants.objectIndex != ~0u) ? constants.objectIndex : uint(gl_InstanceIndex);
+	atomicAdd(counts[object], 1u);
+	gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+}
@@ -0,0 +1,432 @@
+//======================================================================================
+// Filename: MathBenchmarks.cpp
+// Description: Throughput of the math paths over data sets far larger than the cache,
+//				against the code they replaced. MathTests.cpp covers their accuracy.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "MathReference.h"
+
+#include "MathBatch.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+// Streamed from memory, and a set small enough to stay in L1/L2 that is looped over
+// until the run has done millions of them too
+constexpr size_t kMatrixCount = 1 << 20;
+constexpr size_t kCachedMatrixCount = 256;
+
+// 1024 points in and out fit in L1 in either layout
+constexpr size_t kPointCount = 1 << 20;
+constexpr size_t kCachedPointCount = 1024;
+
+constexpr size_t kValueCount = 1 << 20;
+constexpr size_t kCachedValueCount = 4096;
+
+constexpr size_t kAngleCount = 1 << 20;
+
+// A Matrix34d in and a Matrix34 out is 144 bytes an object
+constexpr size_t kObjectCount = 1 << 20;
+constexpr size_t kCachedObjectCount = 256;
+
+//======================================================================================
+// Scalar Code
+//======================================================================================
+
+// The scalar fallbacks of Matrix::operator*, Transpose and Inverse, kept here so the
+// SIMD variants can be timed against them in the same binary
+Matrix ScalarMultiply(const Matrix& a, const Matrix& b)
+{
+	return Matrix
+	(
+		(a._11 * b._11 + a._12 * b._21 + a._13 * b._31 + a._14 * b._41),
+		(a._11 * b._12 + a._12 * b._22 + a._13 * b._32 + a._14 * b._42),
+		(a._11 * b._13 + a._12 * b._23 + a._13 * b._33 + a._14 * b._43),
+		(a._11 * b._14 + a._12 * b._24 + a._13 * b._34 + a._14 * b._44),
+
+		(a._21 * b._11 + a._22 * b._21 + a._23 * b._31 + a._24 * b._41),
+		(a._21 * b._12 + a._22 * b._22 + a._23 * b._32 + a._24 * b._42),
+		(a._21 * b._13 + a._22 * b._23 + a._23 * b._33 + a._24 * b._43),
+		(a._21 * b._14 + a._22 * b._24 + a._23 * b._34 + a._24 * b._44),
+
+		(a._31 * b._11 + a._32 * b._21 + a._33 * b._31 + a._34 * b._41),
+		(a._31 * b._12 + a._32 * b._22 + a._33 * b._32 + a._34 * b._42),
+		(a._31 * b._13 + a._32 * b._23 + a._33 * b._33 + a._34 * b._43),
+		(a._31 * b._14 + a._32 * b._24 + a._33 * b._34 + a._34 * b._44),
+
+		(a._41 * b._11 + a._42 * b._21 + a._43 * b._31 + a._44 * b._41),
+		(a._41 * b._12 + a._42 * b._22 + a._43 * b._32 + a._44 * b._42),
+		(a._41 * b._13 + a._42 * b._23 + a._43 * b._33 + a._44 * b._43),
+		(a._41 * b._14 + a._42 * b._24 + a._43 * b._34 + a._44 * b._44)
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+Matrix ScalarTranspose(const Matrix& m)
+{
+	return Matrix
+	(
+		m._11, m._21, m._31, m._41,
+		m._12, m._22, m._32, m._42,
+		m._13, m._23, m._33, m._43,
+		m._14, m._24, m._34, m._44
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+Matrix ScalarInverse(const Matrix& m)
+{
+	return Adjoint(m) * (1.0f / Determinant(m));
+}
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+// Largest difference between two results in ulps of their largest element
+f64 MaxUlpDifference(const std::vector<Matrix>& a, const std::vector<Matrix>& b, size_t count)
+{
+	ErrorStats difference({ 0.0, 0.0 });
+	for (size_t i = 0; i < count; ++i)
+	{
+		difference.Add(ToValues(a[i]), ToValues(b[i]));
+	}
+	return difference.maxUlp;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Times the engine function and the scalar code over the first count matrices, and
+// checks they agree
+template <typename Engine, typename Scalar>
+void CompareWithScalar(TestContext& context, const char* name, size_t count, f64 maxUlp, const Engine& engine, const Scalar& scalar)
+{
+	if (!context.IsEnabled(name))
+	{
+		return;
+	}
+
+	std::vector<Matrix> engineResult(count);
+	std::vector<Matrix> scalarResult(count);
+	const f64 engineNs = MeasureNs(count, [&](size_t i) { engineResult[i] = engine(i); });
+	const f64 scalarNs = MeasureNs(count, [&](size_t i) { scalarResult[i] = scalar(i); });
+
+	context.ReportTiming(name, engineNs);
+	context.ReportTiming(Name("%s, scalar code", name), scalarNs);
+	context.ReportRate(Name("%s, speedup", name), scalarNs / engineNs, "x");
+	context.ReportRate(Name("%s, throughput", name), 1e3 / engineNs, "M matrices/s");
+	context.Check(Name("%s, matches scalar code", name), MaxUlpDifference(engineResult, scalarResult, count) <= maxUlp);
+}
+
+//======================================================================================
+// Benchmarks
+//======================================================================================
+
+void BenchmarkMatrix(TestContext& context)
+{
+	//Well conditioned, inverses included
+	std::vector<Matrix> a(kMatrixCount);
+	std::vector<Matrix> b(kMatrixCount);
+	for (size_t i = 0; i < kMatrixCount; ++i)
+	{
+		const Vector3 scale(RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f));
+		const Quaternion rotation = Normalize(Quaternion(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), 1.0f));
+		const Vector3 translation(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f));
+		a[i] = Matrix34::Compose(translation, rotation, scale).ToMatrix();
+		b[i] = Transpose(a[i]);
+	}
+
+	for (const size_t count : { kMatrixCount, kCachedMatrixCount })
+	{
+		context.BeginGroup(Name("Matrix, %zu matrices %s", count, (count == kMatrixCount) ? "streamed" : "in cache"));
+		CompareWithScalar(context, "Matrix * Matrix", count, 16.0,
+			[&](size_t i) { return a[i] * b[i]; },
+			[&](size_t i) { return ScalarMultiply(a[i], b[i]); });
+		CompareWithScalar(context, "Transpose(Matrix)", count, 0.0,
+			[&](size_t i) { return Transpose(a[i]); },
+			[&](size_t i) { return ScalarTranspose(a[i]); });
+		CompareWithScalar(context, "Inverse(Matrix)", count, 64.0,
+			[&](size_t i) { return Inverse(a[i]); },
+			[&](size_t i) { return ScalarInverse(a[i]); });
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+// One thread, so the rates are per core, unit is e.g. "M points/s per core"
+void ReportPerItem(TestContext& context, const char* name, f64 nsPerItem, const char* unit)
+{
+	context.ReportTiming(name, nsPerItem);
+	context.ReportRate(Name("%s, throughput", name), 1e3 / nsPerItem, unit);
+}
+
+//--------------------------------------------------------------------------------------
+
+void ReportPerPoint(TestContext& context, const char* name, f64 nsPerPoint)
+{
+	ReportPerItem(context, name, nsPerPoint, "M points/s per core");
+}
+
+//--------------------------------------------------------------------------------------
+
+void BenchmarkTransforms(TestContext& context)
+{
+	std::vector<Vector3> points(kPointCount);
+	std::vector<f32> x(kPointCount), y(kPointCount), z(kPointCount);
+	std::vector<f32> xOut(kPointCount), yOut(kPointCount), zOut(kPointCount);
+	for (size_t i = 0; i < kPointCount; ++i)
+	{
+		points[i] = Vector3(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f));
+		x[i] = points[i].x;
+		y[i] = points[i].y;
+		z[i] = points[i].z;
+	}
+	std::vector<Vector3> out(kPointCount);
+	const Matrix m = Matrix34::Compose(Vector3(1.0f, 2.0f, 3.0f), Normalize(Quaternion(0.1f, 0.2f, 0.3f, 1.0f)), Vector3(2.0f, 2.0f, 2.0f)).ToMatrix();
+
+	for (const size_t count : { kPointCount, kCachedPointCount })
+	{
+		context.BeginGroup(Name("Transforms, %zu points %s", count, (count == kPointCount) ? "streamed" : "in cache"));
+		const Span<const Vector3> input(points.data(), count);
+		const Span<Vector3> output(out.data(), count);
+		const Vector3SoA soa(x.data(), y.data(), z.data(), count);
+		const Vector3SoA soaOut(xOut.data(), yOut.data(), zOut.data(), count);
+		const f64 countScale = 1.0 / static_cast<f64>(count);
+
+		if (context.IsEnabled("TransformCoord"))
+		{
+			ReportPerPoint(context, "TransformCoord, one point per call",
+				MeasureNs(count, [&](size_t i) { out[i] = TransformCoord(points[i], m); }));
+			ReportPerPoint(context, "TransformCoord(Span<Vector3>)",
+				MeasureNs(1, [&](size_t) { TransformCoord(input, m, output); }) * countScale);
+			ReportPerPoint(context, "TransformCoord(Vector3SoA)",
+				MeasureNs(1, [&](size_t) { TransformCoord(soa, m, soaOut); }) * countScale);
+		}
+		if (context.IsEnabled("TransformNormal"))
+		{
+			ReportPerPoint(context, "TransformNormal, one point per call",
+				MeasureNs(count, [&](size_t i) { out[i] = TransformNormal(points[i], m); }));
+			ReportPerPoint(context, "TransformNormal(Span<Vector3>)",
+				MeasureNs(1, [&](size_t) { TransformNormal(input, m, output); }) * countScale);
+			ReportPerPoint(context, "TransformNormal(Vector3SoA)",
+				MeasureNs(1, [&](size_t) { TransformNormal(soa, m, soaOut); }) * countScale);
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+// Error of out against sqrt, or 1/sqrt if inverse, of the first count values
+ErrorStats SqrtError(const Limit& limit, const std::vector<f32>& values, const std::vector<f32>& out, size_t count, bool inverse)
+{
+	ErrorStats error(limit);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Real root = std::sqrt(Real(values[i]));
+		error.Add(ToValues(out[i]), Values<1>{ inverse ? (1.0L / root) : root });
+	}
+	return error;
+}
+
+//--------------------------------------------------------------------------------------
+
+void BenchmarkSqrt(TestContext& context)
+{
+	std::vector<f32> values(kValueCount);
+	for (f32& value : values)
+	{
+		value = RandomLogFloat(1e-4f, 1e4f);
+	}
+	std::vector<f32> out(kValueCount);
+
+	for (const size_t count : { kValueCount, kCachedValueCount })
+	{
+		context.BeginGroup(Name("Sqrt, %zu values %s", count, (count == kValueCount) ? "streamed" : "in cache"));
+		const Span<const f32> input(values.data(), count);
+		const Span<f32> output(out.data(), count);
+		const f64 countScale = 1.0 / static_cast<f64>(count);
+
+		for (const bool inverse : { false, true })
+		{
+			const char* function = inverse ? "RSqrt" : "Sqrt";
+			if (!context.IsEnabled(function))
+			{
+				continue;
+			}
+
+			//Each tier against Exact, the first in kPrecisions
+			f64 exactNs = 0.0;
+			f64 exactBatchNs = 0.0;
+			for (const Precision precision : kPrecisions)
+			{
+				const Limit limit = inverse ? PrecisionLimit(precision, 1.5, 0.0) : PrecisionLimit(precision, 0.5, 1.0);
+				const char* tier = PrecisionName(precision);
+
+				//Picked outside the timed loops so they only call the one function
+				const f64 ns = inverse
+					? MeasureNs(count, [&](size_t i) { out[i] = RSqrt(values[i], precision); })
+					: MeasureNs(count, [&](size_t i) { out[i] = Sqrt(values[i], precision); });
+				context.Report(Name("%s %s", function, tier), ns, SqrtError(limit, values, out, count, inverse));
+
+				const f64 batchNs = countScale * (inverse
+					? MeasureNs(1, [&](size_t) { RSqrt(input, output, precision); })
+					: MeasureNs(1, [&](size_t) { Sqrt(input, output, precision); }));
+				context.Report(Name("%s(Span) %s", function, tier), batchNs, SqrtError(limit, values, out, count, inverse));
+
+				if (precision == Precision::Exact)
+				{
+					exactNs = ns;
+					exactBatchNs = batchNs;
+					continue;
+				}
+				context.ReportRate(Name("%s %s, speedup over Exact", function, tier), exactNs / ns, "x");
+				context.ReportRate(Name("%s(Span) %s, speedup over Exact", function, tier), exactBatchNs / batchNs, "x");
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+// Adds the error of out against sin, or cos if cosine, of every angle
+void AddAngleError(ErrorStats& error, const std::vector<f32>& angles, const std::vector<f32>& out, bool cosine)
+{
+	for (size_t i = 0; i < angles.size(); ++i)
+	{
+		const Real angle = angles[i];
+		error.Add(ToValues(out[i]), Values<1>{ cosine ? std::cos(angle) : std::sin(angle) });
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void BenchmarkSinCos(TestContext& context)
+{
+	context.BeginGroup(Name("SinCos, %zu angles in [-8 pi, 8 pi]", kAngleCount));
+
+	std::vector<f32> angles(kAngleCount);
+	for (f32& angle : angles)
+	{
+		angle = RandomFloat(-kTwoPi * 4.0f, kTwoPi * 4.0f);
+	}
+	std::vector<f32> sinOut(kAngleCount);
+	std::vector<f32> cosOut(kAngleCount);
+	const f64 countScale = 1.0 / static_cast<f64>(kAngleCount);
+
+	//libm is reported against the same bound, it has no speedup of its own
+	const auto report = [&](const char* name, f64 ns, bool sine, bool cosine, f64 libmNs)
+	{
+		ErrorStats error({ 0.0, kSinCosAbsError });
+		if (sine)
+		{
+			AddAngleError(error, angles, sinOut, false);
+		}
+		if (cosine)
+		{
+			AddAngleError(error, angles, cosOut, true);
+		}
+		context.Report(name, ns, error);
+		if (libmNs > 0.0)
+		{
+			context.ReportRate(Name("%s, speedup over libm", name), libmNs / ns, "x");
+		}
+	};
+
+	if (context.IsEnabled("SinCos"))
+	{
+		const f64 libmNs = MeasureNs(kAngleCount, [&](size_t i) { sinOut[i] = std::sin(angles[i]); cosOut[i] = std::cos(angles[i]); });
+		report("std::sin + std::cos", libmNs, true, true, 0.0);
+		report("SinCos", MeasureNs(kAngleCount, [&](size_t i) { SinCos(angles[i], sinOut[i], cosOut[i]); }), true, true, libmNs);
+		report("SinCos(Span)", MeasureNs(1, [&](size_t) { SinCos(angles, sinOut, cosOut); }) * countScale, true, true, libmNs);
+	}
+	if (context.IsEnabled("Sin"))
+	{
+		const f64 libmNs = MeasureNs(kAngleCount, [&](size_t i) { sinOut[i] = std::sin(angles[i]); });
+		report("std::sin", libmNs, true, false, 0.0);
+		report("Sin", MeasureNs(kAngleCount, [&](size_t i) { sinOut[i] = Sin(angles[i]); }), true, false, libmNs);
+		report("Sin(Span)", MeasureNs(1, [&](size_t) { Sin(angles, sinOut); }) * countScale, true, false, libmNs);
+	}
+	if (context.IsEnabled("Cos"))
+	{
+		const f64 libmNs = MeasureNs(kAngleCount, [&](size_t i) { cosOut[i] = std::cos(angles[i]); });
+		report("std::cos", libmNs, false, true, 0.0);
+		report("Cos", MeasureNs(kAngleCount, [&](size_t i) { cosOut[i] = Cos(angles[i]); }), false, true, libmNs);
+		report("Cos(Span)", MeasureNs(1, [&](size_t) { Cos(angles, cosOut); }) * countScale, false, true, libmNs);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void BenchmarkCameraRelative(TestContext& context)
+{
+	//A world 10,000 km across, with the camera somewhere inside it
+	const auto randomPosition = []() { return Vector3d(RandomFloat(-1e7f, 1e7f), RandomFloat(-1e7f, 1e7f), RandomFloat(-1e7f, 1e7f)); };
+	std::vector<Matrix34d> world(kObjectCount);
+	std::vector<Vector3d> positions(kObjectCount);
+	for (size_t i = 0; i < kObjectCount; ++i)
+	{
+		const Quaternion rotation = Normalize(Quaternion(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), 1.0f));
+		positions[i] = randomPosition();
+		world[i] = Matrix34d::Compose(positions[i], rotation, Vector3(1.0f, 1.0f, 1.0f));
+	}
+	const Vector3d camera = randomPosition();
+	std::vector<Matrix34> matrixOut(kObjectCount);
+	std::vector<Vector3> positionOut(kObjectCount);
+
+	for (const size_t count : { kObjectCount, kCachedObjectCount })
+	{
+		context.BeginGroup(Name("Camera relative, %zu objects %s", count, (count == kObjectCount) ? "streamed" : "in cache"));
+		const Span<const Matrix34d> matrices(world.data(), count);
+		const Span<const Vector3d> points(positions.data(), count);
+		const f64 countScale = 1.0 / static_cast<f64>(count);
+
+		if (context.IsEnabled("ToCameraRelative(Matrix34d)"))
+		{
+			ReportPerItem(context, "ToCameraRelative(Matrix34d), one object per call",
+				MeasureNs(count, [&](size_t i) { matrixOut[i] = ToCameraRelative(world[i], camera); }), "M objects/s per core");
+			ReportPerItem(context, "ToCameraRelative(Span<Matrix34d>)",
+				MeasureNs(1, [&](size_t) { ToCameraRelative(matrices, camera, Span<Matrix34>(matrixOut.data(), count)); }) * countScale, "M objects/s per core");
+		}
+		if (context.IsEnabled("ToCameraRelative(Vector3d)"))
+		{
+			ReportPerItem(context, "ToCameraRelative(Vector3d), one object per call",
+				MeasureNs(count, [&](size_t i) { positionOut[i] = ToCameraRelative(positions[i], camera); }), "M objects/s per core");
+			ReportPerItem(context, "ToCameraRelative(Span<Vector3d>)",
+				MeasureNs(1, [&](size_t) { ToCameraRelative(points, camera, Span<Vector3>(positionOut.data(), count)); }) * countScale, "M objects/s per core");
+		}
+	}
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunMathBenchmarks(TestContext& context)
+{
+	BenchmarkMatrix(context);
+	BenchmarkTransforms(context);
+	BenchmarkSqrt(context);
+	BenchmarkSinCos(context);
+	BenchmarkCameraRelative(context);
+}
+
+} // namespace Tests
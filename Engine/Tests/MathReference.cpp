@@ -0,0 +1,423 @@
+//======================================================================================
+// Filename: MathReference.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "MathReference.h"
+
+#include <cmath>
+#include <utility>
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+#if MATH_SIMD_SSE4
+constexpr f64 kHighRelativeError	= 3e-7;
+constexpr f64 kLowRelativeError		= 5e-7;
+#else
+constexpr f64 kHighRelativeError	= 5e-6;
+constexpr f64 kLowRelativeError		= 1.8e-3;
+#endif //MATH_SIMD_SSE4
+
+//--------------------------------------------------------------------------------------
+
+// Relative error bounds are at most rel * 2^24 ulps
+Limit Relative(f64 relative, f64 extraUlp)
+{
+	return { (relative * 16777216.0) + extraUlp, 0.0 };
+}
+
+} // namespace
+
+//======================================================================================
+// Reference Types
+//======================================================================================
+
+MatrixR ToReference(const Math::Matrix& m)
+{
+	//Matrix is stored column by column
+	const f32* elements = &m._11;
+	MatrixR result;
+	for (u32 row = 0; row < 4; ++row)
+	{
+		for (u32 column = 0; column < 4; ++column)
+		{
+			result.m[row][column] = elements[column * 4 + row];
+		}
+	}
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+MatrixR ToReference(const Math::Matrix34& m)
+{
+	return ToReference(m.ToMatrix());
+}
+
+//--------------------------------------------------------------------------------------
+
+MatrixR ToReference(const Math::Matrix34d& m)
+{
+	const f64* elements = &m._11;
+	MatrixR result = {};
+	for (u32 row = 0; row < 3; ++row)
+	{
+		for (u32 column = 0; column < 4; ++column)
+		{
+			result.m[row][column] = elements[row * 4 + column];
+		}
+	}
+	result.m[3][3] = 1.0L;
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+QuaternionR ToReference(const Math::Quaternion& q)
+{
+	return { q.x, q.y, q.z, q.w };
+}
+
+//--------------------------------------------------------------------------------------
+
+MatrixR Multiply(const MatrixR& a, const MatrixR& b)
+{
+	MatrixR result = {};
+	for (u32 row = 0; row < 4; ++row)
+	{
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 k = 0; k < 4; ++k)
+			{
+				result.m[row][column] += a.m[row][k] * b.m[k][column];
+			}
+		}
+	}
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+MatrixR Transpose(const MatrixR& m)
+{
+	MatrixR result;
+	for (u32 row = 0; row < 4; ++row)
+	{
+		for (u32 column = 0; column < 4; ++column)
+		{
+			result.m[row][column] = m.m[column][row];
+		}
+	}
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+MatrixR Inverse(const MatrixR& m)
+{
+	//Gauss-Jordan with partial pivoting
+	MatrixR a = m;
+	MatrixR result = {};
+	for (u32 i = 0; i < 4; ++i)
+	{
+		result.m[i][i] = 1.0L;
+	}
+
+	for (u32 column = 0; column < 4; ++column)
+	{
+		u32 pivot = column;
+		for (u32 row = column + 1; row < 4; ++row)
+		{
+			if (std::fabs(a.m[row][column]) > std::fabs(a.m[pivot][column]))
+			{
+				pivot = row;
+			}
+		}
+		std::swap(a.m[pivot], a.m[column]);
+		std::swap(result.m[pivot], result.m[column]);
+
+		const Real scale = 1.0L / a.m[column][column];
+		for (u32 k = 0; k < 4; ++k)
+		{
+			a.m[column][k] *= scale;
+			result.m[column][k] *= scale;
+		}
+		for (u32 row = 0; row < 4; ++row)
+		{
+			if (row == column)
+			{
+				continue;
+			}
+			const Real factor = a.m[row][column];
+			for (u32 k = 0; k < 4; ++k)
+			{
+				a.m[row][k] -= factor * a.m[column][k];
+				result.m[row][k] -= factor * result.m[column][k];
+			}
+		}
+	}
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+Real Determinant(const MatrixR& m)
+{
+	//Elimination with partial pivoting, every row swap flips the sign
+	MatrixR a = m;
+	Real determinant = 1.0L;
+	for (u32 column = 0; column < 4; ++column)
+	{
+		u32 pivot = column;
+		for (u32 row = column + 1; row < 4; ++row)
+		{
+			if (std::fabs(a.m[row][column]) > std::fabs(a.m[pivot][column]))
+			{
+				pivot = row;
+			}
+		}
+		if (pivot != column)
+		{
+			std::swap(a.m[pivot], a.m[column]);
+			determinant = -determinant;
+		}
+		if (a.m[column][column] == 0.0L)
+		{
+			return 0.0L;
+		}
+
+		determinant *= a.m[column][column];
+		for (u32 row = column + 1; row < 4; ++row)
+		{
+			const Real factor = a.m[row][column] / a.m[column][column];
+			for (u32 k = column; k < 4; ++k)
+			{
+				a.m[row][k] -= factor * a.m[column][k];
+			}
+		}
+	}
+	return determinant;
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<4> Transform(const MatrixR& m, Real x, Real y, Real z, Real w)
+{
+	Values<4> result;
+	for (u32 row = 0; row < 4; ++row)
+	{
+		result[row] = (m.m[row][0] * x) + (m.m[row][1] * y) + (m.m[row][2] * z) + (m.m[row][3] * w);
+	}
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+MatrixR RotationQuaternion(const QuaternionR& q)
+{
+	const Real xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+	const Real xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+	const Real wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+	MatrixR result = {};
+	result.m[0][0] = 1.0L - 2.0L * (yy + zz);
+	result.m[0][1] = 2.0L * (xy - wz);
+	result.m[0][2] = 2.0L * (xz + wy);
+	result.m[1][0] = 2.0L * (xy + wz);
+	result.m[1][1] = 1.0L - 2.0L * (xx + zz);
+	result.m[1][2] = 2.0L * (yz - wx);
+	result.m[2][0] = 2.0L * (xz - wy);
+	result.m[2][1] = 2.0L * (yz + wx);
+	result.m[2][2] = 1.0L - 2.0L * (xx + yy);
+	result.m[3][3] = 1.0L;
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+QuaternionR Multiply(const QuaternionR& a, const QuaternionR& b)
+{
+	return
+	{
+		(a.w * b.x) + (a.x * b.w) + (a.y * b.z) - (a.z * b.y),
+		(a.w * b.y) - (a.x * b.z) + (a.y * b.w) + (a.z * b.x),
+		(a.w * b.z) + (a.x * b.y) - (a.y * b.x) + (a.z * b.w),
+		(a.w * b.w) - (a.x * b.x) - (a.y * b.y) - (a.z * b.z)
+	};
+}
+
+//--------------------------------------------------------------------------------------
+
+QuaternionR Normalize(const QuaternionR& q)
+{
+	const Real scale = 1.0L / std::sqrt((q.x * q.x) + (q.y * q.y) + (q.z * q.z) + (q.w * q.w));
+	return { q.x * scale, q.y * scale, q.z * scale, q.w * scale };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<3> Rotate(const QuaternionR& q, Real x, Real y, Real z)
+{
+	//q v q* without assuming q is unit length
+	const QuaternionR v = { x, y, z, 0.0L };
+	const QuaternionR conjugate = { -q.x, -q.y, -q.z, q.w };
+	const QuaternionR rotated = Multiply(Multiply(q, v), conjugate);
+	const Real lengthSqr = (q.x * q.x) + (q.y * q.y) + (q.z * q.z) + (q.w * q.w);
+	return { rotated.x / lengthSqr, rotated.y / lengthSqr, rotated.z / lengthSqr };
+}
+
+//======================================================================================
+// Values
+//======================================================================================
+
+Values<1> ToValues(f32 value)
+{
+	return { value };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<1> ToValues(f64 value)
+{
+	return { value };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<1> ToValues(bool value)
+{
+	return { value ? 1.0L : 0.0L };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<2> ToValues(const Math::Vector2& v)
+{
+	return { v.x, v.y };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<3> ToValues(const Math::Vector3& v)
+{
+	return { v.x, v.y, v.z };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<3> ToValues(const Math::Vector3d& v)
+{
+	return { v.x, v.y, v.z };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<4> ToValues(const Math::Vector4& v)
+{
+	return { v.x, v.y, v.z, v.w };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<4> ToValues(const Math::VecReg& v)
+{
+	return ToValues(v.ToVector4());
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<4> ToValues(const Math::Quaternion& q)
+{
+	return { q.x, q.y, q.z, q.w };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<4> ToValues(const QuaternionR& q)
+{
+	return { q.x, q.y, q.z, q.w };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<16> ToValues(const Math::Matrix& m)
+{
+	return ToValues(ToReference(m));
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<16> ToValues(const MatrixR& m)
+{
+	Values<16> result;
+	for (u32 i = 0; i < 16; ++i)
+	{
+		result[i] = m.m[i / 4][i % 4];
+	}
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<12> ToValues(const Math::Matrix34& m)
+{
+	return ToValues34(ToReference(m));
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<12> ToValues(const Math::Matrix34d& m)
+{
+	return ToValues34(ToReference(m));
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<12> ToValues34(const MatrixR& m)
+{
+	Values<12> result;
+	for (u32 i = 0; i < 12; ++i)
+	{
+		result[i] = m.m[i / 4][i % 4];
+	}
+	return result;
+}
+
+//======================================================================================
+// Precision
+//======================================================================================
+
+const char* PrecisionName(Math::Precision precision)
+{
+	switch (precision)
+	{
+	case Math::Precision::High:	return "High";
+	case Math::Precision::Low:	return "Low";
+	default:					return "Exact";
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+Limit PrecisionLimit(Math::Precision precision, f64 exactUlp, f64 extraUlp)
+{
+	switch (precision)
+	{
+	case Math::Precision::High:	return Relative(kHighRelativeError, extraUlp);
+	case Math::Precision::Low:	return Relative(kLowRelativeError, extraUlp);
+	default:					return { exactUlp, 0.0 };
+	}
+}
+
+} // namespace Tests
@@ -0,0 +1,93 @@
+#ifndef ENGINE_TESTS_MATH_REFERENCE_H
+#define ENGINE_TESTS_MATH_REFERENCE_H
+//======================================================================================
+// Filename: MathReference.h
+// Description: Long double versions of the Math types the tests compare against, and
+//				conversions from the engine types into flat Values. Matrices flatten
+//				row by row whatever their storage order.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "EngineMath.h"
+
+namespace Tests
+{
+
+//======================================================================================
+// Types
+//======================================================================================
+
+typedef long double Real;
+
+struct MatrixR
+{
+	Real m[4][4]; //[row][column]
+};
+
+struct QuaternionR
+{
+	Real x, y, z, w;
+};
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr Math::Precision kPrecisions[] = { Math::Precision::Exact, Math::Precision::High, Math::Precision::Low };
+
+// The documented Sin/Cos bound for |rad| <= 8192
+constexpr f64 kSinCosAbsError = 1e-7;
+
+//======================================================================================
+// Function Declarations
+//======================================================================================
+
+MatrixR ToReference(const Math::Matrix& m);
+MatrixR ToReference(const Math::Matrix34& m);
+MatrixR ToReference(const Math::Matrix34d& m);
+QuaternionR ToReference(const Math::Quaternion& q);
+
+MatrixR Multiply(const MatrixR& a, const MatrixR& b);
+MatrixR Transpose(const MatrixR& m);
+MatrixR Inverse(const MatrixR& m);
+Real Determinant(const MatrixR& m);
+Values<4> Transform(const MatrixR& m, Real x, Real y, Real z, Real w);
+MatrixR RotationQuaternion(const QuaternionR& q);
+
+QuaternionR Multiply(const QuaternionR& a, const QuaternionR& b);
+QuaternionR Normalize(const QuaternionR& q);
+Values<3> Rotate(const QuaternionR& q, Real x, Real y, Real z);
+
+//--------------------------------------------------------------------------------------
+
+Values<1> ToValues(f32 value);
+Values<1> ToValues(f64 value);
+Values<1> ToValues(bool value);
+Values<2> ToValues(const Math::Vector2& v);
+Values<3> ToValues(const Math::Vector3& v);
+Values<3> ToValues(const Math::Vector3d& v);
+Values<4> ToValues(const Math::Vector4& v);
+Values<4> ToValues(const Math::VecReg& v);
+Values<4> ToValues(const Math::Quaternion& q);
+Values<4> ToValues(const QuaternionR& q);
+Values<16> ToValues(const Math::Matrix& m);
+Values<16> ToValues(const MatrixR& m);
+Values<12> ToValues(const Math::Matrix34& m);
+Values<12> ToValues(const Math::Matrix34d& m);
+Values<12> ToValues34(const MatrixR& m);
+
+//--------------------------------------------------------------------------------------
+
+const char* PrecisionName(Math::Precision precision);
+
+// The documented relative error of precision, Exact allows exactUlp and the others
+// extraUlp for the roundings a function adds on top of its RSqrt
+Limit PrecisionLimit(Math::Precision precision, f64 exactUlp, f64 extraUlp);
+
+} // namespace Tests
+
+#endif // !ENGINE_TESTS_MATH_REFERENCE_H
@@ -0,0 +1,1115 @@
+//======================================================================================
+// Filename: MathTests.cpp
+// Description: Every function in EngineMath.h and MathBatch.h, plus the non trivial
+//				members of the Math types, against a long double reference. Plain
+//				constructors, getters and operators that are a single add or multiply
+//				per component are left to the functions built on them.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "MathReference.h"
+
+#include "Frustum.h"
+#include "MathBatch.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Limits
+//======================================================================================
+
+// Correctly rounded, a single rounding of an exact result
+constexpr Limit kExact				= { 0.5, 0.0 };
+// A short chain of roundings such as a dot product or a single sqrt of one
+constexpr Limit kFewUlp				= { 4.0, 0.0 };
+// Longer chains such as matrix products and cross product based inverses
+constexpr Limit kMatrixUlp			= { 16.0, 0.0 };
+// Comparisons and exact copies
+constexpr Limit kIdentical			= { 0.0, 0.0 };
+
+// The documented polynomial bound of the batch Slerp
+constexpr f64 kBatchSlerpAbsError	= 4e-5;
+
+constexpr u32 kF64MantissaBits		= 53;
+constexpr f64 kF32Roundoff			= 5.9604644775390625e-8;
+constexpr f64 kF64Roundoff			= 1.1102230246251565e-16;
+
+//--------------------------------------------------------------------------------------
+
+// Sums that can cancel are judged against the size of their terms, each term and each
+// add may round by half an ulp of the largest term
+Limit Terms(f64 count, f64 magnitude, f64 roundoff = kF32Roundoff)
+{
+	return { kFewUlp.ulp, 2.0 * count * magnitude * roundoff };
+}
+
+//--------------------------------------------------------------------------------------
+
+// Points within 100 of the origin through scales up to 2 and translations up to 100
+const Limit kTransformLimit = Terms(4.0, 100.0 * 2.0);
+
+//======================================================================================
+// Harness
+//======================================================================================
+
+// func and reference are called with the sample index, func returns an engine value
+// and reference the Values it should have
+template <typename Func, typename Reference>
+void TestFunction(TestContext& context, const char* name, const Limit& limit, const Func& func, const Reference& reference, u32 mantissaBits = 24)
+{
+	if (!context.IsEnabled(name))
+	{
+		return;
+	}
+
+	ErrorStats error(limit, mantissaBits);
+	for (size_t i = 0; i < kSampleCount; ++i)
+	{
+		error.Add(ToValues(func(i)), reference(i));
+	}
+	const f64 nsPerOp = MeasureNs(kSampleCount, [&func](size_t i) { DoNotOptimize(func(i)); });
+	context.Report(name, nsPerOp, error);
+}
+
+//--------------------------------------------------------------------------------------
+
+// batch processes every sample at once, result reads sample i back out of its output
+template <typename Batch, typename Result, typename Reference>
+void TestBatch(TestContext& context, const char* name, const Limit& limit, const Batch& batch, const Result& result, const Reference& reference, u32 mantissaBits = 24)
+{
+	if (!context.IsEnabled(name))
+	{
+		return;
+	}
+
+	batch();
+	ErrorStats error(limit, mantissaBits);
+	for (size_t i = 0; i < kSampleCount; ++i)
+	{
+		error.Add(ToValues(result(i)), reference(i));
+	}
+	const f64 nsPerOp = MeasureNs(1, [&batch](size_t) { batch(); }) / static_cast<f64>(kSampleCount);
+	context.Report(name, nsPerOp, error);
+}
+
+
+//======================================================================================
+// Inputs
+//======================================================================================
+
+struct Inputs
+{
+	std::vector<f32> a;
+	std::vector<f32> b;
+	std::vector<f32> positive;
+	std::vector<f32> t;
+	std::vector<f32> angle;
+	std::vector<Vector3> v0;
+	std::vector<Vector3> v1;
+	std::vector<Vector3> axis;
+	std::vector<Vector4> w0;
+	std::vector<Vector4> w1;
+	std::vector<Quaternion> q;
+	std::vector<Quaternion> unit0;
+	std::vector<Quaternion> unit1;
+	std::vector<Matrix> m0;
+	std::vector<Matrix> m1;
+	std::vector<Matrix34> affine0;
+	std::vector<Matrix34> affine1;
+	std::vector<Matrix34> rigid;
+	std::vector<Vector3d> d0;
+	std::vector<Vector3d> d1;
+	std::vector<Vector3d> camera;
+	std::vector<Matrix34d> world;
+	std::vector<Matrix> viewProjection;
+};
+
+//--------------------------------------------------------------------------------------
+
+Vector3 RandomVector3(f32 extent)
+{
+	return Vector3(RandomFloat(-extent, extent), RandomFloat(-extent, extent), RandomFloat(-extent, extent));
+}
+
+//--------------------------------------------------------------------------------------
+
+Quaternion RandomUnitQuaternion()
+{
+	Quaternion q;
+	f32 lengthSqr = 0.0f;
+	do
+	{
+		q = Quaternion(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f));
+		lengthSqr = MagnitudeSqr(q);
+	} while (lengthSqr < 0.01f || lengthSqr > 1.0f);
+	return q * static_cast<f32>(1.0 / std::sqrt(static_cast<f64>(lengthSqr)));
+}
+
+//--------------------------------------------------------------------------------------
+
+Matrix34 RandomAffine(f32 minScale, f32 maxScale)
+{
+	const Vector3 scale(RandomFloat(minScale, maxScale), RandomFloat(minScale, maxScale), RandomFloat(minScale, maxScale));
+	return Matrix34::Compose(RandomVector3(100.0f), RandomUnitQuaternion(), scale);
+}
+
+//--------------------------------------------------------------------------------------
+
+Matrix RandomViewProjection()
+{
+	//Right handed perspective to [0, 1] depth behind a rigid view
+	const f32 nearZ = 0.1f;
+	const f32 farZ = 1000.0f;
+	const f32 focal = 1.0f / std::tan(RandomFloat(0.4f, 0.8f));
+	const f32 aspect = RandomFloat(1.0f, 2.0f);
+	const Matrix projection
+	(
+		focal / aspect, 0.0f, 0.0f, 0.0f,
+		0.0f, focal, 0.0f, 0.0f,
+		0.0f, 0.0f, farZ / (nearZ - farZ), (nearZ * farZ) / (nearZ - farZ),
+		0.0f, 0.0f, -1.0f, 0.0f
+	);
+	const Matrix34 view = InverseOrthonormal(Matrix34::Compose(RandomVector3(50.0f), RandomUnitQuaternion(), Vector3::One()));
+	return projection * view.ToMatrix();
+}
+
+//--------------------------------------------------------------------------------------
+
+Inputs MakeInputs()
+{
+	Inputs inputs;
+	for (size_t i = 0; i < kSampleCount; ++i)
+	{
+		inputs.a.push_back(RandomFloat(-100.0f, 100.0f));
+		inputs.b.push_back(RandomFloat(-100.0f, 100.0f));
+		inputs.positive.push_back(RandomLogFloat(1e-4f, 1e4f));
+		inputs.t.push_back(RandomFloat(0.0f, 1.0f));
+		inputs.angle.push_back(RandomFloat(-kTwoPi * 4.0f, kTwoPi * 4.0f));
+		inputs.v0.push_back(RandomVector3(100.0f));
+		inputs.v1.push_back(RandomVector3(100.0f));
+		inputs.axis.push_back(Normalize(RandomVector3(1.0f) + Vector3(0.01f, 0.0f, 0.0f)));
+		inputs.w0.push_back(Vector4(RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f)));
+		inputs.w1.push_back(Vector4(RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f)));
+		inputs.q.push_back(Quaternion(RandomFloat(-2.0f, 2.0f), RandomFloat(-2.0f, 2.0f), RandomFloat(-2.0f, 2.0f), RandomFloat(0.5f, 2.0f)));
+		inputs.unit0.push_back(RandomUnitQuaternion());
+		inputs.unit1.push_back(RandomUnitQuaternion());
+
+		//Affine with a small projective row, well conditioned but exercising all 16 terms
+		Matrix m0 = RandomAffine(0.5f, 2.0f).ToMatrix();
+		m0._41 = RandomFloat(-1e-4f, 1e-4f);
+		m0._42 = RandomFloat(-1e-4f, 1e-4f);
+		m0._43 = RandomFloat(-1e-4f, 1e-4f);
+		inputs.m0.push_back(m0);
+		inputs.m1.push_back(RandomAffine(0.5f, 2.0f).ToMatrix());
+		inputs.affine0.push_back(RandomAffine(0.5f, 2.0f));
+		inputs.affine1.push_back(RandomAffine(0.5f, 2.0f));
+		inputs.rigid.push_back(RandomAffine(1.0f, 1.0f));
+
+		//World positions up to 10,000 km out, cameras within a kilometre of them
+		const Vector3d position(RandomFloat(-1e7f, 1e7f), RandomFloat(-1e7f, 1e7f), RandomFloat(-1e7f, 1e7f));
+		inputs.d0.push_back(position);
+		inputs.d1.push_back(Vector3d(RandomFloat(-1e7f, 1e7f), RandomFloat(-1e7f, 1e7f), RandomFloat(-1e7f, 1e7f)));
+		inputs.camera.push_back(position + Vector3d(RandomVector3(1000.0f)) + Vector3d(0.123456789, 0.987654321, 0.5));
+		inputs.world.push_back(Matrix34d::Compose(position + Vector3d(0.25, 0.125, 0.0625), RandomUnitQuaternion(), Vector3(1.0f, 2.0f, 0.5f)));
+
+		inputs.viewProjection.push_back(RandomViewProjection());
+	}
+	return inputs;
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<3> Reference3(Real x, Real y, Real z)
+{
+	return { x, y, z };
+}
+
+//--------------------------------------------------------------------------------------
+
+Values<3> ReferenceCross(const Vector3& a, const Vector3& b)
+{
+	return Reference3
+	(
+		(Real(a.y) * b.z) - (Real(a.z) * b.y),
+		(Real(a.z) * b.x) - (Real(a.x) * b.z),
+		(Real(a.x) * b.y) - (Real(a.y) * b.x)
+	);
+}
+
+//--------------------------------------------------------------------------------------
+
+template <size_t N>
+Values<N> ReferenceNormalize(Values<N> v)
+{
+	Real lengthSqr = 0.0L;
+	for (Real value : v)
+	{
+		lengthSqr += value * value;
+	}
+	const Real scale = 1.0L / std::sqrt(lengthSqr);
+	for (Real& value : v)
+	{
+		value *= scale;
+	}
+	return v;
+}
+
+//--------------------------------------------------------------------------------------
+
+template <size_t N>
+Values<N> ReferenceLerp(const Values<N>& v0, const Values<N>& v1, Real t)
+{
+	Values<N> result;
+	for (size_t i = 0; i < N; ++i)
+	{
+		result[i] = v0[i] + ((v1[i] - v0[i]) * t);
+	}
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+template <size_t N>
+Real ReferenceDot(const Values<N>& a, const Values<N>& b)
+{
+	Real result = 0.0L;
+	for (size_t i = 0; i < N; ++i)
+	{
+		result += a[i] * b[i];
+	}
+	return result;
+}
+
+//--------------------------------------------------------------------------------------
+
+QuaternionR ReferenceNlerp(const Quaternion& q0, const Quaternion& q1, Real t)
+{
+	const QuaternionR a = ToReference(q0);
+	QuaternionR b = ToReference(q1);
+	const Real sign = (ReferenceDot(ToValues(a), ToValues(b)) < 0.0L) ? -1.0L : 1.0L;
+	return Normalize(QuaternionR{ a.x + ((sign * b.x - a.x) * t), a.y + ((sign * b.y - a.y) * t), a.z + ((sign * b.z - a.z) * t), a.w + ((sign * b.w - a.w) * t) });
+}
+
+//--------------------------------------------------------------------------------------
+
+QuaternionR ReferenceSlerp(const Quaternion& q0, const Quaternion& q1, Real t)
+{
+	const QuaternionR a = ToReference(q0);
+	const QuaternionR b = ToReference(q1);
+	Real cosTheta = ReferenceDot(ToValues(a), ToValues(b));
+	const Real sign = (cosTheta < 0.0L) ? -1.0L : 1.0L;
+	cosTheta = std::fmin(cosTheta * sign, 1.0L);
+
+	const Real theta = std::acos(cosTheta);
+	const Real sinTheta = std::sin(theta);
+	if (sinTheta < 1e-12L)
+	{
+		return a;
+	}
+	const Real s0 = std::sin((1.0L - t) * theta) / sinTheta;
+	const Real s1 = sign * std::sin(t * theta) / sinTheta;
+	return { (a.x * s0) + (b.x * s1), (a.y * s0) + (b.y * s1), (a.z * s0) + (b.z * s1), (a.w * s0) + (b.w * s1) };
+}
+
+//--------------------------------------------------------------------------------------
+
+// Planes in long double, not normalized so the classifications below stay exact
+std::array<Values<4>, Frustum::kPlaneCount> ReferencePlanes(const Matrix& viewProjection)
+{
+	const MatrixR m = ToReference(viewProjection);
+	std::array<Values<4>, Frustum::kPlaneCount> planes;
+	for (u32 i = 0; i < 4; ++i)
+	{
+		planes[Frustum::kLeft][i]	= m.m[3][i] + m.m[0][i];
+		planes[Frustum::kRight][i]	= m.m[3][i] - m.m[0][i];
+		planes[Frustum::kTop][i]	= m.m[3][i] + m.m[1][i];
+		planes[Frustum::kBottom][i]	= m.m[3][i] - m.m[1][i];
+		planes[Frustum::kNear][i]	= m.m[2][i];
+		planes[Frustum::kFar][i]	= m.m[3][i] - m.m[2][i];
+	}
+	for (Values<4>& plane : planes)
+	{
+		const Real scale = 1.0L / std::sqrt((plane[0] * plane[0]) + (plane[1] * plane[1]) + (plane[2] * plane[2]));
+		for (Real& value : plane)
+		{
+			value *= scale;
+		}
+	}
+	return planes;
+}
+
+//--------------------------------------------------------------------------------------
+
+// f32 plane math is a few ulp of the far plane distance off, shapes closer to a plane
+// than this can land on either side
+constexpr Real kFrustumAmbiguity = 0.01L;
+
+// distance(plane) is how far inside the plane the shape reaches, NaN if too close to call
+template <typename Distance>
+Values<1> ReferenceClassify(const Matrix& viewProjection, const Distance& distance)
+{
+	bool isVisible = true;
+	bool isAmbiguous = false;
+	for (const Values<4>& plane : ReferencePlanes(viewProjection))
+	{
+		const Real inside = distance(plane);
+		isVisible &= (inside >= 0.0L);
+		isAmbiguous |= (std::fabs(inside) < kFrustumAmbiguity);
+	}
+	return { isAmbiguous ? NAN : (isVisible ? 1.0L : 0.0L) };
+}
+
+//======================================================================================
+// Groups
+//======================================================================================
+
+void TestScalar(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math scalar");
+
+	TestFunction(context, "Min", kIdentical,
+		[&](size_t i) { return Min(in.a[i], in.b[i]); },
+		[&](size_t i) { return Values<1>{ std::fmin(Real(in.a[i]), Real(in.b[i])) }; });
+	TestFunction(context, "Max", kIdentical,
+		[&](size_t i) { return Max(in.a[i], in.b[i]); },
+		[&](size_t i) { return Values<1>{ std::fmax(Real(in.a[i]), Real(in.b[i])) }; });
+	TestFunction(context, "Clamp", kIdentical,
+		[&](size_t i) { return Clamp(in.a[i], -50.0f, 50.0f); },
+		[&](size_t i) { return Values<1>{ std::fmin(std::fmax(Real(in.a[i]), -50.0L), 50.0L) }; });
+	TestFunction(context, "Abs", kIdentical,
+		[&](size_t i) { return Abs(in.a[i]); },
+		[&](size_t i) { return Values<1>{ std::fabs(Real(in.a[i])) }; });
+	TestFunction(context, "Sign", kIdentical,
+		[&](size_t i) { return Sign(in.a[i]); },
+		[&](size_t i) { return Values<1>{ (in.a[i] > 0.0f) ? 1.0L : -1.0L }; });
+	TestFunction(context, "Sqr", kExact,
+		[&](size_t i) { return Sqr(in.a[i]); },
+		[&](size_t i) { return Values<1>{ Real(in.a[i]) * in.a[i] }; });
+
+	for (Precision precision : kPrecisions)
+	{
+		TestFunction(context, Name("Sqrt %s", PrecisionName(precision)), PrecisionLimit(precision, 0.5, 1.0),
+			[&](size_t i) { return Sqrt(in.positive[i], precision); },
+			[&](size_t i) { return Values<1>{ std::sqrt(Real(in.positive[i])) }; });
+	}
+	for (Precision precision : kPrecisions)
+	{
+		TestFunction(context, Name("RSqrt %s", PrecisionName(precision)), PrecisionLimit(precision, 1.5, 0.0),
+			[&](size_t i) { return RSqrt(in.positive[i], precision); },
+			[&](size_t i) { return Values<1>{ 1.0L / std::sqrt(Real(in.positive[i])) }; });
+	}
+
+	TestFunction(context, "SinCos", { 0.0, kSinCosAbsError },
+		[&](size_t i) { Vector2 result; SinCos(in.angle[i], result.x, result.y); return result; },
+		[&](size_t i) { return Values<2>{ std::sin(Real(in.angle[i])), std::cos(Real(in.angle[i])) }; });
+	TestFunction(context, "Sin", { 0.0, kSinCosAbsError },
+		[&](size_t i) { return Sin(in.angle[i]); },
+		[&](size_t i) { return Values<1>{ std::sin(Real(in.angle[i])) }; });
+	TestFunction(context, "Cos", { 0.0, kSinCosAbsError },
+		[&](size_t i) { return Cos(in.angle[i]); },
+		[&](size_t i) { return Values<1>{ std::cos(Real(in.angle[i])) }; });
+
+	//inf and NaN give NaN like libm, so do angles too large to reduce
+	if (context.IsEnabled("SinCos"))
+	{
+		const f32 infinity = std::numeric_limits<f32>::infinity();
+		const f32 nan = std::numeric_limits<f32>::quiet_NaN();
+		f32 sinInfinity, cosInfinity;
+		SinCos(infinity, sinInfinity, cosInfinity);
+		context.Check("SinCos, Sin and Cos of inf are NaN", std::isnan(sinInfinity) && std::isnan(cosInfinity) && std::isnan(Sin(-infinity)) && std::isnan(Cos(infinity)));
+		context.Check("Sin and Cos of NaN are NaN", std::isnan(Sin(nan)) && std::isnan(Cos(nan)));
+		context.Check("Sin and Cos of |rad| > 1.3e7 are NaN", std::isnan(Sin(2e7f)) && std::isnan(Cos(-1e30f)) && !std::isnan(Sin(1e7f)));
+	}
+
+	TestFunction(context, "Compare", kIdentical,
+		[&](size_t i) { return Compare(in.a[i] * 1e-6f, in.b[i] * 1e-6f, 1e-4f); },
+		[&](size_t i) { return ToValues(std::fabs(Real(in.a[i] * 1e-6f) - Real(in.b[i] * 1e-6f)) < Real(1e-4f)); });
+	TestFunction(context, "IsZero(f32)", kIdentical,
+		[&](size_t i) { return IsZero(in.a[i] * 1e-7f); },
+		[&](size_t i) { return ToValues(std::fabs(Real(in.a[i] * 1e-7f)) < Real(0.000001f)); });
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestVector2(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math Vector2");
+
+	const auto v0 = [&](size_t i) { return Vector2(in.v0[i].x, in.v0[i].y); };
+	const auto v1 = [&](size_t i) { return Vector2(in.v1[i].x, in.v1[i].y); };
+	const auto r0 = [&](size_t i) { return ToValues(v0(i)); };
+	const auto r1 = [&](size_t i) { return ToValues(v1(i)); };
+
+	TestFunction(context, "IsZero(Vector2)", kIdentical,
+		[&](size_t i) { return IsZero(v0(i) * 1e-8f); },
+		[&](size_t i) { return ToValues(std::fabs(Real(in.v0[i].x * 1e-8f)) < Real(0.000001f) && std::fabs(Real(in.v0[i].y * 1e-8f)) < Real(0.000001f)); });
+	TestFunction(context, "MagnitudeSqr(Vector2)", kFewUlp,
+		[&](size_t i) { return MagnitudeSqr(v0(i)); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r0(i), r0(i)) }; });
+	TestFunction(context, "Magnitude(Vector2)", kFewUlp,
+		[&](size_t i) { return Magnitude(v0(i)); },
+		[&](size_t i) { return Values<1>{ std::sqrt(ReferenceDot(r0(i), r0(i))) }; });
+	for (Precision precision : kPrecisions)
+	{
+		TestFunction(context, Name("Normalize(Vector2) %s", PrecisionName(precision)), PrecisionLimit(precision, 4.0, 3.0),
+			[&](size_t i) { return Normalize(v0(i), precision); },
+			[&](size_t i) { return ReferenceNormalize(r0(i)); });
+	}
+	TestFunction(context, "DistanceSqr(Vector2)", kFewUlp,
+		[&](size_t i) { return DistanceSqr(v0(i), v1(i)); },
+		[&](size_t i) { const Values<2> d = { r1(i)[0] - r0(i)[0], r1(i)[1] - r0(i)[1] }; return Values<1>{ ReferenceDot(d, d) }; });
+	TestFunction(context, "Distance(Vector2)", kFewUlp,
+		[&](size_t i) { return Distance(v0(i), v1(i)); },
+		[&](size_t i) { const Values<2> d = { r1(i)[0] - r0(i)[0], r1(i)[1] - r0(i)[1] }; return Values<1>{ std::sqrt(ReferenceDot(d, d)) }; });
+	TestFunction(context, "Lerp(Vector2)", Terms(2.0, 100.0),
+		[&](size_t i) { return Lerp(v0(i), v1(i), in.t[i]); },
+		[&](size_t i) { return ReferenceLerp(r0(i), r1(i), in.t[i]); });
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestVector3(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math Vector3");
+
+	const auto r0 = [&](size_t i) { return ToValues(in.v0[i]); };
+	const auto r1 = [&](size_t i) { return ToValues(in.v1[i]); };
+	const auto difference = [&](size_t i) { return Reference3(Real(in.v1[i].x) - in.v0[i].x, Real(in.v1[i].y) - in.v0[i].y, Real(in.v1[i].z) - in.v0[i].z); };
+
+	TestFunction(context, "IsZero(Vector3)", kIdentical,
+		[&](size_t i) { return IsZero(in.v0[i] * 1e-8f); },
+		[&](size_t i)
+		{
+			const Vector3 v = in.v0[i] * 1e-8f;
+			return ToValues(std::fabs(Real(v.x)) < Real(0.000001f) && std::fabs(Real(v.y)) < Real(0.000001f) && std::fabs(Real(v.z)) < Real(0.000001f));
+		});
+	TestFunction(context, "MagnitudeSqr(Vector3)", kFewUlp,
+		[&](size_t i) { return MagnitudeSqr(in.v0[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r0(i), r0(i)) }; });
+	TestFunction(context, "Magnitude(Vector3)", kFewUlp,
+		[&](size_t i) { return Magnitude(in.v0[i]); },
+		[&](size_t i) { return Values<1>{ std::sqrt(ReferenceDot(r0(i), r0(i))) }; });
+	TestFunction(context, "MagnitudeXZSqr", kFewUlp,
+		[&](size_t i) { return MagnitudeXZSqr(in.v0[i]); },
+		[&](size_t i) { return Values<1>{ (Real(in.v0[i].x) * in.v0[i].x) + (Real(in.v0[i].z) * in.v0[i].z) }; });
+	TestFunction(context, "MagnitudeXZ", kFewUlp,
+		[&](size_t i) { return MagnitudeXZ(in.v0[i]); },
+		[&](size_t i) { return Values<1>{ std::sqrt((Real(in.v0[i].x) * in.v0[i].x) + (Real(in.v0[i].z) * in.v0[i].z)) }; });
+	for (Precision precision : kPrecisions)
+	{
+		TestFunction(context, Name("Normalize(Vector3) %s", PrecisionName(precision)), PrecisionLimit(precision, 4.0, 3.0),
+			[&](size_t i) { return Normalize(in.v0[i], precision); },
+			[&](size_t i) { return ReferenceNormalize(r0(i)); });
+	}
+	TestFunction(context, "DistanceSqr(Vector3)", kFewUlp,
+		[&](size_t i) { return DistanceSqr(in.v0[i], in.v1[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(difference(i), difference(i)) }; });
+	TestFunction(context, "Distance(Vector3)", kFewUlp,
+		[&](size_t i) { return Distance(in.v0[i], in.v1[i]); },
+		[&](size_t i) { return Values<1>{ std::sqrt(ReferenceDot(difference(i), difference(i))) }; });
+	TestFunction(context, "DistanceXZSqr", kFewUlp,
+		[&](size_t i) { return DistanceXZSqr(in.v0[i], in.v1[i]); },
+		[&](size_t i) { return Values<1>{ (difference(i)[0] * difference(i)[0]) + (difference(i)[2] * difference(i)[2]) }; });
+	TestFunction(context, "DistanceXZ", kFewUlp,
+		[&](size_t i) { return DistanceXZ(in.v0[i], in.v1[i]); },
+		[&](size_t i) { return Values<1>{ std::sqrt((difference(i)[0] * difference(i)[0]) + (difference(i)[2] * difference(i)[2])) }; });
+
+	TestFunction(context, "Dot(Vector3)", Terms(3.0, 1e4),
+		[&](size_t i) { return Dot(in.v0[i], in.v1[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r0(i), r1(i)) }; });
+	TestFunction(context, "Cross(Vector3)", Terms(2.0, 1e4),
+		[&](size_t i) { return Cross(in.v0[i], in.v1[i]); },
+		[&](size_t i) { return ReferenceCross(in.v0[i], in.v1[i]); });
+	TestFunction(context, "Project", Terms(4.0, 100.0),
+		[&](size_t i) { return Project(in.v0[i], in.axis[i]); },
+		[&](size_t i)
+		{
+			const Values<3> n = ToValues(in.axis[i]);
+			const Real scale = ReferenceDot(r0(i), n) / ReferenceDot(n, n);
+			return Reference3(n[0] * scale, n[1] * scale, n[2] * scale);
+		});
+	TestFunction(context, "Lerp(Vector3)", Terms(2.0, 100.0),
+		[&](size_t i) { return Lerp(in.v0[i], in.v1[i], in.t[i]); },
+		[&](size_t i) { return ReferenceLerp(r0(i), r1(i), in.t[i]); });
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestVector4(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math Vector4 / VecReg");
+
+	const auto r0 = [&](size_t i) { return ToValues(in.w0[i]); };
+	const auto r1 = [&](size_t i) { return ToValues(in.w1[i]); };
+	const auto transform = [&](size_t i) { const Values<4> v = r0(i); return Transform(ToReference(in.m0[i]), v[0], v[1], v[2], v[3]); };
+
+	TestFunction(context, "Dot(Vector4)", Terms(4.0, 100.0),
+		[&](size_t i) { return Dot(in.w0[i], in.w1[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r0(i), r1(i)) }; });
+	TestFunction(context, "MagnitudeSqr(Vector4)", kFewUlp,
+		[&](size_t i) { return MagnitudeSqr(in.w0[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r0(i), r0(i)) }; });
+	TestFunction(context, "Magnitude(Vector4)", kFewUlp,
+		[&](size_t i) { return Magnitude(in.w0[i]); },
+		[&](size_t i) { return Values<1>{ std::sqrt(ReferenceDot(r0(i), r0(i))) }; });
+	for (Precision precision : kPrecisions)
+	{
+		TestFunction(context, Name("Normalize(Vector4) %s", PrecisionName(precision)), PrecisionLimit(precision, 4.0, 3.0),
+			[&](size_t i) { return Normalize(in.w0[i], precision); },
+			[&](size_t i) { return ReferenceNormalize(r0(i)); });
+	}
+	TestFunction(context, "Lerp(Vector4)", Terms(2.0, 10.0),
+		[&](size_t i) { return Lerp(in.w0[i], in.w1[i], in.t[i]); },
+		[&](size_t i) { return ReferenceLerp(r0(i), r1(i), in.t[i]); });
+	TestFunction(context, "Transform(Vector4)", Terms(4.0, 10.0 * 2.0),
+		[&](size_t i) { return Transform(in.w0[i], in.m0[i]); },
+		transform);
+
+	const auto reg0 = [&](size_t i) { return VecReg(in.w0[i]); };
+	const auto reg1 = [&](size_t i) { return VecReg(in.w1[i]); };
+
+	TestFunction(context, "Dot(VecReg)", Terms(4.0, 100.0),
+		[&](size_t i) { return Dot(reg0(i), reg1(i)); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r0(i), r1(i)) }; });
+	TestFunction(context, "Cross(VecReg)", Terms(2.0, 100.0),
+		[&](size_t i) { return Cross(reg0(i), reg1(i)); },
+		[&](size_t i)
+		{
+			const Values<3> cross = ReferenceCross(in.w0[i].ToVector3(), in.w1[i].ToVector3());
+			return Values<4>{ cross[0], cross[1], cross[2], 0.0L };
+		});
+	TestFunction(context, "MagnitudeSqr(VecReg)", kFewUlp,
+		[&](size_t i) { return MagnitudeSqr(reg0(i)); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r0(i), r0(i)) }; });
+	TestFunction(context, "Magnitude(VecReg)", kFewUlp,
+		[&](size_t i) { return Magnitude(reg0(i)); },
+		[&](size_t i) { return Values<1>{ std::sqrt(ReferenceDot(r0(i), r0(i))) }; });
+	for (Precision precision : kPrecisions)
+	{
+		TestFunction(context, Name("Normalize(VecReg) %s", PrecisionName(precision)), PrecisionLimit(precision, 4.0, 3.0),
+			[&](size_t i) { return Normalize(reg0(i), precision); },
+			[&](size_t i) { return ReferenceNormalize(r0(i)); });
+	}
+	TestFunction(context, "Lerp(VecReg)", Terms(2.0, 10.0),
+		[&](size_t i) { return Lerp(reg0(i), reg1(i), in.t[i]); },
+		[&](size_t i) { return ReferenceLerp(r0(i), r1(i), in.t[i]); });
+	TestFunction(context, "Transform(VecReg)", Terms(4.0, 10.0 * 2.0),
+		[&](size_t i) { return Transform(reg0(i), in.m0[i]); },
+		transform);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestVector3d(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math Vector3d");
+
+	const auto r0 = [&](size_t i) { return ToValues(in.d0[i]); };
+	const auto r1 = [&](size_t i) { return ToValues(in.d1[i]); };
+	const auto difference = [&](size_t i) { return Reference3(r1(i)[0] - r0(i)[0], r1(i)[1] - r0(i)[1], r1(i)[2] - r0(i)[2]); };
+
+	TestFunction(context, "Dot(Vector3d)", Terms(3.0, 1e14, kF64Roundoff),
+		[&](size_t i) { return Dot(in.d0[i], in.d1[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r0(i), r1(i)) }; }, kF64MantissaBits);
+	TestFunction(context, "MagnitudeSqr(Vector3d)", kFewUlp,
+		[&](size_t i) { return MagnitudeSqr(in.d0[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r0(i), r0(i)) }; }, kF64MantissaBits);
+	TestFunction(context, "Magnitude(Vector3d)", kFewUlp,
+		[&](size_t i) { return Magnitude(in.d0[i]); },
+		[&](size_t i) { return Values<1>{ std::sqrt(ReferenceDot(r0(i), r0(i))) }; }, kF64MantissaBits);
+	TestFunction(context, "DistanceSqr(Vector3d)", kFewUlp,
+		[&](size_t i) { return DistanceSqr(in.d0[i], in.d1[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(difference(i), difference(i)) }; }, kF64MantissaBits);
+	TestFunction(context, "Distance(Vector3d)", kFewUlp,
+		[&](size_t i) { return Distance(in.d0[i], in.d1[i]); },
+		[&](size_t i) { return Values<1>{ std::sqrt(ReferenceDot(difference(i), difference(i))) }; }, kF64MantissaBits);
+	TestFunction(context, "Lerp(Vector3d)", Terms(2.0, 1e7, kF64Roundoff),
+		[&](size_t i) { return Lerp(in.d0[i], in.d1[i], static_cast<f64>(in.t[i])); },
+		[&](size_t i) { return ReferenceLerp(r0(i), r1(i), in.t[i]); }, kF64MantissaBits);
+	TestFunction(context, "TransformCoord(Vector3d, Matrix34d)", Terms(4.0, 1e7 * 2.0, kF64Roundoff),
+		[&](size_t i) { return TransformCoord(in.d1[i], in.world[i]); },
+		[&](size_t i)
+		{
+			const Values<4> result = Transform(ToReference(in.world[i]), r1(i)[0], r1(i)[1], r1(i)[2], 1.0L);
+			return Reference3(result[0], result[1], result[2]);
+		}, kF64MantissaBits);
+
+	//Only the final rounding to f32 is allowed to lose anything
+	const Limit cameraRelativeLimit = { 0.5 + 1e-3, 0.0 };
+	TestFunction(context, "ToCameraRelative(Vector3d)", cameraRelativeLimit,
+		[&](size_t i) { return ToCameraRelative(in.d0[i], in.camera[i]); },
+		[&](size_t i) { return Reference3(Real(in.d0[i].x) - in.camera[i].x, Real(in.d0[i].y) - in.camera[i].y, Real(in.d0[i].z) - in.camera[i].z); });
+	TestFunction(context, "ToCameraRelative(Matrix34d)", cameraRelativeLimit,
+		[&](size_t i) { return ToCameraRelative(in.world[i], in.camera[i]); },
+		[&](size_t i)
+		{
+			MatrixR m = ToReference(in.world[i]);
+			m.m[0][3] -= in.camera[i].x;
+			m.m[1][3] -= in.camera[i].y;
+			m.m[2][3] -= in.camera[i].z;
+			return ToValues34(m);
+		});
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestMatrix(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math Matrix");
+
+	TestFunction(context, "Determinant", kMatrixUlp,
+		[&](size_t i) { return Determinant(in.m0[i]); },
+		[&](size_t i) { return Values<1>{ Determinant(ToReference(in.m0[i])) }; });
+	TestFunction(context, "Adjoint", kMatrixUlp,
+		[&](size_t i) { return Adjoint(in.m0[i]); },
+		[&](size_t i)
+		{
+			const MatrixR m = ToReference(in.m0[i]);
+			MatrixR adjoint = Inverse(m);
+			const Real determinant = Determinant(m);
+			for (auto& row : adjoint.m)
+			{
+				for (Real& value : row)
+				{
+					value *= determinant;
+				}
+			}
+			return ToValues(adjoint);
+		});
+	TestFunction(context, "Inverse(Matrix)", { 64.0, 0.0 },
+		[&](size_t i) { return Inverse(in.m0[i]); },
+		[&](size_t i) { return ToValues(Inverse(ToReference(in.m0[i]))); });
+	TestFunction(context, "Transpose(Matrix)", kIdentical,
+		[&](size_t i) { return Transpose(in.m0[i]); },
+		[&](size_t i) { return ToValues(Transpose(ToReference(in.m0[i]))); });
+	TestFunction(context, "TransformCoord(Vector3, Matrix)", kTransformLimit,
+		[&](size_t i) { return TransformCoord(in.v0[i], in.m1[i]); },
+		[&](size_t i)
+		{
+			const Values<4> result = Transform(ToReference(in.m1[i]), in.v0[i].x, in.v0[i].y, in.v0[i].z, 1.0L);
+			return Reference3(result[0], result[1], result[2]);
+		});
+	TestFunction(context, "TransformNormal(Vector3, Matrix)", kTransformLimit,
+		[&](size_t i) { return TransformNormal(in.v0[i], in.m1[i]); },
+		[&](size_t i)
+		{
+			const Values<4> result = Transform(ToReference(in.m1[i]), in.v0[i].x, in.v0[i].y, in.v0[i].z, 0.0L);
+			return Reference3(result[0], result[1], result[2]);
+		});
+	TestFunction(context, "Matrix * Matrix", kMatrixUlp,
+		[&](size_t i) { return in.m0[i] * in.m1[i]; },
+		[&](size_t i) { return ToValues(Multiply(ToReference(in.m0[i]), ToReference(in.m1[i]))); });
+
+	const auto rotation = [&](size_t i, u32 axis)
+	{
+		const Real s = std::sin(Real(in.angle[i]));
+		const Real c = std::cos(Real(in.angle[i]));
+		const u32 u = (axis + 1) % 3;
+		const u32 v = (axis + 2) % 3;
+		MatrixR m = {};
+		m.m[axis][axis] = 1.0L;
+		m.m[3][3] = 1.0L;
+		m.m[u][u] = c;
+		m.m[u][v] = -s;
+		m.m[v][u] = s;
+		m.m[v][v] = c;
+		return ToValues(m);
+	};
+	const Limit rotationLimit = { 2.0, kSinCosAbsError };
+	TestFunction(context, "Matrix::RotationX", rotationLimit,
+		[&](size_t i) { return Matrix::RotationX(in.angle[i]); },
+		[&](size_t i) { return rotation(i, 0); });
+	TestFunction(context, "Matrix::RotationY", rotationLimit,
+		[&](size_t i) { return Matrix::RotationY(in.angle[i]); },
+		[&](size_t i) { return rotation(i, 1); });
+	TestFunction(context, "Matrix::RotationZ", rotationLimit,
+		[&](size_t i) { return Matrix::RotationZ(in.angle[i]); },
+		[&](size_t i) { return rotation(i, 2); });
+	TestFunction(context, "Matrix::RotationAxis", { 8.0, 8.0 * kSinCosAbsError },
+		[&](size_t i) { return Matrix::RotationAxis(in.axis[i], in.angle[i]); },
+		[&](size_t i)
+		{
+			//The quaternion for the same rotation is built exactly from the f32 axis
+			const Real halfAngle = Real(in.angle[i]) * 0.5L;
+			const Real s = std::sin(halfAngle);
+			return ToValues(RotationQuaternion({ in.axis[i].x * s, in.axis[i].y * s, in.axis[i].z * s, std::cos(halfAngle) }));
+		});
+	TestFunction(context, "Matrix::RotationQuaternion", kFewUlp,
+		[&](size_t i) { return Matrix::RotationQuaternion(in.unit0[i]); },
+		[&](size_t i) { return ToValues(RotationQuaternion(ToReference(in.unit0[i]))); });
+	TestFunction(context, "Matrix::Translation", kIdentical,
+		[&](size_t i) { return Matrix::Translation(in.v0[i]); },
+		[&](size_t i)
+		{
+			MatrixR m = ToReference(Matrix::Identity());
+			m.m[0][3] = in.v0[i].x;
+			m.m[1][3] = in.v0[i].y;
+			m.m[2][3] = in.v0[i].z;
+			return ToValues(m);
+		});
+	TestFunction(context, "Matrix::Scaling", kIdentical,
+		[&](size_t i) { return Matrix::Scaling(in.v0[i]); },
+		[&](size_t i)
+		{
+			MatrixR m = ToReference(Matrix::Identity());
+			m.m[0][0] = in.v0[i].x;
+			m.m[1][1] = in.v0[i].y;
+			m.m[2][2] = in.v0[i].z;
+			return ToValues(m);
+		});
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestMatrix34(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math Matrix34 / Matrix34d");
+
+	TestFunction(context, "Inverse(Matrix34)", { 64.0, 0.0 },
+		[&](size_t i) { return Inverse(in.affine0[i]); },
+		[&](size_t i) { return ToValues34(Inverse(ToReference(in.affine0[i]))); });
+	TestFunction(context, "InverseOrthonormal", kMatrixUlp,
+		[&](size_t i) { return InverseOrthonormal(in.rigid[i]); },
+		[&](size_t i) { return ToValues34(Inverse(ToReference(in.rigid[i]))); });
+	TestFunction(context, "TransformCoord(Vector3, Matrix34)", kTransformLimit,
+		[&](size_t i) { return TransformCoord(in.v0[i], in.affine0[i]); },
+		[&](size_t i)
+		{
+			const Values<4> result = Transform(ToReference(in.affine0[i]), in.v0[i].x, in.v0[i].y, in.v0[i].z, 1.0L);
+			return Reference3(result[0], result[1], result[2]);
+		});
+	TestFunction(context, "TransformNormal(Vector3, Matrix34)", kTransformLimit,
+		[&](size_t i) { return TransformNormal(in.v0[i], in.affine0[i]); },
+		[&](size_t i)
+		{
+			const Values<4> result = Transform(ToReference(in.affine0[i]), in.v0[i].x, in.v0[i].y, in.v0[i].z, 0.0L);
+			return Reference3(result[0], result[1], result[2]);
+		});
+	TestFunction(context, "Matrix34 * Matrix34", kMatrixUlp,
+		[&](size_t i) { return in.affine0[i] * in.affine1[i]; },
+		[&](size_t i) { return ToValues34(Multiply(ToReference(in.affine0[i]), ToReference(in.affine1[i]))); });
+	TestFunction(context, "Matrix34::Compose", kFewUlp,
+		[&](size_t i) { return Matrix34::Compose(in.v0[i], in.unit0[i], in.w0[i].ToVector3()); },
+		[&](size_t i)
+		{
+			MatrixR m = RotationQuaternion(ToReference(in.unit0[i]));
+			for (u32 row = 0; row < 3; ++row)
+			{
+				m.m[row][0] *= in.w0[i].x;
+				m.m[row][1] *= in.w0[i].y;
+				m.m[row][2] *= in.w0[i].z;
+			}
+			m.m[0][3] = in.v0[i].x;
+			m.m[1][3] = in.v0[i].y;
+			m.m[2][3] = in.v0[i].z;
+			return ToValues34(m);
+		});
+	TestFunction(context, "Matrix34(Matrix)", kIdentical,
+		[&](size_t i) { return Matrix34(in.m1[i]); },
+		[&](size_t i) { return ToValues34(ToReference(in.m1[i])); });
+	TestFunction(context, "Matrix34::ToMatrix", kIdentical,
+		[&](size_t i) { return in.affine0[i].ToMatrix(); },
+		[&](size_t i) { return ToValues(ToReference(in.affine0[i])); });
+
+	TestFunction(context, "Matrix34d * Matrix34d", kMatrixUlp,
+		[&](size_t i) { return in.world[i] * Matrix34d(in.affine0[i]); },
+		[&](size_t i) { return ToValues34(Multiply(ToReference(in.world[i]), ToReference(in.affine0[i]))); }, kF64MantissaBits);
+	TestFunction(context, "Matrix34d::Compose", kIdentical,
+		[&](size_t i) { return Matrix34d::Compose(in.d0[i], in.unit0[i], in.w0[i].ToVector3()); },
+		[&](size_t i)
+		{
+			//The basis is Matrix34::Compose, only the translation has to keep its range
+			MatrixR m = ToReference(Matrix34::Compose(Vector3::Zero(), in.unit0[i], in.w0[i].ToVector3()));
+			m.m[0][3] = in.d0[i].x;
+			m.m[1][3] = in.d0[i].y;
+			m.m[2][3] = in.d0[i].z;
+			return ToValues34(m);
+		}, kF64MantissaBits);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestQuaternion(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math Quaternion");
+
+	const auto r = [&](size_t i) { return ToValues(in.q[i]); };
+
+	TestFunction(context, "Dot(Quaternion)", Terms(4.0, 2.0),
+		[&](size_t i) { return Dot(in.q[i], in.unit0[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r(i), ToValues(in.unit0[i])) }; });
+	TestFunction(context, "MagnitudeSqr(Quaternion)", kFewUlp,
+		[&](size_t i) { return MagnitudeSqr(in.q[i]); },
+		[&](size_t i) { return Values<1>{ ReferenceDot(r(i), r(i)) }; });
+	TestFunction(context, "Magnitude(Quaternion)", kFewUlp,
+		[&](size_t i) { return Magnitude(in.q[i]); },
+		[&](size_t i) { return Values<1>{ std::sqrt(ReferenceDot(r(i), r(i))) }; });
+	for (Precision precision : kPrecisions)
+	{
+		TestFunction(context, Name("Normalize(Quaternion) %s", PrecisionName(precision)), PrecisionLimit(precision, 4.0, 3.0),
+			[&](size_t i) { return Normalize(in.q[i], precision); },
+			[&](size_t i) { return ReferenceNormalize(r(i)); });
+	}
+	TestFunction(context, "Conjugate", kIdentical,
+		[&](size_t i) { return Conjugate(in.q[i]); },
+		[&](size_t i) { return Values<4>{ -r(i)[0], -r(i)[1], -r(i)[2], r(i)[3] }; });
+	TestFunction(context, "Inverse(Quaternion)", kFewUlp,
+		[&](size_t i) { return Inverse(in.q[i]); },
+		[&](size_t i)
+		{
+			const Real lengthSqr = ReferenceDot(r(i), r(i));
+			return Values<4>{ -r(i)[0] / lengthSqr, -r(i)[1] / lengthSqr, -r(i)[2] / lengthSqr, r(i)[3] / lengthSqr };
+		});
+	TestFunction(context, "Rotate", kMatrixUlp,
+		[&](size_t i) { return Rotate(in.v0[i], in.unit0[i]); },
+		[&](size_t i) { return Rotate(ToReference(in.unit0[i]), in.v0[i].x, in.v0[i].y, in.v0[i].z); });
+	TestFunction(context, "ToAxisAngle", kFewUlp,
+		[&](size_t i) { Vector3 axis; f32 rad = 0.0f; ToAxisAngle(in.unit0[i], axis, rad); return Vector4(axis.x, axis.y, axis.z, rad); },
+		[&](size_t i)
+		{
+			const QuaternionR q = ToReference(in.unit0[i]);
+			const Real sinHalfAngle = std::sqrt((q.x * q.x) + (q.y * q.y) + (q.z * q.z));
+			return Values<4>{ q.x / sinHalfAngle, q.y / sinHalfAngle, q.z / sinHalfAngle, 2.0L * std::atan2(sinHalfAngle, q.w) };
+		});
+	TestFunction(context, "Nlerp", kFewUlp,
+		[&](size_t i) { return Nlerp(in.unit0[i], in.unit1[i], in.t[i]); },
+		[&](size_t i) { return ToValues(ReferenceNlerp(in.unit0[i], in.unit1[i], in.t[i])); });
+	TestFunction(context, "Slerp", kMatrixUlp,
+		[&](size_t i) { return Slerp(in.unit0[i], in.unit1[i], in.t[i]); },
+		[&](size_t i) { return ToValues(ReferenceSlerp(in.unit0[i], in.unit1[i], in.t[i])); });
+	TestFunction(context, "Quaternion * Quaternion", kFewUlp,
+		[&](size_t i) { return in.unit0[i] * in.unit1[i]; },
+		[&](size_t i) { return ToValues(Multiply(ToReference(in.unit0[i]), ToReference(in.unit1[i]))); });
+	TestFunction(context, "Quaternion::RotationAxis", { 2.0, kSinCosAbsError },
+		[&](size_t i) { return Quaternion::RotationAxis(in.axis[i], in.angle[i]); },
+		[&](size_t i)
+		{
+			const Real halfAngle = Real(in.angle[i]) * 0.5L;
+			const Real s = std::sin(halfAngle);
+			return Values<4>{ in.axis[i].x * s, in.axis[i].y * s, in.axis[i].z * s, std::cos(halfAngle) };
+		});
+	TestFunction(context, "Quaternion::RotationMatrix", kMatrixUlp,
+		[&](size_t i) { return Quaternion::RotationMatrix(Matrix::RotationQuaternion(in.unit0[i])); },
+		[&](size_t i)
+		{
+			//q and -q are the same rotation, compare against the one the engine picked
+			const Quaternion result = Quaternion::RotationMatrix(Matrix::RotationQuaternion(in.unit0[i]));
+			const Real sign = (Dot(result, in.unit0[i]) < 0.0f) ? -1.0L : 1.0L;
+			const QuaternionR q = ToReference(in.unit0[i]);
+			return Values<4>{ q.x * sign, q.y * sign, q.z * sign, q.w * sign };
+		});
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestFrustum(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math Frustum");
+
+	if (context.IsEnabled("Frustum::FromMatrix"))
+	{
+		//Plane by plane so the far plane distance does not hide the normals
+		ErrorStats error(kMatrixUlp);
+		for (size_t i = 0; i < kSampleCount; ++i)
+		{
+			const Frustum frustum = Frustum::FromMatrix(in.viewProjection[i]);
+			const std::array<Values<4>, Frustum::kPlaneCount> planes = ReferencePlanes(in.viewProjection[i]);
+			for (u32 plane = 0; plane < Frustum::kPlaneCount; ++plane)
+			{
+				error.Add(ToValues(frustum.planes[plane]), planes[plane]);
+			}
+		}
+		const f64 nsPerOp = MeasureNs(kSampleCount, [&](size_t i) { DoNotOptimize(Frustum::FromMatrix(in.viewProjection[i])); });
+		context.Report("Frustum::FromMatrix", nsPerOp, error);
+	}
+
+	std::vector<Frustum> frustums;
+	for (const Matrix& viewProjection : in.viewProjection)
+	{
+		frustums.push_back(Frustum::FromMatrix(viewProjection));
+	}
+	const auto center = [&](size_t i) { return in.v0[i] * 2.0f; };
+	const auto radius = [&](size_t i) { return in.positive[i] * 0.01f; };
+	const auto extent = [&](size_t i) { return Vector3(Abs(in.w0[i].x), Abs(in.w0[i].y), Abs(in.w0[i].z)) * 2.0f; };
+
+	TestFunction(context, "Frustum::TestSphere", kIdentical,
+		[&](size_t i) { return frustums[i].TestSphere(center(i), radius(i)); },
+		[&](size_t i)
+		{
+			const Values<3> c = ToValues(center(i));
+			return ReferenceClassify(in.viewProjection[i], [&](const Values<4>& plane)
+			{
+				return (plane[0] * c[0]) + (plane[1] * c[1]) + (plane[2] * c[2]) + plane[3] + radius(i);
+			});
+		});
+	TestFunction(context, "Frustum::TestAABB", kIdentical,
+		[&](size_t i) { return frustums[i].TestAABB(center(i) - extent(i), center(i) + extent(i)); },
+		[&](size_t i)
+		{
+			const Values<3> c = ToValues(center(i));
+			const Values<3> e = ToValues(extent(i));
+			return ReferenceClassify(in.viewProjection[i], [&](const Values<4>& plane)
+			{
+				return (plane[0] * c[0]) + (plane[1] * c[1]) + (plane[2] * c[2]) + plane[3]
+					+ (std::fabs(plane[0]) * e[0]) + (std::fabs(plane[1]) * e[1]) + (std::fabs(plane[2]) * e[2]);
+			});
+		});
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestBatches(TestContext& context, const Inputs& in)
+{
+	context.BeginGroup("Math batch (ns per element)");
+
+	const size_t count = kSampleCount;
+	std::vector<Vector3> vectorOut(count);
+	std::vector<f32> x(count), y(count), z(count);
+	std::vector<f32> xOut(count), yOut(count), zOut(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] = in.v0[i].x;
+		y[i] = in.v0[i].y;
+		z[i] = in.v0[i].z;
+	}
+	const Vector3SoA soa(x.data(), y.data(), z.data(), count);
+	const Vector3SoA soaOut(xOut.data(), yOut.data(), zOut.data(), count);
+	const Matrix& m = in.m1[0];
+	const auto transform = [&](size_t i, Real w)
+	{
+		const Values<4> result = Transform(ToReference(m), in.v0[i].x, in.v0[i].y, in.v0[i].z, w);
+		return Reference3(result[0], result[1], result[2]);
+	};
+
+	TestBatch(context, "TransformCoord(Span<Vector3>)", kTransformLimit,
+		[&]() { TransformCoord(in.v0, m, vectorOut); },
+		[&](size_t i) { return vectorOut[i]; },
+		[&](size_t i) { return transform(i, 1.0L); });
+	TestBatch(context, "TransformNormal(Span<Vector3>)", kTransformLimit,
+		[&]() { TransformNormal(in.v0, m, vectorOut); },
+		[&](size_t i) { return vectorOut[i]; },
+		[&](size_t i) { return transform(i, 0.0L); });
+	TestBatch(context, "TransformCoord(Vector3SoA)", kTransformLimit,
+		[&]() { TransformCoord(soa, m, soaOut); },
+		[&](size_t i) { return Vector3(xOut[i], yOut[i], zOut[i]); },
+		[&](size_t i) { return transform(i, 1.0L); });
+	TestBatch(context, "TransformNormal(Vector3SoA)", kTransformLimit,
+		[&]() { TransformNormal(soa, m, soaOut); },
+		[&](size_t i) { return Vector3(xOut[i], yOut[i], zOut[i]); },
+		[&](size_t i) { return transform(i, 0.0L); });
+
+	for (Precision precision : kPrecisions)
+	{
+		TestBatch(context, Name("Sqrt(Span) %s", PrecisionName(precision)), PrecisionLimit(precision, 0.5, 1.0),
+			[&]() { Sqrt(in.positive, xOut, precision); },
+			[&](size_t i) { return xOut[i]; },
+			[&](size_t i) { return Values<1>{ std::sqrt(Real(in.positive[i])) }; });
+	}
+	for (Precision precision : kPrecisions)
+	{
+		TestBatch(context, Name("RSqrt(Span) %s", PrecisionName(precision)), PrecisionLimit(precision, 1.5, 0.0),
+			[&]() { RSqrt(in.positive, xOut, precision); },
+			[&](size_t i) { return xOut[i]; },
+			[&](size_t i) { return Values<1>{ 1.0L / std::sqrt(Real(in.positive[i])) }; });
+	}
+
+	TestBatch(context, "SinCos(Span)", { 0.0, kSinCosAbsError },
+		[&]() { SinCos(in.angle, xOut, yOut); },
+		[&](size_t i) { return Vector2(xOut[i], yOut[i]); },
+		[&](size_t i) { return Values<2>{ std::sin(Real(in.angle[i])), std::cos(Real(in.angle[i])) }; });
+	TestBatch(context, "Sin(Span)", { 0.0, kSinCosAbsError },
+		[&]() { Sin(in.angle, xOut); },
+		[&](size_t i) { return xOut[i]; },
+		[&](size_t i) { return Values<1>{ std::sin(Real(in.angle[i])) }; });
+	TestBatch(context, "Cos(Span)", { 0.0, kSinCosAbsError },
+		[&]() { Cos(in.angle, xOut); },
+		[&](size_t i) { return xOut[i]; },
+		[&](size_t i) { return Values<1>{ std::cos(Real(in.angle[i])) }; });
+
+	//A full AVX2 register, every lane but the last too large to reduce
+	if (context.IsEnabled("SinCos(Span)"))
+	{
+		const f32 infinity = std::numeric_limits<f32>::infinity();
+		const std::vector<f32> unreducible = { infinity, -infinity, std::numeric_limits<f32>::quiet_NaN(), 2e7f, -1e30f, 1e10f, -2e7f, 1e7f };
+		std::vector<f32> sinOut(unreducible.size()), cosOut(unreducible.size());
+		SinCos(unreducible, sinOut, cosOut);
+		bool isNaN = true;
+		for (size_t i = 0; i + 1 < unreducible.size(); ++i)
+		{
+			isNaN = isNaN && std::isnan(sinOut[i]) && std::isnan(cosOut[i]);
+		}
+		context.Check("SinCos(Span) of |rad| > 1.3e7, inf, NaN", isNaN && !std::isnan(sinOut.back()) && !std::isnan(cosOut.back()));
+	}
+
+	std::vector<Quaternion> quaternionOut(count);
+	const f32 t = 0.375f;
+	TestBatch(context, "Multiply(Span<Quaternion>)", kFewUlp,
+		[&]() { Multiply(in.unit0, in.unit1, quaternionOut); },
+		[&](size_t i) { return quaternionOut[i]; },
+		[&](size_t i) { return ToValues(Multiply(ToReference(in.unit0[i]), ToReference(in.unit1[i]))); });
+	TestBatch(context, "Nlerp(Span<Quaternion>)", kFewUlp,
+		[&]() { Nlerp(in.unit0, in.unit1, t, quaternionOut); },
+		[&](size_t i) { return quaternionOut[i]; },
+		[&](size_t i) { return ToValues(ReferenceNlerp(in.unit0[i], in.unit1[i], t)); });
+	TestBatch(context, "Slerp(Span<Quaternion>)", { 0.0, kBatchSlerpAbsError },
+		[&]() { Slerp(in.unit0, in.unit1, t, quaternionOut); },
+		[&](size_t i) { return quaternionOut[i]; },
+		[&](size_t i) { return ToValues(ReferenceSlerp(in.unit0[i], in.unit1[i], t)); });
+
+	std::vector<Matrix34> affineOut(count);
+	TestBatch(context, "PackAffine", kIdentical,
+		[&]() { PackAffine(in.m1, affineOut); },
+		[&](size_t i) { return affineOut[i]; },
+		[&](size_t i) { return ToValues34(ToReference(in.m1[i])); });
+	TestBatch(context, "ToCameraRelative(Span<Matrix34d>)", { 0.5 + 1e-3, 0.0 },
+		[&]() { ToCameraRelative(Span<const Matrix34d>(in.world), in.camera[0], affineOut); },
+		[&](size_t i) { return affineOut[i]; },
+		[&](size_t i)
+		{
+			MatrixR world = ToReference(in.world[i]);
+			world.m[0][3] -= in.camera[0].x;
+			world.m[1][3] -= in.camera[0].y;
+			world.m[2][3] -= in.camera[0].z;
+			return ToValues34(world);
+		});
+	TestBatch(context, "ToCameraRelative(Span<Vector3d>)", { 0.5 + 1e-3, 0.0 },
+		[&]() { ToCameraRelative(Span<const Vector3d>(in.d0), in.camera[0], vectorOut); },
+		[&](size_t i) { return vectorOut[i]; },
+		[&](size_t i) { return Reference3(Real(in.d0[i].x) - in.camera[0].x, Real(in.d0[i].y) - in.camera[0].y, Real(in.d0[i].z) - in.camera[0].z); });
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunMathTests(TestContext& context)
+{
+	const Inputs inputs = MakeInputs();
+
+	TestScalar(context, inputs);
+	TestVector2(context, inputs);
+	TestVector3(context, inputs);
+	TestVector4(context, inputs);
+	TestVector3d(context, inputs);
+	TestMatrix(context, inputs);
+	TestMatrix34(context, inputs);
+	TestQuaternion(context, inputs);
+	TestFrustum(context, inputs);
+	TestBatches(context, inputs);
+}
+
+} // namespace Tests
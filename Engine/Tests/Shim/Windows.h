@@ -0,0 +1,57 @@
+#ifndef ENGINE_TESTS_SHIM_WINDOWS_H
+#define ENGINE_TESTS_SHIM_WINDOWS_H
+//======================================================================================
+// Filename: Windows.h
+// Description: The few Win32 names the engine core uses, so the platform independent
+//				sources build on Linux for the Tests target. Not used by the engine.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include <cfloat>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//======================================================================================
+// Defines
+//======================================================================================
+
+#define __int64 long long
+
+#define sprintf_s(buffer, size, ...)		snprintf(buffer, size, __VA_ARGS__)
+#define strcat_s(buffer, size, source)		strncat(buffer, source, (size) - strlen(buffer) - 1)
+
+//======================================================================================
+// Functions
+//======================================================================================
+
+inline void OutputDebugStringA(const char* text)
+{
+	fputs(text, stderr);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline void DebugBreak()
+{
+	abort();
+}
+
+//--------------------------------------------------------------------------------------
+
+inline void* _aligned_malloc(size_t size, size_t alignment)
+{
+	//aligned_alloc wants the size to be a multiple of the alignment
+	return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+//--------------------------------------------------------------------------------------
+
+inline void _aligned_free(void* memory)
+{
+	free(memory);
+}
+
+#endif // !ENGINE_TESTS_SHIM_WINDOWS_H
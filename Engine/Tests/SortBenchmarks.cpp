@@ -0,0 +1,158 @@
+//======================================================================================
+// Filename: SortBenchmarks.cpp
+// Description: RadixSorter on a frame's worth of draw keys against std::sort, and how
+//				many instanced draws the sorted keys merge into.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "DrawKey.h"
+#include "JobSystem.h"
+#include "RadixSort.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr size_t kDrawCounts[] = { 10000, 100000, 1000000 };
+
+// A scene's worth of state. Every draw picks a mesh at random, and each mesh always
+// uses the same material and pipeline.
+constexpr u32 kPipelineCount = 8;
+constexpr u32 kMaterialCount = 256;
+constexpr u32 kMeshCount = 1024;
+
+//======================================================================================
+// Types
+//======================================================================================
+
+struct KeyValue
+{
+	u64 key;
+	u32 value;
+
+	bool operator<(const KeyValue& rhs) const								{ return key < rhs.key; }
+};
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+// Draws DrawBatcher would record for sorted keys, one per run of the same batch key
+size_t CountBatches(const std::vector<u64>& sortedKeys, size_t count)
+{
+	size_t batchCount = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (i == 0 || GetDrawBatchKey(sortedKeys[i]) != GetDrawBatchKey(sortedKeys[i - 1]))
+		{
+			++batchCount;
+		}
+	}
+	return batchCount;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Times a sort of count draws, each run starts from a copy of the unsorted input
+template <typename Sort>
+f64 ReportSort(TestContext& context, const char* name, size_t count, f64 baselineNs, const Sort& sort)
+{
+	const f64 ns = MeasureNs(1, [&](size_t) { sort(); });
+	context.ReportTiming(name, ns / static_cast<f64>(count));
+	context.ReportRate(Name("%s, whole frame", name), ns * 1e-6, "ms");
+	if (baselineNs > 0.0)
+	{
+		context.ReportRate(Name("%s, speedup", name), baselineNs / ns, "x");
+	}
+	return ns;
+}
+
+//======================================================================================
+// Benchmarks
+//======================================================================================
+
+void BenchmarkDrawSort(TestContext& context)
+{
+	const size_t maxCount = kDrawCounts[2];
+	std::vector<u64> keys(maxCount);
+	std::vector<KeyValue> pairs(maxCount);
+	for (size_t i = 0; i < maxCount; ++i)
+	{
+		const u32 mesh = static_cast<u32>(GetRandom()() % kMeshCount);
+		const u32 material = mesh % kMaterialCount;
+		const u32 pipeline = material % kPipelineCount;
+		keys[i] = MakeDrawKey(pipeline, material, mesh, RandomFloat(0.0f, 1.0f));
+		pairs[i] = { keys[i], static_cast<u32>(i) };
+	}
+
+	std::vector<u64> sortedKeys(maxCount);
+	std::vector<u32> sortedValues(maxCount);
+	std::vector<KeyValue> sortedPairs(maxCount);
+	RadixSorter sorter;
+	JobSystem jobSystem;
+
+	for (const size_t count : kDrawCounts)
+	{
+		context.BeginGroup(Name("Draw key sort, %zu draws, %u job workers", count, jobSystem.GetWorkerCount()));
+		if (!context.IsEnabled("Draw key sort"))
+		{
+			continue;
+		}
+
+		const auto copyPairs = [&]() { std::copy(pairs.begin(), pairs.begin() + count, sortedPairs.begin()); };
+		const auto copyKeys = [&]()
+		{
+			std::copy(keys.begin(), keys.begin() + count, sortedKeys.begin());
+			for (size_t i = 0; i < count; ++i)
+			{
+				sortedValues[i] = static_cast<u32>(i);
+			}
+		};
+		const Span<u64> keySpan(sortedKeys.data(), count);
+		const Span<u32> valueSpan(sortedValues.data(), count);
+
+		const f64 baselineNs = ReportSort(context, "std::sort", count, 0.0,
+			[&]() { copyPairs(); std::sort(sortedPairs.begin(), sortedPairs.begin() + count); });
+		ReportSort(context, "std::stable_sort", count, baselineNs,
+			[&]() { copyPairs(); std::stable_sort(sortedPairs.begin(), sortedPairs.begin() + count); });
+		ReportSort(context, "RadixSorter::Sort", count, baselineNs,
+			[&]() { copyKeys(); sorter.Sort(keySpan, valueSpan); });
+		ReportSort(context, "RadixSorter::Sort on the job system", count, baselineNs,
+			[&]() { copyKeys(); sorter.Sort(jobSystem, keySpan, valueSpan); });
+
+		//Both are stable, so the values have to come out in the same order too
+		bool sameOrder = true;
+		for (size_t i = 0; i < count; ++i)
+		{
+			sameOrder = sameOrder && (sortedKeys[i] == sortedPairs[i].key) && (sortedValues[i] == sortedPairs[i].value);
+		}
+		context.Check("RadixSorter, same order as std::stable_sort", sameOrder);
+		context.ReportRate("Instanced draws after merging", static_cast<f64>(CountBatches(sortedKeys, count)), "");
+	}
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunSortBenchmarks(TestContext& context)
+{
+	BenchmarkDrawSort(context);
+}
+
+} // namespace Tests
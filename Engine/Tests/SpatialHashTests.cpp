@@ -0,0 +1,288 @@
+//======================================================================================
+// Filename: SpatialHashTests.cpp
+// Description: SpatialHash radius and box queries against testing every object, on
+//				both the cell walk and the every object path, and its occupancy stats.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "EngineMath.h"
+#include "JobSystem.h"
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr u32 kObjectCount = 20000;
+constexpr u32 kBucketCount = 16384;
+constexpr f32 kCellSize = 10.0f;
+constexpr f32 kSceneHalfSize = 500.0f;
+constexpr f32 kMaxObjectRadius = 5.0f;
+
+// Small queries cover a few hundred cells and walk them, large ones cover more cells
+// than there are objects and test every object instead
+constexpr f32 kSmallQuerySize = 20.0f;
+constexpr f32 kLargeQuerySize = 400.0f;
+constexpr u32 kQueryCount = 64;
+
+//======================================================================================
+// Types
+//======================================================================================
+
+struct Objects
+{
+	std::vector<Vector3>	positions;
+	std::vector<f32>		radii;
+	std::vector<u8>			isInserted;
+};
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+Vector3 RandomPoint(f32 halfSize)
+{
+	return Vector3(RandomFloat(-halfSize, halfSize), RandomFloat(-halfSize, halfSize), RandomFloat(-halfSize, halfSize));
+}
+
+//--------------------------------------------------------------------------------------
+
+Objects MakeObjects()
+{
+	Objects objects;
+	for (u32 i = 0; i < kObjectCount; ++i)
+	{
+		objects.positions.push_back(RandomPoint(kSceneHalfSize));
+		objects.radii.push_back(RandomFloat(0.0f, kMaxObjectRadius));
+		objects.isInserted.push_back(1);
+	}
+	return objects;
+}
+
+//--------------------------------------------------------------------------------------
+
+// The query's results, sorted, or an empty list with a marker if they didn't fit
+std::vector<u32> Sorted(std::vector<u32> results, size_t found)
+{
+	if (found > results.size())
+	{
+		return { U32_MAX };
+	}
+	results.resize(found);
+	std::sort(results.begin(), results.end());
+	return results;
+}
+
+//--------------------------------------------------------------------------------------
+
+std::vector<u32> QueryRadius(const SpatialHash& hash, const Vector3& center, f32 radius)
+{
+	std::vector<u32> results(kObjectCount);
+	return Sorted(results, hash.QueryRadius(center, radius, Span<u32>(results)));
+}
+
+//--------------------------------------------------------------------------------------
+
+std::vector<u32> QueryBox(const SpatialHash& hash, const Vector3& min, const Vector3& max)
+{
+	std::vector<u32> results(kObjectCount);
+	return Sorted(results, hash.QueryBox(min, max, Span<u32>(results)));
+}
+
+//--------------------------------------------------------------------------------------
+
+// Every inserted object the sphere touches, with the same test SpatialHash uses
+std::vector<u32> QueryRadiusEvery(const Objects& objects, const Vector3& center, f32 radius)
+{
+	std::vector<u32> results;
+	for (u32 i = 0; i < kObjectCount; ++i)
+	{
+		const f32 reach = radius + objects.radii[i];
+		if (objects.isInserted[i] != 0 && MagnitudeSqr(objects.positions[i] - center) <= reach * reach)
+		{
+			results.push_back(i);
+		}
+	}
+	return results;
+}
+
+//--------------------------------------------------------------------------------------
+
+std::vector<u32> QueryBoxEvery(const Objects& objects, const Vector3& min, const Vector3& max)
+{
+	std::vector<u32> results;
+	for (u32 i = 0; i < kObjectCount; ++i)
+	{
+		const Vector3& position = objects.positions[i];
+		const Vector3 closest(Clamp(position.x, min.x, max.x), Clamp(position.y, min.y, max.y), Clamp(position.z, min.z, max.z));
+		if (objects.isInserted[i] != 0 && MagnitudeSqr(position - closest) <= objects.radii[i] * objects.radii[i])
+		{
+			results.push_back(i);
+		}
+	}
+	return results;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Radius and box queries of querySize around random points, all against every object
+bool QueriesMatch(const SpatialHash& hash, const Objects& objects, f32 querySize)
+{
+	bool isMatch = true;
+	for (u32 query = 0; query < kQueryCount; ++query)
+	{
+		const Vector3 center = RandomPoint(kSceneHalfSize);
+		const Vector3 extent(querySize, querySize * 0.5f, querySize * 0.25f);
+		isMatch = isMatch && (QueryRadius(hash, center, querySize) == QueryRadiusEvery(objects, center, querySize));
+		isMatch = isMatch && (QueryBox(hash, center - extent, center + extent) == QueryBoxEvery(objects, center - extent, center + extent));
+	}
+	return isMatch;
+}
+
+//--------------------------------------------------------------------------------------
+
+bool operator==(const SpatialHashStats& lhs, const SpatialHashStats& rhs)
+{
+	return lhs.objectCount == rhs.objectCount && lhs.bucketCount == rhs.bucketCount && lhs.occupiedBuckets == rhs.occupiedBuckets
+		&& lhs.maxBucketSize == rhs.maxBucketSize && lhs.averageBucketSize == rhs.averageBucketSize && lhs.maxRadius == rhs.maxRadius
+		&& std::equal(lhs.histogram, lhs.histogram + kSpatialHashHistogramSize, rhs.histogram);
+}
+
+//======================================================================================
+// Tests
+//======================================================================================
+
+void TestQueries(TestContext& context)
+{
+	context.BeginGroup("SpatialHash queries");
+	if (!context.IsEnabled("SpatialHash"))
+	{
+		return;
+	}
+
+	Objects objects = MakeObjects();
+	SpatialHash hash(kCellSize, kBucketCount);
+	hash.Rebuild(Span<const Vector3>(objects.positions), Span<const f32>(objects.radii));
+	context.Check("Small queries, same as every object", QueriesMatch(hash, objects, kSmallQuerySize));
+	context.Check("Large queries, same as every object", QueriesMatch(hash, objects, kLargeQuerySize));
+
+	//Every other slot is left over from the build above and must not show up
+	hash.Reset(kObjectCount);
+	for (u32 i = 0; i < kObjectCount; ++i)
+	{
+		objects.positions[i] = RandomPoint(kSceneHalfSize);
+		objects.isInserted[i] = (i % 2 == 0) ? 1 : 0;
+		if (objects.isInserted[i] != 0)
+		{
+			hash.Insert(i, objects.positions[i], objects.radii[i]);
+		}
+	}
+	context.Check("Half inserted, small queries, same as every object", QueriesMatch(hash, objects, kSmallQuerySize));
+	context.Check("Half inserted, large queries, same as every object", QueriesMatch(hash, objects, kLargeQuerySize));
+	context.Check("Half inserted, inserted count", hash.GetInsertedCount() == kObjectCount / 2 && hash.GetStats().objectCount == kObjectCount / 2);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestParallelRebuild(TestContext& context)
+{
+	JobSystem jobSystem;
+	context.BeginGroup(Name("SpatialHash parallel Rebuild, %u job workers", jobSystem.GetWorkerCount()));
+	if (!context.IsEnabled("SpatialHash"))
+	{
+		return;
+	}
+
+	const Objects objects = MakeObjects();
+	SpatialHash serialHash(kCellSize, kBucketCount);
+	SpatialHash parallelHash(kCellSize, kBucketCount);
+	serialHash.Rebuild(Span<const Vector3>(objects.positions), Span<const f32>(objects.radii));
+	parallelHash.Rebuild(jobSystem, Span<const Vector3>(objects.positions), Span<const f32>(objects.radii));
+
+	//Insert order within a bucket can differ, so the sorted results are compared
+	bool isMatch = true;
+	for (u32 query = 0; query < kQueryCount; ++query)
+	{
+		const Vector3 center = RandomPoint(kSceneHalfSize);
+		const f32 radius = (query % 2 == 0) ? kSmallQuerySize : kLargeQuerySize;
+		isMatch = isMatch && (QueryRadius(parallelHash, center, radius) == QueryRadius(serialHash, center, radius));
+	}
+	context.Check("Same results as the serial Rebuild", isMatch);
+	context.Check("Same stats as the serial Rebuild", parallelHash.GetStats() == serialHash.GetStats());
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestStats(TestContext& context)
+{
+	context.BeginGroup("SpatialHash stats");
+	if (!context.IsEnabled("SpatialHash"))
+	{
+		return;
+	}
+
+	//Three objects in one cell and one in another, far enough apart that the cells
+	//can't share a bucket unless the hash collides
+	SpatialHash hash(1.0f, 1024);
+	hash.Reset(5);
+	hash.Insert(0, Vector3(0.1f, 0.1f, 0.1f), 0.5f);
+	hash.Insert(1, Vector3(0.2f, 0.3f, 0.4f), 0.25f);
+	hash.Insert(2, Vector3(0.9f, 0.9f, 0.9f), 2.0f);
+	hash.Insert(4, Vector3(7.5f, -3.5f, 2.5f), 1.0f);
+	const SpatialHashStats stats = hash.GetStats();
+	context.Check("Object count", stats.objectCount == 4);
+	context.Check("Bucket count", stats.bucketCount == 1024);
+	context.Check("Occupied buckets", stats.occupiedBuckets == 2);
+	context.Check("Largest bucket", stats.maxBucketSize == 3);
+	context.Check("Average bucket", stats.averageBucketSize == 2.0f);
+	context.Check("Largest radius", stats.maxRadius == 2.0f);
+	context.Check("Histogram", stats.histogram[0] == 1 && stats.histogram[1] == 0 && stats.histogram[2] == 1);
+
+	//Over a full scene every object lands in exactly one bucket
+	const Objects objects = MakeObjects();
+	hash.Rebuild(Span<const Vector3>(objects.positions), Span<const f32>(objects.radii));
+	const SpatialHashStats sceneStats = hash.GetStats();
+	u32 histogramBuckets = 0;
+	u32 histogramObjects = 0;
+	for (u32 size = 0; size < kSpatialHashHistogramSize; ++size)
+	{
+		histogramBuckets += sceneStats.histogram[size];
+		histogramObjects += sceneStats.histogram[size] * (size + 1);
+	}
+	const bool isLastEmpty = (sceneStats.histogram[kSpatialHashHistogramSize - 1] == 0);
+	context.Check("Scene, histogram covers every occupied bucket", histogramBuckets == sceneStats.occupiedBuckets);
+	context.Check("Scene, histogram covers every object", isLastEmpty ? (histogramObjects == kObjectCount) : (histogramObjects <= kObjectCount));
+	context.Check("Scene, largest radius", sceneStats.maxRadius == *std::max_element(objects.radii.begin(), objects.radii.end()));
+	context.ReportRate("Scene, occupied buckets", static_cast<f64>(sceneStats.occupiedBuckets), "");
+	context.ReportRate("Scene, largest bucket", static_cast<f64>(sceneStats.maxBucketSize), "");
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunSpatialHashTests(TestContext& context)
+{
+	TestQueries(context);
+	TestParallelRebuild(context);
+	TestStats(context);
+}
+
+} // namespace Tests
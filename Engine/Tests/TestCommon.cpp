@@ -0,0 +1,164 @@
+//======================================================================================
+// Filename: TestCommon.cpp
+// Description:
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace Tests
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+namespace
+{
+	constexpr u32 kRandomSeed = 1234u;
+}
+
+//======================================================================================
+// Class Definitions
+//======================================================================================
+
+ErrorStats::ErrorStats(const Limit& limit, u32 mantissaBits)
+	: limit(limit)
+	, ulpScale(std::ldexp(1.0, static_cast<s32>(mantissaBits)))
+{}
+
+//--------------------------------------------------------------------------------------
+
+void ErrorStats::Add(const long double* value, const long double* reference, size_t count)
+{
+	long double scale = 0.0L;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!std::isnan(reference[i]))
+		{
+			scale = std::fmax(scale, std::fabs(reference[i]));
+		}
+	}
+
+	//One ulp at the largest component, the smallest normal keeps it finite around 0
+	s32 exponent = 0;
+	std::frexp(static_cast<f64>(std::fmax(scale, static_cast<long double>(F32_MIN))), &exponent);
+	const f64 ulp = std::ldexp(1.0, exponent) / ulpScale;
+
+	bool isFailure = false;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (std::isnan(reference[i]))
+		{
+			continue;
+		}
+		const f64 absError = std::isnan(value[i]) ? INFINITY : static_cast<f64>(std::fabs(value[i] - reference[i]));
+		const f64 ulpError = absError / ulp;
+		maxAbs = std::fmax(maxAbs, absError);
+		maxUlp = std::fmax(maxUlp, ulpError);
+		isFailure |= (absError > limit.abs && ulpError > limit.ulp);
+	}
+	++sampleCount;
+	failureCount += isFailure ? 1 : 0;
+}
+
+//--------------------------------------------------------------------------------------
+
+TestContext::TestContext(const char* variant, const char* filter)
+	: mVariant(variant)
+	, mFilter(filter)
+{
+	printf("EngineTests [%s]\n", mVariant);
+}
+
+//--------------------------------------------------------------------------------------
+
+bool TestContext::IsEnabled(const char* name) const
+{
+	return (mFilter == nullptr) || (strstr(name, mFilter) != nullptr) || (mGroup.find(mFilter) != std::string::npos);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestContext::BeginGroup(const char* group)
+{
+	mGroup = group;
+	GetRandom().seed(kRandomSeed);
+	printf("\n== %s\n", mGroup.c_str());
+	printf("%-44s %12s %12s %12s  %s\n", "function", "ns/op", "max ulp", "max abs", "result");
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestContext::Report(const char* name, f64 nsPerOp, const ErrorStats& error)
+{
+	const bool isPassed = (error.failureCount == 0);
+	printf("%-44s %12.2f %12.2f %12.3g  %s", name, nsPerOp, error.maxUlp, error.maxAbs, isPassed ? "ok" : "FAIL");
+	if (!isPassed)
+	{
+		printf(" (%zu of %zu samples over %.2f ulp / %.3g abs)", error.failureCount, error.sampleCount, error.limit.ulp, error.limit.abs);
+		++mFailureCount;
+	}
+	printf("\n");
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestContext::ReportTiming(const char* name, f64 nsPerOp)
+{
+	printf("%-44s %12.2f %12s %12s  ok\n", name, nsPerOp, "-", "-");
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestContext::ReportRate(const char* name, f64 value, const char* unit)
+{
+	printf("%-44s %12.4g %s\n", name, value, unit);
+}
+
+//--------------------------------------------------------------------------------------
+
+void TestContext::Check(const char* name, bool passed)
+{
+	printf("%-44s %12s %12s %12s  %s\n", name, "-", "-", "-", passed ? "ok" : "FAIL");
+	mFailureCount += passed ? 0 : 1;
+}
+
+//--------------------------------------------------------------------------------------
+
+s32 TestContext::GetExitCode() const
+{
+	printf("\n%u failure(s)\n", mFailureCount);
+	return (mFailureCount == 0) ? 0 : 1;
+}
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+std::mt19937& GetRandom()
+{
+	static std::mt19937 random(kRandomSeed);
+	return random;
+}
+
+//--------------------------------------------------------------------------------------
+
+f32 RandomFloat(f32 min, f32 max)
+{
+	return std::uniform_real_distribution<f32>(min, max)(GetRandom());
+}
+
+//--------------------------------------------------------------------------------------
+
+f32 RandomLogFloat(f32 min, f32 max)
+{
+	return std::exp(RandomFloat(std::log(min), std::log(max)));
+}
+
+} // namespace Tests
@@ -0,0 +1,180 @@
+#ifndef ENGINE_TESTS_TEST_COMMON_H
+#define ENGINE_TESTS_TEST_COMMON_H
+//======================================================================================
+// Filename: TestCommon.h
+// Description: Error tracking, timing and reporting shared by the Tests groups.
+//				Every group checks engine results against a reference computed in
+//				long double and reports ns/op next to the worst error it saw.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "Common.h"
+
+#include <array>
+#include <chrono>
+#include <random>
+
+namespace Tests
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+// Inputs per test, small enough that the inputs of one test stay in L2
+inline constexpr size_t kSampleCount = 1 << 14;
+
+//======================================================================================
+// Types
+//======================================================================================
+
+template <size_t N>
+using Values = std::array<long double, N>;
+
+// A sample passes if it is within either bound. Ulps are counted in f32 (or f64 for
+// the double types) at the largest reference component, so a small component next to
+// a large one is judged by the precision the whole result has.
+struct Limit
+{
+	f64 ulp = 0.0;
+	f64 abs = 0.0;
+};
+
+//======================================================================================
+// Class Declarations
+//======================================================================================
+
+class ErrorStats
+{
+public:
+	explicit ErrorStats(const Limit& limit, u32 mantissaBits = 24);
+
+	template <size_t N>
+	void Add(const Values<N>& value, const Values<N>& reference);
+
+	// A NaN reference marks a component where either result is correct
+	void Add(const long double* value, const long double* reference, size_t count);
+
+	Limit	limit;
+	f64		ulpScale;
+	f64		maxUlp = 0.0;
+	f64		maxAbs = 0.0;
+	size_t	sampleCount = 0;
+	size_t	failureCount = 0;
+};
+
+//--------------------------------------------------------------------------------------
+
+class TestContext
+{
+public:
+	TestContext(const char* variant, const char* filter);
+
+	bool IsEnabled(const char* name) const;
+
+	void BeginGroup(const char* group);
+	void Report(const char* name, f64 nsPerOp, const ErrorStats& error);
+	void ReportTiming(const char* name, f64 nsPerOp);
+	void ReportRate(const char* name, f64 value, const char* unit);
+	void Check(const char* name, bool passed);
+
+	s32 GetExitCode() const;
+
+private:
+	const char*	mVariant;
+	const char*	mFilter;
+	std::string	mGroup;
+	u32			mFailureCount = 0;
+};
+
+//======================================================================================
+// Functions
+//======================================================================================
+
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+	asm volatile("" : : "r"(&value) : "memory");
+}
+
+//--------------------------------------------------------------------------------------
+
+// Best of a few runs, each long enough to swamp the clock resolution. func is called
+// with the sample index and returns the ns per operation of the fastest run.
+template <typename Func>
+f64 MeasureNs(size_t count, const Func& func)
+{
+	using Clock = std::chrono::steady_clock;
+	constexpr u32 kRunCount = 5;
+	constexpr f64 kMinRunNs = 2000000.0;
+
+	f64 bestNs = 0.0;
+	for (u32 run = 0; run < kRunCount; ++run)
+	{
+		size_t operationCount = 0;
+		f64 elapsedNs = 0.0;
+		const Clock::time_point start = Clock::now();
+		do
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				func(i);
+			}
+			operationCount += count;
+			elapsedNs = static_cast<f64>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+		} while (elapsedNs < kMinRunNs);
+
+		const f64 nsPerOp = elapsedNs / static_cast<f64>(operationCount);
+		bestNs = (run == 0 || nsPerOp < bestNs) ? nsPerOp : bestNs;
+	}
+	return bestNs;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Formats a test name, valid until the next call
+template <typename... Args>
+const char* Name(const char* format, Args... args)
+{
+	static char buffer[64];
+	snprintf(buffer, sizeof(buffer), format, args...);
+	return buffer;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Reseeded by every group so each sees the same inputs in every variant and run
+std::mt19937& GetRandom();
+f32 RandomFloat(f32 min, f32 max);
+f32 RandomLogFloat(f32 min, f32 max);
+
+//======================================================================================
+// Groups
+//======================================================================================
+
+void RunMathTests(TestContext& context);
+void RunSpatialHashTests(TestContext& context);
+void RunTransformHierarchyTests(TestContext& context);
+void RunMathBenchmarks(TestContext& context);
+void RunCullingBenchmarks(TestContext& context);
+void RunBvhBenchmarks(TestContext& context);
+void RunEntityBenchmarks(TestContext& context);
+void RunSortBenchmarks(TestContext& context);
+void RunTransformBenchmarks(TestContext& context);
+void RunAllocationTests(TestContext& context);
+// False when there is no Vulkan device to run on
+bool RunGpuCullTests(TestContext& context);
+
+//--------------------------------------------------------------------------------------
+
+template <size_t N>
+void ErrorStats::Add(const Values<N>& value, const Values<N>& reference)
+{
+	Add(value.data(), reference.data(), N);
+}
+
+} // namespace Tests
+
+#endif // !ENGINE_TESTS_TEST_COMMON_H
@@ -0,0 +1,79 @@
+//======================================================================================
+// Filename: TestMain.cpp
+// Description: Entry point of the EngineTests executables. Each build variant runs
+//				the same groups, an optional argument only runs the tests or groups
+//				whose name contains it.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "MathSIMD.h"
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+namespace
+{
+	// ctest reports this exit code as skipped, see SKIP_RETURN_CODE in CMakeLists.txt
+	constexpr s32 kSkipExitCode = 77;
+
+#if BUILD_ENABLE_ALLOCATION_TRACKING
+	constexpr const char* kVariant = "SSE4.1, allocation tracking";
+#elif ENGINE_TESTS_VULKAN
+	constexpr const char* kVariant = "SSE4.1, Vulkan";
+#elif MATH_SIMD_AVX2
+	constexpr const char* kVariant = "AVX2";
+#elif MATH_SIMD_SSE4
+	constexpr const char* kVariant = "SSE4.1";
+#else
+	constexpr const char* kVariant = "Scalar";
+#endif
+}
+
+//======================================================================================
+// Main
+//======================================================================================
+
+int main(int argc, char** argv)
+{
+#if MATH_SIMD_AVX2
+	if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma"))
+	{
+		printf("EngineTests [%s] skipped, the CPU has no AVX2/FMA\n", kVariant);
+		return kSkipExitCode;
+	}
+#elif MATH_SIMD_SSE4
+	if (!__builtin_cpu_supports("sse4.1"))
+	{
+		printf("EngineTests [%s] skipped, the CPU has no SSE4.1\n", kVariant);
+		return kSkipExitCode;
+	}
+#endif
+
+	Tests::TestContext context(kVariant, (argc > 1) ? argv[1] : nullptr);
+#if BUILD_ENABLE_ALLOCATION_TRACKING
+	//Counting every operator new would skew the timings, so this variant only counts
+	Tests::RunAllocationTests(context);
+#elif ENGINE_TESTS_VULKAN
+	if (!Tests::RunGpuCullTests(context))
+	{
+		printf("EngineTests [%s] skipped, no Vulkan device that can run GpuDrawCuller\n", kVariant);
+		return kSkipExitCode;
+	}
+#else
+	Tests::RunMathTests(context);
+	Tests::RunSpatialHashTests(context);
+	Tests::RunTransformHierarchyTests(context);
+	Tests::RunMathBenchmarks(context);
+	Tests::RunCullingBenchmarks(context);
+	Tests::RunBvhBenchmarks(context);
+	Tests::RunEntityBenchmarks(context);
+	Tests::RunSortBenchmarks(context);
+	Tests::RunTransformBenchmarks(context);
+#endif
+	return context.GetExitCode();
+}
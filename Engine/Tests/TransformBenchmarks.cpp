@@ -0,0 +1,133 @@
+//======================================================================================
+// Filename: TransformBenchmarks.cpp
+// Description: TransformHierarchy::Update with a few transforms moved against all of
+//				them, to show the cost follows what moved rather than the scene size.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "EngineMath.h"
+#include "JobSystem.h"
+#include "TransformHierarchy.h"
+
+#include <vector>
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+constexpr u32 kTransformCount = 100000;
+constexpr u32 kRootCount = 64;
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+// Random parents among the earlier transforms, so most are leaves or near them
+void BuildScene(TransformHierarchy& hierarchy)
+{
+	std::vector<TransformId> ids;
+	for (u32 i = 0; i < kTransformCount; ++i)
+	{
+		const TransformId parent = (i < kRootCount) ? kTransformInvalid : ids[GetRandom()() % ids.size()];
+		const TransformId id = hierarchy.Create(parent);
+		const Vector3 position(RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f));
+		const Quaternion rotation = Quaternion::RotationAxis(Vector3(0.0f, 1.0f, 0.0f), RandomFloat(-kPi, kPi));
+		hierarchy.SetLocal(id, position, rotation, Vector3::One());
+		ids.push_back(id);
+	}
+	hierarchy.Update();
+}
+
+//--------------------------------------------------------------------------------------
+
+// Moves every moveStride-th transform, which keeps clear of the roots at the start,
+// and brings the hierarchy up to date. Reports the time per Update and per world
+// matrix it recomputed.
+template <typename Update>
+void ReportMoved(TestContext& context, const char* name, TransformHierarchy& hierarchy, u32 moveStride, const Update& update)
+{
+	std::vector<TransformId> moved;
+	for (TransformId id = moveStride - 1; id < kTransformCount; id += moveStride)
+	{
+		moved.push_back(id);
+	}
+
+	f32 offset = 0.0f;
+	const f64 ns = MeasureNs(1, [&](size_t)
+	{
+		offset = (offset < 1.0f) ? offset + 0.01f : 0.0f;
+		for (TransformId id : moved)
+		{
+			hierarchy.SetPosition(id, Vector3(offset, 0.0f, 0.0f));
+		}
+		update();
+	});
+	const u32 updateCount = hierarchy.GetLastUpdateCount();
+	context.ReportTiming(name, ns);
+	context.ReportRate(Name("%s, recomputed", name), static_cast<f64>(updateCount), "transforms");
+	context.ReportRate(Name("%s, per recomputed", name), ns / static_cast<f64>(updateCount), "ns");
+}
+
+//======================================================================================
+// Benchmarks
+//======================================================================================
+
+void BenchmarkUpdate(TestContext& context)
+{
+	JobSystem jobSystem;
+	context.BeginGroup(Name("TransformHierarchy, %u transforms, %u job workers", kTransformCount, jobSystem.GetWorkerCount()));
+	if (!context.IsEnabled("TransformHierarchy"))
+	{
+		return;
+	}
+
+	TransformHierarchy hierarchy;
+	BuildScene(hierarchy);
+	context.ReportRate("Levels", static_cast<f64>(hierarchy.GetLevelCount()), "");
+
+	//Moved transforms are spread over the scene, each drags its descendants along
+	const auto update = [&]() { hierarchy.Update(); };
+	const auto updateJobs = [&]() { hierarchy.Update(jobSystem); };
+	ReportMoved(context, "Update, 0.1% moved", hierarchy, 1000, update);
+	ReportMoved(context, "Update, 1% moved", hierarchy, 100, update);
+	ReportMoved(context, "Update, 10% moved", hierarchy, 10, update);
+	ReportMoved(context, "Update, all moved", hierarchy, 1, update);
+	ReportMoved(context, "Update(JobSystem&), 1% moved", hierarchy, 100, updateJobs);
+	ReportMoved(context, "Update(JobSystem&), all moved", hierarchy, 1, updateJobs);
+
+	//A structural change re-sorts the storage, which touches every transform once
+	const TransformId leaf = kTransformCount - 1;
+	const TransformId parents[2] = { 0, 1 };
+	u32 reparentCount = 0;
+	const f64 reparentNs = MeasureNs(1, [&](size_t)
+	{
+		hierarchy.SetParent(leaf, parents[reparentCount++ % 2]);
+		hierarchy.Update();
+	});
+	context.ReportTiming("Update after one SetParent", reparentNs);
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunTransformBenchmarks(TestContext& context)
+{
+	BenchmarkUpdate(context);
+}
+
+} // namespace Tests
@@ -0,0 +1,377 @@
+//======================================================================================
+// Filename: TransformHierarchyTests.cpp
+// Description: TransformHierarchy world matrices against a full recompute from a plain
+//				parent array, through random moves, reparenting, creation and
+//				destruction, and the count of transforms each Update recomputes.
+//======================================================================================
+
+//======================================================================================
+// Includes
+//======================================================================================
+#include "TestCommon.h"
+
+#include "EngineMath.h"
+#include "JobSystem.h"
+#include "TransformHierarchy.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace Math;
+
+namespace Tests
+{
+
+namespace
+{
+
+//======================================================================================
+// Constants
+//======================================================================================
+
+// Random parents among the earlier transforms give about ten levels, the widest well
+// over kTransformGrainSize so Update(JobSystem&) splits them
+constexpr u32 kTransformCount = 20000;
+constexpr u32 kRootCount = 16;
+constexpr u32 kRoundCount = 48;
+constexpr u32 kMovesPerRound = 200;
+constexpr u32 kReparentsPerRound = 50;
+constexpr u32 kCreatesPerRound = 100;
+constexpr u32 kDestroysPerRound = 20;
+
+// Both sides do the same float operations, this only allows for contraction
+constexpr f32 kTolerance = 1e-5f;
+
+//======================================================================================
+// Types
+//======================================================================================
+
+// What the hierarchy should hold, indexed by id
+struct Model
+{
+	std::vector<TransformId>	parents;
+	std::vector<Vector3>		positions;
+	std::vector<Quaternion>		rotations;
+	std::vector<Vector3>		scales;
+	std::vector<u8>				isAlive;
+	std::vector<u8>				isTouched;	// Changed since the last Update
+	std::vector<TransformId>	alive;
+};
+
+//======================================================================================
+// Helpers
+//======================================================================================
+
+Vector3 RandomPosition()
+{
+	return Vector3(RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f));
+}
+
+//--------------------------------------------------------------------------------------
+
+Quaternion RandomRotation()
+{
+	const Vector3 axis(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f));
+	return Quaternion::RotationAxis(Normalize(axis + Vector3(0.0f, 0.0f, 1e-3f)), RandomFloat(-kPi, kPi));
+}
+
+//--------------------------------------------------------------------------------------
+
+Vector3 RandomScale()
+{
+	return Vector3(RandomFloat(0.8f, 1.25f), RandomFloat(0.8f, 1.25f), RandomFloat(0.8f, 1.25f));
+}
+
+//--------------------------------------------------------------------------------------
+
+TransformId RandomAlive(const Model& model)
+{
+	return model.alive[GetRandom()() % model.alive.size()];
+}
+
+//--------------------------------------------------------------------------------------
+
+void RebuildAliveList(Model& model)
+{
+	model.alive.clear();
+	for (TransformId id = 0; id < model.isAlive.size(); ++id)
+	{
+		if (model.isAlive[id] != 0)
+		{
+			model.alive.push_back(id);
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+
+void Create(TransformHierarchy& hierarchy, Model& model, TransformId parent)
+{
+	const TransformId id = hierarchy.Create(parent);
+	if (id >= model.parents.size())
+	{
+		model.parents.resize(id + 1);
+		model.positions.resize(id + 1);
+		model.rotations.resize(id + 1);
+		model.scales.resize(id + 1);
+		model.isAlive.resize(id + 1, 0);
+		model.isTouched.resize(id + 1, 0);
+	}
+	model.parents[id] = parent;
+	model.positions[id] = RandomPosition();
+	model.rotations[id] = RandomRotation();
+	model.scales[id] = RandomScale();
+	model.isAlive[id] = 1;
+	model.isTouched[id] = 1;
+	model.alive.push_back(id);
+	hierarchy.SetLocal(id, model.positions[id], model.rotations[id], model.scales[id]);
+}
+
+//--------------------------------------------------------------------------------------
+
+bool IsDescendant(const Model& model, TransformId id, TransformId ancestor)
+{
+	for (TransformId parent = id; parent != kTransformInvalid; parent = model.parents[parent])
+	{
+		if (parent == ancestor)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------------------------------
+
+// One random SetPosition, SetRotation, SetScale or SetLocal
+void Move(TransformHierarchy& hierarchy, Model& model, TransformId id)
+{
+	switch (GetRandom()() % 4)
+	{
+	case 0:
+		model.positions[id] = RandomPosition();
+		hierarchy.SetPosition(id, model.positions[id]);
+		break;
+	case 1:
+		model.rotations[id] = RandomRotation();
+		hierarchy.SetRotation(id, model.rotations[id]);
+		break;
+	case 2:
+		model.scales[id] = RandomScale();
+		hierarchy.SetScale(id, model.scales[id]);
+		break;
+	default:
+		model.positions[id] = RandomPosition();
+		model.rotations[id] = RandomRotation();
+		model.scales[id] = RandomScale();
+		hierarchy.SetLocal(id, model.positions[id], model.rotations[id], model.scales[id]);
+		break;
+	}
+	model.isTouched[id] = 1;
+}
+
+//--------------------------------------------------------------------------------------
+
+// Reparents to a random transform that isn't below it, or to the root now and then
+void Reparent(TransformHierarchy& hierarchy, Model& model, TransformId id)
+{
+	TransformId parent = (GetRandom()() % 8 == 0) ? kTransformInvalid : RandomAlive(model);
+	if (parent != kTransformInvalid && IsDescendant(model, parent, id))
+	{
+		parent = kTransformInvalid;
+	}
+	model.parents[id] = parent;
+	model.isTouched[id] = 1;
+	hierarchy.SetParent(id, parent);
+}
+
+//--------------------------------------------------------------------------------------
+
+// Destroys id and, in the model, everything below it
+void Destroy(TransformHierarchy& hierarchy, Model& model, TransformId id)
+{
+	hierarchy.Destroy(id);
+	for (TransformId other : model.alive)
+	{
+		if (IsDescendant(model, other, id))
+		{
+			model.isAlive[other] = 0;
+		}
+	}
+	RebuildAliveList(model);
+}
+
+//--------------------------------------------------------------------------------------
+
+// Every world matrix from scratch by walking up to the root, memoized per id
+Matrix34 NaiveWorld(const Model& model, TransformId id, std::vector<Matrix34>& worlds, std::vector<u8>& isDone)
+{
+	if (isDone[id] == 0)
+	{
+		const Matrix34 local = Matrix34::Compose(model.positions[id], model.rotations[id], model.scales[id]);
+		const TransformId parent = model.parents[id];
+		worlds[id] = (parent != kTransformInvalid) ? NaiveWorld(model, parent, worlds, isDone) * local : local;
+		isDone[id] = 1;
+	}
+	return worlds[id];
+}
+
+//--------------------------------------------------------------------------------------
+
+bool IsNear(const Matrix34& lhs, const Matrix34& rhs)
+{
+	const f32* a = &lhs._11;
+	const f32* b = &rhs._11;
+	for (u32 i = 0; i < 12; ++i)
+	{
+		if (!(std::abs(a[i] - b[i]) <= kTolerance * (1.0f + std::abs(b[i]))))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------
+
+struct Comparison
+{
+	bool isWorldMatch = true;
+	bool isParentMatch = true;
+	bool isCountMatch = true;
+	bool isLevelMatch = true;
+	bool isUpdateCountMatch = true;
+};
+
+// Checks the hierarchy after an Update against the model, then clears the touched flags
+void Compare(const TransformHierarchy& hierarchy, Model& model, Comparison& comparison)
+{
+	std::vector<Matrix34> worlds(model.parents.size());
+	std::vector<u8> isDone(model.parents.size(), 0);
+	u32 touchedCount = 0;
+	u32 levelCount = 0;
+	for (TransformId id : model.alive)
+	{
+		comparison.isWorldMatch = comparison.isWorldMatch && IsNear(hierarchy.GetWorld(id), NaiveWorld(model, id, worlds, isDone));
+		comparison.isParentMatch = comparison.isParentMatch && (hierarchy.GetParent(id) == model.parents[id]);
+
+		//Touched, or below something that was
+		u32 depth = 0;
+		bool isTouched = false;
+		for (TransformId parent = id; parent != kTransformInvalid; parent = model.parents[parent])
+		{
+			isTouched = isTouched || (model.isTouched[parent] != 0);
+			++depth;
+		}
+		touchedCount += isTouched ? 1 : 0;
+		levelCount = (depth > levelCount) ? depth : levelCount;
+	}
+	comparison.isCountMatch = comparison.isCountMatch && (hierarchy.GetCount() == model.alive.size());
+	comparison.isLevelMatch = comparison.isLevelMatch && (hierarchy.GetLevelCount() == levelCount);
+	comparison.isUpdateCountMatch = comparison.isUpdateCountMatch && (hierarchy.GetLastUpdateCount() == touchedCount);
+
+	std::fill(model.isTouched.begin(), model.isTouched.end(), 0);
+}
+
+//======================================================================================
+// Tests
+//======================================================================================
+
+void TestUpdate(TestContext& context)
+{
+	JobSystem jobSystem;
+	context.BeginGroup(Name("TransformHierarchy, %u transforms, %u job workers", kTransformCount, jobSystem.GetWorkerCount()));
+	if (!context.IsEnabled("TransformHierarchy"))
+	{
+		return;
+	}
+
+	TransformHierarchy hierarchy;
+	Model model;
+	for (u32 i = 0; i < kTransformCount; ++i)
+	{
+		Create(hierarchy, model, (i < kRootCount) ? kTransformInvalid : RandomAlive(model));
+	}
+	hierarchy.Update();
+
+	Comparison first;
+	Compare(hierarchy, model, first);
+	context.Check("First Update, same as a full recompute", first.isWorldMatch);
+	context.Check("First Update, recomputes everything", hierarchy.GetLastUpdateCount() == kTransformCount);
+
+	//Even rounds only move, which leaves the storage alone and queues straight into
+	//the dirty levels. Odd rounds also change the structure, which re-sorts it first.
+	//Every fourth moves the roots, which recomputes everything and splits every wide
+	//level on the job system.
+	Comparison serial;
+	Comparison parallel;
+	for (u32 round = 0; round < kRoundCount; ++round)
+	{
+		if (round % 4 == 3)
+		{
+			for (TransformId id : model.alive)
+			{
+				if (model.parents[id] == kTransformInvalid)
+				{
+					Move(hierarchy, model, id);
+				}
+			}
+		}
+		for (u32 move = 0; move < kMovesPerRound; ++move)
+		{
+			Move(hierarchy, model, RandomAlive(model));
+		}
+		if (round % 2 == 1)
+		{
+			for (u32 reparent = 0; reparent < kReparentsPerRound; ++reparent)
+			{
+				Reparent(hierarchy, model, RandomAlive(model));
+			}
+			for (u32 destroy = 0; destroy < kDestroysPerRound && model.alive.size() > kRootCount; ++destroy)
+			{
+				Destroy(hierarchy, model, RandomAlive(model));
+			}
+			for (u32 create = 0; create < kCreatesPerRound; ++create)
+			{
+				Create(hierarchy, model, (GetRandom()() % 16 == 0) ? kTransformInvalid : RandomAlive(model));
+			}
+		}
+
+		const bool isParallel = (round % 8) >= 4;
+		if (isParallel)
+		{
+			hierarchy.Update(jobSystem);
+		}
+		else
+		{
+			hierarchy.Update();
+		}
+		Compare(hierarchy, model, isParallel ? parallel : serial);
+	}
+
+	context.Check("Update, same as a full recompute", serial.isWorldMatch);
+	context.Check("Update, same parents", serial.isParentMatch);
+	context.Check("Update, only moved and below are recomputed", serial.isUpdateCountMatch);
+	context.Check("Update, transform and level counts", serial.isCountMatch && serial.isLevelMatch);
+	context.Check("Update(JobSystem&), same as a full recompute", parallel.isWorldMatch);
+	context.Check("Update(JobSystem&), same parents", parallel.isParentMatch);
+	context.Check("Update(JobSystem&), only moved and below are recomputed", parallel.isUpdateCountMatch);
+	context.Check("Update(JobSystem&), transform and level counts", parallel.isCountMatch && parallel.isLevelMatch);
+
+	//Nothing changed, nothing to do
+	hierarchy.Update();
+	context.Check("Update with nothing moved, recomputes nothing", hierarchy.GetLastUpdateCount() == 0);
+}
+
+} // namespace
+
+//======================================================================================
+// Function Definitions
+//======================================================================================
+
+void RunTransformHierarchyTests(TestContext& context)
+{
+	TestUpdate(context);
+}
+
+} // namespace Tests